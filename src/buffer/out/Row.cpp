@@ -220,3 +220,185 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const size_t index, co
 
     return it;
 }
+
+// Routine Description:
+// - fills a range of the row with one narrow glyph and one attribute
+// - this is the bulk counterpart to WriteCells: instead of walking an
+//   iterator cell by cell, the glyphs are filled in one pass and the
+//   attributes are replaced with a single run.
+// Arguments:
+// - left - the first column to fill
+// - right - the column after the last one to fill
+// - wch - the glyph to fill with. It must not be full width.
+// - attr - the attribute to fill with
+// Return Value:
+// - <none>
+// Note:
+// - will throw exception on error.
+void ROW::FillCells(const size_t left, const size_t right, const wchar_t wch, const TextAttribute attr)
+{
+    THROW_HR_IF(E_INVALIDARG, left > right || right > _charRow.size());
+    if (left == right)
+    {
+        return;
+    }
+
+    // Glyphs too big for a cell live in the buffer's UnicodeStorage. Drop the
+    // ones we're about to overwrite, or they'd stay there forever.
+    auto& storage = GetUnicodeStorage();
+    for (size_t column = left; column < right; ++column)
+    {
+        if (_charRow.DbcsAttrAt(column).IsGlyphStored())
+        {
+            storage.Erase(_charRow.GetStorageKey(column));
+        }
+    }
+
+    std::fill(_charRow.begin() + left, _charRow.begin() + right, CharRowCell{ wch, DbcsAttribute{} });
+
+    if (left == 0 && right == _charRow.size())
+    {
+        _attrRow.Reset(attr);
+    }
+    else
+    {
+        const TextAttributeRun run{ right - left, attr };
+        THROW_IF_FAILED(_attrRow.InsertAttrRuns({ &run, 1 }, left, right - 1, _charRow.size()));
+    }
+}
+
+// Routine Description:
+// - reads a range of the row into CHAR_INFOs, the way the public API hands cells out
+// - this is the bulk counterpart to walking the row with a cell iterator: the
+//   glyphs and DBCS flags are read straight out of the CharRow, and each
+//   attribute run is converted to a legacy attribute once rather than per cell.
+// Arguments:
+// - left - the first column to read
+// - target - where to put the cells. One is read for each CHAR_INFO in it.
+// - toLegacy - converts an attribute to the legacy attribute reported for it
+// Return Value:
+// - <none>
+// Note:
+// - will throw exception on error.
+void ROW::ReadCharInfos(const size_t left,
+                        gsl::span<CHAR_INFO> target,
+                        const std::function<WORD(const TextAttribute&)>& toLegacy) const
+{
+    const size_t count = gsl::narrow<size_t>(target.size());
+    THROW_HR_IF(E_INVALIDARG, left > _charRow.size() || count > _charRow.size() - left);
+
+    auto targetIt = target.begin();
+    size_t column = left;
+    const size_t right = left + count;
+    while (column < right)
+    {
+        size_t applies = 0;
+        const WORD legacyAttr = toLegacy(_attrRow.GetAttrByColumn(column, &applies));
+        const size_t runEnd = std::min(right, column + applies);
+
+        for (auto cell = _charRow.cbegin() + column; column < runEnd; ++column, ++cell, ++targetIt)
+        {
+            const auto& dbcsAttr = cell->DbcsAttr();
+            targetIt->Char.UnicodeChar = dbcsAttr.IsGlyphStored() ? Utf16ToUcs2(_charRow.GlyphAt(column)) : cell->Char();
+            targetIt->Attributes = legacyAttr;
+            targetIt->Attributes |= dbcsAttr.GeneratePublicApiAttributeFormat();
+        }
+    }
+}
+
+// Routine Description:
+// - writes CHAR_INFOs from the public API into a range of the row
+// - this is the bulk counterpart to WriteCells: the glyphs are copied into
+//   the CharRow in one pass, and the attributes are packed into runs and
+//   inserted into the row at once instead of one cell at a time.
+// Arguments:
+// - left - the first column to write
+// - source - the cells to write
+// - setWrap - set the wrap flag if the cells fill the last column of the row
+// Return Value:
+// - true if the cells were written. false if nothing was written, because
+//   the range starts at the first column with a trailing half or ends at the
+//   last column with a leading half. WriteCells pads those out instead.
+// Note:
+// - will throw exception on error.
+bool ROW::WriteCharInfos(const size_t left, const gsl::span<const CHAR_INFO> source, const bool setWrap)
+{
+    const size_t count = gsl::narrow<size_t>(source.size());
+    THROW_HR_IF(E_INVALIDARG, left > _charRow.size() || count > _charRow.size() - left);
+    if (count == 0)
+    {
+        return true;
+    }
+
+    const size_t right = left + count;
+    if ((left == 0 && s_DbcsAttrFromLegacy(source.begin()->Attributes).IsTrailing()) ||
+        (right == _charRow.size() && s_DbcsAttrFromLegacy((source.end() - 1)->Attributes).IsLeading()))
+    {
+        return false;
+    }
+
+    std::vector<TextAttributeRun> runs;
+    WORD runAttr = 0;
+
+    auto& storage = GetUnicodeStorage();
+    auto sourceIt = source.begin();
+    auto cell = _charRow.begin() + left;
+    for (size_t column = left; column < right; ++column, ++cell, ++sourceIt)
+    {
+        // Glyphs too big for a cell live in the buffer's UnicodeStorage. Drop the
+        // ones we're about to overwrite, or they'd stay there forever.
+        if (cell->DbcsAttr().IsGlyphStored())
+        {
+            storage.Erase(_charRow.GetStorageKey(column));
+        }
+
+        const auto& charInfo = *sourceIt;
+        *cell = CharRowCell{ charInfo.Char.UnicodeChar, s_DbcsAttrFromLegacy(charInfo.Attributes) };
+
+        // The DBCS flags aren't part of the attribute, so they don't split runs.
+        const auto attr = static_cast<WORD>(charInfo.Attributes & ~COMMON_LVB_SBCSDBCS);
+        if (runs.empty() || attr != runAttr)
+        {
+            runs.emplace_back(1, TextAttribute{ attr });
+            runAttr = attr;
+        }
+        else
+        {
+            runs.back().IncrementLength();
+        }
+    }
+
+    if (left == 0 && right == _charRow.size() && runs.size() == 1)
+    {
+        _attrRow.Reset(runs.front().GetAttributes());
+    }
+    else
+    {
+        THROW_IF_FAILED(_attrRow.InsertAttrRuns({ runs.data(), runs.size() }, left, right - 1, _charRow.size()));
+    }
+
+    if (setWrap && right == _charRow.size())
+    {
+        _charRow.SetWrapForced(true);
+    }
+
+    return true;
+}
+
+// Routine Description:
+// - returns the DBCS attribute described by the flags of a legacy attribute
+// - unlike DbcsAttribute::FromPublicApiAttributeFormat, having both flags isn't
+//   an error. Leading wins, as it always has for WriteConsoleOutput.
+DbcsAttribute ROW::s_DbcsAttrFromLegacy(const WORD attributes) noexcept
+{
+    DbcsAttribute dbcsAttr;
+    if (WI_IsFlagSet(attributes, COMMON_LVB_LEADING_BYTE))
+    {
+        dbcsAttr.SetLeading();
+    }
+    else if (WI_IsFlagSet(attributes, COMMON_LVB_TRAILING_BYTE))
+    {
+        dbcsAttr.SetTrailing();
+    }
+    return dbcsAttr;
+}
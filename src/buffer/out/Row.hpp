@@ -59,6 +59,11 @@ public:
     const UnicodeStorage& GetUnicodeStorage() const;
 
     OutputCellIterator WriteCells(OutputCellIterator it, const size_t index, const bool setWrap, std::optional<size_t> limitRight = std::nullopt);
+    void FillCells(const size_t left, const size_t right, const wchar_t wch, const TextAttribute attr);
+    void ReadCharInfos(const size_t left,
+                       gsl::span<CHAR_INFO> target,
+                       const std::function<WORD(const TextAttribute&)>& toLegacy) const;
+    bool WriteCharInfos(const size_t left, const gsl::span<const CHAR_INFO> source, const bool setWrap);
 
     friend bool operator==(const ROW& a, const ROW& b) noexcept;
 
@@ -72,6 +77,8 @@ private:
     SHORT _id;
     size_t _rowWidth;
     TextBuffer* _pParent; // non ownership pointer
+
+    static DbcsAttribute s_DbcsAttrFromLegacy(const WORD attributes) noexcept;
 };
 
 inline bool operator==(const ROW& a, const ROW& b) noexcept
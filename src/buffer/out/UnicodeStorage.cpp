@@ -5,7 +5,8 @@
 #include "UnicodeStorage.hpp"
 
 UnicodeStorage::UnicodeStorage() :
-    _map{}
+    _map{},
+    _columns{}
 {
 }
 
@@ -28,6 +29,10 @@ const UnicodeStorage::mapped_type& UnicodeStorage::GetText(const key_type key) c
 // - glyph - the glyph data to store
 void UnicodeStorage::StoreGlyph(const key_type key, const mapped_type& glyph)
 {
+    if (_map.find(key) == _map.end())
+    {
+        _columns[key.Y].push_back(key.X);
+    }
     _map.insert_or_assign(key, glyph);
 }
 
@@ -37,7 +42,19 @@ void UnicodeStorage::StoreGlyph(const key_type key, const mapped_type& glyph)
 // - key - the key to remove
 void UnicodeStorage::Erase(const key_type key) noexcept
 {
-    _map.erase(key);
+    if (_map.erase(key) != 0)
+    {
+        const auto row = _columns.find(key.Y);
+        if (row != _columns.end())
+        {
+            auto& columns = row->second;
+            columns.erase(std::remove(columns.begin(), columns.end(), key.X), columns.end());
+            if (columns.empty())
+            {
+                _columns.erase(row);
+            }
+        }
+    }
 }
 
 // Routine Description:
@@ -51,6 +68,7 @@ void UnicodeStorage::Remap(const std::map<SHORT, SHORT>& rowMap, const std::opti
 {
     // Make a temporary map to hold all the new row positioning
     std::unordered_map<key_type, mapped_type> newMap;
+    std::unordered_map<SHORT, std::vector<SHORT>> newColumns;
 
     // Walk through every stored item.
     for (const auto& pair : _map)
@@ -91,8 +109,72 @@ void UnicodeStorage::Remap(const std::map<SHORT, SHORT>& rowMap, const std::opti
 
         // Put the adjusted coordinate into the map with the original value.
         newMap.emplace(newCoord, pair.second);
+        newColumns[newRowId].push_back(oldCoord.X);
     }
 
     // Swap into the stored map, free the temporary when we exit.
     _map.swap(newMap);
+    _columns.swap(newColumns);
+}
+
+// Routine Description:
+// - Remaps the stored items in some of the rows to new row IDs, after those
+//   rows were shuffled amongst themselves. Unlike Remap, items in rows that
+//   aren't in the map stay where they are.
+// - Only the items in the rows that moved are visited.
+// Arguments:
+// - rowMap - A map of the old row IDs to the new row IDs, for the rows that moved.
+//   The new row IDs must be the same set as the old ones.
+void UnicodeStorage::RemapRows(const std::map<SHORT, SHORT>& rowMap)
+{
+    // Find the rows that moved and have items in them.
+    std::vector<std::pair<decltype(_columns)::iterator, SHORT>> movedRows;
+    size_t movedCount = 0;
+    for (const auto& [oldRowId, newRowId] : rowMap)
+    {
+        if (oldRowId != newRowId)
+        {
+            const auto row = _columns.find(oldRowId);
+            if (row != _columns.end())
+            {
+                movedRows.emplace_back(row, newRowId);
+                movedCount += row->second.size();
+            }
+        }
+    }
+
+    // Take all of their items out before putting any back, since a row can
+    // move to where another one of them was.
+    std::vector<decltype(_map)::node_type> movedItems;
+    movedItems.reserve(movedCount);
+    std::vector<std::pair<SHORT, std::vector<SHORT>>> movedColumns;
+    movedColumns.reserve(movedRows.size());
+    for (auto& [row, newRowId] : movedRows)
+    {
+        for (const auto column : row->second)
+        {
+            auto item = _map.extract(COORD{ column, row->first });
+            if (item)
+            {
+                item.key().Y = newRowId;
+                movedItems.push_back(std::move(item));
+            }
+        }
+        movedColumns.emplace_back(newRowId, std::move(row->second));
+    }
+
+    for (const auto& [row, newRowId] : movedRows)
+    {
+        _columns.erase(row);
+    }
+
+    for (auto& item : movedItems)
+    {
+        _map.insert(std::move(item));
+    }
+
+    for (auto& [newRowId, columns] : movedColumns)
+    {
+        _columns.insert_or_assign(newRowId, std::move(columns));
+    }
 }
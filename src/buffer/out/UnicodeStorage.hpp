@@ -58,9 +58,15 @@ public:
 
     void Remap(const std::map<SHORT, SHORT>& rowMap, const std::optional<SHORT> width);
 
+    void RemapRows(const std::map<SHORT, SHORT>& rowMap);
+
 private:
     std::unordered_map<key_type, mapped_type> _map;
 
+    // The columns of the stored items in each row that has any, so that
+    // moving a few rows doesn't have to look at every stored item.
+    std::unordered_map<SHORT, std::vector<SHORT>> _columns;
+
 #ifdef UNIT_TESTING
     friend class UnicodeStorageTests;
     friend class TextBufferTests;
@@ -0,0 +1,938 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "regexMatcher.hpp"
+
+#include <map>
+
+namespace
+{
+    // Limits that keep a pathological pattern from taking all of the memory,
+    // or all of the time, it'd take to compile. Patterns past them are
+    // rejected the same way invalid ones are.
+    constexpr size_t s_MaxRepeatCount = 1000;
+    constexpr size_t s_MaxNesting = 100;
+    constexpr size_t s_MaxNfaStates = 50000;
+    constexpr size_t s_MaxDfaStates = 4096;
+    constexpr size_t s_MaxTableEntries = 1 << 22;
+
+    constexpr size_t s_CharCount = 0x10000;
+    constexpr size_t s_Unbounded = SIZE_MAX;
+
+    using CharSet = std::vector<bool>;
+
+    struct Node
+    {
+        enum class Kind
+        {
+            Chars,
+            Sequence,
+            Alternation,
+            Repeat,
+            LineStart,
+            LineEnd
+        };
+
+        Kind kind;
+        size_t set = 0;
+        std::vector<size_t> children{};
+        size_t min = 0;
+        size_t max = 0;
+    };
+
+    // Parses a pattern into a tree of nodes, which refer to each other and to
+    // their sets of chars by index.
+    class Parser final
+    {
+    public:
+        Parser(const std::wstring_view pattern, const bool caseInsensitive) noexcept :
+            _pattern{ pattern },
+            _pos{ 0 },
+            _depth{ 0 },
+            _caseInsensitive{ caseInsensitive }
+        {
+        }
+
+        size_t Parse()
+        {
+            const size_t root = _Alternation();
+
+            // the only thing that stops the top level early is a ')' with no '('.
+            THROW_HR_IF(E_INVALIDARG, !_AtEnd());
+            return root;
+        }
+
+        std::vector<Node> nodes;
+        std::vector<CharSet> sets;
+
+    private:
+        bool _AtEnd() const noexcept
+        {
+            return _pos >= _pattern.size();
+        }
+
+        wchar_t _Peek() const noexcept
+        {
+            return _AtEnd() ? L'\0' : _pattern[_pos];
+        }
+
+        wchar_t _Next()
+        {
+            THROW_HR_IF(E_INVALIDARG, _AtEnd());
+            return _pattern[_pos++];
+        }
+
+        size_t _AddNode(Node node)
+        {
+            nodes.push_back(std::move(node));
+            return nodes.size() - 1;
+        }
+
+        size_t _AddChars(CharSet set)
+        {
+            sets.push_back(std::move(set));
+            Node node{ Node::Kind::Chars };
+            node.set = sets.size() - 1;
+            return _AddNode(std::move(node));
+        }
+
+        void _Fold(CharSet& set) const
+        {
+            if (_caseInsensitive)
+            {
+                for (size_t ch = 0; ch < s_CharCount; ++ch)
+                {
+                    if (set[ch])
+                    {
+                        set[towlower(static_cast<wchar_t>(ch))] = true;
+                        set[towupper(static_cast<wchar_t>(ch))] = true;
+                    }
+                }
+            }
+        }
+
+        size_t _Alternation()
+        {
+            THROW_HR_IF(E_INVALIDARG, ++_depth > s_MaxNesting);
+
+            Node node{ Node::Kind::Alternation };
+            node.children.push_back(_Sequence());
+            while (_Peek() == L'|')
+            {
+                ++_pos;
+                node.children.push_back(_Sequence());
+            }
+
+            --_depth;
+            return node.children.size() == 1 ? node.children.front() : _AddNode(std::move(node));
+        }
+
+        size_t _Sequence()
+        {
+            Node node{ Node::Kind::Sequence };
+            while (!_AtEnd() && _Peek() != L'|' && _Peek() != L')')
+            {
+                node.children.push_back(_Repetition());
+            }
+
+            return node.children.size() == 1 ? node.children.front() : _AddNode(std::move(node));
+        }
+
+        size_t _Repetition()
+        {
+            size_t atom = _Atom();
+            while (!_AtEnd())
+            {
+                Node node{ Node::Kind::Repeat };
+                switch (_Peek())
+                {
+                case L'*':
+                    ++_pos;
+                    node.min = 0;
+                    node.max = s_Unbounded;
+                    break;
+                case L'+':
+                    ++_pos;
+                    node.min = 1;
+                    node.max = s_Unbounded;
+                    break;
+                case L'?':
+                    ++_pos;
+                    node.min = 0;
+                    node.max = 1;
+                    break;
+                case L'{':
+                    ++_pos;
+                    _Bounds(node.min, node.max);
+                    break;
+                default:
+                    return atom;
+                }
+
+                node.children.push_back(atom);
+                atom = _AddNode(std::move(node));
+            }
+            return atom;
+        }
+
+        // Parses the inside of {n}, {n,} or {n,m}, up to the closing brace.
+        void _Bounds(size_t& min, size_t& max)
+        {
+            min = _Number();
+            max = min;
+            if (_Peek() == L',')
+            {
+                ++_pos;
+                max = _Peek() == L'}' ? s_Unbounded : _Number();
+            }
+
+            THROW_HR_IF(E_INVALIDARG, _Next() != L'}');
+            THROW_HR_IF(E_INVALIDARG, min > max);
+        }
+
+        size_t _Number()
+        {
+            THROW_HR_IF(E_INVALIDARG, !iswdigit(_Peek()));
+
+            size_t value = 0;
+            while (iswdigit(_Peek()))
+            {
+                value = value * 10 + (_Next() - L'0');
+                THROW_HR_IF(E_INVALIDARG, value > s_MaxRepeatCount);
+            }
+            return value;
+        }
+
+        size_t _Atom()
+        {
+            const wchar_t ch = _Next();
+            switch (ch)
+            {
+            case L'(':
+            {
+                if (_pattern.substr(_pos, 2) == L"?:")
+                {
+                    _pos += 2;
+                }
+                else
+                {
+                    // lookarounds, named groups and the like aren't supported.
+                    THROW_HR_IF(E_INVALIDARG, _Peek() == L'?');
+                }
+
+                const size_t inner = _Alternation();
+                THROW_HR_IF(E_INVALIDARG, _Next() != L')');
+                return inner;
+            }
+            case L'[':
+                return _AddChars(_Class());
+            case L'.':
+                return _AddChars(CharSet(s_CharCount, true));
+            case L'^':
+                return _AddNode(Node{ Node::Kind::LineStart });
+            case L'$':
+                return _AddNode(Node{ Node::Kind::LineEnd });
+            case L'*':
+            case L'+':
+            case L'?':
+            case L'{':
+            case L')':
+                // a quantifier with nothing to repeat.
+                THROW_HR(E_INVALIDARG);
+            default:
+            {
+                CharSet set(s_CharCount, false);
+                if (ch == L'\\')
+                {
+                    _Escape(set);
+                }
+                else
+                {
+                    set[ch] = true;
+                }
+                _Fold(set);
+                return _AddChars(std::move(set));
+            }
+            }
+        }
+
+        // Parses a class like [a-z] or [^0-9], after the opening bracket.
+        CharSet _Class()
+        {
+            CharSet set(s_CharCount, false);
+
+            const bool negated = _Peek() == L'^';
+            if (negated)
+            {
+                ++_pos;
+            }
+
+            // a ']' straight after the '[' is just a char.
+            for (bool first = true;; first = false)
+            {
+                wchar_t ch = _Next();
+                if (ch == L']' && !first)
+                {
+                    break;
+                }
+
+                if (ch == L'\\')
+                {
+                    const auto literal = _Escape(set);
+                    if (!literal.has_value())
+                    {
+                        continue;
+                    }
+                    ch = literal.value();
+                }
+
+                if (_Peek() == L'-' && _pos + 1 < _pattern.size() && _pattern[_pos + 1] != L']')
+                {
+                    ++_pos;
+                    wchar_t last = _Next();
+                    if (last == L'\\')
+                    {
+                        CharSet unused(s_CharCount, false);
+                        const auto literal = _Escape(unused);
+                        THROW_HR_IF(E_INVALIDARG, !literal.has_value());
+                        last = literal.value();
+                    }
+
+                    THROW_HR_IF(E_INVALIDARG, last < ch);
+                    for (size_t member = ch; member <= last; ++member)
+                    {
+                        set[member] = true;
+                    }
+                }
+                else
+                {
+                    set[ch] = true;
+                }
+            }
+
+            _Fold(set);
+            if (negated)
+            {
+                set.flip();
+            }
+            return set;
+        }
+
+        // Parses an escape, after the backslash, and adds the chars it stands for to the set.
+        // Returns the char if the escape stands for just the one, so that it can start or end a range.
+        std::optional<wchar_t> _Escape(CharSet& set)
+        {
+            const wchar_t ch = _Next();
+            switch (ch)
+            {
+            case L'd':
+            case L'D':
+                _AddWhere(set, ch == L'D', [](const wchar_t member) noexcept { return member >= L'0' && member <= L'9'; });
+                return std::nullopt;
+            case L'w':
+            case L'W':
+                _AddWhere(set, ch == L'W', [](const wchar_t member) noexcept {
+                    return (member >= L'a' && member <= L'z') ||
+                           (member >= L'A' && member <= L'Z') ||
+                           (member >= L'0' && member <= L'9') ||
+                           member == L'_';
+                });
+                return std::nullopt;
+            case L's':
+            case L'S':
+                _AddWhere(set, ch == L'S', [](const wchar_t member) noexcept { return iswspace(member) != 0; });
+                return std::nullopt;
+            case L't':
+                set[L'\t'] = true;
+                return L'\t';
+            case L'n':
+                set[L'\n'] = true;
+                return L'\n';
+            case L'r':
+                set[L'\r'] = true;
+                return L'\r';
+            case L'u':
+            {
+                size_t value = 0;
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    const wchar_t digit = _Next();
+                    THROW_HR_IF(E_INVALIDARG, !iswxdigit(digit));
+                    value = value * 16 + (iswdigit(digit) ? digit - L'0' : towlower(digit) - L'a' + 10);
+                }
+                set[value] = true;
+                return static_cast<wchar_t>(value);
+            }
+            default:
+                // backreferences, word boundaries and any other escape of a
+                // letter or digit aren't supported. Anything else stands for itself.
+                THROW_HR_IF(E_INVALIDARG, iswalnum(ch));
+                set[ch] = true;
+                return ch;
+            }
+        }
+
+        template<typename Predicate>
+        static void _AddWhere(CharSet& set, const bool negated, Predicate predicate)
+        {
+            for (size_t ch = 0; ch < s_CharCount; ++ch)
+            {
+                if (predicate(static_cast<wchar_t>(ch)) != negated)
+                {
+                    set[ch] = true;
+                }
+            }
+        }
+
+        const std::wstring_view _pattern;
+        size_t _pos;
+        size_t _depth;
+        const bool _caseInsensitive;
+    };
+
+    // Returns the tree of the pattern that matches the same strings backwards.
+    // The anchors still mean the start and the end of the line, which a
+    // backwards scan passes at its end and at its start.
+    std::vector<Node> Reverse(std::vector<Node> nodes)
+    {
+        for (auto& node : nodes)
+        {
+            if (node.kind == Node::Kind::Sequence)
+            {
+                std::reverse(node.children.begin(), node.children.end());
+            }
+        }
+        return nodes;
+    }
+
+    bool IsNullable(const std::vector<Node>& nodes, const size_t id)
+    {
+        const Node& node = nodes.at(id);
+        switch (node.kind)
+        {
+        case Node::Kind::Chars:
+            return false;
+        case Node::Kind::Sequence:
+            return std::all_of(node.children.begin(), node.children.end(), [&](const size_t child) { return IsNullable(nodes, child); });
+        case Node::Kind::Alternation:
+            return std::any_of(node.children.begin(), node.children.end(), [&](const size_t child) { return IsNullable(nodes, child); });
+        case Node::Kind::Repeat:
+            return node.min == 0 || IsNullable(nodes, node.children.front());
+        default:
+            // the anchors don't consume anything.
+            return true;
+        }
+    }
+
+    struct NfaState
+    {
+        enum class Kind
+        {
+            Chars,
+            Split,
+            LineStart,
+            LineEnd,
+            Match
+        };
+
+        Kind kind;
+        size_t set = 0;
+        std::vector<size_t> next{};
+    };
+
+    // Compiles the tree into a Thompson NFA. Each node is compiled with the
+    // state that follows it already known, so the tree is walked back to front.
+    class NfaBuilder final
+    {
+    public:
+        NfaBuilder(const std::vector<Node>& nodes) noexcept :
+            _nodes{ nodes }
+        {
+        }
+
+        size_t Build(const size_t root)
+        {
+            const size_t match = _Add(NfaState{ NfaState::Kind::Match });
+            return _Compile(root, match);
+        }
+
+        std::vector<NfaState> states;
+
+    private:
+        size_t _Add(NfaState state)
+        {
+            THROW_HR_IF(E_INVALIDARG, states.size() >= s_MaxNfaStates);
+            states.push_back(std::move(state));
+            return states.size() - 1;
+        }
+
+        size_t _Compile(const size_t id, const size_t next)
+        {
+            const Node& node = _nodes.at(id);
+            switch (node.kind)
+            {
+            case Node::Kind::Chars:
+                return _Add(NfaState{ NfaState::Kind::Chars, node.set, { next } });
+            case Node::Kind::LineStart:
+                return _Add(NfaState{ NfaState::Kind::LineStart, 0, { next } });
+            case Node::Kind::LineEnd:
+                return _Add(NfaState{ NfaState::Kind::LineEnd, 0, { next } });
+            case Node::Kind::Sequence:
+            {
+                size_t entry = next;
+                for (auto child = node.children.rbegin(); child != node.children.rend(); ++child)
+                {
+                    entry = _Compile(*child, entry);
+                }
+                return entry;
+            }
+            case Node::Kind::Alternation:
+            {
+                NfaState split{ NfaState::Kind::Split };
+                for (const size_t child : node.children)
+                {
+                    split.next.push_back(_Compile(child, next));
+                }
+                return _Add(std::move(split));
+            }
+            default:
+                return _CompileRepeat(node, next);
+            }
+        }
+
+        size_t _CompileRepeat(const Node& node, const size_t next)
+        {
+            const size_t child = node.children.front();
+
+            size_t entry = next;
+            if (node.max == s_Unbounded)
+            {
+                const size_t loop = _Add(NfaState{ NfaState::Kind::Split });
+                const size_t body = _Compile(child, loop);
+                states.at(loop).next = { body, next };
+                entry = loop;
+            }
+            else
+            {
+                // each optional copy can skip straight past all of the rest.
+                for (size_t i = node.min; i < node.max; ++i)
+                {
+                    const size_t body = _Compile(child, entry);
+                    entry = _Add(NfaState{ NfaState::Kind::Split, 0, { body, next } });
+                }
+            }
+
+            for (size_t i = 0; i < node.min; ++i)
+            {
+                entry = _Compile(child, entry);
+            }
+            return entry;
+        }
+
+        const std::vector<Node>& _nodes;
+    };
+
+    // Splits the chars into classes, so that two chars are in the same class
+    // if every set has both or neither of them.
+    // Returns the number of classes, and the lowest char in each one.
+    std::vector<size_t> PartitionChars(const std::vector<CharSet>& sets, std::vector<uint16_t>& classOf)
+    {
+        size_t classCount = 1;
+        std::fill(classOf.begin(), classOf.end(), static_cast<uint16_t>(0));
+
+        for (const auto& set : sets)
+        {
+            // every class splits into the chars in the set and the ones that aren't.
+            std::vector<size_t> split(classCount * 2, SIZE_MAX);
+            size_t splitCount = 0;
+            for (size_t ch = 0; ch < s_CharCount; ++ch)
+            {
+                size_t& newClass = split.at(classOf[ch] * 2 + (set[ch] ? 1 : 0));
+                if (newClass == SIZE_MAX)
+                {
+                    newClass = splitCount++;
+                }
+                classOf[ch] = gsl::narrow<uint16_t>(newClass);
+            }
+            classCount = splitCount;
+        }
+
+        std::vector<size_t> representatives(classCount, SIZE_MAX);
+        for (size_t ch = s_CharCount; ch-- > 0;)
+        {
+            representatives.at(classOf[ch]) = ch;
+        }
+        return representatives;
+    }
+
+    // Compiles the NFA into a DFA with the subset construction. The DFA's
+    // alphabet is the classes of chars, then the line start and line end
+    // pseudo-classes, which are fed to it around a line.
+    class DfaBuilder final
+    {
+    public:
+        DfaBuilder(const std::vector<NfaState>& nfa,
+                   const size_t start,
+                   const std::vector<CharSet>& sets,
+                   const std::vector<size_t>& representatives) :
+            _nfa{ nfa },
+            _start{ start },
+            _classCount{ representatives.size() },
+            _setHasClass{},
+            _marks(nfa.size(), 0),
+            _generation{ 0 }
+        {
+            for (const auto& set : sets)
+            {
+                CharSet hasClass(_classCount, false);
+                for (size_t charClass = 0; charClass < _classCount; ++charClass)
+                {
+                    hasClass[charClass] = set[representatives[charClass]];
+                }
+                _setHasClass.push_back(std::move(hasClass));
+            }
+        }
+
+        // Builds the DFA. If it's unanchored, a match can start at any char,
+        // so every state also holds everything the start state does.
+        void Build(const bool unanchored, std::vector<uint32_t>& transitions, std::vector<bool>& accepting)
+        {
+            const size_t alphabetSize = _classCount + 2;
+            const size_t lineStartClass = _classCount;
+
+            const auto startStates = _Closure({ _start });
+
+            std::map<std::vector<size_t>, uint32_t> ids;
+            std::vector<std::vector<size_t>> subsets;
+            const auto intern = [&](std::vector<size_t>&& subset) {
+                const auto found = ids.find(subset);
+                if (found != ids.end())
+                {
+                    return found->second;
+                }
+
+                THROW_HR_IF(E_INVALIDARG, subsets.size() >= s_MaxDfaStates);
+                THROW_HR_IF(E_INVALIDARG, (subsets.size() + 1) * alphabetSize > s_MaxTableEntries);
+                const auto id = gsl::narrow<uint32_t>(subsets.size());
+                ids.emplace(subset, id);
+                subsets.push_back(std::move(subset));
+                return id;
+            };
+
+            // the dead state, then the start state.
+            intern({});
+            intern(std::vector<size_t>{ startStates });
+
+            transitions.assign(alphabetSize, 0);
+            for (size_t id = 1; id < subsets.size(); ++id)
+            {
+                // copied, since interning new states can move the subsets around.
+                const std::vector<size_t> current = subsets.at(id);
+
+                std::vector<uint32_t> row(alphabetSize, 0);
+                for (size_t charClass = 0; charClass < alphabetSize; ++charClass)
+                {
+                    std::vector<size_t> next;
+                    if (charClass < _classCount)
+                    {
+                        next = _Consume(current, charClass);
+                    }
+                    else
+                    {
+                        next = _Assert(current, charClass == lineStartClass ? NfaState::Kind::LineStart : NfaState::Kind::LineEnd);
+                    }
+
+                    if (unanchored)
+                    {
+                        next.insert(next.end(), startStates.begin(), startStates.end());
+                        next = _Closure(next);
+                    }
+
+                    row.at(charClass) = intern(std::move(next));
+                }
+                transitions.insert(transitions.end(), row.begin(), row.end());
+            }
+
+            accepting.assign(subsets.size(), false);
+            for (size_t id = 0; id < subsets.size(); ++id)
+            {
+                accepting.at(id) = std::any_of(subsets[id].begin(), subsets[id].end(), [&](const size_t state) {
+                    return _nfa.at(state).kind == NfaState::Kind::Match;
+                });
+            }
+        }
+
+    private:
+        // Returns the states reached by consuming a char of the given class.
+        std::vector<size_t> _Consume(const std::vector<size_t>& current, const size_t charClass)
+        {
+            std::vector<size_t> moved;
+            for (const size_t state : current)
+            {
+                const NfaState& nfaState = _nfa.at(state);
+                if (nfaState.kind == NfaState::Kind::Chars && _setHasClass.at(nfaState.set)[charClass])
+                {
+                    moved.push_back(nfaState.next.front());
+                }
+            }
+            return _Closure(moved);
+        }
+
+        // Returns the states reached by passing the start or end of the line.
+        // That doesn't consume anything, so all of the current states stay
+        // where they are, and one anchor can lead straight to another.
+        std::vector<size_t> _Assert(const std::vector<size_t>& current, const NfaState::Kind anchor)
+        {
+            std::vector<size_t> reached{ current };
+            for (;;)
+            {
+                std::vector<size_t> moved{ reached };
+                for (const size_t state : reached)
+                {
+                    const NfaState& nfaState = _nfa.at(state);
+                    if (nfaState.kind == anchor)
+                    {
+                        moved.push_back(nfaState.next.front());
+                    }
+                }
+
+                moved = _Closure(moved);
+                if (moved == reached)
+                {
+                    return reached;
+                }
+                reached = std::move(moved);
+            }
+        }
+
+        // Follows the splits from the given states, and returns the states they
+        // lead to that consume something or match, sorted so that equal subsets compare equal.
+        std::vector<size_t> _Closure(const std::vector<size_t>& from)
+        {
+            ++_generation;
+
+            std::vector<size_t> result;
+            std::vector<size_t> pending{ from };
+            while (!pending.empty())
+            {
+                const size_t state = pending.back();
+                pending.pop_back();
+
+                if (_marks.at(state) == _generation)
+                {
+                    continue;
+                }
+                _marks.at(state) = _generation;
+
+                const NfaState& nfaState = _nfa.at(state);
+                if (nfaState.kind == NfaState::Kind::Split)
+                {
+                    pending.insert(pending.end(), nfaState.next.begin(), nfaState.next.end());
+                }
+                else
+                {
+                    result.push_back(state);
+                }
+            }
+
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+        const std::vector<NfaState>& _nfa;
+        const size_t _start;
+        const size_t _classCount;
+        std::vector<CharSet> _setHasClass;
+
+        // The generation each NFA state was last visited in, so that
+        // _Closure doesn't have to clear a visited set every time.
+        std::vector<size_t> _marks;
+        size_t _generation;
+    };
+}
+
+// Routine Description:
+// - Compiles a pattern.
+// Arguments:
+// - pattern - The regular expression to match
+// - caseInsensitive - True if upper and lower case chars should match each other
+// Note:
+// - Throws E_INVALIDARG if the pattern is invalid, uses syntax that isn't
+//   supported, can match an empty string, or is too large to compile.
+RegexMatcher::RegexMatcher(const std::wstring_view pattern, const bool caseInsensitive) :
+    _classOf(s_CharCount, static_cast<uint16_t>(0)),
+    _alphabetSize{ 0 },
+    _lineStartClass{ 0 },
+    _lineEndClass{ 0 },
+    _anchored{},
+    _reversed{}
+{
+    THROW_HR_IF(E_INVALIDARG, pattern.empty());
+
+    Parser parser{ pattern, caseInsensitive };
+    const size_t root = parser.Parse();
+    THROW_HR_IF(E_INVALIDARG, IsNullable(parser.nodes, root));
+
+    NfaBuilder nfa{ parser.nodes };
+    const size_t start = nfa.Build(root);
+
+    const auto reversedNodes = Reverse(parser.nodes);
+    NfaBuilder reversedNfa{ reversedNodes };
+    const size_t reversedStart = reversedNfa.Build(root);
+
+    const auto representatives = PartitionChars(parser.sets, _classOf);
+    _lineStartClass = representatives.size();
+    _lineEndClass = representatives.size() + 1;
+    _alphabetSize = representatives.size() + 2;
+
+    DfaBuilder dfa{ nfa.states, start, parser.sets, representatives };
+    dfa.Build(false, _anchored.transitions, _anchored.accepting);
+
+    DfaBuilder reversedDfa{ reversedNfa.states, reversedStart, parser.sets, representatives };
+    reversedDfa.Build(true, _reversed.transitions, _reversed.accepting);
+}
+
+// Routine Description:
+// - Finds the first match in a line of text at or after the given position.
+// Arguments:
+// - text - The whole line. ^ only matches at its start, and $ at its end.
+// - start - The position to start looking at
+// Return Value:
+// - The offsets of the first char of the match, and the one just past its
+//   end. Of the matches that start there, it's the longest one.
+// - nullopt if nothing matches.
+// Note:
+// - This has to scan back from the end of the line every time. To find every
+//   match in a line, use FindAll, which only does that once.
+std::optional<std::pair<size_t, size_t>> RegexMatcher::Find(const std::wstring_view text, const size_t start) const
+{
+    if (start >= text.size())
+    {
+        return std::nullopt;
+    }
+
+    std::vector<bool> starts;
+    _FindMatchStarts(text, start, starts);
+
+    const auto first = std::find(starts.begin(), starts.end(), true);
+    if (first == starts.end())
+    {
+        return std::nullopt;
+    }
+
+    const size_t matchStart = start + gsl::narrow_cast<size_t>(first - starts.begin());
+    return std::make_pair(matchStart, matchStart + _LongestMatchAt(text, matchStart));
+}
+
+// Routine Description:
+// - Finds every match in a line of text that doesn't overlap an earlier one,
+//   the same ones calling Find from the end of each match would.
+// Arguments:
+// - text - The whole line. ^ only matches at its start, and $ at its end.
+// Return Value:
+// - The offsets of the first char of each match, and the one just past its end.
+std::vector<std::pair<size_t, size_t>> RegexMatcher::FindAll(const std::wstring_view text) const
+{
+    std::vector<std::pair<size_t, size_t>> matches;
+    if (text.empty())
+    {
+        return matches;
+    }
+
+    // Whether a match starts somewhere only depends on the text from there
+    // on, so the starts found in one pass hold for every match.
+    std::vector<bool> starts;
+    _FindMatchStarts(text, 0, starts);
+
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        if (starts[pos])
+        {
+            const size_t end = pos + _LongestMatchAt(text, pos);
+            matches.emplace_back(pos, end);
+            pos = end;
+        }
+        else
+        {
+            ++pos;
+        }
+    }
+    return matches;
+}
+
+// Routine Description:
+// - Returns the number of states in the compiled DFAs, which is what a
+//   matcher's memory use depends on.
+size_t RegexMatcher::StateCount() const noexcept
+{
+    return _anchored.accepting.size() + _reversed.accepting.size();
+}
+
+uint32_t RegexMatcher::_Step(const _Dfa& dfa, const uint32_t state, const size_t charClass) const noexcept
+{
+    return dfa.transitions[state * _alphabetSize + charClass];
+}
+
+// Routine Description:
+// - Runs the reversed DFA back from the end of the line, to find every
+//   position from the given one on that a match starts at.
+// Arguments:
+// - text - The whole line
+// - start - The first position to look at
+// - starts - On return, whether a match starts at each position from start on
+// Return Value:
+// - <none>
+void RegexMatcher::_FindMatchStarts(const std::wstring_view text, const size_t start, std::vector<bool>& starts) const
+{
+    starts.assign(text.size() - start, false);
+
+    uint32_t state = _Step(_reversed, s_StartState, _lineEndClass);
+    for (size_t pos = text.size(); pos-- > start;)
+    {
+        state = _Step(_reversed, state, _classOf[text[pos]]);
+        if (pos == 0)
+        {
+            state = _Step(_reversed, state, _lineStartClass);
+        }
+        starts[pos - start] = _reversed.accepting[state];
+    }
+}
+
+// Routine Description:
+// - Measures the longest match that starts at the given position.
+// Arguments:
+// - text - The whole line
+// - start - Where the match has to start
+// Return Value:
+// - The length of the match, or 0 if no match starts there.
+size_t RegexMatcher::_LongestMatchAt(const std::wstring_view text, const size_t start) const noexcept
+{
+    uint32_t state = s_StartState;
+    if (start == 0)
+    {
+        state = _Step(_anchored, state, _lineStartClass);
+    }
+
+    size_t longest = 0;
+    for (size_t pos = start; pos < text.size(); ++pos)
+    {
+        state = _Step(_anchored, state, _classOf[text[pos]]);
+        if (state == s_DeadState)
+        {
+            return longest;
+        }
+        if (_anchored.accepting[state])
+        {
+            longest = pos + 1 - start;
+        }
+    }
+
+    if (_anchored.accepting[_Step(_anchored, state, _lineEndClass)])
+    {
+        longest = text.size() - start;
+    }
+    return longest;
+}
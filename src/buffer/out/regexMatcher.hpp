@@ -0,0 +1,78 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- regexMatcher.hpp
+
+Abstract:
+- Matches a regular expression against lines of text, for searching the
+  text buffer.
+- The pattern is compiled into DFAs up front, so scanning a line costs one
+  table lookup per char whatever the pattern is, and never backtracks. Since
+  nothing is built lazily, a matcher is never modified after it's constructed,
+  and any number of threads can search with the same one at once.
+- Like RE2 does for longest matches, a DFA of the reversed pattern is run
+  back from the end of the line first, which marks every position a match
+  starts at in one pass. The DFA of the pattern then only has to run forward
+  from the start of each match it finds, until it can't go any further.
+  That's linear in the length of the line, except that when matches are
+  close together, the forward runs can look past where each match ends, up
+  to where the pattern is sure not to match any longer.
+- Supported syntax: literals, '.', classes like [a-z] and [^0-9], the escapes
+  \d \D \w \W \s \S \t \n \r \uXXXX and escaped punctuation, groups with
+  ( ) and (?: ), alternation with |, the quantifiers * + ? {n} {n,} {n,m},
+  and the anchors ^ and $, which match at the start and end of a line.
+- Matches are leftmost-longest, like POSIX, rather than leftmost-first like
+  a backtracking engine. A pattern that can match nothing is rejected, since
+  every position of every line would match it.
+- Chars are matched one UTF-16 code unit at a time, so '.' matches half of a
+  surrogate pair.
+--*/
+
+#pragma once
+
+class RegexMatcher final
+{
+public:
+    RegexMatcher(const std::wstring_view pattern, const bool caseInsensitive);
+
+    std::optional<std::pair<size_t, size_t>> Find(const std::wstring_view text, const size_t start) const;
+    std::vector<std::pair<size_t, size_t>> FindAll(const std::wstring_view text) const;
+
+    size_t StateCount() const noexcept;
+
+private:
+    struct _Dfa
+    {
+        // The next state for each state and class of char, a row of
+        // _alphabetSize entries per state.
+        std::vector<uint32_t> transitions;
+        std::vector<bool> accepting;
+    };
+
+    // The state every DFA starts in. State 0 is the dead state, which
+    // nothing leaves, and which never accepts.
+    static constexpr uint32_t s_DeadState = 0;
+    static constexpr uint32_t s_StartState = 1;
+
+    uint32_t _Step(const _Dfa& dfa, const uint32_t state, const size_t charClass) const noexcept;
+    void _FindMatchStarts(const std::wstring_view text, const size_t start, std::vector<bool>& starts) const;
+    size_t _LongestMatchAt(const std::wstring_view text, const size_t start) const noexcept;
+
+    // Every UTF-16 code unit maps to a class of chars that the pattern can't
+    // tell apart, so that the DFAs only need one column per class.
+    std::vector<uint16_t> _classOf;
+    size_t _alphabetSize;
+
+    // Pseudo-classes fed to the DFAs at the start and the end of a line, for ^ and $.
+    size_t _lineStartClass;
+    size_t _lineEndClass;
+
+    // Matches the pattern starting at the position it's started at.
+    _Dfa _anchored;
+
+    // Matches the reversed pattern ending at any position from where it's
+    // started, so that run backwards, it accepts wherever a match starts.
+    _Dfa _reversed;
+};
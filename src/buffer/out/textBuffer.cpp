@@ -7,6 +7,7 @@
 #include "CharRow.hpp"
 
 #include "../types/inc/convert.hpp"
+#include "../types/inc/GlyphWidth.hpp"
 
 #pragma hdrstop
 
@@ -31,7 +32,8 @@ TextBuffer::TextBuffer(const COORD screenBufferSize,
     _cursor{ cursorSize, *this },
     _storage{},
     _unicodeStorage{},
-    _renderTarget{ renderTarget }
+    _renderTarget{ renderTarget },
+    _searchSession{}
 {
     // initialize ROWs
     for (size_t i = 0; i < static_cast<size_t>(screenBufferSize.Y); ++i)
@@ -86,8 +88,15 @@ const ROW& TextBuffer::GetRowByOffset(const size_t index) const
 // - Number of rows down from the first row of the buffer.
 // Return Value:
 // - reference to the requested row. Asserts if out of bounds.
+// Note:
+// - Anyone who changes a row gets it from here, so if there's a search session,
+//   the row is marked to be searched again.
 ROW& TextBuffer::GetRowByOffset(const size_t index)
 {
+    if (_searchSession)
+    {
+        _searchSession->InvalidateRow((_firstRow + index) % TotalRowCount());
+    }
     return const_cast<ROW&>(static_cast<const TextBuffer*>(this)->GetRowByOffset(index));
 }
 
@@ -372,6 +381,101 @@ OutputCellIterator TextBuffer::WriteLine(const OutputCellIterator givenIt,
     return newIt;
 }
 
+// Routine Description:
+// - Fills a rectangle of the buffer with one character and one attribute.
+// - Unlike writing an OutputCellIterator over the same area, this fills each
+//   row in bulk and notifies the renderer once for the whole rectangle.
+// - This is what ED, EL and ECH erase with, so that clearing the screen
+//   doesn't cost a pair of fills and a redraw for every row.
+// Arguments:
+// - rect - The area to fill. It must be within the buffer.
+// - wch - The character to fill with. It must not be full width.
+// - attr - The attribute to fill with.
+// Return Value:
+// - <none>
+// Note:
+// - will throw exception on error.
+void TextBuffer::FillRect(const Viewport& rect,
+                          const wchar_t wch,
+                          const TextAttribute attr)
+{
+    THROW_HR_IF(E_INVALIDARG, !GetSize().IsInBounds(rect));
+    THROW_HR_IF(E_INVALIDARG, IsGlyphFullWidth(wch));
+
+    for (auto y = rect.Top(); y < rect.BottomExclusive(); y++)
+    {
+        GetRowByOffset(y).FillCells(rect.Left(), rect.RightExclusive(), wch, attr);
+    }
+
+    _NotifyPaint(rect);
+}
+
+// Routine Description:
+// - Reads a rectangle of the buffer into CHAR_INFOs, the way the public API
+//   hands cells out.
+// - Each row is converted straight out of its storage, without making a cell
+//   object for every cell along the way.
+// Arguments:
+// - rect - The area to read. It must be within the buffer.
+// - target - Where to put the cells. Each row of the rectangle goes
+//   targetWidth cells after the one before it.
+// - targetWidth - The distance between the rows in the target
+// - toLegacy - Converts an attribute to the legacy attribute reported for it
+// Return Value:
+// - <none>
+// Note:
+// - will throw exception on error.
+void TextBuffer::ReadCharInfos(const Viewport& rect,
+                               gsl::span<CHAR_INFO> target,
+                               const size_t targetWidth,
+                               const std::function<WORD(const TextAttribute&)>& toLegacy) const
+{
+    THROW_HR_IF(E_INVALIDARG, !GetSize().IsInBounds(rect));
+
+    const auto width = gsl::narrow<size_t>(rect.Width());
+    for (auto y = rect.Top(); y < rect.BottomExclusive(); y++)
+    {
+        const auto offset = static_cast<size_t>(y - rect.Top()) * targetWidth;
+        GetRowByOffset(y).ReadCharInfos(rect.Left(), s_RectRow(target, offset, width), toLegacy);
+    }
+}
+
+// Routine Description:
+// - Writes CHAR_INFOs from the public API into a rectangle of the buffer.
+// - Unlike writing an OutputCellIterator over each row, the cells of each row
+//   are converted straight into its storage, and the renderer is notified once
+//   for the whole rectangle.
+// Arguments:
+// - rect - The area to write. It must be within the buffer.
+// - source - The cells to write. Each row of the rectangle comes
+//   sourceWidth cells after the one before it.
+// - sourceWidth - The distance between the rows in the source
+// Return Value:
+// - <none>
+// Note:
+// - will throw exception on error.
+void TextBuffer::WriteCharInfos(const Viewport& rect,
+                                const gsl::span<const CHAR_INFO> source,
+                                const size_t sourceWidth)
+{
+    THROW_HR_IF(E_INVALIDARG, !GetSize().IsInBounds(rect));
+
+    const auto width = gsl::narrow<size_t>(rect.Width());
+    for (auto y = rect.Top(); y < rect.BottomExclusive(); y++)
+    {
+        const auto offset = static_cast<size_t>(y - rect.Top()) * sourceWidth;
+        const auto cells = s_RectRow(source, offset, width);
+        if (!GetRowByOffset(y).WriteCharInfos(rect.Left(), cells, true))
+        {
+            // A half of a full width glyph that doesn't fit in the row gets
+            // padded out the same way as any other write.
+            Write(OutputCellIterator{ std::basic_string_view<CHAR_INFO>(cells.data(), cells.size()) }, { rect.Left(), y });
+        }
+    }
+
+    _NotifyPaint(rect);
+}
+
 //Routine Description:
 // - Inserts one codepoint into the buffer at the current cursor position and advances the cursor as appropriate.
 //Arguments:
@@ -541,6 +645,10 @@ bool TextBuffer::IncrementCircularBuffer()
 
     // First, clean out the old "first row" as it will become the "last row" of the buffer after the circle is performed.
     bool fSuccess = _storage.at(_firstRow).Reset(_currentAttributes);
+    if (_searchSession)
+    {
+        _searchSession->InvalidateRow(_firstRow);
+    }
     if (fSuccess)
     {
         // Now proceed to increment.
@@ -637,6 +745,17 @@ void TextBuffer::_SetFirstRowIndex(const SHORT FirstRowIndex)
     _firstRow = FirstRowIndex;
 }
 
+// Routine Description:
+// - Moves size rows, starting at firstRow, by delta rows (negative is up). The
+//      rows that are moved over take the place the moved rows left behind.
+// - Only the rows between the source and the destination are touched, so the
+//      cost depends on the size of the region, not on the size of the buffer.
+// Arguments:
+// - firstRow - The first row to move, as an offset from the top of the buffer.
+// - size - The number of rows to move.
+// - delta - The distance to move them.
+// Return Value:
+// - <none>
 void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT delta)
 {
     // If we don't have to move anything, leave early.
@@ -645,18 +764,32 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
         return;
     }
 
+    // All the rows that change places, as offsets from the top of the buffer.
+    const size_t rangeTop = static_cast<size_t>(std::min(firstRow + delta, static_cast<int>(firstRow)));
+    const size_t rangeHeight = static_cast<size_t>(size + std::abs(delta));
+
     // OK. We're about to play games by moving rows around within the deque to
     // scroll a massive region in a faster way than copying things.
-    // To make this easier, first correct the circular buffer to have the first row be 0 again.
-    if (_firstRow != 0)
+    // The rows are stored circularly, so the range is usually in one piece in
+    // the deque. Only if it wraps around the end do we have to correct the
+    // circular buffer to have the first row be 0 again, which moves every row.
+    const size_t totalRows = TotalRowCount();
+    size_t storageTop = (_firstRow + rangeTop) % totalRows;
+    const bool fRotateAll = storageTop + rangeHeight > totalRows;
+    if (fRotateAll)
     {
         // Rotate the buffer to put the first row at the front.
         std::rotate(_storage.begin(), _storage.begin() + _firstRow, _storage.end());
 
         // The first row is now at the top.
         _firstRow = 0;
+        storageTop = rangeTop;
     }
 
+    // From here on, A, B and C below are relative to where the range starts in
+    // the deque, rather than to the start of the deque.
+    const auto rangeBegin = _storage.begin() + storageTop;
+
     // Rotate just the subsection specified
     if (delta < 0)
     {
@@ -693,7 +826,7 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
         // | 10
         // | 11
         // - end
-        std::rotate(_storage.begin() + firstRow + delta, _storage.begin() + firstRow, _storage.begin() + firstRow + size);
+        std::rotate(rangeBegin, rangeBegin - delta, rangeBegin - delta + size);
     }
     else
     {
@@ -730,12 +863,35 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
         // | 10
         // | 11
         // - end
-        std::rotate(_storage.begin() + firstRow, _storage.begin() + firstRow + size, _storage.begin() + firstRow + size + delta);
+        std::rotate(rangeBegin, rangeBegin + size, rangeBegin + size + delta);
     }
 
     // Renumber the IDs now that we've rearranged where the rows sit within the buffer.
     // Refreshing should also delegate to the UnicodeStorage to re-key all the stored unicode sequences (where applicable).
-    _RefreshRowIDs(std::nullopt);
+    if (fRotateAll)
+    {
+        _RefreshRowIDs(std::nullopt);
+    }
+    else
+    {
+        _RefreshRowIDs(storageTop, rangeHeight);
+    }
+
+    // The rows that moved have to be searched again where they are now.
+    if (_searchSession)
+    {
+        if (fRotateAll)
+        {
+            _searchSession->InvalidateAll(totalRows);
+        }
+        else
+        {
+            for (size_t i = storageTop; i < storageTop + rangeHeight; ++i)
+            {
+                _searchSession->InvalidateRow(i);
+            }
+        }
+    }
 }
 
 Cursor& TextBuffer::GetCursor()
@@ -771,6 +927,11 @@ void TextBuffer::Reset()
         row.GetCharRow().Reset();
         row.GetAttrRow().Reset(attr);
     }
+
+    if (_searchSession)
+    {
+        _searchSession->InvalidateAll(TotalRowCount());
+    }
 }
 
 // Routine Description:
@@ -823,6 +984,10 @@ NTSTATUS TextBuffer::ResizeTraditional(const COORD newSize) noexcept
         // and cleanup the UnicodeStorage characters that might fall outside the resized buffer.
         _RefreshRowIDs(newSize.X);
 
+        if (_searchSession)
+        {
+            _searchSession->InvalidateAll(TotalRowCount());
+        }
     }
     CATCH_RETURN();
 
@@ -875,6 +1040,35 @@ void TextBuffer::_RefreshRowIDs(std::optional<SHORT> newRowWidth)
     _unicodeStorage.Remap(rowMap, newRowWidth);
 }
 
+// Routine Description:
+// - Refreshes the Row IDs of just the given rows, after they were shuffled
+//   amongst themselves. Rows outside of the range keep their IDs, and so do
+//   the UnicodeStorage items in them.
+// Arguments:
+// - first - The index in the storage of the first row to refresh.
+// - count - The number of rows to refresh.
+void TextBuffer::_RefreshRowIDs(const size_t first, const size_t count)
+{
+    std::map<SHORT, SHORT> rowMap;
+    for (size_t i = first; i < first + count; i++)
+    {
+        auto& row = _storage[i];
+        const SHORT id = gsl::narrow<SHORT>(i);
+
+        // Build a map so we can update Unicode Storage
+        rowMap.emplace(row.GetId(), id);
+
+        // Update the IDs
+        row.SetId(id);
+
+        // Also update the char row parent pointers as they can get shuffled up in the rotates.
+        row.GetCharRow().UpdateParent(&row);
+    }
+
+    // Give the new mapping to Unicode Storage
+    _unicodeStorage.RemapRows(rowMap);
+}
+
 void TextBuffer::_NotifyPaint(const Viewport& viewport) const
 {
     _renderTarget.TriggerRedraw(viewport);
@@ -923,6 +1117,80 @@ Microsoft::Console::Render::IRenderTarget& TextBuffer::GetRenderTarget()
     return _renderTarget;
 }
 
+// Routine Description:
+// - Starts keeping every match of a string in the buffer up to date, so that
+//   they can all be highlighted. Replaces any search session already running.
+// Arguments:
+// - needle - The string to search for
+// - caseInsensitive - True if upper and lower case chars should match each other
+// Return Value:
+// - <none>
+void TextBuffer::StartSearchSession(const std::wstring_view needle, const bool caseInsensitive)
+{
+    _searchSession = std::make_unique<TextBufferSearchSession>(needle, caseInsensitive, TotalRowCount());
+    _renderTarget.TriggerRedrawAll();
+}
+
+// Routine Description:
+// - Stops the search session, if there is one, and removes its highlights.
+void TextBuffer::StopSearchSession()
+{
+    if (_searchSession)
+    {
+        _searchSession.reset();
+        _renderTarget.TriggerRedrawAll();
+    }
+}
+
+// Routine Description:
+// - Takes over the search session of another buffer, as when this one
+//   replaces it on a resize. Every row is searched again the next time the
+//   matches are asked for, since none of them are where they were.
+// Arguments:
+// - other - The buffer to take the search session from. It's left without one.
+// Return Value:
+// - <none>
+// Note:
+// - will throw on allocation failure, in which case neither buffer has the session.
+void TextBuffer::TakeSearchSession(TextBuffer& other)
+{
+    _searchSession = std::move(other._searchSession);
+    if (_searchSession)
+    {
+        auto stop = wil::scope_exit([&]() noexcept { _searchSession.reset(); });
+        _searchSession->InvalidateAll(TotalRowCount());
+        stop.release();
+        _renderTarget.TriggerRedrawAll();
+    }
+}
+
+bool TextBuffer::HasSearchSession() const noexcept
+{
+    return _searchSession != nullptr;
+}
+
+// Routine Description:
+// - Returns the number of matches of the search session in the whole buffer.
+// Return Value:
+// - The number of matches. 0 if there's no search session.
+size_t TextBuffer::GetSearchMatchCount() const
+{
+    return _searchSession ? _searchSession->GetMatchCount(*this) : 0;
+}
+
+// Routine Description:
+// - Returns the cells to highlight for the matches of the search session.
+// - Only the rows that changed since the last call are searched again.
+// Arguments:
+// - area - The part of the buffer to highlight, usually the viewport
+// Return Value:
+// - One rectangle (inclusive, in buffer coordinates) for each row that a match
+//   covers, trimmed to the area. Empty if there's no search session.
+std::vector<SMALL_RECT> TextBuffer::GetSearchHighlights(const Viewport& area) const
+{
+    return _searchSession ? _searchSession->GetHighlights(*this, area) : std::vector<SMALL_RECT>{};
+}
+
 // Routine Description:
 // - Retrieves the text data from the selected region and presents it in a clipboard-ready format (given little post-processing).
 // Arguments:
@@ -57,6 +57,7 @@ filling in the last row, and updating the screen.
 
 #include "../buffer/out/textBufferCellIterator.hpp"
 #include "../buffer/out/textBufferTextIterator.hpp"
+#include "../buffer/out/textBufferSearchSession.hpp"
 
 #include "../renderer/inc/IRenderTarget.hpp"
 
@@ -96,6 +97,18 @@ public:
                                  const bool setWrap = false,
                                  const std::optional<size_t> limitRight = std::nullopt);
 
+    void FillRect(const Microsoft::Console::Types::Viewport& rect,
+                  const wchar_t wch,
+                  const TextAttribute attr);
+
+    void ReadCharInfos(const Microsoft::Console::Types::Viewport& rect,
+                       gsl::span<CHAR_INFO> target,
+                       const size_t targetWidth,
+                       const std::function<WORD(const TextAttribute&)>& toLegacy) const;
+    void WriteCharInfos(const Microsoft::Console::Types::Viewport& rect,
+                        const gsl::span<const CHAR_INFO> source,
+                        const size_t sourceWidth);
+
     bool InsertCharacter(const wchar_t wch, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool InsertCharacter(const std::wstring_view chars, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool IncrementCursor();
@@ -132,6 +145,13 @@ public:
 
     Microsoft::Console::Render::IRenderTarget& GetRenderTarget();
 
+    void StartSearchSession(const std::wstring_view needle, const bool caseInsensitive);
+    void StopSearchSession();
+    void TakeSearchSession(TextBuffer& other);
+    bool HasSearchSession() const noexcept;
+    size_t GetSearchMatchCount() const;
+    std::vector<SMALL_RECT> GetSearchHighlights(const Microsoft::Console::Types::Viewport& area) const;
+
     class TextAndColor
     {
     public:
@@ -159,9 +179,13 @@ private:
     UnicodeStorage _unicodeStorage;
 
     void _RefreshRowIDs(std::optional<SHORT> newRowWidth);
+    void _RefreshRowIDs(const size_t first, const size_t count);
 
     Microsoft::Console::Render::IRenderTarget& _renderTarget;
 
+    // Keeps the matches of a search up to date as rows change, if one was started.
+    std::unique_ptr<TextBufferSearchSession> _searchSession;
+
     void _SetFirstRowIndex(const SHORT FirstRowIndex);
 
     COORD _GetPreviousFromCursor() const;
@@ -171,6 +195,16 @@ private:
 
     void _NotifyPaint(const Microsoft::Console::Types::Viewport& viewport) const;
 
+    // Returns one row of a rectangle of cells kept in a span, after making
+    // sure all of its cells are in the span.
+    template<typename T>
+    static gsl::span<T> s_RectRow(const gsl::span<T> cells, const size_t offset, const size_t width)
+    {
+        const size_t size = gsl::narrow<size_t>(cells.size());
+        THROW_HR_IF(E_INVALIDARG, offset > size || width > size - offset);
+        return cells.subspan(gsl::narrow<ptrdiff_t>(offset), gsl::narrow<ptrdiff_t>(width));
+    }
+
     // Assist with maintaining proper buffer state for Double Byte character sequences
     bool _PrepareForDoubleByteSequence(const DbcsAttribute dbcsAttribute);
     bool _AssertValidDoubleByteSequence(const DbcsAttribute dbcsAttribute);
@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "textBufferRegexSearch.hpp"
+#include "textBuffer.hpp"
+
+#include <future>
+#include <thread>
+
+// Routine Description:
+// - Compiles a pattern to search for.
+// Arguments:
+// - pattern - The regular expression to search for
+// - caseInsensitive - True if upper and lower case chars should match each other
+// Note:
+// - Throws E_INVALIDARG if the pattern can't be compiled. See RegexMatcher.
+TextBufferRegexSearch::TextBufferRegexSearch(const std::wstring_view pattern, const bool caseInsensitive) :
+    _matcher{ pattern, caseInsensitive }
+{
+}
+
+// Routine Description:
+// - Finds every match in the buffer.
+// Arguments:
+// - buffer - The text buffer to search. It mustn't change until this returns.
+// - threadCount - The most threads to search on, or 0 for one per processor
+// Return Value:
+// - The matches, in the order they appear in the buffer.
+std::vector<TextBufferRegexSearch::Match> TextBufferRegexSearch::FindAll(const TextBuffer& buffer, const size_t threadCount) const
+{
+    const size_t rowCount = buffer.TotalRowCount();
+
+    size_t chunkCount = threadCount != 0 ? threadCount : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    chunkCount = std::max<size_t>(std::min(chunkCount, rowCount / s_MinRowsPerThread), 1);
+
+    const auto chunkStart = [&](const size_t chunk) noexcept {
+        return rowCount * chunk / chunkCount;
+    };
+
+    // Hand every chunk but the first to a worker, and search the first one right here.
+    std::vector<std::future<std::vector<Match>>> workers;
+    for (size_t chunk = 1; chunk < chunkCount; ++chunk)
+    {
+        const size_t first = chunkStart(chunk);
+        const size_t count = chunkStart(chunk + 1) - first;
+        workers.emplace_back(std::async(std::launch::async, [this, &buffer, first, count]() {
+            return FindAllInRows(buffer, first, count);
+        }));
+    }
+
+    std::vector<Match> matches = FindAllInRows(buffer, 0, chunkStart(1));
+    for (auto& worker : workers)
+    {
+        const auto chunkMatches = worker.get();
+        matches.insert(matches.end(), chunkMatches.begin(), chunkMatches.end());
+    }
+    return matches;
+}
+
+// Routine Description:
+// - Finds the matches in the lines that start in the given rows. A line that
+//   starts in them is searched in full, even where it wraps past the last of
+//   them, and a line that wrapped into them from before isn't searched at all,
+//   so that chunks of rows that are next to each other find each match once.
+// Arguments:
+// - buffer - The text buffer to search
+// - firstRow - The first row to search, counting from the top of the buffer
+// - rowCount - The number of rows to search
+// Return Value:
+// - The matches, in the order they appear in the buffer.
+std::vector<TextBufferRegexSearch::Match> TextBufferRegexSearch::FindAllInRows(const TextBuffer& buffer,
+                                                                                 const size_t firstRow,
+                                                                                 const size_t rowCount) const
+{
+    std::vector<Match> matches;
+
+    const size_t end = std::min<size_t>(firstRow + rowCount, buffer.TotalRowCount());
+    size_t row = firstRow;
+    while (row < end && !_StartsLine(buffer, row))
+    {
+        ++row;
+    }
+
+    _Line line;
+    while (row < end)
+    {
+        row = _ReadLine(buffer, row, line);
+
+        for (const auto& found : _matcher.FindAll(line.text))
+        {
+            matches.emplace_back(line.firstCells.at(found.first), line.lastCells.at(found.second - 1));
+        }
+    }
+    return matches;
+}
+
+// Routine Description:
+// - Returns true if the row starts a line, rather than going on with the
+//   text of a row before it that wrapped.
+bool TextBufferRegexSearch::_StartsLine(const TextBuffer& buffer, const size_t row)
+{
+    return row == 0 || !buffer.GetRowByOffset(row - 1).GetCharRow().WasWrapForced();
+}
+
+// Routine Description:
+// - Copies the text of the line that starts at the given row.
+// Arguments:
+// - buffer - The text buffer to read
+// - firstRow - The row the line starts in
+// - line - Receives the text of the line, and where each char of it is
+// Return Value:
+// - The row after the last one the line takes up.
+size_t TextBufferRegexSearch::_ReadLine(const TextBuffer& buffer, const size_t firstRow, _Line& line)
+{
+    line.text.clear();
+    line.firstCells.clear();
+    line.lastCells.clear();
+
+    // The length of the line up to the last char that isn't a space, since
+    // the rest is just what's left of the last row.
+    size_t length = 0;
+
+    const size_t rowCount = buffer.TotalRowCount();
+    size_t row = firstRow;
+    for (bool wrapped = true; wrapped && row < rowCount; ++row)
+    {
+        const auto& charRow = buffer.GetRowByOffset(row).GetCharRow();
+        const SHORT y = gsl::narrow<SHORT>(row);
+
+        for (size_t x = 0; x < charRow.size(); ++x)
+        {
+            const COORD cell{ gsl::narrow<SHORT>(x), y };
+
+            // The trailing half of a wide glyph is the same glyph as the
+            // leading half, so it just stretches the glyph's chars to cover it.
+            if (charRow.DbcsAttrAt(x).IsTrailing() && !line.text.empty())
+            {
+                for (size_t i = line.lastCells.size(); i-- > 0 && line.firstCells.at(i) == line.firstCells.back();)
+                {
+                    line.lastCells.at(i) = cell;
+                }
+                continue;
+            }
+
+            const std::wstring_view glyph = charRow.GlyphAt(x);
+            for (const wchar_t ch : glyph)
+            {
+                line.text.push_back(ch);
+                line.firstCells.push_back(cell);
+                line.lastCells.push_back(cell);
+            }
+
+            if (glyph != std::wstring_view{ L" " })
+            {
+                length = line.text.size();
+            }
+        }
+
+        wrapped = charRow.WasWrapForced();
+    }
+
+    line.text.resize(length);
+    line.firstCells.resize(length);
+    line.lastCells.resize(length);
+    return row;
+}
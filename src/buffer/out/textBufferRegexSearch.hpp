@@ -0,0 +1,57 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- textBufferRegexSearch.hpp
+
+Abstract:
+- Finds the matches of a regular expression in a text buffer.
+- Unlike TextBufferSearch, the buffer is searched a line at a time, the way
+  it was written rather than the way it's laid out: rows that were wrapped
+  because the text ran past the end of them are joined to the row after, and
+  the spaces that pad out the end of a line aren't part of it. So ^ and $
+  match at the ends of what the program wrote, and a match can run on from
+  one row to the next wherever the text did.
+- Each glyph is one char of the line, or two if it's a surrogate pair, no
+  matter how many cells it takes up.
+- The rows are split into chunks, which are searched on as many threads at
+  once, since a large scrollback can hold tens of megabytes of text.
+--*/
+
+#pragma once
+
+#include "regexMatcher.hpp"
+
+class TextBuffer;
+
+class TextBufferRegexSearch final
+{
+public:
+    // The first and last cell of a match, both inclusive.
+    using Match = std::pair<COORD, COORD>;
+
+    TextBufferRegexSearch(const std::wstring_view pattern, const bool caseInsensitive);
+
+    std::vector<Match> FindAll(const TextBuffer& buffer, const size_t threadCount = 0) const;
+    std::vector<Match> FindAllInRows(const TextBuffer& buffer, const size_t firstRow, const size_t rowCount) const;
+
+private:
+    // The fewest rows a thread is given, so that a small buffer isn't split
+    // into chunks that take less time to search than to start a thread for.
+    static constexpr size_t s_MinRowsPerThread = 256;
+
+    struct _Line
+    {
+        std::wstring text;
+
+        // The first and last cell of the glyph each char is part of.
+        std::vector<COORD> firstCells;
+        std::vector<COORD> lastCells;
+    };
+
+    static bool _StartsLine(const TextBuffer& buffer, const size_t row);
+    static size_t _ReadLine(const TextBuffer& buffer, const size_t firstRow, _Line& line);
+
+    const RegexMatcher _matcher;
+};
@@ -0,0 +1,380 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "textBufferSearch.hpp"
+#include "textBuffer.hpp"
+
+#include "../../types/inc/Utf16Parser.hpp"
+#include "../../types/inc/GlyphWidth.hpp"
+
+// Routine Description:
+// - Prepares a string to be searched for.
+// Arguments:
+// - needle - The string to search for
+// - caseInsensitive - True if upper and lower case chars should match each other
+TextBufferSearch::TextBufferSearch(const std::wstring_view needle, const bool caseInsensitive) :
+    _glyphs{},
+    _keys{},
+    _hasComplexCells{ false },
+    _shifts{},
+    _caseInsensitive{ caseInsensitive }
+{
+    for (const auto& chars : Utf16Parser::Parse(needle))
+    {
+        const std::wstring glyph{ chars.data(), chars.size() };
+        const size_t cells = IsGlyphFullWidth(glyph) ? 2 : 1;
+        for (size_t i = 0; i < cells; ++i)
+        {
+            _glyphs.push_back(glyph);
+            _keys.push_back(_CellKey(glyph));
+        }
+    }
+
+    _hasComplexCells = _keys.find(s_ComplexCell) != std::wstring::npos;
+
+    // The standard Horspool table: a char that isn't in the needle (before its
+    // last cell) lets the window skip past it entirely. Chars that share a low
+    // byte share an entry, which just means a shorter skip for one of them.
+    const size_t cellCount = _keys.size();
+    _shifts.fill(std::max<size_t>(cellCount, 1));
+    for (size_t i = 0; i + 1 < cellCount; ++i)
+    {
+        _shifts[_keys[i] & 0xFF] = cellCount - 1 - i;
+    }
+}
+
+// Routine Description:
+// - Returns the number of cells that a match takes up in the buffer.
+size_t TextBufferSearch::CellCount() const noexcept
+{
+    return _keys.size();
+}
+
+// Routine Description:
+// - Finds the first match that starts at one of the given positions.
+// Arguments:
+// - buffer - The text buffer to search
+// - start - The first position to try
+// - count - The number of positions to try, stepping forward or backward from
+//   the start one cell at a time, and wrapping around the ends of the buffer.
+//   More than the number of cells in the buffer tries each of them once.
+// - forward - True to step forward from the start, false to step backward.
+// Return Value:
+// - The position that the first match found starts at, if there is one.
+// Note:
+// - An empty string matches at the start.
+std::optional<COORD> TextBufferSearch::FindFirst(const TextBuffer& buffer,
+                                                 const COORD start,
+                                                 const size_t count,
+                                                 const bool forward) const
+{
+    const auto bufferSize = buffer.GetSize();
+    const size_t width = bufferSize.Width();
+    const size_t total = width * bufferSize.Height();
+    if (total == 0 || count == 0)
+    {
+        return std::nullopt;
+    }
+
+    if (_keys.empty())
+    {
+        return start;
+    }
+
+    const size_t tries = std::min(count, total);
+    const size_t startIndex = start.Y * width + start.X;
+
+    // The positions to try make up at most two ranges, split where they wrap
+    // around the end of the buffer. Each range is searched in the direction
+    // we're stepping, so that the first match found is the closest one.
+    std::wstring line;
+    std::optional<size_t> found;
+    if (forward)
+    {
+        const size_t last = std::min(total - 1, startIndex + tries - 1);
+        found = _FindInRange(buffer, startIndex, last, true, line);
+
+        const size_t remaining = tries - (last - startIndex + 1);
+        if (!found.has_value() && remaining > 0)
+        {
+            found = _FindInRange(buffer, 0, remaining - 1, true, line);
+        }
+    }
+    else
+    {
+        const size_t first = startIndex + 1 >= tries ? startIndex + 1 - tries : 0;
+        found = _FindInRange(buffer, first, startIndex, false, line);
+
+        const size_t remaining = tries - (startIndex - first + 1);
+        if (!found.has_value() && remaining > 0)
+        {
+            found = _FindInRange(buffer, total - remaining, total - 1, false, line);
+        }
+    }
+
+    if (found.has_value())
+    {
+        return COORD{ gsl::narrow_cast<SHORT>(found.value() % width), gsl::narrow_cast<SHORT>(found.value() / width) };
+    }
+    return std::nullopt;
+}
+
+// Routine Description:
+// - Finds the position of the last cell of a match.
+// Arguments:
+// - buffer - The text buffer that was searched
+// - matchStart - The position that the match starts at
+// Return Value:
+// - The position of the last cell of the match, wrapping around the end of the buffer
+//   if need be. For an empty string, the cell just before the start.
+COORD TextBufferSearch::GetMatchEnd(const TextBuffer& buffer, const COORD matchStart) const
+{
+    const auto bufferSize = buffer.GetSize();
+    const size_t width = bufferSize.Width();
+    const size_t total = width * bufferSize.Height();
+
+    const size_t end = (matchStart.Y * width + matchStart.X + total + _keys.size() % total - 1) % total;
+    return { gsl::narrow_cast<SHORT>(end % width), gsl::narrow_cast<SHORT>(end / width) };
+}
+
+// Routine Description:
+// - Finds every match that starts in the given rows. Unlike FindFirst, matches
+//   don't wrap around from the end of the buffer to the start.
+// Arguments:
+// - buffer - The text buffer to search
+// - firstRow - The first row to search, as an offset from the top of the buffer
+// - rowCount - The number of rows to search
+// Return Value:
+// - The position that each match starts at, from the top left to the bottom right.
+std::vector<COORD> TextBufferSearch::FindAll(const TextBuffer& buffer, const size_t firstRow, const size_t rowCount) const
+{
+    const auto bufferSize = buffer.GetSize();
+    const size_t width = bufferSize.Width();
+    const size_t total = width * bufferSize.Height();
+    const size_t cellCount = _keys.size();
+
+    std::vector<COORD> matches;
+    const size_t first = firstRow * width;
+    const size_t end = std::min(total, (firstRow + rowCount) * width);
+    if (cellCount == 0 || first >= end || cellCount > total - first)
+    {
+        return matches;
+    }
+
+    // A match has to end by the last cell of the buffer.
+    const size_t last = std::min(end - 1, total - cellCount);
+
+    std::wstring line;
+    _CopyCells(buffer, first, last - first + cellCount, line);
+    _ScanLine(buffer, first, line, last - first, [&](const size_t index) {
+        matches.push_back({ gsl::narrow_cast<SHORT>(index % width), gsl::narrow_cast<SHORT>(index / width) });
+        return false;
+    });
+
+    return matches;
+}
+
+wchar_t TextBufferSearch::_Fold(const wchar_t wch) const noexcept
+{
+    return _caseInsensitive ? static_cast<wchar_t>(::towlower(wch)) : wch;
+}
+
+// Routine Description:
+// - Returns the char that stands for a cell in the line that's searched.
+// Arguments:
+// - glyph - the text of the cell
+// Return Value:
+// - The (folded) char of the cell, or s_ComplexCell if its glyph isn't a single char
+wchar_t TextBufferSearch::_CellKey(const std::wstring_view glyph) const noexcept
+{
+    if (glyph.size() == 1 && glyph.front() != s_ComplexCell)
+    {
+        return _Fold(glyph.front());
+    }
+    return s_ComplexCell;
+}
+
+bool TextBufferSearch::_GlyphsMatch(const std::wstring_view glyph, const std::wstring_view needleGlyph) const noexcept
+{
+    if (glyph.size() != needleGlyph.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < glyph.size(); ++i)
+    {
+        if (_Fold(glyph[i]) != _Fold(needleGlyph[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Routine Description:
+// - Copies the key of each cell in a range into the line, one row at a time.
+// Arguments:
+// - buffer - The text buffer to copy from
+// - first - The index of the first cell, counting across each row and down the buffer
+// - count - The number of cells to copy. Wraps around the end of the buffer.
+// - line - Receives the keys of the cells
+// Return Value:
+// - <none>
+void TextBufferSearch::_CopyCells(const TextBuffer& buffer, const size_t first, const size_t count, std::wstring& line) const
+{
+    const auto bufferSize = buffer.GetSize();
+    const size_t width = bufferSize.Width();
+    const size_t total = width * bufferSize.Height();
+
+    line.clear();
+    line.reserve(count);
+
+    size_t index = first % total;
+    size_t remaining = count;
+    while (remaining > 0)
+    {
+        const size_t x = index % width;
+        const auto& charRow = buffer.GetRowByOffset(index / width).GetCharRow();
+        const size_t cells = std::min(remaining, width - x);
+        for (size_t i = 0; i < cells; ++i)
+        {
+            line.push_back(_CellKey(charRow.GlyphAt(x + i)));
+        }
+
+        remaining -= cells;
+        index = (index + cells) % total;
+    }
+}
+
+// Routine Description:
+// - Compares the cells of a match that stood in as s_ComplexCell in full.
+// Arguments:
+// - buffer - The text buffer that's being searched
+// - matchStart - The index of the first cell of the match
+// Return Value:
+// - True if the glyphs of those cells match the needle's
+bool TextBufferSearch::_VerifyComplexCells(const TextBuffer& buffer, const size_t matchStart) const
+{
+    const auto bufferSize = buffer.GetSize();
+    const size_t width = bufferSize.Width();
+    const size_t total = width * bufferSize.Height();
+
+    for (size_t i = 0; i < _keys.size(); ++i)
+    {
+        if (_keys[i] == s_ComplexCell)
+        {
+            const size_t index = (matchStart + i) % total;
+            const std::wstring_view glyph = buffer.GetRowByOffset(index / width).GetCharRow().GlyphAt(index % width);
+            if (!_GlyphsMatch(glyph, _glyphs[i]))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Routine Description:
+// - Runs Boyer-Moore-Horspool over a line of cells copied out of the buffer.
+// Arguments:
+// - buffer - The text buffer the line was copied from
+// - lineFirst - The index of the cell the line starts at
+// - line - The keys of the cells. Must hold lastStart plus the needle's cells.
+// - lastStart - The offset in the line of the last cell a match may start at
+// - onMatch - Called with the index of the first cell of each match, from the
+//   start of the line to the end. Returns true to stop looking.
+// Return Value:
+// - <none>
+void TextBufferSearch::_ScanLine(const TextBuffer& buffer,
+                                 const size_t lineFirst,
+                                 const std::wstring& line,
+                                 const size_t lastStart,
+                                 const std::function<bool(const size_t)>& onMatch) const
+{
+    const size_t cellCount = _keys.size();
+
+    size_t pos = 0;
+    while (pos <= lastStart)
+    {
+        size_t i = cellCount;
+        while (i > 0 && line[pos + i - 1] == _keys[i - 1])
+        {
+            --i;
+        }
+
+        if (i == 0 && (!_hasComplexCells || _VerifyComplexCells(buffer, lineFirst + pos)))
+        {
+            if (onMatch(lineFirst + pos))
+            {
+                return;
+            }
+        }
+
+        pos += _shifts[line[pos + cellCount - 1] & 0xFF];
+    }
+}
+
+// Routine Description:
+// - Finds the first or last match that starts in a range of cells, a batch of
+//   rows at a time.
+// Arguments:
+// - buffer - The text buffer to search
+// - first - The index of the first cell a match may start at
+// - last - The index of the last cell a match may start at. Not before first.
+// - forward - True for the first match in the range, false for the last.
+// - line - Scratch space for the text of the cells
+// Return Value:
+// - The index of the cell the match starts at, if there is one
+std::optional<size_t> TextBufferSearch::_FindInRange(const TextBuffer& buffer,
+                                                     const size_t first,
+                                                     const size_t last,
+                                                     const bool forward,
+                                                     std::wstring& line) const
+{
+    const size_t cellCount = _keys.size();
+    const size_t batchSize = s_RowsPerBatch * buffer.GetSize().Width();
+
+    size_t batchFirst = forward ? first : (last - first >= batchSize ? last - batchSize + 1 : first);
+    for (;;)
+    {
+        const size_t batchLast = std::min(last, batchFirst + batchSize - 1);
+        const size_t lastStart = batchLast - batchFirst;
+
+        // A match may start on the last cell of the batch, so the line takes in
+        // enough of the cells after it for the rest of the needle.
+        _CopyCells(buffer, batchFirst, lastStart + cellCount, line);
+
+        std::optional<size_t> found;
+        _ScanLine(buffer, batchFirst, line, lastStart, [&](const size_t index) {
+            found = index;
+            return forward;
+        });
+
+        if (found.has_value())
+        {
+            return found;
+        }
+
+        if (forward)
+        {
+            if (batchLast == last)
+            {
+                break;
+            }
+            batchFirst = batchLast + 1;
+        }
+        else
+        {
+            if (batchFirst == first)
+            {
+                break;
+            }
+            const size_t nextLast = batchFirst - 1;
+            batchFirst = nextLast - first >= batchSize ? nextLast - batchSize + 1 : first;
+        }
+    }
+
+    return std::nullopt;
+}
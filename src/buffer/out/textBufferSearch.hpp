@@ -0,0 +1,79 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- textBufferSearch.hpp
+
+Abstract:
+- Finds a string in a text buffer, for conhost's Search (and so UIA's FindText)
+  and anything else that holds a TextBuffer.
+- The buffer is searched as one long run of cells, going from the end of each
+  row onto the start of the next one, and from the end of the buffer back
+  around to the start, the same way the cursor would step through it.
+- A wide glyph takes up two cells, so it's matched twice: once for each half.
+- The text of a batch of rows is copied into one contiguous line, one char per
+  cell, and searched with Boyer-Moore-Horspool. Cells whose glyph doesn't fit
+  in one char stand in as a marker char, and are compared in full wherever
+  the rest of the string matched.
+--*/
+
+#pragma once
+
+#include <array>
+
+class TextBuffer;
+
+class TextBufferSearch final
+{
+public:
+    TextBufferSearch(const std::wstring_view needle, const bool caseInsensitive);
+
+    size_t CellCount() const noexcept;
+
+    std::optional<COORD> FindFirst(const TextBuffer& buffer,
+                                   const COORD start,
+                                   const size_t count,
+                                   const bool forward) const;
+
+    std::vector<COORD> FindAll(const TextBuffer& buffer, const size_t firstRow, const size_t rowCount) const;
+
+    COORD GetMatchEnd(const TextBuffer& buffer, const COORD matchStart) const;
+
+private:
+    // Stands in for a cell whose glyph is more than one char. It's a
+    // noncharacter, so text shouldn't have it, but if it does, it's compared
+    // in full like the rest.
+    static constexpr wchar_t s_ComplexCell = 0xFFFF;
+
+    // The number of rows that are copied into the line at a time.
+    static constexpr size_t s_RowsPerBatch = 64;
+
+    wchar_t _Fold(const wchar_t wch) const noexcept;
+    wchar_t _CellKey(const std::wstring_view glyph) const noexcept;
+    bool _GlyphsMatch(const std::wstring_view glyph, const std::wstring_view needleGlyph) const noexcept;
+
+    void _CopyCells(const TextBuffer& buffer, const size_t first, const size_t count, std::wstring& line) const;
+    bool _VerifyComplexCells(const TextBuffer& buffer, const size_t matchStart) const;
+    void _ScanLine(const TextBuffer& buffer,
+                   const size_t lineFirst,
+                   const std::wstring& line,
+                   const size_t lastStart,
+                   const std::function<bool(const size_t)>& onMatch) const;
+    std::optional<size_t> _FindInRange(const TextBuffer& buffer,
+                                       const size_t first,
+                                       const size_t last,
+                                       const bool forward,
+                                       std::wstring& line) const;
+
+    // One entry for each cell of the needle.
+    std::vector<std::wstring> _glyphs;
+    std::wstring _keys;
+    bool _hasComplexCells;
+
+    // How far the window moves when the char under its last cell doesn't match,
+    // indexed by the low byte of that char.
+    std::array<size_t, 256> _shifts;
+
+    const bool _caseInsensitive;
+};
@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "textBufferSearchSession.hpp"
+#include "textBuffer.hpp"
+
+using namespace Microsoft::Console::Types;
+
+// Routine Description:
+// - Starts keeping the matches of a string in a text buffer. Nothing is
+//   searched until the matches are asked for.
+// Arguments:
+// - needle - The string to search for
+// - caseInsensitive - True if upper and lower case chars should match each other
+// - rowCount - The number of rows in the text buffer
+TextBufferSearchSession::TextBufferSearchSession(const std::wstring_view needle,
+                                                 const bool caseInsensitive,
+                                                 const size_t rowCount) :
+    _needle{ needle, caseInsensitive },
+    _matches{},
+    _matchCount{ 0 },
+    _invalid{},
+    _invalidRows{}
+{
+    InvalidateAll(rowCount);
+}
+
+// Routine Description:
+// - Marks a row as changed, so that it will be scanned again.
+// Arguments:
+// - storageIndex - The index of the row in the buffer's storage (not its offset
+//   from the top of the buffer)
+// Return Value:
+// - <none>
+void TextBufferSearchSession::InvalidateRow(const size_t storageIndex) noexcept
+{
+    if (storageIndex < _invalid.size() && !_invalid[storageIndex])
+    {
+        _invalid[storageIndex] = true;
+
+        // There's room for every row, and each row is only in here once.
+        _invalidRows.push_back(storageIndex);
+    }
+}
+
+// Routine Description:
+// - Drops every match and marks every row as changed. Used when the rows were
+//   all moved around or the buffer changed size.
+// Arguments:
+// - rowCount - The number of rows in the text buffer
+// Return Value:
+// - <none>
+// Note:
+// - will throw on allocation failure
+void TextBufferSearchSession::InvalidateAll(const size_t rowCount)
+{
+    _matches.assign(rowCount, {});
+    _matchCount = 0;
+
+    _invalid.assign(rowCount, true);
+    _invalidRows.clear();
+    _invalidRows.reserve(rowCount);
+    for (size_t i = 0; i < rowCount; ++i)
+    {
+        _invalidRows.push_back(i);
+    }
+}
+
+// Routine Description:
+// - Returns the number of matches in the whole buffer.
+// Arguments:
+// - buffer - The text buffer the session belongs to
+// Return Value:
+// - The number of matches.
+size_t TextBufferSearchSession::GetMatchCount(const TextBuffer& buffer)
+{
+    _Update(buffer);
+    return _matchCount;
+}
+
+// Routine Description:
+// - Returns the cells to highlight for every match that is at least partly in the given area.
+// Arguments:
+// - buffer - The text buffer the session belongs to
+// - area - The part of the buffer to highlight, usually the viewport
+// Return Value:
+// - One rectangle (inclusive, in buffer coordinates) for each row that a match covers,
+//   trimmed to the area.
+std::vector<SMALL_RECT> TextBufferSearchSession::GetHighlights(const TextBuffer& buffer, const Viewport& area)
+{
+    _Update(buffer);
+
+    std::vector<SMALL_RECT> highlights;
+
+    const auto bufferSize = buffer.GetSize();
+    const size_t width = bufferSize.Width();
+    const size_t height = bufferSize.Height();
+    const size_t cellCount = _needle.CellCount();
+    if (cellCount == 0 || area.Width() <= 0 || area.Height() <= 0 || height == 0 || area.RightInclusive() < 0)
+    {
+        return highlights;
+    }
+
+    const size_t top = std::max<SHORT>(area.Top(), 0);
+    const size_t bottom = std::min<size_t>(std::max<SHORT>(area.BottomInclusive(), 0), height - 1);
+    const size_t before = _RowsBefore(buffer);
+    const size_t firstRow = buffer.GetFirstRowIndex();
+
+    // Matches that start a few rows above the area may run into it.
+    for (size_t row = top >= before ? top - before : 0; row <= bottom; ++row)
+    {
+        for (const auto column : _matches.at((firstRow + row) % height))
+        {
+            const size_t start = row * width + column;
+            const size_t end = start + cellCount - 1;
+
+            for (size_t y = std::max(row, top); y <= std::min(end / width, bottom); ++y)
+            {
+                const size_t left = std::max<size_t>(y == row ? column : 0, area.Left());
+                const size_t right = std::min<size_t>(y == end / width ? end % width : width - 1, area.RightInclusive());
+                if (left <= right)
+                {
+                    SMALL_RECT rect;
+                    rect.Left = gsl::narrow_cast<SHORT>(left);
+                    rect.Top = gsl::narrow_cast<SHORT>(y);
+                    rect.Right = gsl::narrow_cast<SHORT>(right);
+                    rect.Bottom = rect.Top;
+                    highlights.push_back(rect);
+                }
+            }
+        }
+    }
+
+    return highlights;
+}
+
+// Routine Description:
+// - Scans the rows that were changed since the last time, along with the rows
+//   just above them whose matches could run into them.
+// Arguments:
+// - buffer - The text buffer the session belongs to
+// Return Value:
+// - <none>
+void TextBufferSearchSession::_Update(const TextBuffer& buffer)
+{
+    if (_invalidRows.empty())
+    {
+        return;
+    }
+
+    const size_t height = buffer.TotalRowCount();
+    const size_t firstRow = buffer.GetFirstRowIndex();
+    const size_t before = _RowsBefore(buffer);
+
+    const size_t changedCount = _invalidRows.size();
+    for (size_t i = 0; i < changedCount; ++i)
+    {
+        const size_t row = (_invalidRows[i] + height - firstRow) % height;
+        for (size_t j = 1; j <= before && j <= row; ++j)
+        {
+            InvalidateRow((firstRow + row - j) % height);
+        }
+    }
+
+    for (const auto storageIndex : _invalidRows)
+    {
+        _ScanRow(buffer, (storageIndex + height - firstRow) % height);
+        _invalid[storageIndex] = false;
+    }
+    _invalidRows.clear();
+}
+
+// Routine Description:
+// - Replaces the matches that start in a row with what's in the buffer now.
+// Arguments:
+// - buffer - The text buffer the session belongs to
+// - row - The offset of the row from the top of the buffer
+// Return Value:
+// - <none>
+void TextBufferSearchSession::_ScanRow(const TextBuffer& buffer, const size_t row)
+{
+    auto& matches = _matches.at((buffer.GetFirstRowIndex() + row) % buffer.TotalRowCount());
+    _matchCount -= matches.size();
+    matches.clear();
+
+    for (const auto& pos : _needle.FindAll(buffer, row, 1))
+    {
+        matches.push_back(pos.X);
+    }
+    _matchCount += matches.size();
+}
+
+// Routine Description:
+// - Returns the number of rows above a row that a match could start in and
+//   still run into the row.
+size_t TextBufferSearchSession::_RowsBefore(const TextBuffer& buffer) const
+{
+    const size_t width = buffer.GetSize().Width();
+    const size_t cellCount = _needle.CellCount();
+    return cellCount > 1 && width > 0 ? (cellCount - 1 + width - 1) / width : 0;
+}
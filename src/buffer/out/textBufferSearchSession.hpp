@@ -0,0 +1,54 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- textBufferSearchSession.hpp
+
+Abstract:
+- Keeps every match of a string in a text buffer, so that the renderer can
+  highlight all of them (say, while tailing a log) without searching the
+  whole buffer on every frame.
+- The text buffer tells the session which rows it hands out for writing and
+  which rows it moves around. The session only rescans those rows, the next
+  time someone asks for the matches, so keeping up costs about as much as the
+  output itself rather than the size of the buffer.
+- Matches are stored by the index of the row in the buffer's storage, which
+  doesn't change when the circular buffer moves on by a row.
+--*/
+
+#pragma once
+
+#include "textBufferSearch.hpp"
+#include "../types/inc/Viewport.hpp"
+
+class TextBuffer;
+
+class TextBufferSearchSession final
+{
+public:
+    TextBufferSearchSession(const std::wstring_view needle, const bool caseInsensitive, const size_t rowCount);
+
+    void InvalidateRow(const size_t storageIndex) noexcept;
+    void InvalidateAll(const size_t rowCount);
+
+    size_t GetMatchCount(const TextBuffer& buffer);
+    std::vector<SMALL_RECT> GetHighlights(const TextBuffer& buffer, const Microsoft::Console::Types::Viewport& area);
+
+private:
+    void _Update(const TextBuffer& buffer);
+    void _ScanRow(const TextBuffer& buffer, const size_t row);
+    size_t _RowsBefore(const TextBuffer& buffer) const;
+
+    const TextBufferSearch _needle;
+
+    // The columns that matches start at in each row, by storage index.
+    std::vector<std::vector<SHORT>> _matches;
+    size_t _matchCount;
+
+    // The rows (by storage index) that were changed since they were last scanned.
+    // _invalidRows holds each of them once, and has room for every row, so that
+    // adding to it can't fail.
+    std::vector<bool> _invalid;
+    std::vector<size_t> _invalidRows;
+};
@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../regexMatcher.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class RegexMatcherTests
+{
+    TEST_CLASS(RegexMatcherTests);
+
+    static std::wstring s_Find(const std::wstring_view pattern, const std::wstring_view text, const bool caseInsensitive = false)
+    {
+        const RegexMatcher matcher{ pattern, caseInsensitive };
+        const auto found = matcher.Find(text, 0);
+        if (!found.has_value())
+        {
+            return L"<none>";
+        }
+        return std::wstring{ text.substr(found->first, found->second - found->first) };
+    }
+
+    TEST_METHOD(MatchesLiteralsAndClasses)
+    {
+        VERIFY_ARE_EQUAL(std::wstring{ L"error" }, s_Find(L"error", L"an error occurred"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"x7" }, s_Find(L"[a-z]\\d", L"A1 x7"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"7" }, s_Find(L"[^a-zA-Z 1]", L"A1 x7"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"a.b" }, s_Find(L"a\\.b", L"axb a.b"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"a]" }, s_Find(L"a[]]", L"a] "));
+        VERIFY_ARE_EQUAL(std::wstring{ L"A" }, s_Find(L"\\u0041", L"zA"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"<none>" }, s_Find(L"warning", L"an error occurred"));
+    }
+
+    TEST_METHOD(MatchesLeftmostLongest)
+    {
+        // the earliest start wins, then the longest match from it, whatever the order of the alternatives.
+        VERIFY_ARE_EQUAL(std::wstring{ L"abcd" }, s_Find(L"ab|abcd|bcd", L"xabcd"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"aaa" }, s_Find(L"a+", L"baaab"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"ab" }, s_Find(L"a(?:b|c)?", L"abc"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"aaaa" }, s_Find(L"a{2,4}", L"aaaaaa"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"aa" }, s_Find(L"a{2}", L"a aaa"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"aaaaa" }, s_Find(L"a{2,}", L"a aaaaa"));
+
+        // the match that ends first isn't the one that starts first.
+        VERIFY_ARE_EQUAL(std::wstring{ L"abcd" }, s_Find(L"abcd|c", L"abcd"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"xyyyz" }, s_Find(L"xy*z|y", L"axyyyz"));
+    }
+
+    TEST_METHOD(MatchesAnchorsAtLineEnds)
+    {
+        VERIFY_ARE_EQUAL(std::wstring{ L"C:\\" }, s_Find(L"^C:\\\\", L"C:\\>"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"<none>" }, s_Find(L"^>", L"C:\\>"));
+        VERIFY_ARE_EQUAL(std::wstring{ L">" }, s_Find(L">$", L"C:\\>"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"<none>" }, s_Find(L"C$", L"C:\\>"));
+        VERIFY_ARE_EQUAL(std::wstring{ L"abc" }, s_Find(L"^abc$", L"abc"));
+
+        // ^ only matches at the start of the line, not where the search starts.
+        const RegexMatcher matcher{ L"^a", false };
+        VERIFY_IS_TRUE(matcher.Find(L"aa", 0).has_value());
+        VERIFY_IS_FALSE(matcher.Find(L"aa", 1).has_value());
+    }
+
+    TEST_METHOD(MatchesCaseInsensitively)
+    {
+        VERIFY_ARE_EQUAL(std::wstring{ L"ErRoR" }, s_Find(L"error", L"an ErRoR", true));
+        VERIFY_ARE_EQUAL(std::wstring{ L"<none>" }, s_Find(L"error", L"an ErRoR", false));
+        VERIFY_ARE_EQUAL(std::wstring{ L"Q" }, s_Find(L"[p-r]", L"Q", true));
+
+        // a negated class excludes both cases of what's in it.
+        VERIFY_ARE_EQUAL(std::wstring{ L"b" }, s_Find(L"[^a]", L"Ab", true));
+    }
+
+    TEST_METHOD(FindsSuccessiveMatches)
+    {
+        const RegexMatcher matcher{ L"\\d+", false };
+        const std::wstring_view text{ L"10 + 200 = 210" };
+
+        std::vector<std::wstring> found;
+        size_t pos = 0;
+        while (const auto match = matcher.Find(text, pos))
+        {
+            found.emplace_back(text.substr(match->first, match->second - match->first));
+            pos = match->second;
+        }
+
+        VERIFY_ARE_EQUAL(3u, found.size());
+        VERIFY_ARE_EQUAL(std::wstring{ L"10" }, found.at(0));
+        VERIFY_ARE_EQUAL(std::wstring{ L"200" }, found.at(1));
+        VERIFY_ARE_EQUAL(std::wstring{ L"210" }, found.at(2));
+    }
+
+    TEST_METHOD(FindAllMatchesFindingFromEachEnd)
+    {
+        const std::pair<std::wstring_view, std::wstring_view> cases[] = {
+            { L"\\d+", L"10 + 200 = 210" },
+            { L"^a|b$|ab", L"aabab" },
+            { L"abcd|c", L"ccabcdc" },
+            { L"a[^b]*b|a", L"aaaa" },
+        };
+
+        for (const auto& [pattern, text] : cases)
+        {
+            Log::Comment(NoThrowString().Format(L"Pattern: %.*s", gsl::narrow<int>(pattern.size()), pattern.data()));
+            const RegexMatcher matcher{ pattern, false };
+
+            std::vector<std::pair<size_t, size_t>> expected;
+            size_t pos = 0;
+            while (const auto match = matcher.Find(text, pos))
+            {
+                expected.push_back(match.value());
+                pos = match->second;
+            }
+
+            const auto all = matcher.FindAll(text);
+            VERIFY_ARE_EQUAL(expected.size(), all.size());
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                VERIFY_ARE_EQUAL(expected.at(i).first, all.at(i).first);
+                VERIFY_ARE_EQUAL(expected.at(i).second, all.at(i).second);
+            }
+        }
+    }
+
+    TEST_METHOD(RejectsUnsupportedPatterns)
+    {
+        const std::wstring_view patterns[] = {
+            L"",
+            L"(a",
+            L"a)",
+            L"[a",
+            L"*a",
+            L"a{2,1}",
+            L"a{1001}",
+            L"(a)\\1",
+            L"\\bword",
+            L"(?=a)",
+            // these can match nothing at all, so they'd match everywhere.
+            L"a*",
+            L"^",
+            L"(a|)",
+        };
+
+        for (const auto pattern : patterns)
+        {
+            Log::Comment(NoThrowString().Format(L"Pattern: %.*s", gsl::narrow<int>(pattern.size()), pattern.data()));
+            VERIFY_THROWS_SPECIFIC(RegexMatcher(pattern, false),
+                                   wil::ResultException,
+                                   [](wil::ResultException& e) { return e.GetErrorCode() == E_INVALIDARG; });
+        }
+    }
+};
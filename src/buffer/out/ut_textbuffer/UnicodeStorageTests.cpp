@@ -49,4 +49,33 @@ class UnicodeStorageTests
             VERIFY_ARE_EQUAL(fullMoonGlyph.at(i), fullMoon.at(i));
         }
     }
+
+    TEST_METHOD(RemapRowsMovesOnlyTheRowsInTheMap)
+    {
+        UnicodeStorage storage;
+        const std::vector<wchar_t> newMoon{ 0xD83C, 0xDF11 };
+        const std::vector<wchar_t> fullMoon{ 0xD83C, 0xDF15 };
+        const std::vector<wchar_t> firstQuarter{ 0xD83C, 0xDF13 };
+
+        storage.StoreGlyph({ 1, 2 }, newMoon);
+        storage.StoreGlyph({ 4, 2 }, firstQuarter);
+        storage.StoreGlyph({ 1, 3 }, fullMoon);
+        storage.StoreGlyph({ 0, 7 }, newMoon);
+
+        Log::Comment(L"Rows 2, 3 and 4 are rotated up by one.");
+        storage.RemapRows({ { SHORT{ 2 }, SHORT{ 4 } }, { SHORT{ 3 }, SHORT{ 2 } }, { SHORT{ 4 }, SHORT{ 3 } } });
+
+        VERIFY_ARE_EQUAL(4u, storage._map.size());
+        VERIFY_IS_TRUE(newMoon == storage.GetText({ 1, 4 }));
+        VERIFY_IS_TRUE(firstQuarter == storage.GetText({ 4, 4 }));
+        VERIFY_IS_TRUE(fullMoon == storage.GetText({ 1, 2 }));
+        VERIFY_IS_TRUE(newMoon == storage.GetText({ 0, 7 }));
+
+        Log::Comment(L"Erasing the last item in a row that moved leaves nothing behind to move.");
+        storage.Erase({ 1, 2 });
+        storage.RemapRows({ { SHORT{ 2 }, SHORT{ 3 } }, { SHORT{ 3 }, SHORT{ 2 } } });
+        VERIFY_ARE_EQUAL(3u, storage._map.size());
+        VERIFY_IS_TRUE(storage._columns.find(2) == storage._columns.end());
+        VERIFY_IS_TRUE(storage._columns.find(3) == storage._columns.end());
+    }
 };
@@ -2,6 +2,9 @@
 // Licensed under the MIT license.
 
 #pragma once
+
+#include "../../terminal/adapter/DispatchTypes.hpp"
+
 namespace Microsoft::Terminal::Core
 {
     class ITerminalApi
@@ -23,6 +26,17 @@ namespace Microsoft::Terminal::Core
         virtual COORD GetCursorPosition() = 0;
 
         virtual bool EraseCharacters(const unsigned int numChars) = 0;
+        virtual bool EraseInLine(const ::Microsoft::Console::VirtualTerminal::DispatchTypes::EraseType eraseType) = 0;
+        virtual bool EraseInDisplay(const ::Microsoft::Console::VirtualTerminal::DispatchTypes::EraseType eraseType) = 0;
+
+        virtual bool SetScrollingMargins(const short topMargin, const short bottomMargin) = 0;
+        virtual bool InsertLines(const unsigned int numLines) = 0;
+        virtual bool DeleteLines(const unsigned int numLines) = 0;
+        virtual bool ScrollUp(const unsigned int numLines) = 0;
+        virtual bool ScrollDown(const unsigned int numLines) = 0;
+
+        virtual bool UseAlternateScreenBuffer() = 0;
+        virtual bool UseMainScreenBuffer() = 0;
 
         virtual bool SetWindowTitle(std::wstring_view title) = 0;
 
@@ -18,16 +18,14 @@ using namespace Microsoft::Console::Render;
 using namespace Microsoft::Console::Types;
 using namespace Microsoft::Console::VirtualTerminal;
 
-std::wstring _KeyEventsToText(std::deque<std::unique_ptr<IInputEvent>>& inEventsToWrite)
+std::wstring _KeyEventsToText(const gsl::span<const INPUT_RECORD> records)
 {
     std::wstring wstr = L"";
-    for(auto& ev : inEventsToWrite)
+    for(const auto& record : records)
     {
-        if (ev->EventType() == InputEventType::KeyEvent)
+        if (record.EventType == KEY_EVENT)
         {
-            auto& k = static_cast<KeyEvent&>(*ev);
-            auto wch = k.GetCharData();
-            wstr += wch;
+            wstr += record.Event.KeyEvent.uChar.UnicodeChar;
         }
     }
     return wstr;
@@ -35,6 +33,8 @@ std::wstring _KeyEventsToText(std::deque<std::unique_ptr<IInputEvent>>& inEvents
 
 Terminal::Terminal() :
     _mutableViewport{Viewport::Empty()},
+    _inactiveViewport{ Viewport::Empty() },
+    _inAltBuffer{ false },
     _title{ L"" },
     _colorTable{},
     _defaultFg{ RGB(255, 255, 255) },
@@ -49,10 +49,10 @@ Terminal::Terminal() :
 {
     _stateMachine = std::make_unique<StateMachine>(new OutputStateMachineEngine(new TerminalDispatch(*this)));
 
-    auto passAlongInput = [&](std::deque<std::unique_ptr<IInputEvent>>& inEventsToWrite)
+    auto passAlongInput = [&](const gsl::span<const INPUT_RECORD> records)
     {
         if(!_pfnWriteInput) return;
-        std::wstring wstr = _KeyEventsToText(inEventsToWrite);
+        std::wstring wstr = _KeyEventsToText(records);
         _pfnWriteInput(wstr);
     };
 
@@ -69,6 +69,10 @@ void Terminal::Create(COORD viewportSize, SHORT scrollbackLines, IRenderTarget&
     TextAttribute attr{};
     UINT cursorSize = 12;
     _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, renderTarget);
+
+    // The alternate buffer has no scrollback.
+    _inactiveViewport = _mutableViewport;
+    _inactiveBuffer = std::make_unique<TextBuffer>(viewportSize, attr, cursorSize, renderTarget);
 }
 
 // Method Description:
@@ -120,6 +124,9 @@ void Terminal::UpdateSettings(winrt::Microsoft::Terminal::Settings::ICoreSetting
     _buffer->GetCursor().SetStyle(settings.CursorHeight(),
                                   settings.CursorColor(),
                                   cursorShape);
+    _inactiveBuffer->GetCursor().SetStyle(settings.CursorHeight(),
+                                          settings.CursorColor(),
+                                          cursorShape);
 
     for (int i = 0; i < 16; i++)
     {
@@ -152,26 +159,38 @@ HRESULT Terminal::UserResize(const COORD viewportSize) noexcept
         return S_FALSE;
     }
 
-    const auto oldTop = _mutableViewport.Top();
+    // Resizes one of the buffers, keeping the top of its viewport where it
+    //      was unless the viewport would no longer fit in the buffer.
+    auto resize = [&](TextBuffer& buffer, Viewport& view, const short scrollbackLines) -> HRESULT {
+        const COORD bufferSize{ viewportSize.X, gsl::narrow_cast<short>(viewportSize.Y + scrollbackLines) };
+        RETURN_IF_FAILED(buffer.ResizeTraditional(bufferSize));
+
+        auto proposedTop = view.Top();
+        const auto newView = Viewport::FromDimensions({ 0, proposedTop }, viewportSize);
+        const auto proposedBottom = newView.BottomExclusive();
+        // If the new bottom would be below the bottom of the buffer, then slide the
+        // top up so that we'll still fit within the buffer.
+        if (proposedBottom > bufferSize.Y)
+        {
+            proposedTop -= (proposedBottom - bufferSize.Y);
+        }
 
-    const short newBufferHeight = viewportSize.Y + _scrollbackLines;
-    COORD bufferSize{ viewportSize.X, newBufferHeight };
-    RETURN_IF_FAILED(_buffer->ResizeTraditional(bufferSize));
+        view = Viewport::FromDimensions({ 0, proposedTop }, viewportSize);
+        return S_OK;
+    };
 
-    auto proposedTop = oldTop;
-    const auto newView = Viewport::FromDimensions({ 0, proposedTop }, viewportSize);
-    const auto proposedBottom = newView.BottomExclusive();
-    // If the new bottom would be below the bottom of the buffer, then slide the
-    // top up so that we'll still fit within the buffer.
-    if (proposedBottom > bufferSize.Y)
-    {
-        proposedTop -= (proposedBottom - bufferSize.Y);
-    }
+    // Both buffers are kept the size of the viewport, so that switching
+    //      between them never has to allocate.
+    RETURN_IF_FAILED(resize(*_buffer, _mutableViewport, _inAltBuffer ? 0 : _scrollbackLines));
+    RETURN_IF_FAILED(resize(*_inactiveBuffer, _inactiveViewport, _inAltBuffer ? _scrollbackLines : 0));
 
-    _mutableViewport = Viewport::FromDimensions({ 0, proposedTop }, viewportSize);
     _scrollOffset = 0;
     _NotifyScrollEvent();
 
+    // The margins were relative to the old viewport size.
+    _scrollMargins.reset();
+    _inactiveScrollMargins.reset();
+
     return S_OK;
 }
 
@@ -300,100 +319,282 @@ Viewport Terminal::_GetVisibleViewport() const noexcept
 //      in accordance with the written text.
 // This method is our proverbial `WriteCharsLegacy`, and great care should be made to
 //      keep it minimal and orderly, lest it become WriteCharsLegacy2ElectricBoogaloo
-// TODO: MSFT 21006766
-//       This needs to become stream logic on the buffer itself sooner rather than later
-//       because it's otherwise impossible to avoid the Electric Boogaloo-ness here.
-//       I had to make a bunch of hacks to get Japanese and emoji to work-ish.
+// Runs of printable text are written a row segment at a time, straight up to
+//      the right edge of the buffer, wrapping onto the next row as needed.
+//      The cursor, the viewport and the renderer are only updated once for the
+//      whole string, no matter how many rows it fills or how many times the
+//      buffer circles.
 void Terminal::_WriteBuffer(const std::wstring_view& stringView)
 {
     auto& cursor = _buffer->GetCursor();
     const Viewport bufferSize = _buffer->GetSize();
+    const short width = bufferSize.Width();
+    const short height = bufferSize.Height();
+    const TextAttribute attributes = _buffer->GetCurrentAttributes();
+
+    COORD position = cursor.GetPosition();
+
+    // If the last write filled the final column, the cursor waits there. The
+    //      next printable character goes to the start of the next row.
+    bool delayedWrap = cursor.IsDelayedEOLWrap() && position.X == width - 1;
+
+    // The number of times we cycled the buffer, scrolling its contents up a row.
+    int rowsCircled = 0;
+
+    // If there are scroll margins, a line feed on the bottom margin scrolls
+    //      just the rows between the margins, and a line feed on the last row
+    //      of the viewport does nothing.
+    const auto scrollRegion = _GetScrollRegion();
+    const short marginTop = scrollRegion.first;
+    const short marginBottom = scrollRegion.second;
+    const short viewBottom = _mutableViewport.BottomInclusive();
+
+    // Moves down a row. If we're about to move past the bottom of the buffer,
+    //      instead cycle the buffer.
+    auto lineFeed = [&]() {
+        if (_scrollMargins.has_value() && (position.Y == marginBottom || position.Y == viewBottom))
+        {
+            if (position.Y == marginBottom)
+            {
+                _ScrollRegion(marginTop, marginBottom, -1);
+            }
+        }
+        else if (position.Y + 1 < height)
+        {
+            position.Y++;
+        }
+        else if (_buffer->IncrementCircularBuffer())
+        {
+            rowsCircled++;
+        }
+    };
+
+    auto isControl = [](const wchar_t wch) {
+        return wch == UNICODE_LINEFEED || wch == UNICODE_CARRIAGERETURN || wch == UNICODE_BACKSPACE;
+    };
 
-    for (size_t i = 0; i < stringView.size(); i++)
+    for (size_t i = 0; i < stringView.size();)
     {
-        wchar_t wch = stringView[i];
-        const COORD cursorPosBefore = cursor.GetPosition();
-        COORD proposedCursorPosition = cursorPosBefore;
-        bool notifyScroll = false;
+        const wchar_t wch = stringView[i];
 
         if (wch == UNICODE_LINEFEED)
         {
-            proposedCursorPosition.Y++;
+            lineFeed();
+            delayedWrap = false;
+            i++;
         }
         else if (wch == UNICODE_CARRIAGERETURN)
         {
-            proposedCursorPosition.X = 0;
+            position.X = 0;
+            delayedWrap = false;
+            i++;
         }
         else if (wch == UNICODE_BACKSPACE)
         {
-            if (cursorPosBefore.X == 0)
+            if (position.X == 0)
             {
-                proposedCursorPosition.X = bufferSize.Width() - 1;
-                proposedCursorPosition.Y--;
+                if (position.Y > 0)
+                {
+                    position.X = width - 1;
+                    position.Y--;
+                }
             }
             else
             {
-                proposedCursorPosition.X--;
+                position.X--;
             }
+            delayedWrap = false;
+            i++;
         }
         else
         {
-            // TODO: MSFT 21006766
-            // This is not great but I need it demoable. Fix by making a buffer stream writer.
-            if (wch >= 0xD800 && wch <= 0xDFFF)
-            {
-                OutputCellIterator it{ stringView.substr(i, 2) , _buffer->GetCurrentAttributes() };
-                const auto end = _buffer->Write(it);
-                const auto cellDistance = end.GetCellDistance(it);
-                i += cellDistance - 1;
-                proposedCursorPosition.X += gsl::narrow<SHORT>(cellDistance);
-            }
-            else
+            // Take everything up to the next control character as one run.
+            const auto runEnd = std::find_if(stringView.cbegin() + i, stringView.cend(), isControl);
+            const size_t runLength = std::distance(stringView.cbegin() + i, runEnd);
+
+            OutputCellIterator it{ stringView.substr(i, runLength), attributes };
+            while (it)
             {
-                OutputCellIterator it{ stringView.substr(i, 1) , _buffer->GetCurrentAttributes() };
-                const auto end = _buffer->Write(it);
-                const auto cellDistance = end.GetCellDistance(it);
-                proposedCursorPosition.X += gsl::narrow<SHORT>(cellDistance);
+                if (delayedWrap)
+                {
+                    position.X = 0;
+                    lineFeed();
+                    delayedWrap = false;
+                }
+
+                // Fill as much of this row as we can. This sets the wrap flag
+                //      on the row if we reach its last column.
+                const auto next = _buffer->WriteLine(it, position, true);
+                const auto cellsWritten = gsl::narrow<SHORT>(next.GetCellDistance(it));
+
+                if (cellsWritten == 0 && position.X == 0)
+                {
+                    // Not even a full row has room for this glyph. Drop it.
+                    ++it;
+                    continue;
+                }
+
+                it = next;
+                if (it)
+                {
+                    // Whatever's left continues at the start of the next row.
+                    position.X = 0;
+                    lineFeed();
+                }
+                else
+                {
+                    position.X += cellsWritten;
+                    if (position.X >= width)
+                    {
+                        position.X = width - 1;
+                        delayedWrap = true;
+                    }
+                }
             }
+
+            i += runLength;
         }
+    }
+
+    // This section is essentially equivalent to `AdjustCursorPosition`
+    // Update Cursor Position
+    cursor.SetPosition(position);
+    if (delayedWrap)
+    {
+        cursor.DelayEOLWrap(position);
+    }
+
+    bool notifyScroll = false;
+
+    // Cycling the buffer moved everything that was already on the screen up.
+    //      Anything further than the height of the buffer is all the same.
+    if (rowsCircled > 0)
+    {
+        const COORD delta{ 0, gsl::narrow<SHORT>(-std::min<int>(rowsCircled, height)) };
+        _buffer->GetRenderTarget().TriggerScroll(&delta);
+        notifyScroll = true;
+    }
 
-        // If we're about to scroll past the bottom of the buffer, instead cycle the buffer.
-        const auto newRows = proposedCursorPosition.Y - bufferSize.Height() + 1;
-        if (newRows > 0)
+    // Move the viewport down if the cursor moved below the viewport.
+    // The renderer notices the new viewport and scrolls to it on its next frame.
+    if (position.Y > _mutableViewport.BottomInclusive())
+    {
+        const auto newViewTop = std::max(0, position.Y - (_mutableViewport.Height() - 1));
+        if (newViewTop != _mutableViewport.Top())
         {
-            for(auto dy = 0; dy < newRows; dy++)
-            {
-                _buffer->IncrementCircularBuffer();
-                proposedCursorPosition.Y--;
-            }
+            _mutableViewport = Viewport::FromDimensions({0, gsl::narrow<short>(newViewTop)}, _mutableViewport.Dimensions());
             notifyScroll = true;
         }
+    }
+
+    if (notifyScroll)
+    {
+        _NotifyScrollEvent();
+    }
+}
 
-        // This section is essentially equivalent to `AdjustCursorPosition`
-        // Update Cursor Position
-        cursor.SetPosition(proposedCursorPosition);
+// Method Description:
+// - Gets the rows that scroll, in buffer coordinates (inclusive). That's the
+//      rows between the margins, if they're set, or the whole viewport.
+// Arguments:
+// - <none>
+// Return Value:
+// - The top and bottom row of the scrolling region.
+std::pair<short, short> Terminal::_GetScrollRegion() const noexcept
+{
+    const short viewTop = _mutableViewport.Top();
+    if (_scrollMargins.has_value())
+    {
+        return { gsl::narrow_cast<short>(viewTop + _scrollMargins->first), gsl::narrow_cast<short>(viewTop + _scrollMargins->second) };
+    }
+    return { viewTop, _mutableViewport.BottomInclusive() };
+}
+
+// Method Description:
+// - Moves the contents of the rows from top to bottom (inclusive) by delta
+//      rows, negative being up. Contents moved past either end are lost, and
+//      the rows exposed are erased with the current attributes.
+// - The ROWs themselves are moved rather than their contents, so this costs
+//      no more than the height of the region, and the renderer is told exactly
+//      which region moved, so it only has to repaint the exposed rows.
+// Arguments:
+// - top: The first row of the region, in buffer coordinates.
+// - bottom: The last row of the region, in buffer coordinates.
+// - delta: The number of rows to move the contents by.
+// Return Value:
+// - <none>
+void Terminal::_ScrollRegion(const short top, const short bottom, const int delta)
+{
+    const short height = bottom - top + 1;
+    const short distance = gsl::narrow_cast<short>(std::min<int>(std::abs(delta), height));
+    if (distance == 0)
+    {
+        return;
+    }
 
-        const COORD cursorPosAfter = cursor.GetPosition();
+    if (distance < height)
+    {
+        const short signedDistance = delta < 0 ? -distance : distance;
+        const short firstMoved = delta < 0 ? top + distance : top;
+        _buffer->ScrollRows(firstMoved, height - distance, signedDistance);
 
-        // Move the viewport down if the cursor moved below the viewport.
-        if (cursorPosAfter.Y > _mutableViewport.BottomInclusive())
-        {
-            const auto newViewTop = std::max(0, cursorPosAfter.Y - (_mutableViewport.Height() - 1));
-            if (newViewTop != _mutableViewport.Top())
-            {
-                _mutableViewport = Viewport::FromDimensions({0, gsl::narrow<short>(newViewTop)}, _mutableViewport.Dimensions());
-                notifyScroll = true;
-            }
-        }
+        const auto region = Viewport::FromInclusive({ 0, top, _buffer->GetSize().RightInclusive(), bottom });
+        _buffer->GetRenderTarget().TriggerScrollRegion(region, signedDistance);
+    }
 
-        if (notifyScroll)
+    // The rows that were moved over are now in the exposed spots.
+    const short exposedTop = delta < 0 ? bottom - distance + 1 : top;
+    _EraseRect(Viewport::FromDimensions({ 0, exposedTop }, { _buffer->GetSize().Width(), distance }));
+}
+
+// Method Description:
+// - Fills the given rectangle with spaces in the current attributes. Rows
+//      erased entirely are no longer wrapped.
+// Arguments:
+// - rect: The rectangle to erase, in buffer coordinates. May be empty.
+// Return Value:
+// - <none>
+void Terminal::_EraseRect(const Viewport& rect)
+{
+    if (rect.Width() <= 0 || rect.Height() <= 0)
+    {
+        return;
+    }
+
+    _buffer->FillRect(rect, UNICODE_SPACE, _buffer->GetCurrentAttributes());
+
+    if (rect.Width() == _buffer->GetSize().Width())
+    {
+        for (auto y = rect.Top(); y < rect.BottomExclusive(); y++)
         {
-            _buffer->GetRenderTarget().TriggerRedrawAll();
-            _NotifyScrollEvent();
+            _buffer->GetRowByOffset(y).GetCharRow().SetWrapForced(false);
         }
     }
 }
 
+// Method Description:
+// - Swaps the active buffer with the inactive one, along with the viewport
+//      and the margins that go with each. A selection can't carry over to
+//      the other buffer, so it's cleared.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Terminal::_SwapBuffers() noexcept
+{
+    std::swap(_buffer, _inactiveBuffer);
+    std::swap(_mutableViewport, _inactiveViewport);
+    std::swap(_scrollMargins, _inactiveScrollMargins);
+    _inAltBuffer = !_inAltBuffer;
+
+    // The buffers are already swapped, so a failure here can't be allowed to escape.
+    try
+    {
+        ClearSelection();
+    }
+    CATCH_LOG();
+}
+
 void Terminal::UserScrollViewport(const int viewTop)
 {
     const auto clampedNewTop = std::max(0, viewTop);
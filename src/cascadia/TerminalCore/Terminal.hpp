@@ -69,6 +69,15 @@ public:
     bool SetCursorPosition(short x, short y) override;
     COORD GetCursorPosition() override;
     bool EraseCharacters(const unsigned int numChars) override;
+    bool EraseInLine(const ::Microsoft::Console::VirtualTerminal::DispatchTypes::EraseType eraseType) override;
+    bool EraseInDisplay(const ::Microsoft::Console::VirtualTerminal::DispatchTypes::EraseType eraseType) override;
+    bool SetScrollingMargins(const short topMargin, const short bottomMargin) override;
+    bool InsertLines(const unsigned int numLines) override;
+    bool DeleteLines(const unsigned int numLines) override;
+    bool ScrollUp(const unsigned int numLines) override;
+    bool ScrollDown(const unsigned int numLines) override;
+    bool UseAlternateScreenBuffer() override;
+    bool UseMainScreenBuffer() override;
     bool SetWindowTitle(std::wstring_view title) override;
     bool SetColorTableEntry(const size_t tableIndex, const DWORD dwColor) override;
     #pragma endregion
@@ -149,12 +158,24 @@ public:
 
     std::shared_mutex _readWriteLock;
 
-    // TODO: These members are not shared by an alt-buffer. They should be
-    //      encapsulated, such that a Terminal can have both a main and alt buffer.
+    // These members describe the active buffer, whether that's the main
+    //      buffer or the alternate one.
     std::unique_ptr<TextBuffer> _buffer;
     Microsoft::Console::Types::Viewport _mutableViewport;
     SHORT _scrollbackLines;
 
+    // The top and bottom margins set by DECSTBM, as rows relative to the
+    //      viewport (inclusive). If they aren't set, the whole viewport scrolls.
+    std::optional<std::pair<short, short>> _scrollMargins;
+
+    // The same for the inactive buffer. The alternate buffer is allocated up
+    //      front, the size of the viewport with no scrollback, so switching
+    //      buffers is just a swap of these with the members above.
+    std::unique_ptr<TextBuffer> _inactiveBuffer;
+    Microsoft::Console::Types::Viewport _inactiveViewport;
+    std::optional<std::pair<short, short>> _inactiveScrollMargins;
+    bool _inAltBuffer;
+
     // _scrollOffset is the number of lines above the viewport that are currently visible
     // If _scrollOffset is 0, then the visible region of the buffer is the viewport.
     int _scrollOffset;
@@ -181,6 +202,12 @@ public:
 
     void _WriteBuffer(const std::wstring_view& stringView);
 
+    std::pair<short, short> _GetScrollRegion() const noexcept;
+    void _ScrollRegion(const short top, const short bottom, const int delta);
+    void _EraseRect(const Microsoft::Console::Types::Viewport& rect);
+
+    void _SwapBuffers() noexcept;
+
     void _NotifyScrollEvent();
 
     std::vector<SMALL_RECT> _GetSelectionRects() const;
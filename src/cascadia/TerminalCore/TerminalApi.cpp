@@ -137,6 +137,231 @@ bool Terminal::EraseCharacters(const unsigned int numChars)
     return true;
 }
 
+// Method Description:
+// - Erases part or all of the cursor's row (EL), filling it with spaces in the
+//      current attributes.
+// Arguments:
+// - eraseType: Which part of the row to erase.
+// Return Value:
+// - true iff eraseType is supported for a line.
+bool Terminal::EraseInLine(const DispatchTypes::EraseType eraseType)
+{
+    const auto cursorPos = _buffer->GetCursor().GetPosition();
+    const short width = _mutableViewport.Width();
+
+    switch (eraseType)
+    {
+    case DispatchTypes::EraseType::ToEnd:
+        _EraseRect(Viewport::FromDimensions(cursorPos, { gsl::narrow_cast<short>(width - cursorPos.X), 1 }));
+        return true;
+    case DispatchTypes::EraseType::FromBeginning:
+        _EraseRect(Viewport::FromDimensions({ 0, cursorPos.Y }, { gsl::narrow_cast<short>(cursorPos.X + 1), 1 }));
+        return true;
+    case DispatchTypes::EraseType::All:
+        _EraseRect(Viewport::FromDimensions({ 0, cursorPos.Y }, { width, 1 }));
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Method Description:
+// - Erases part or all of the viewport (ED), or the scrollback above it,
+//      filling it with spaces in the current attributes.
+// - Nothing is scrolled. Only the erased cells are repainted.
+// Arguments:
+// - eraseType: Which part of the display to erase.
+// Return Value:
+// - true iff eraseType is supported.
+bool Terminal::EraseInDisplay(const DispatchTypes::EraseType eraseType)
+{
+    const auto cursorPos = _buffer->GetCursor().GetPosition();
+    const short width = _mutableViewport.Width();
+    const short viewTop = _mutableViewport.Top();
+    const short viewBottom = _mutableViewport.BottomExclusive();
+
+    switch (eraseType)
+    {
+    case DispatchTypes::EraseType::ToEnd:
+        _EraseRect(Viewport::FromDimensions(cursorPos, { gsl::narrow_cast<short>(width - cursorPos.X), 1 }));
+        _EraseRect(Viewport::FromDimensions({ 0, gsl::narrow_cast<short>(cursorPos.Y + 1) }, { width, gsl::narrow_cast<short>(viewBottom - (cursorPos.Y + 1)) }));
+        return true;
+    case DispatchTypes::EraseType::FromBeginning:
+        _EraseRect(Viewport::FromDimensions({ 0, viewTop }, { width, gsl::narrow_cast<short>(cursorPos.Y - viewTop) }));
+        _EraseRect(Viewport::FromDimensions({ 0, cursorPos.Y }, { gsl::narrow_cast<short>(cursorPos.X + 1), 1 }));
+        return true;
+    case DispatchTypes::EraseType::All:
+        _EraseRect(_mutableViewport);
+        return true;
+    case DispatchTypes::EraseType::Scrollback:
+        _EraseRect(Viewport::FromDimensions({ 0, 0 }, { width, viewTop }));
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Method Description:
+// - Sets the top and bottom margins of the scrolling region (DECSTBM). A line
+//      feed on the bottom margin scrolls just the rows between the margins,
+//      and IL, DL, SU and SD stay within them. Setting them moves the cursor
+//      to the top left corner.
+// Arguments:
+// - topMargin: The 1-based row of the top margin, or 0 for the top of the viewport.
+// - bottomMargin: The 1-based row of the bottom margin, or 0 for the bottom of the viewport.
+// Return Value:
+// - true iff the margins are valid.
+bool Terminal::SetScrollingMargins(const short topMargin, const short bottomMargin)
+{
+    const short viewHeight = _mutableViewport.Height();
+    const short top = topMargin > 0 ? topMargin - 1 : 0;
+    const short bottom = bottomMargin > 0 ? bottomMargin - 1 : viewHeight - 1;
+    if (top < 0 || top >= bottom || bottom >= viewHeight)
+    {
+        return false;
+    }
+
+    // Margins that cover the whole viewport are the same as no margins at all.
+    if (top == 0 && bottom == viewHeight - 1)
+    {
+        _scrollMargins.reset();
+    }
+    else
+    {
+        _scrollMargins = std::make_pair(top, bottom);
+    }
+
+    return SetCursorPosition(0, 0);
+}
+
+// Method Description:
+// - Inserts blank lines at the cursor (IL), pushing the rows below it down
+//      towards the bottom margin. Rows pushed past the margin are lost.
+// Arguments:
+// - numLines: The number of lines to insert.
+// Return Value:
+// - true
+bool Terminal::InsertLines(const unsigned int numLines)
+{
+    auto& cursor = _buffer->GetCursor();
+    const auto cursorPos = cursor.GetPosition();
+    const auto [top, bottom] = _GetScrollRegion();
+
+    // Outside of the margins, IL has no effect.
+    if (cursorPos.Y >= top && cursorPos.Y <= bottom)
+    {
+        const auto distance = std::min<unsigned int>(numLines, bottom - cursorPos.Y + 1);
+        _ScrollRegion(cursorPos.Y, bottom, static_cast<int>(distance));
+        cursor.SetPosition({ 0, cursorPos.Y });
+    }
+    return true;
+}
+
+// Method Description:
+// - Deletes lines at the cursor (DL), pulling the rows below it up. Blank
+//      lines are exposed at the bottom margin.
+// Arguments:
+// - numLines: The number of lines to delete.
+// Return Value:
+// - true
+bool Terminal::DeleteLines(const unsigned int numLines)
+{
+    auto& cursor = _buffer->GetCursor();
+    const auto cursorPos = cursor.GetPosition();
+    const auto [top, bottom] = _GetScrollRegion();
+
+    // Outside of the margins, DL has no effect.
+    if (cursorPos.Y >= top && cursorPos.Y <= bottom)
+    {
+        const auto distance = std::min<unsigned int>(numLines, bottom - cursorPos.Y + 1);
+        _ScrollRegion(cursorPos.Y, bottom, -static_cast<int>(distance));
+        cursor.SetPosition({ 0, cursorPos.Y });
+    }
+    return true;
+}
+
+// Method Description:
+// - Scrolls the rows between the margins up (SU), exposing blank lines at
+//      the bottom margin. The cursor doesn't move.
+// Arguments:
+// - numLines: The number of lines to scroll.
+// Return Value:
+// - true
+bool Terminal::ScrollUp(const unsigned int numLines)
+{
+    const auto [top, bottom] = _GetScrollRegion();
+    const auto distance = std::min<unsigned int>(numLines, bottom - top + 1);
+    _ScrollRegion(top, bottom, -static_cast<int>(distance));
+    return true;
+}
+
+// Method Description:
+// - Scrolls the rows between the margins down (SD), exposing blank lines at
+//      the top margin. The cursor doesn't move.
+// Arguments:
+// - numLines: The number of lines to scroll.
+// Return Value:
+// - true
+bool Terminal::ScrollDown(const unsigned int numLines)
+{
+    const auto [top, bottom] = _GetScrollRegion();
+    const auto distance = std::min<unsigned int>(numLines, bottom - top + 1);
+    _ScrollRegion(top, bottom, static_cast<int>(distance));
+    return true;
+}
+
+// Method Description:
+// - Switches to the alternate buffer (ASBSET), and clears it. The current
+//      attributes carry over to it. If the alternate buffer is already
+//      active, it's just cleared.
+// - The alternate buffer was allocated along with the main one, so this is
+//      just a swap, and one invalidation of the viewport by the erase.
+// Arguments:
+// - <none>
+// Return Value:
+// - true
+bool Terminal::UseAlternateScreenBuffer()
+{
+    if (!_inAltBuffer)
+    {
+        const auto attributes = _buffer->GetCurrentAttributes();
+        _SwapBuffers();
+        _buffer->SetCurrentAttributes(attributes);
+    }
+
+    _scrollMargins.reset();
+
+    auto& cursor = _buffer->GetCursor();
+    cursor.SetPosition({ 0, 0 });
+    cursor.ResetDelayEOLWrap();
+
+    _EraseRect(_buffer->GetSize());
+
+    // The alternate buffer has no scrollback to look at.
+    _scrollOffset = 0;
+    _NotifyScrollEvent();
+    return true;
+}
+
+// Method Description:
+// - Switches back to the main buffer (ASBRST), which comes back the way it
+//      was left, cursor and all. If the main buffer is already active, this
+//      does nothing.
+// Arguments:
+// - <none>
+// Return Value:
+// - true
+bool Terminal::UseMainScreenBuffer()
+{
+    if (_inAltBuffer)
+    {
+        _SwapBuffers();
+        _buffer->GetRenderTarget().TriggerRedrawAll();
+        _NotifyScrollEvent();
+    }
+    return true;
+}
+
 bool Terminal::SetWindowTitle(std::wstring_view title)
 {
     _title = title;
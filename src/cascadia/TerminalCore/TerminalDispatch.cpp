@@ -53,6 +53,101 @@ bool TerminalDispatch::EraseCharacters(const unsigned int uiNumChars)
     return _terminalApi.EraseCharacters(uiNumChars);
 }
 
+bool TerminalDispatch::EraseInLine(const DispatchTypes::EraseType eraseType)
+{
+    return _terminalApi.EraseInLine(eraseType);
+}
+
+bool TerminalDispatch::EraseInDisplay(const DispatchTypes::EraseType eraseType)
+{
+    return _terminalApi.EraseInDisplay(eraseType);
+}
+
+bool TerminalDispatch::SetTopBottomScrollingMargins(const SHORT sTopMargin, const SHORT sBottomMargin)
+{
+    return _terminalApi.SetScrollingMargins(sTopMargin, sBottomMargin);
+}
+
+bool TerminalDispatch::InsertLine(const unsigned int uiDistance)
+{
+    return _terminalApi.InsertLines(uiDistance);
+}
+
+bool TerminalDispatch::DeleteLine(const unsigned int uiDistance)
+{
+    return _terminalApi.DeleteLines(uiDistance);
+}
+
+bool TerminalDispatch::ScrollUp(const unsigned int uiDistance)
+{
+    return _terminalApi.ScrollUp(uiDistance);
+}
+
+bool TerminalDispatch::ScrollDown(const unsigned int uiDistance)
+{
+    return _terminalApi.ScrollDown(uiDistance);
+}
+
+bool TerminalDispatch::UseAlternateScreenBuffer()
+{
+    return _terminalApi.UseAlternateScreenBuffer();
+}
+
+bool TerminalDispatch::UseMainScreenBuffer()
+{
+    return _terminalApi.UseMainScreenBuffer();
+}
+
+// Method Description:
+// - DECSET - Enables the given DEC private mode params. Only the ones the
+//      terminal supports are handled, but all of them are attempted.
+// Arguments:
+// - rgParams: array of params to set
+// - cParams: length of rgParams
+// Return Value:
+// - True if all the params were handled successfully. False otherwise.
+bool TerminalDispatch::SetPrivateModes(_In_reads_(cParams) const DispatchTypes::PrivateModeParams* const rgParams,
+                                       const size_t cParams)
+{
+    return _SetResetPrivateModes(rgParams, cParams, true);
+}
+
+// Method Description:
+// - DECRST - Disables the given DEC private mode params. Only the ones the
+//      terminal supports are handled, but all of them are attempted.
+// Arguments:
+// - rgParams: array of params to reset
+// - cParams: length of rgParams
+// Return Value:
+// - True if all the params were handled successfully. False otherwise.
+bool TerminalDispatch::ResetPrivateModes(_In_reads_(cParams) const DispatchTypes::PrivateModeParams* const rgParams,
+                                         const size_t cParams)
+{
+    return _SetResetPrivateModes(rgParams, cParams, false);
+}
+
+bool TerminalDispatch::_SetResetPrivateModes(_In_reads_(cParams) const DispatchTypes::PrivateModeParams* const rgParams,
+                                             const size_t cParams,
+                                             const bool enable)
+{
+    size_t failures = 0;
+    for (size_t i = 0; i < cParams; i++)
+    {
+        bool success = false;
+        switch (rgParams[i])
+        {
+        case DispatchTypes::PrivateModeParams::ASB_AlternateScreenBuffer:
+            success = enable ? UseAlternateScreenBuffer() : UseMainScreenBuffer();
+            break;
+        default:
+            success = false;
+            break;
+        }
+        failures += success ? 0 : 1;
+    }
+    return failures == 0;
+}
+
 bool TerminalDispatch::SetWindowTitle(std::wstring_view title)
 {
     return _terminalApi.SetWindowTitle(title);
@@ -22,6 +22,22 @@ public:
     bool CursorForward(const unsigned int uiDistance) override;
 
     bool EraseCharacters(const unsigned int uiNumChars) override;
+    bool EraseInLine(const ::Microsoft::Console::VirtualTerminal::DispatchTypes::EraseType eraseType) override; // EL
+    bool EraseInDisplay(const ::Microsoft::Console::VirtualTerminal::DispatchTypes::EraseType eraseType) override; // ED
+
+    bool SetTopBottomScrollingMargins(const SHORT sTopMargin, const SHORT sBottomMargin) override; // DECSTBM
+    bool InsertLine(const unsigned int uiDistance) override; // IL
+    bool DeleteLine(const unsigned int uiDistance) override; // DL
+    bool ScrollUp(const unsigned int uiDistance) override; // SU
+    bool ScrollDown(const unsigned int uiDistance) override; // SD
+
+    bool UseAlternateScreenBuffer() override; // ASBSET
+    bool UseMainScreenBuffer() override; // ASBRST
+    bool SetPrivateModes(_In_reads_(cParams) const ::Microsoft::Console::VirtualTerminal::DispatchTypes::PrivateModeParams* const rgParams,
+                         const size_t cParams) override; // DECSET
+    bool ResetPrivateModes(_In_reads_(cParams) const ::Microsoft::Console::VirtualTerminal::DispatchTypes::PrivateModeParams* const rgParams,
+                           const size_t cParams) override; // DECRST
+
     bool SetWindowTitle(std::wstring_view title) override;
 
     bool SetColorTableEntry(const size_t tableIndex, const DWORD dwColor) override;
@@ -40,4 +56,8 @@ private:
     bool _SetDefaultColorHelper(const ::Microsoft::Console::VirtualTerminal::DispatchTypes::GraphicsOptions option);
     void _SetGraphicsOptionHelper(const ::Microsoft::Console::VirtualTerminal::DispatchTypes::GraphicsOptions opt);
 
+    bool _SetResetPrivateModes(_In_reads_(cParams) const ::Microsoft::Console::VirtualTerminal::DispatchTypes::PrivateModeParams* const rgParams,
+                               const size_t cParams,
+                               const bool enable);
+
 };
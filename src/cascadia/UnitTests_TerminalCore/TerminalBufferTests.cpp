@@ -0,0 +1,214 @@
+/*
+* Copyright (c) Microsoft Corporation.
+* Licensed under the MIT license.
+*/
+#include "precomp.h"
+#include <WexTestClass.h>
+
+#include "../cascadia/TerminalCore/Terminal.hpp"
+#include "../renderer/inc/DummyRenderTarget.hpp"
+#include "consoletaeftemplates.hpp"
+
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+using namespace Microsoft::Terminal::Core;
+using namespace Microsoft::Console::Render;
+
+namespace TerminalCoreUnitTests
+{
+    class TerminalBufferTests
+    {
+        TEST_CLASS(TerminalBufferTests);
+
+        TEST_METHOD(WriteWrapsAtRightEdge)
+        {
+            Terminal term = Terminal();
+            DummyRenderTarget emptyRT;
+            term.Create({ 10, 5 }, 0, emptyRT);
+
+            term.Write(L"0123456789AB");
+
+            const auto& buffer = term.GetTextBuffer();
+            VERIFY_ARE_EQUAL(L"0123456789", buffer.GetRowByOffset(0).GetText());
+            VERIFY_IS_TRUE(buffer.GetRowByOffset(0).GetCharRow().WasWrapForced());
+            VERIFY_ARE_EQUAL(L"AB        ", buffer.GetRowByOffset(1).GetText());
+            VERIFY_IS_FALSE(buffer.GetRowByOffset(1).GetCharRow().WasWrapForced());
+            VERIFY_ARE_EQUAL(COORD({ 2, 1 }), term.GetCursorPosition());
+        }
+
+        TEST_METHOD(WriteDelaysWrapAtLastColumn)
+        {
+            Terminal term = Terminal();
+            DummyRenderTarget emptyRT;
+            term.Create({ 10, 5 }, 0, emptyRT);
+
+            Log::Comment(L"Filling the row leaves the cursor on its last column.");
+            term.Write(L"0123456789");
+            VERIFY_ARE_EQUAL(COORD({ 9, 0 }), term.GetCursorPosition());
+
+            Log::Comment(L"A newline from there doesn't leave a blank row behind.");
+            term.Write(L"\r\nA");
+
+            const auto& buffer = term.GetTextBuffer();
+            VERIFY_ARE_EQUAL(L"0123456789", buffer.GetRowByOffset(0).GetText());
+            VERIFY_ARE_EQUAL(L"A         ", buffer.GetRowByOffset(1).GetText());
+            VERIFY_ARE_EQUAL(COORD({ 1, 1 }), term.GetCursorPosition());
+
+            Log::Comment(L"A printable character from there goes to the next row.");
+            term.Write(L"\r123456789");
+            VERIFY_ARE_EQUAL(COORD({ 9, 1 }), term.GetCursorPosition());
+            term.Write(L"B");
+            VERIFY_ARE_EQUAL(L"A123456789", buffer.GetRowByOffset(1).GetText());
+            VERIFY_ARE_EQUAL(L"B         ", buffer.GetRowByOffset(2).GetText());
+            VERIFY_ARE_EQUAL(COORD({ 1, 2 }), term.GetCursorPosition());
+        }
+
+        TEST_METHOD(WriteCirclesBuffer)
+        {
+            Terminal term = Terminal();
+            DummyRenderTarget emptyRT;
+            term.Create({ 10, 3 }, 0, emptyRT);
+
+            term.Write(L"a\r\nb\r\nc\r\nd\r\n0123456789012345");
+
+            const auto& buffer = term.GetTextBuffer();
+            VERIFY_ARE_EQUAL(L"d         ", buffer.GetRowByOffset(0).GetText());
+            VERIFY_ARE_EQUAL(L"0123456789", buffer.GetRowByOffset(1).GetText());
+            VERIFY_ARE_EQUAL(L"012345    ", buffer.GetRowByOffset(2).GetText());
+            VERIFY_ARE_EQUAL(COORD({ 6, 2 }), term.GetCursorPosition());
+        }
+
+        TEST_METHOD(LineFeedScrollsWithinMargins)
+        {
+            Terminal term = Terminal();
+            DummyRenderTarget emptyRT;
+            term.Create({ 10, 5 }, 0, emptyRT);
+
+            term.Write(L"0\r\n1\r\n2\r\n3\r\n4");
+
+            Log::Comment(L"Setting the margins homes the cursor.");
+            term.Write(L"\x1b[2;4r");
+            VERIFY_ARE_EQUAL(COORD({ 0, 0 }), term.GetCursorPosition());
+
+            Log::Comment(L"A line feed on the bottom margin only scrolls the rows between the margins.");
+            term.Write(L"\x1b[4;1H\nX");
+
+            const auto& buffer = term.GetTextBuffer();
+            VERIFY_ARE_EQUAL(L"0         ", buffer.GetRowByOffset(0).GetText());
+            VERIFY_ARE_EQUAL(L"2         ", buffer.GetRowByOffset(1).GetText());
+            VERIFY_ARE_EQUAL(L"3         ", buffer.GetRowByOffset(2).GetText());
+            VERIFY_ARE_EQUAL(L"X         ", buffer.GetRowByOffset(3).GetText());
+            VERIFY_ARE_EQUAL(L"4         ", buffer.GetRowByOffset(4).GetText());
+            VERIFY_ARE_EQUAL(COORD({ 1, 3 }), term.GetCursorPosition());
+
+            Log::Comment(L"Resetting the margins lets the whole viewport scroll again.");
+            term.Write(L"\x1b[r\x1b[5;1H\nY");
+            VERIFY_ARE_EQUAL(L"2         ", buffer.GetRowByOffset(0).GetText());
+            VERIFY_ARE_EQUAL(L"4         ", buffer.GetRowByOffset(3).GetText());
+            VERIFY_ARE_EQUAL(L"Y         ", buffer.GetRowByOffset(4).GetText());
+        }
+
+        TEST_METHOD(InsertDeleteAndScrollLines)
+        {
+            Terminal term = Terminal();
+            DummyRenderTarget emptyRT;
+            term.Create({ 10, 5 }, 0, emptyRT);
+
+            term.Write(L"0\r\n1\r\n2\r\n3\r\n4");
+            const auto& buffer = term.GetTextBuffer();
+
+            Log::Comment(L"IL pushes the rows below the cursor down, and moves the cursor to the left edge.");
+            term.Write(L"\x1b[2;3H\x1b[L");
+            VERIFY_ARE_EQUAL(L"0         ", buffer.GetRowByOffset(0).GetText());
+            VERIFY_ARE_EQUAL(L"          ", buffer.GetRowByOffset(1).GetText());
+            VERIFY_ARE_EQUAL(L"1         ", buffer.GetRowByOffset(2).GetText());
+            VERIFY_ARE_EQUAL(L"3         ", buffer.GetRowByOffset(4).GetText());
+            VERIFY_ARE_EQUAL(COORD({ 0, 1 }), term.GetCursorPosition());
+
+            Log::Comment(L"DL pulls the rows below the cursor up.");
+            term.Write(L"\x1b[2M");
+            VERIFY_ARE_EQUAL(L"0         ", buffer.GetRowByOffset(0).GetText());
+            VERIFY_ARE_EQUAL(L"2         ", buffer.GetRowByOffset(1).GetText());
+            VERIFY_ARE_EQUAL(L"3         ", buffer.GetRowByOffset(2).GetText());
+            VERIFY_ARE_EQUAL(L"          ", buffer.GetRowByOffset(3).GetText());
+
+            Log::Comment(L"SU and SD stay within the margins, and leave the cursor alone.");
+            term.Write(L"\x1b[1;3r\x1b[2;2H\x1b[T");
+            VERIFY_ARE_EQUAL(L"          ", buffer.GetRowByOffset(0).GetText());
+            VERIFY_ARE_EQUAL(L"0         ", buffer.GetRowByOffset(1).GetText());
+            VERIFY_ARE_EQUAL(L"2         ", buffer.GetRowByOffset(2).GetText());
+            VERIFY_ARE_EQUAL(L"          ", buffer.GetRowByOffset(3).GetText());
+            VERIFY_ARE_EQUAL(COORD({ 1, 1 }), term.GetCursorPosition());
+
+            term.Write(L"\x1b[5S");
+            VERIFY_ARE_EQUAL(L"          ", buffer.GetRowByOffset(0).GetText());
+            VERIFY_ARE_EQUAL(L"          ", buffer.GetRowByOffset(2).GetText());
+        }
+
+        TEST_METHOD(EraseInLineAndDisplay)
+        {
+            Terminal term = Terminal();
+            DummyRenderTarget emptyRT;
+            term.Create({ 10, 3 }, 0, emptyRT);
+
+            term.Write(L"abcdefghij\r\nabcdefghij\r\nabcdefghij");
+            const auto& buffer = term.GetTextBuffer();
+
+            term.Write(L"\x1b[1;4H\x1b[K");
+            VERIFY_ARE_EQUAL(L"abc       ", buffer.GetRowByOffset(0).GetText());
+
+            term.Write(L"\x1b[2;3H\x1b[1K");
+            VERIFY_ARE_EQUAL(L"   defghij", buffer.GetRowByOffset(1).GetText());
+
+            term.Write(L"\x1b[3;5H\x1b[1J");
+            VERIFY_ARE_EQUAL(L"          ", buffer.GetRowByOffset(0).GetText());
+            VERIFY_ARE_EQUAL(L"          ", buffer.GetRowByOffset(1).GetText());
+            VERIFY_ARE_EQUAL(L"     fghij", buffer.GetRowByOffset(2).GetText());
+
+            term.Write(L"\x1b[2J");
+            VERIFY_ARE_EQUAL(L"          ", buffer.GetRowByOffset(2).GetText());
+            VERIFY_ARE_EQUAL(COORD({ 4, 2 }), term.GetCursorPosition());
+        }
+
+        TEST_METHOD(AlternateBufferIsSwappedNotAllocated)
+        {
+            Terminal term = Terminal();
+            DummyRenderTarget emptyRT;
+            term.Create({ 10, 3 }, 2, emptyRT);
+
+            term.Write(L"main\r\nx");
+            const auto* const mainBuffer = &term.GetTextBuffer();
+            VERIFY_ARE_EQUAL(5, mainBuffer->GetSize().Height());
+
+            Log::Comment(L"The alternate buffer starts out blank, with the cursor at the origin, and has no scrollback.");
+            term.Write(L"\x1b[?1049h");
+            const auto* const altBuffer = &term.GetTextBuffer();
+            VERIFY_ARE_NOT_EQUAL(mainBuffer, altBuffer);
+            VERIFY_ARE_EQUAL(3, altBuffer->GetSize().Height());
+            VERIFY_ARE_EQUAL(L"          ", altBuffer->GetRowByOffset(0).GetText());
+            VERIFY_ARE_EQUAL(COORD({ 0, 0 }), term.GetCursorPosition());
+
+            term.Write(L"alt");
+            VERIFY_ARE_EQUAL(L"alt       ", altBuffer->GetRowByOffset(0).GetText());
+
+            Log::Comment(L"The main buffer comes back the way it was left.");
+            term.Write(L"\x1b[?1049l");
+            VERIFY_ARE_EQUAL(mainBuffer, &term.GetTextBuffer());
+            VERIFY_ARE_EQUAL(L"main      ", mainBuffer->GetRowByOffset(0).GetText());
+            VERIFY_ARE_EQUAL(COORD({ 1, 1 }), term.GetCursorPosition());
+
+            Log::Comment(L"Switching again reuses the same alternate buffer, cleared.");
+            term.Write(L"\x1b[?1049h");
+            VERIFY_ARE_EQUAL(altBuffer, &term.GetTextBuffer());
+            VERIFY_ARE_EQUAL(L"          ", altBuffer->GetRowByOffset(0).GetText());
+
+            Log::Comment(L"Resizing while in the alternate buffer resizes both.");
+            VERIFY_SUCCEEDED(term.UserResize({ 8, 4 }));
+            VERIFY_ARE_EQUAL(COORD({ 8, 4 }), altBuffer->GetSize().Dimensions());
+            VERIFY_ARE_EQUAL(COORD({ 8, 6 }), mainBuffer->GetSize().Dimensions());
+            term.Write(L"\x1b[?1049l");
+            VERIFY_ARE_EQUAL(L"main    ", mainBuffer->GetRowByOffset(0).GetText());
+        }
+    };
+}
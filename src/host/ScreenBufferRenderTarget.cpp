@@ -90,6 +90,16 @@ void ScreenBufferRenderTarget::TriggerScroll(const COORD* const pcoordDelta)
     }
 }
 
+void ScreenBufferRenderTarget::TriggerScrollRegion(const Microsoft::Console::Types::Viewport& region, const short sDelta)
+{
+    auto* pRenderer = ServiceLocator::LocateGlobals().pRender;
+    const auto* pActive = &ServiceLocator::LocateGlobals().getConsoleInformation().GetActiveOutputBuffer().GetActiveBuffer();
+    if (pRenderer != nullptr && pActive == &_owner)
+    {
+        pRenderer->TriggerScrollRegion(region, sDelta);
+    }
+}
+
 void ScreenBufferRenderTarget::TriggerCircling()
 {
     auto* pRenderer = ServiceLocator::LocateGlobals().pRender;
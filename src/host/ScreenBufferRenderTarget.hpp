@@ -37,6 +37,7 @@ public:
     void TriggerSelection() override;
     void TriggerScroll() override;
     void TriggerScroll(const COORD* const pcoordDelta) override;
+    void TriggerScrollRegion(const Microsoft::Console::Types::Viewport& region, const short sDelta) override;
     void TriggerCircling() override;
     void TriggerTitleChange() override;
 
@@ -11,6 +11,7 @@
 #include "outputStream.hpp" // For ConhostInternalGetSet
 #include "../terminal/adapter/InteractDispatch.hpp"
 #include "../types/inc/convert.hpp"
+#include "../types/inc/PerfMetrics.hpp"
 #include "server.h"
 #include "output.h"
 #include "handle.h"
@@ -30,7 +31,8 @@ VtInputThread::VtInputThread(_In_ wil::unique_hfile hPipe,
     _utf8Parser{ CP_UTF8 },
     _dwThreadId{ 0 },
     _exitRequested{ false },
-    _exitResult{ S_OK }
+    _exitResult{ S_OK },
+    _pDispatch{ nullptr }
 {
     THROW_HR_IF(E_HANDLE, _hFile.get() == INVALID_HANDLE_VALUE);
 
@@ -39,7 +41,11 @@ VtInputThread::VtInputThread(_In_ wil::unique_hfile hPipe,
     auto pGetSet = std::make_unique<ConhostInternalGetSet>(gci);
     THROW_IF_NULL_ALLOC(pGetSet.get());
 
-    auto engine = std::make_unique<InputStateMachineEngine>(new InteractDispatch(pGetSet.release()), inheritCursor);
+    auto dispatch = std::make_unique<_LockOnUseDispatch>(std::make_unique<InteractDispatch>(pGetSet.release()));
+    THROW_IF_NULL_ALLOC(dispatch.get());
+
+    _pDispatch = dispatch.get();
+    auto engine = std::make_unique<InputStateMachineEngine>(dispatch.release(), inheritCursor);
     THROW_IF_NULL_ALLOC(engine.get());
 
     _pInputStateMachine = std::make_unique<StateMachine>(engine.release());
@@ -58,25 +64,34 @@ VtInputThread::VtInputThread(_In_ wil::unique_hfile hPipe,
 [[nodiscard]]
 HRESULT VtInputThread::_HandleRunInput(_In_reads_(cch) const byte* const charBuffer, const int cch)
 {
-    // Make sure to call the GLOBAL Lock/Unlock, not the gci's lock/unlock.
-    // Only the global unlock attempts to dispatch ctrl events. If you use the
-    //      gci's unlock, when you press C-c, it won't be dispatched until the
-    //      next console API call. For something like `powershell sleep 60`,
-    //      that won't happen for 60s
-    LockConsole();
-    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
-
+    // The utf-8 parser and the state machine belong to this thread, so the
+    //      input is decoded and parsed without the console lock. The keys the
+    //      state machine writes are posted to the input buffer, and the lock
+    //      is only taken by the dispatches that need the console's state, and
+    //      to hand the posted keys to readers all at once when we're done
+    //      with this input, instead of waking them up for every key.
+    std::unique_ptr<wchar_t[]> pwsSequence;
+    unsigned int cchSequence;
     try
     {
-        std::unique_ptr<wchar_t[]> pwsSequence;
         unsigned int cchConsumed;
-        unsigned int cchSequence;
         auto hr = _utf8Parser.Parse(charBuffer, cch, cchConsumed, pwsSequence, cchSequence);
         // If we hit a parsing error, eat it. It's bad utf-8, we can't do anything with it.
         if (FAILED(hr))
         {
             return S_FALSE;
         }
+    }
+    CATCH_RETURN();
+
+    auto Flush = wil::scope_exit([&] {
+        _pDispatch->Lock();
+        ServiceLocator::LocateGlobals().getConsoleInformation().GetActiveInputBuffer()->FlushPostedInput();
+        _pDispatch->EndRun();
+    });
+
+    try
+    {
         _pInputStateMachine->ProcessString(pwsSequence.get(), cchSequence);
     }
     CATCH_RETURN();
@@ -84,6 +99,112 @@ HRESULT VtInputThread::_HandleRunInput(_In_reads_(cch) const byte* const charBuf
     return S_OK;
 }
 
+VtInputThread::_LockOnUseDispatch::_LockOnUseDispatch(std::unique_ptr<VirtualTerminal::IInteractDispatch> dispatch) noexcept :
+    _dispatch{ std::move(dispatch) },
+    _locked{ false },
+    _codepage{}
+{
+}
+
+// Method Description:
+// - Posts the records to the input buffer. The console lock isn't needed.
+bool VtInputThread::_LockOnUseDispatch::WriteInput(const gsl::span<const INPUT_RECORD> inputRecords)
+{
+    return _dispatch->WriteInput(inputRecords);
+}
+
+bool VtInputThread::_LockOnUseDispatch::WriteCtrlC()
+{
+    Lock();
+    return _dispatch->WriteCtrlC();
+}
+
+// Method Description:
+// - Converts the string to keystrokes and posts them to the input buffer. The
+//      console lock is only taken to read the output codepage, once per run.
+// Arguments:
+// - pws: a string to write to the console.
+// - cch: the number of chars in pws.
+// Return Value:
+// True if handled successfully. False otherwise.
+bool VtInputThread::_LockOnUseDispatch::WriteString(_In_reads_(cch) const wchar_t* const pws, const size_t cch)
+{
+    if (cch == 0)
+    {
+        return true;
+    }
+
+    if (!_codepage.has_value())
+    {
+        LockConsole();
+        _codepage = ServiceLocator::LocateGlobals().getConsoleInformation().OutputCP;
+        UnlockConsole();
+    }
+
+    std::vector<INPUT_RECORD> keyRecords;
+    keyRecords.reserve(cch * 2);
+    for (size_t i = 0; i < cch; ++i)
+    {
+        const std::deque<std::unique_ptr<KeyEvent>> convertedEvents = CharToKeyEvents(pws[i], _codepage.value());
+        for (const auto& keyEvent : convertedEvents)
+        {
+            keyRecords.push_back(keyEvent->ToInputRecord());
+        }
+    }
+    return WriteInput(keyRecords);
+}
+
+bool VtInputThread::_LockOnUseDispatch::WriteTextRun(_In_reads_(cch) const wchar_t* const pws, const size_t cch)
+{
+    Lock();
+    return _dispatch->WriteTextRun(pws, cch);
+}
+
+bool VtInputThread::_LockOnUseDispatch::WindowManipulation(const VirtualTerminal::DispatchTypes::WindowManipulationType uiFunction,
+                                                          _In_reads_(cParams) const unsigned short* const rgusParams,
+                                                          const size_t cParams)
+{
+    Lock();
+    return _dispatch->WindowManipulation(uiFunction, rgusParams, cParams);
+}
+
+bool VtInputThread::_LockOnUseDispatch::MoveCursor(const unsigned int row, const unsigned int col)
+{
+    Lock();
+    return _dispatch->MoveCursor(row, col);
+}
+
+// Method Description:
+// - Takes the console lock, if it isn't held already, and holds it until the
+//      end of the run of input.
+// Note:
+// - Make sure to call the GLOBAL Lock/Unlock, not the gci's lock/unlock.
+//      Only the global unlock attempts to dispatch ctrl events. If you use the
+//      gci's unlock, when you press C-c, it won't be dispatched until the
+//      next console API call. For something like `powershell sleep 60`,
+//      that won't happen for 60s
+void VtInputThread::_LockOnUseDispatch::Lock() noexcept
+{
+    if (!_locked)
+    {
+        LockConsole();
+        _locked = true;
+    }
+}
+
+// Method Description:
+// - Releases the console lock if a dispatch took it, and forgets the output
+//      codepage, since it may change before the next run of input.
+void VtInputThread::_LockOnUseDispatch::EndRun() noexcept
+{
+    if (_locked)
+    {
+        _locked = false;
+        UnlockConsole();
+    }
+    _codepage.reset();
+}
+
 // Function Description:
 // - Static function used for initializing an instance's ThreadProc.
 // Arguments:
@@ -121,6 +242,9 @@ void VtInputThread::DoReadInput(const bool throwOnFail)
         return;
     }
 
+    static auto& s_inputBytes = Metrics::MetricsRegistry::Instance().GetCounter(Metrics::Names::InputBytes);
+    s_inputBytes.Add(dwRead);
+
     HRESULT hr = _HandleRunInput(buffer, dwRead);
     if (FAILED(hr))
     {
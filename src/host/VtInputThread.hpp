@@ -15,6 +15,7 @@ Author(s):
 #pragma once
 
 #include "..\terminal\parser\StateMachine.hpp"
+#include "..\terminal\adapter\IInteractDispatch.hpp"
 #include "utf8ToWideCharParser.hpp"
 
 namespace Microsoft::Console
@@ -30,6 +31,33 @@ namespace Microsoft::Console
         void DoReadInput(const bool throwOnFail);
 
     private:
+        // Hands the keys the state machine writes to the input buffer without
+        //      taking the console lock, and only takes it, once per run of
+        //      input, for the dispatches that need the console's state.
+        class _LockOnUseDispatch final : public VirtualTerminal::IInteractDispatch
+        {
+        public:
+            _LockOnUseDispatch(std::unique_ptr<VirtualTerminal::IInteractDispatch> dispatch) noexcept;
+
+            bool WriteInput(const gsl::span<const INPUT_RECORD> inputRecords) override;
+            bool WriteCtrlC() override;
+            bool WriteString(_In_reads_(cch) const wchar_t* const pws, const size_t cch) override;
+            bool WriteTextRun(_In_reads_(cch) const wchar_t* const pws, const size_t cch) override;
+            bool WindowManipulation(const VirtualTerminal::DispatchTypes::WindowManipulationType uiFunction,
+                                    _In_reads_(cParams) const unsigned short* const rgusParams,
+                                    const size_t cParams) override;
+            bool MoveCursor(const unsigned int row, const unsigned int col) override;
+
+            void Lock() noexcept;
+            void EndRun() noexcept;
+
+        private:
+            std::unique_ptr<VirtualTerminal::IInteractDispatch> _dispatch;
+            bool _locked;
+            // The output codepage, read once per run.
+            std::optional<unsigned int> _codepage;
+        };
+
         [[nodiscard]]
         HRESULT _HandleRunInput(_In_reads_(cch) const byte* const charBuffer, const int cch);
         DWORD _InputThread();
@@ -42,6 +70,8 @@ namespace Microsoft::Console
         HRESULT _exitResult;
 
         std::unique_ptr<StateMachine> _pInputStateMachine;
+        // Owned by the state machine's engine.
+        _LockOnUseDispatch* _pDispatch;
         Utf8ToWideCharParser _utf8Parser;
     };
 }
@@ -19,11 +19,13 @@
 #include "../types/inc/convert.hpp"
 #include "../types/inc/GlyphWidth.hpp"
 #include "../types/inc/Viewport.hpp"
+#include "../types/inc/PerfMetrics.hpp"
 
 #include "..\interactivity\inc\ServiceLocator.hpp"
 
 #pragma hdrstop
 using namespace Microsoft::Console::Types;
+using namespace Microsoft::Console::Metrics;
 
 // Used by WriteCharsLegacy.
 #define IS_GLYPH_CHAR(wch)   (((wch) < L' ') || ((wch) == 0x007F))
@@ -403,6 +405,27 @@ NTSTATUS WriteCharsLegacy(SCREEN_INFORMATION& screenInfo,
         wchar_t* LocalBufPtr = LocalBuffer;
         while (*pcb < BufferSize && i < LOCAL_BUFFER_SIZE && XPosition < coordScreenBufferSize.X)
         {
+            // Most output is narrow printable text, which is copied as is. Copy as much
+            // of it as fits in one go, rather than checking it a char at a time below.
+            {
+                const size_t cchFits = std::min({ (BufferSize - *pcb) / sizeof(WCHAR),
+                                                  LOCAL_BUFFER_SIZE - i,
+                                                  static_cast<size_t>(coordScreenBufferSize.X - XPosition) });
+                const size_t cchRun = GetGlyphNarrowRunLength({ lpString, cchFits });
+                if (cchRun > 0)
+                {
+                    std::copy_n(lpString, cchRun, LocalBufPtr);
+                    LocalBufPtr += cchRun;
+                    XPosition += gsl::narrow_cast<SHORT>(cchRun);
+                    i += cchRun;
+                    pwchBuffer += cchRun;
+                    lpString += cchRun;
+                    pwchRealUnicode += cchRun;
+                    *pcb += cchRun * sizeof(WCHAR);
+                    continue;
+                }
+            }
+
 #pragma prefast(suppress:26019, "Buffer is taken in multiples of 2. Validation is ok.")
             const wchar_t Char = *lpString;
             const wchar_t RealUnicodeChar = *pwchRealUnicode;
@@ -1034,6 +1057,10 @@ NTSTATUS DoWriteConsole(_In_reads_bytes_(*pcbBuffer) PWCHAR pwchBuffer,
         return CONSOLE_STATUS_WAIT;
     }
 
+    static auto& s_outputBytes = MetricsRegistry::Instance().GetCounter(Names::OutputBytes);
+    s_outputBytes.Add(*pcbBuffer);
+    UnpaintedOutput().Begin();
+
     const auto& textBuffer = screenInfo.GetTextBuffer();
     return WriteChars(screenInfo,
                       pwchBuffer,
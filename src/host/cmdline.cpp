@@ -574,19 +574,20 @@ void CommandLine::_setPromptToNewestCommand(COOKED_READ_DATA& cookedReadData)
 // - cookedReadData - The cooked read data to operate on
 void CommandLine::DeletePromptAfterCursor(COOKED_READ_DATA& cookedReadData) noexcept
 {
-    DeleteCommandLine(cookedReadData, false);
+    // The text before the cursor stays where it is, so only the rest is blanked out.
+    std::wstring before;
+    try
+    {
+        before.assign(cookedReadData.BufferStartPtr(), cookedReadData.BytesRead() / sizeof(WCHAR));
+    }
+    CATCH_LOG();
+
     cookedReadData.BytesRead() = cookedReadData.InsertionPoint() * sizeof(WCHAR);
     if (cookedReadData.IsEchoInput())
     {
-        FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      &cookedReadData.BytesRead(),
-                                                      &cookedReadData.VisibleCharCount(),
-                                                      cookedReadData.OriginalCursorPosition().X,
-                                                      WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_ECHO,
-                                                      nullptr));
+        SHORT ScrollY = 0;
+        FAIL_FAST_IF_NTSTATUS_FAILED(cookedReadData.EchoChangedTail(before, cookedReadData.InsertionPoint(), ScrollY));
+        cookedReadData.OriginalCursorPosition().Y += ScrollY;
     }
 }
 
@@ -1073,9 +1074,13 @@ COORD CommandLine::DeleteFromRightOfCursor(COOKED_READ_DATA& cookedReadData) noe
 
     if (!cookedReadData.AtEol())
     {
-        // Delete commandline.
-#pragma prefast(suppress:__WARNING_BUFFER_OVERFLOW, "Not sure why prefast is getting confused here")
-        DeleteCommandLine(cookedReadData, false);
+        // Only the text from the cursor on changes, so only that is written again.
+        std::wstring before;
+        try
+        {
+            before.assign(cookedReadData.BufferStartPtr(), cookedReadData.BytesRead() / sizeof(WCHAR));
+        }
+        CATCH_LOG();
 
         // Delete char.
         cookedReadData.BytesRead() -= sizeof(WCHAR);
@@ -1091,15 +1096,10 @@ COORD CommandLine::DeleteFromRightOfCursor(COOKED_READ_DATA& cookedReadData) noe
         // Write commandline.
         if (cookedReadData.IsEchoInput())
         {
-            FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          &cookedReadData.BytesRead(),
-                                                          &cookedReadData.VisibleCharCount(),
-                                                          cookedReadData.OriginalCursorPosition().X,
-                                                          WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_ECHO,
-                                                          nullptr));
+            SHORT ScrollY = 0;
+            FAIL_FAST_IF_NTSTATUS_FAILED(cookedReadData.EchoChangedTail(before, cookedReadData.InsertionPoint(), ScrollY));
+            cookedReadData.OriginalCursorPosition().Y += ScrollY;
+            cursorPosition.Y += ScrollY;
         }
 
         // restore cursor position
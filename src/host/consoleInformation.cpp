@@ -10,6 +10,28 @@
 
 #include "..\interactivity\inc\ServiceLocator.hpp"
 #include "..\types\inc\convert.hpp"
+#include "..\types\inc\PerfMetrics.hpp"
+
+using namespace Microsoft::Console::Metrics;
+
+namespace
+{
+    // Lets LockAndMeasureWait take the console's critical section.
+    struct CriticalSectionLock
+    {
+        CRITICAL_SECTION& cs;
+
+        bool try_lock() noexcept
+        {
+            return !!TryEnterCriticalSection(&cs);
+        }
+
+        void lock() noexcept
+        {
+            EnterCriticalSection(&cs);
+        }
+    };
+}
 
 CONSOLE_INFORMATION::CONSOLE_INFORMATION() :
     // ProcessHandleList initializes itself
@@ -57,7 +79,11 @@ bool CONSOLE_INFORMATION::IsConsoleLocked() const
 #pragma prefast(suppress:26135, "Adding lock annotation spills into entire project. Future work.")
 void CONSOLE_INFORMATION::LockConsole()
 {
-    EnterCriticalSection(&_csConsoleLock);
+    static auto& s_waits = MetricsRegistry::Instance().GetHistogram(Names::ConsoleLockWaitMicroseconds);
+    static auto& s_uncontended = MetricsRegistry::Instance().GetCounter(Names::ConsoleLockUncontended);
+
+    CriticalSectionLock lock{ _csConsoleLock };
+    LockAndMeasureWait(lock, s_waits, s_uncontended);
 }
 
 #pragma prefast(suppress:26135, "Adding lock annotation spills into entire project. Future work.")
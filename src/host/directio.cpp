@@ -396,10 +396,10 @@ HRESULT ApiRoutines::ReadConsoleInputWImpl(IConsoleInputObject& context,
 }
 
 // Routine Description:
-// - Writes events to the input buffer
+// - Writes records to the input buffer
 // Arguments:
 // - context - the input buffer to write to
-// - events - the events to written
+// - records - the records to written
 // - written  - on output, the number of events written
 // - append - true if events should be written to the end of the input
 // buffer, false if they should be written to the front
@@ -407,7 +407,7 @@ HRESULT ApiRoutines::ReadConsoleInputWImpl(IConsoleInputObject& context,
 // - HRESULT indicating success or failure
 [[nodiscard]]
 static HRESULT _WriteConsoleInputWImplHelper(InputBuffer& context,
-                                             std::deque<std::unique_ptr<IInputEvent>>& events,
+                                             const gsl::span<const INPUT_RECORD> records,
                                              size_t& written,
                                              const bool append) noexcept
 {
@@ -415,14 +415,18 @@ static HRESULT _WriteConsoleInputWImplHelper(InputBuffer& context,
     {
         written = 0;
 
+        // Records are stored as they are, so anything that isn't an event
+        // is rejected here, before any of them are.
+        RETURN_HR_IF(E_INVALIDARG, !std::all_of(records.begin(), records.end(), InputBuffer::s_IsValidRecord));
+
         // add to InputBuffer
         if (append)
         {
-            written = context.Write(events);
+            written = context.Write(records);
         }
         else
         {
-            written = context.Prepend(events);
+            written = context.Prepend(records);
         }
 
         return S_OK;
@@ -431,10 +435,10 @@ static HRESULT _WriteConsoleInputWImplHelper(InputBuffer& context,
 }
 
 // Routine Description:
-// - Writes events to the input buffer already formed into IInputEvents (private call)
+// - Writes events to the input buffer already formed into INPUT_RECORDs (private call)
 // Arguments:
 // - context - the input buffer to write to
-// - events - the events to written
+// - records - the records to written
 // - written  - on output, the number of events written
 // - append - true if events should be written to the end of the input
 // buffer, false if they should be written to the front
@@ -442,11 +446,34 @@ static HRESULT _WriteConsoleInputWImplHelper(InputBuffer& context,
 // - HRESULT indicating success or failure
 [[nodiscard]]
 HRESULT DoSrvPrivateWriteConsoleInputW(_Inout_ InputBuffer* const pInputBuffer,
-                                       _Inout_ std::deque<std::unique_ptr<IInputEvent>>& events,
+                                       const gsl::span<const INPUT_RECORD> records,
                                        _Out_ size_t& eventsWritten,
                                        const bool append) noexcept
 {
-    return _WriteConsoleInputWImplHelper(*pInputBuffer, events, eventsWritten, append);
+    return _WriteConsoleInputWImplHelper(*pInputBuffer, records, eventsWritten, append);
+}
+
+// Routine Description:
+// - Writes a run of text to the end of the input buffer (private call)
+// Arguments:
+// - pInputBuffer - the input buffer to write to
+// - text - the text to write
+// - charsWritten - on output, the number of characters written
+// Return Value:
+// - HRESULT indicating success or failure
+[[nodiscard]]
+HRESULT DoSrvPrivateWriteConsoleInputText(_Inout_ InputBuffer* const pInputBuffer,
+                                          const std::wstring_view text,
+                                          _Out_ size_t& charsWritten) noexcept
+{
+    charsWritten = 0;
+
+    try
+    {
+        charsWritten = pInputBuffer->WriteText(text);
+        return S_OK;
+    }
+    CATCH_RETURN();
 }
 
 // Routine Description:
@@ -489,7 +516,8 @@ HRESULT ApiRoutines::WriteConsoleInputAImpl(InputBuffer& context,
             context.StoreWritePartialByteSequence(std::move(partialEvent));
         }
 
-        return _WriteConsoleInputWImplHelper(context, events, written, append);
+        const std::vector<INPUT_RECORD> records = IInputEvent::ToInputRecords(events);
+        return _WriteConsoleInputWImplHelper(context, records, written, append);
     }
     CATCH_RETURN();
 }
@@ -517,9 +545,8 @@ HRESULT ApiRoutines::WriteConsoleInputWImpl(InputBuffer& context,
 
     try
     {
-        auto events = IInputEvent::Create(buffer);
-
-        return _WriteConsoleInputWImplHelper(context, events, written, append);
+        // Unicode records go into the input buffer as they are, with no conversion.
+        return _WriteConsoleInputWImplHelper(context, gsl::make_span(buffer.data(), buffer.size()), written, append);
     }
     CATCH_RETURN();
 }
@@ -851,44 +878,23 @@ static HRESULT _ReadConsoleOutputWImplHelper(const SCREEN_INFORMATION& context,
         // The final "request rectangle" or the area inside the buffer we want to read, is the clipped dimensions.
         const auto clippedRequestRectangle = Viewport::FromExclusive(clip);
 
-        // We will start reading the buffer at the point of the top left corner (origin) of the (potentially adjusted) request
-        const auto sourcePoint = clippedRequestRectangle.Origin();
-
-        // Get an iterator to the beginning of the return buffer
-        // We might have to seek this forward or skip around if we clipped the request.
-        auto targetIter = targetBuffer.begin();
-        COORD targetPos = { 0 };
-        const auto targetLimit = Viewport::FromDimensions(targetPoint, clippedRequestRectangle.Dimensions());
-
-        // Get an iterator to the beginning of the request inside the screen buffer
-        // This should walk exactly along every cell of the clipped request.
-        auto sourceIter = storageBuffer.GetCellDataAt(sourcePoint, clippedRequestRectangle);
-
-        // Walk through every cell of the target, advancing the buffer.
-        // Validate that we always still have a valid iterator to the backgin store,
-        // that we always are writing inside the user's buffer (before the end)
-        // and we're always targeting the user's buffer inside its original bounds.
-        while (sourceIter && targetIter < targetBuffer.end())
+        // Convert every row of the request straight out of the buffer's storage into the user's buffer.
+        // If we clipped the request, the rows go in offset by as much as we clipped off the top and left.
+        if (clippedRequestRectangle.Width() > 0 && clippedRequestRectangle.Height() > 0)
         {
-            // If the point we're trying to write is inside the limited buffer write zone...
-            if (targetLimit.IsInBounds(targetPos))
-            {
-                // Copy the data into position...
-                *targetIter = gci.AsCharInfo(*sourceIter);
-                // ... and advance the read iterator.
-                sourceIter++;
-            }
-
-            // Always advance the write iterator, we might have skipped it due to clipping.
-            targetIter++;
-
-            // Increment the target
-            targetPos.X++;
-            if (targetPos.X >= targetSize.X)
-            {
-                targetPos.X = 0;
-                targetPos.Y++;
-            }
+            ptrdiff_t targetOffset;
+            RETURN_IF_FAILED(PtrdiffTMult(targetPoint.Y, targetSize.X, &targetOffset));
+            RETURN_IF_FAILED(PtrdiffTAdd(targetOffset, targetPoint.X, &targetOffset));
+            RETURN_HR_IF(E_INVALIDARG, targetOffset > targetBuffer.size());
+
+            storageBuffer.GetTextBuffer().ReadCharInfos(clippedRequestRectangle,
+                                                        targetBuffer.subspan(targetOffset),
+                                                        targetSize.X,
+                                                        [&](const TextAttribute& attr) {
+                                                            // If the attributes aren't legacy attributes, then use gci to
+                                                            // look up the nearest legacy attributes to report instead.
+                                                            return gci.GenerateLegacyAttributes(attr);
+                                                        });
         }
 
         // Reply with the region we read out of the backing buffer (potentially clipped)
@@ -1017,34 +1023,23 @@ static HRESULT _WriteConsoleOutputWImplHelper(SCREEN_INFORMATION& context,
 
         const auto writeRectangle = Viewport::FromInclusive(writeRegion);
 
-        auto target = writeRectangle.Origin();
-
-        // For every row in the request, create a view into the clamped portion of just the one line to write.
-        // This allows us to restrict the width of the call without allocating/copying any memory by just making
-        // a smaller view over the existing big blob of data from the original call.
-        for (; target.Y < writeRectangle.BottomExclusive(); target.Y++)
-        {
-            // We find the offset into the original buffer by the dimensions of the original request rectangle.
-            ptrdiff_t rowOffset = 0;
-            RETURN_IF_FAILED(PtrdiffTSub(target.Y, requestRectangle.Top(), &rowOffset));
-            RETURN_IF_FAILED(PtrdiffTMult(rowOffset, requestRectangle.Width(), &rowOffset));
-
-            ptrdiff_t colOffset = 0;
-            RETURN_IF_FAILED(PtrdiffTSub(target.X, requestRectangle.Left(), &colOffset));
+        // We find where the first row to write starts in the original buffer by the dimensions of the original
+        // request rectangle. Every row after it is one request width further along, and the buffer converts
+        // just as much of each as fits straight into its storage, without making a copy of any of it first.
+        ptrdiff_t rowOffset = 0;
+        RETURN_IF_FAILED(PtrdiffTSub(writeRectangle.Top(), requestRectangle.Top(), &rowOffset));
+        RETURN_IF_FAILED(PtrdiffTMult(rowOffset, requestRectangle.Width(), &rowOffset));
 
-            ptrdiff_t totalOffset = 0;
-            RETURN_IF_FAILED(PtrdiffTAdd(rowOffset, colOffset, &totalOffset));
+        ptrdiff_t colOffset = 0;
+        RETURN_IF_FAILED(PtrdiffTSub(writeRectangle.Left(), requestRectangle.Left(), &colOffset));
 
-            // Now we make a subspan starting from that offset for as much of the original request as would fit
-            const auto subspan = buffer.subspan(totalOffset, writeRectangle.Width());
+        ptrdiff_t totalOffset = 0;
+        RETURN_IF_FAILED(PtrdiffTAdd(rowOffset, colOffset, &totalOffset));
+        RETURN_HR_IF(E_INVALIDARG, totalOffset > buffer.size());
 
-            // Convert to a CHAR_INFO view to fit into the iterator
-            const auto charInfos = std::basic_string_view<CHAR_INFO>(subspan.data(), subspan.size());
-
-            // Make the iterator and write to the target position.
-            OutputCellIterator it(charInfos);
-            storageBuffer.Write(it, target);
-        }
+        storageBuffer.GetTextBuffer().WriteCharInfos(writeRectangle,
+                                                     buffer.subspan(totalOffset),
+                                                     requestRectangle.Width());
 
         // Since we've managed to write part of the request, return the clamped part that we actually used.
         writtenRectangle = writeRectangle;
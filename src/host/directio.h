@@ -23,10 +23,15 @@ class SCREEN_INFORMATION;
 
 [[nodiscard]]
 HRESULT DoSrvPrivateWriteConsoleInputW(_Inout_ InputBuffer* const pInputBuffer,
-                                       _Inout_ std::deque<std::unique_ptr<IInputEvent>>& events,
+                                       const gsl::span<const INPUT_RECORD> records,
                                        _Out_ size_t& eventsWritten,
                                        const bool append) noexcept;
 
+[[nodiscard]]
+HRESULT DoSrvPrivateWriteConsoleInputText(_Inout_ InputBuffer* const pInputBuffer,
+                                          const std::wstring_view text,
+                                          _Out_ size_t& charsWritten) noexcept;
+
 [[nodiscard]]
 NTSTATUS ConsoleCreateScreenBuffer(std::unique_ptr<ConsoleHandleData>& handle,
                                    _In_ PCONSOLE_API_MSG Message,
@@ -15,6 +15,7 @@
 
 #include "../types/inc/convert.hpp"
 #include "../types/inc/viewport.hpp"
+#include "../terminal/adapter/conGetSet.hpp"
 
 #include "ApiRoutines.h"
 
@@ -1651,6 +1652,55 @@ NTSTATUS DoSrvPrivateEraseAll(SCREEN_INFORMATION&  screenInfo)
     return NTSTATUS_FROM_HRESULT(screenInfo.GetActiveBuffer().VtEraseAll());
 }
 
+// Routine Description:
+// - A private API call for filling a rectangle of the screen buffer with one
+//      character and one attribute, as the VT erase operations do.
+// - Unlike a FillConsoleOutputCharacter/FillConsoleOutputAttribute pair per
+//      row, the whole rectangle is filled in one pass over the text buffer and
+//      repainted and reported to accessibility once.
+// Parameters:
+// - screenInfo - The screen buffer to fill. The fill applies to its active buffer.
+// - fill - The inclusive rectangle to fill. It's clipped to the buffer.
+// - wch - The character to fill with.
+// - attributes - The legacy attributes to fill with.
+// Return value:
+// - S_OK if we succeeded, otherwise the HRESULT of the failure.
+[[nodiscard]]
+HRESULT DoSrvPrivateFillRect(SCREEN_INFORMATION& screenInfo,
+                             const SMALL_RECT& fill,
+                             const wchar_t wch,
+                             const WORD attributes) noexcept
+{
+    try
+    {
+        auto& buffer = screenInfo.GetActiveBuffer();
+        const auto rect = Viewport::Intersect(buffer.GetBufferSize(), Viewport::FromInclusive(fill));
+        if (!rect.IsValid())
+        {
+            return S_OK;
+        }
+
+        // As in FillConsoleOutputAttributeImpl, RGB colors can't roundtrip
+        //      through the legacy attributes. If we're given the legacy
+        //      version of the current attributes, use the full version.
+        TextAttribute useThisAttr(attributes);
+        if (buffer.InVTMode())
+        {
+            const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+            if (gci.GenerateLegacyAttributes(buffer.GetAttributes()) == attributes)
+            {
+                useThisAttr = buffer.GetAttributes();
+            }
+        }
+
+        buffer.GetTextBuffer().FillRect(rect, wch, useThisAttr);
+        buffer.NotifyAccessibilityEventing(rect.Left(), rect.Top(), rect.RightInclusive(), rect.BottomInclusive());
+    }
+    CATCH_RETURN();
+
+    return S_OK;
+}
+
 void DoSrvSetCursorStyle(SCREEN_INFORMATION& screenInfo,
                          const CursorType cursorType)
 {
@@ -1691,6 +1741,32 @@ NTSTATUS DoSrvPrivateGetConsoleScreenBufferAttributes(_In_ const SCREEN_INFORMAT
     return Status;
 }
 
+// Routine Description:
+// - A private API call to get the cursor position, viewport, buffer size,
+//   attributes and scroll margins of the screen buffer.
+// - This is used as a performance optimization by the VT adapter, which needs
+//   these on nearly every sequence, instead of calling through the public API
+//   GetConsoleScreenBufferInfoEx, which also copies the color table and
+//   computes the maximum window size from the font and monitor.
+// - Like the public API, this reports on the active buffer, and the viewport is exclusive.
+// Parameters
+// - screenInfo - The screen buffer to retrieve the state of
+// - state - Receives the state of the screen buffer
+// Return Value:
+// - <none>
+void DoSrvPrivateGetScreenBufferState(const SCREEN_INFORMATION& screenInfo,
+                                      Microsoft::Console::VirtualTerminal::ScreenBufferState& state)
+{
+    const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    const SCREEN_INFORMATION& buffer = screenInfo.GetActiveBuffer();
+
+    state.dwSize = buffer.GetBufferSize().Dimensions();
+    state.dwCursorPosition = buffer.GetTextBuffer().GetCursor().GetPosition();
+    state.srWindow = buffer.GetViewport().ToExclusive();
+    state.wAttributes = gci.GenerateLegacyAttributes(buffer.GetAttributes());
+    state.srScrollMargins = buffer.AreMarginsSet() ? buffer.GetRelativeScrollMargins().ToInclusive() : SMALL_RECT{ 0 };
+}
+
 // Routine Description:
 // - A private API call for forcing the renderer to repaint the screen. If the
 //      input screen buffer is not the active one, then just do nothing. We only
@@ -17,6 +17,10 @@ Revision History:
 #pragma once
 #include "../inc/conattrs.hpp"
 class SCREEN_INFORMATION;
+namespace Microsoft::Console::VirtualTerminal
+{
+    struct ScreenBufferState;
+}
 
 
 void DoSrvPrivateSetLegacyAttributes(SCREEN_INFORMATION& screenInfo,
@@ -72,6 +76,11 @@ void DoSrvPrivateBoldText(SCREEN_INFORMATION& screenInfo, const bool bolded);
 
 [[nodiscard]]
 NTSTATUS DoSrvPrivateEraseAll(SCREEN_INFORMATION& screenInfo);
+[[nodiscard]]
+HRESULT DoSrvPrivateFillRect(SCREEN_INFORMATION& screenInfo,
+                             const SMALL_RECT& fill,
+                             const wchar_t wch,
+                             const WORD attributes) noexcept;
 
 void DoSrvSetCursorStyle(SCREEN_INFORMATION& screenInfo,
                          const CursorType cursorType);
@@ -82,6 +91,9 @@ void DoSrvSetCursorColor(SCREEN_INFORMATION& screenInfo,
 NTSTATUS DoSrvPrivateGetConsoleScreenBufferAttributes(const SCREEN_INFORMATION& screenInfo,
                                                       _Out_ WORD* const pwAttributes);
 
+void DoSrvPrivateGetScreenBufferState(const SCREEN_INFORMATION& screenInfo,
+                                      Microsoft::Console::VirtualTerminal::ScreenBufferState& state);
+
 void DoSrvPrivateRefreshWindow(const SCREEN_INFORMATION& screenInfo);
 
 void DoSrvGetConsoleOutputCodePage(_Out_ unsigned int* const pCodePage);
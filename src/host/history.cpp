@@ -30,6 +30,9 @@
 // for maintaining LRU, then this datatype can be changed.
 std::list<CommandHistory> CommandHistory::s_historyLists;
 
+std::unique_ptr<HistoryStore> CommandHistory::s_store;
+bool CommandHistory::s_storeOpened = false;
+
 CommandHistory* CommandHistory::s_Find(const HANDLE processHandle)
 {
     for (auto& historyList : s_historyLists)
@@ -55,6 +58,17 @@ void CommandHistory::s_Free(const HANDLE processHandle)
     {
         WI_ClearFlag(History->Flags, CLE_ALLOCATED);
         History->_processHandle = nullptr;
+
+        // The app won't be entering any more commands, so write out the ones
+        // still waiting rather than leave them for the next app to fill a batch.
+        if (s_store)
+        {
+            try
+            {
+                s_store->Flush();
+            }
+            CATCH_LOG();
+        }
     }
 }
 
@@ -88,6 +102,76 @@ void CommandHistory::_Reset()
     WI_SetFlag(Flags, CLE_RESET);
 }
 
+// Routine Description:
+// - Fills a history that was just given to an app with the newest commands
+//   the app entered in earlier sessions, if history is being persisted.
+// - Commands are added to the file every time they're entered, so if
+//   duplicates are being suppressed, only the newest copy of each is kept.
+void CommandHistory::_LoadPersisted()
+{
+    HistoryStore* const store = s_GetStore();
+    if (store)
+    {
+        try
+        {
+            const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+            const bool suppressDuplicates = WI_IsFlagSet(gci.Flags, CONSOLE_HISTORY_NODUP);
+            for (const auto& command : store->Load(_appName, gsl::narrow<size_t>(_maxCommands), suppressDuplicates))
+            {
+                _commands.push_back(command);
+            }
+            _Reset();
+        }
+        CATCH_LOG();
+    }
+}
+
+// Routine Description:
+// - Hands a command that was added to the history to the file that keeps it
+//   for later sessions, if history is being persisted.
+// Arguments:
+// - command - the command that was added
+void CommandHistory::_Persist(const std::wstring_view command) noexcept
+{
+    try
+    {
+        HistoryStore* const store = s_GetStore();
+        if (store)
+        {
+            store->Append(_appName, command);
+        }
+    }
+    CATCH_LOG();
+}
+
+// Routine Description:
+// - Returns the file that history is persisted to, opening it the first time
+//   it's asked for.
+// Return Value:
+// - The file, or nullptr if history isn't being persisted or the file
+//   couldn't be opened.
+HistoryStore* CommandHistory::s_GetStore()
+{
+    const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    if (!gci.GetPersistHistory())
+    {
+        return nullptr;
+    }
+
+    // Only try opening it once, so that a file that can't be opened doesn't
+    // cost every command the attempt.
+    if (!s_storeOpened)
+    {
+        s_storeOpened = true;
+        try
+        {
+            s_store = std::make_unique<HistoryStore>(HistoryStore::s_GetDefaultPath());
+        }
+        CATCH_LOG();
+    }
+    return s_store.get();
+}
+
 [[nodiscard]]
 HRESULT CommandHistory::Add(const std::wstring_view newCommand,
                             const bool suppressDuplicates)
@@ -121,7 +205,7 @@ HRESULT CommandHistory::Add(const std::wstring_view newCommand,
             // find free record.  if all records are used, free the lru one.
             if ((SHORT)_commands.size() == _maxCommands)
             {
-                _commands.erase(_commands.cbegin());
+                _commands.pop_front();
                 // move LastDisplayed back one in order to stay synced with the
                 // command it referred to before erasing the lru one
                 --LastDisplayed;
@@ -130,12 +214,13 @@ HRESULT CommandHistory::Add(const std::wstring_view newCommand,
             // add newCommand to array
             if (!reuse.empty())
             {
-                _commands.emplace_back(reuse);
+                _commands.push_back(reuse);
             }
             else
             {
-                _commands.emplace_back(newCommand);
+                _commands.push_back(newCommand);
             }
+            _Persist(newCommand);
 
             if (LastDisplayed == -1 ||
                 _commands.at(LastDisplayed).size() != newCommand.size() ||
@@ -279,13 +364,10 @@ void CommandHistory::Realloc(const size_t commands)
         return;
     }
 
-    const auto oldCommands = _commands;
-    const auto newNumberOfCommands = gsl::narrow<SHORT>(std::min(_commands.size(), commands));
-
-    _commands.clear();
-    for (SHORT i = 0; i < newNumberOfCommands; i++)
+    // The oldest commands are the ones that are kept.
+    while (_commands.size() > commands)
     {
-        _commands.emplace_back(oldCommands[i]);
+        _commands.pop_back();
     }
 
     WI_SetFlag(Flags, CLE_RESET);
@@ -367,6 +449,7 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
         History.LastDisplayed = -1;
         History._maxCommands = gsl::narrow<SHORT>(gci.GetHistoryBufferSize());
         History._processHandle = processHandle;
+        History._LoadPersisted();
         return &s_historyLists.emplace_front(History);
     }
     else if (!BestCandidate.has_value() && s_historyLists.size() > 0)
@@ -392,6 +475,7 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
             BestCandidate->_commands.clear();
             BestCandidate->LastDisplayed = -1;
             BestCandidate->_appName = appName;
+            BestCandidate->_LoadPersisted();
         }
 
         BestCandidate->_processHandle = processHandle;
@@ -472,7 +556,7 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
 
         if (iDel < iLast)
         {
-            _commands.erase(_commands.cbegin() + iDel);
+            _commands.erase(iDel);
             if ((iDisp > iDel) && (iDisp <= iLast))
             {
                 _Dec(iDisp);
@@ -481,7 +565,7 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
         }
         else if (iFirst <= iDel)
         {
-            _commands.erase(_commands.cbegin() + iDel);
+            _commands.erase(iDel);
             if ((iDisp >= iFirst) && (iDisp < iDel))
             {
                 _Inc(iDisp);
@@ -527,22 +611,19 @@ bool CommandHistory::FindMatchingCommand(const std::wstring_view givenCommand,
         return true;
     }
 
+    // An index that's out of range was never going to match anything.
+    if (indexFound < 0 || gsl::narrow_cast<size_t>(indexFound) >= _commands.size())
+    {
+        return false;
+    }
+
     try
     {
-        for (size_t i = 0; i < _commands.size(); i++)
+        const auto found = _commands.FindLatest(givenCommand, WI_IsFlagSet(options, MatchOptions::ExactMatch), indexFound);
+        if (found.has_value())
         {
-            const auto& storedCommand = _commands.at(indexFound);
-            if ((WI_IsFlagClear(options, MatchOptions::ExactMatch) && (givenCommand.size() <= storedCommand.size())) || (givenCommand.size() == storedCommand.size()))
-            {
-                if (std::equal(storedCommand.begin(), storedCommand.begin() + givenCommand.size(),
-                               givenCommand.begin(), givenCommand.end(),
-                               CaseInsensitiveEquality))
-                {
-                    return true;
-                }
-            }
-
-            _Prev(indexFound);
+            indexFound = gsl::narrow<SHORT>(found.value());
+            return true;
         }
     }
     CATCH_LOG();
@@ -564,7 +645,7 @@ void CommandHistory::s_ClearHistoryListStorage()
 // - indexB - index of one history item to swap
 void CommandHistory::Swap(const short indexA, const short indexB)
 {
-    std::swap(_commands.at(indexA), _commands.at(indexB));
+    _commands.swap(indexA, indexB);
 }
 
 // Routine Description:
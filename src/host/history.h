@@ -12,6 +12,9 @@ Abstract:
 
 #pragma once
 
+#include "historyRing.hpp"
+#include "historyStore.hpp"
+
 // CommandHistory Flags
 #define CLE_ALLOCATED 0x00000001
 #define CLE_RESET     0x00000002
@@ -77,6 +80,10 @@ public:
 
 private:
     void _Reset();
+    void _LoadPersisted();
+    void _Persist(const std::wstring_view command) noexcept;
+
+    static HistoryStore* s_GetStore();
 
     // _Next and _Prev go to the next and prev command
     // _Inc  and _Dec go to the next and prev slots
@@ -87,7 +94,7 @@ private:
     void _Inc(SHORT& ind) const;
 
 
-    std::vector<std::wstring> _commands;
+    HistoryRing _commands;
     SHORT _maxCommands;
 
     std::wstring _appName;
@@ -95,6 +102,10 @@ private:
 
     static std::list<CommandHistory> s_historyLists;
 
+    // The file commands are kept in between sessions, if that's turned on.
+    static std::unique_ptr<HistoryStore> s_store;
+    static bool s_storeOpened;
+
 public:
     DWORD Flags;
     SHORT LastDisplayed;
@@ -0,0 +1,302 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "historyRing.hpp"
+
+// Routine Description:
+// - Creates an empty ring. Nothing is allocated until the first command is stored.
+HistoryRing::HistoryRing() noexcept :
+    _entries{},
+    _head{ 0 },
+    _size{ 0 },
+    _nextSequence{ 0 },
+    _index{}
+{
+}
+
+// Routine Description:
+// - Returns the number of commands stored in the ring.
+size_t HistoryRing::size() const noexcept
+{
+    return _size;
+}
+
+// Routine Description:
+// - Returns true if there are no commands stored in the ring.
+bool HistoryRing::empty() const noexcept
+{
+    return _size == 0;
+}
+
+// Routine Description:
+// - Returns the command at the given position, counting from the oldest one.
+// Arguments:
+// - index - the position of the command
+// Return Value:
+// - The command.
+// Note:
+// - throws std::out_of_range if there's no command at that position
+const std::wstring& HistoryRing::at(const size_t index) const
+{
+    if (index >= _size)
+    {
+        throw std::out_of_range("HistoryRing index out of range");
+    }
+    return _At(index).command;
+}
+
+// Routine Description:
+// - Returns the newest command.
+// Note:
+// - throws std::out_of_range if the ring is empty
+const std::wstring& HistoryRing::back() const
+{
+    return at(_size - 1);
+}
+
+// Routine Description:
+// - Stores a command after the newest one.
+// Arguments:
+// - command - the command to store
+// Return Value:
+// - <none>
+// Note:
+// - will throw on allocation failure, in which case the ring is unchanged
+void HistoryRing::push_back(const std::wstring_view command)
+{
+    if (_size == _entries.size())
+    {
+        _Grow();
+    }
+
+    std::wstring stored{ command };
+    _index.emplace(s_Fold(command), _nextSequence);
+
+    _Entry& entry = _At(_size);
+    entry.command = std::move(stored);
+    entry.sequence = _nextSequence;
+
+    ++_nextSequence;
+    ++_size;
+}
+
+// Routine Description:
+// - Drops the oldest command. The ring must not be empty.
+void HistoryRing::pop_front()
+{
+    _Unindex(_At(0));
+    _At(0).command.clear();
+    _head = (_head + 1) & (_entries.size() - 1);
+    --_size;
+}
+
+// Routine Description:
+// - Drops the newest command. The ring must not be empty.
+void HistoryRing::pop_back()
+{
+    _Unindex(_At(_size - 1));
+    _At(_size - 1).command.clear();
+    --_size;
+}
+
+// Routine Description:
+// - Removes the command at the given position, keeping the order of the rest.
+// - The commands on whichever side of it is shorter are moved over to fill the gap.
+// Arguments:
+// - index - the position of the command to remove
+// Return Value:
+// - The command that was removed.
+// Note:
+// - throws std::out_of_range if there's no command at that position
+std::wstring HistoryRing::erase(const size_t index)
+{
+    std::wstring removed = at(index);
+    _Unindex(_At(index));
+
+    if (index < _size / 2)
+    {
+        for (size_t i = index; i > 0; --i)
+        {
+            _At(i) = std::move(_At(i - 1));
+        }
+        _At(0).command.clear();
+        _head = (_head + 1) & (_entries.size() - 1);
+    }
+    else
+    {
+        for (size_t i = index; i + 1 < _size; ++i)
+        {
+            _At(i) = std::move(_At(i + 1));
+        }
+        _At(_size - 1).command.clear();
+    }
+    --_size;
+
+    return removed;
+}
+
+// Routine Description:
+// - Exchanges the commands at two positions.
+// Arguments:
+// - indexA - the position of one command
+// - indexB - the position of the other command
+// Return Value:
+// - <none>
+// Note:
+// - throws std::out_of_range if there's no command at either position
+void HistoryRing::swap(const size_t indexA, const size_t indexB)
+{
+    at(indexA);
+    at(indexB);
+    if (indexA == indexB)
+    {
+        return;
+    }
+
+    _Entry& a = _At(indexA);
+    _Entry& b = _At(indexB);
+
+    // The entries keep their sequence numbers, since those follow the
+    // positions, and the commands swap between them.
+    _Unindex(a);
+    _Unindex(b);
+    std::swap(a.command, b.command);
+    _index.emplace(s_Fold(a.command), a.sequence);
+    _index.emplace(s_Fold(b.command), b.sequence);
+}
+
+// Routine Description:
+// - Removes all of the commands. The capacity is kept.
+void HistoryRing::clear() noexcept
+{
+    for (size_t i = 0; i < _size; ++i)
+    {
+        _At(i).command.clear();
+    }
+    _index.clear();
+    _head = 0;
+    _size = 0;
+}
+
+// Routine Description:
+// - Finds the newest command at or before the given position that matches,
+//   going around to the newest command of all if there's none before it.
+//   Matches ignore case.
+// Arguments:
+// - command - the text to look for
+// - exactMatch - true if the command has to be the whole text, rather than
+//   just start with it
+// - lastIndex - the position to start looking at. Must be less than size().
+// Return Value:
+// - The position of the matching command, or nullopt if none match.
+std::optional<size_t> HistoryRing::FindLatest(const std::wstring_view command,
+                                              const bool exactMatch,
+                                              const size_t lastIndex) const
+{
+    const auto key = s_Fold(command);
+    const uint64_t last = _At(lastIndex).sequence;
+
+    std::optional<uint64_t> before;
+    std::optional<uint64_t> newest;
+
+    // Every command with the same text is in one run of the index, in
+    // the order they were added. The runs of the different commands that
+    // start with the text are next to each other.
+    auto run = _index.lower_bound({ key, 0 });
+    while (run != _index.end() && run->first.compare(0, key.size(), key) == 0)
+    {
+        if (exactMatch && run->first.size() != key.size())
+        {
+            break;
+        }
+
+        const auto runEnd = _index.upper_bound({ run->first, UINT64_MAX });
+
+        const uint64_t runNewest = std::prev(runEnd)->second;
+        newest = std::max(newest.value_or(0), runNewest);
+
+        const auto after = _index.upper_bound({ run->first, last });
+        if (after != run)
+        {
+            before = std::max(before.value_or(0), std::prev(after)->second);
+        }
+
+        run = runEnd;
+    }
+
+    if (before.has_value())
+    {
+        return _IndexOf(before.value());
+    }
+    if (newest.has_value())
+    {
+        return _IndexOf(newest.value());
+    }
+    return std::nullopt;
+}
+
+std::wstring HistoryRing::s_Fold(const std::wstring_view command)
+{
+    std::wstring folded{ command };
+    std::transform(folded.begin(), folded.end(), folded.begin(), [](const wchar_t wch) {
+        return static_cast<wchar_t>(::towlower(wch));
+    });
+    return folded;
+}
+
+HistoryRing::_Entry& HistoryRing::_At(const size_t index) noexcept
+{
+    return _entries[(_head + index) & (_entries.size() - 1)];
+}
+
+const HistoryRing::_Entry& HistoryRing::_At(const size_t index) const noexcept
+{
+    return _entries[(_head + index) & (_entries.size() - 1)];
+}
+
+// Routine Description:
+// - Finds the position of the entry with the given sequence number, which
+//   must be stored. The sequence numbers only grow from the oldest entry to
+//   the newest, so it's a binary search.
+size_t HistoryRing::_IndexOf(const uint64_t sequence) const noexcept
+{
+    size_t low = 0;
+    size_t high = _size;
+    while (high - low > 1)
+    {
+        const size_t middle = low + (high - low) / 2;
+        if (_At(middle).sequence <= sequence)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+void HistoryRing::_Unindex(const _Entry& entry)
+{
+    _index.erase({ s_Fold(entry.command), entry.sequence });
+}
+
+// Routine Description:
+// - Moves the commands into storage twice the size, unwrapping them so that
+//   the oldest is at the start.
+// Note:
+// - will throw on allocation failure, in which case the ring is unchanged
+void HistoryRing::_Grow()
+{
+    std::vector<_Entry> newEntries(std::max(_entries.size() * 2, s_MinimumCapacity));
+    for (size_t i = 0; i < _size; ++i)
+    {
+        newEntries[i] = std::move(_At(i));
+    }
+
+    _entries.swap(newEntries);
+    _head = 0;
+}
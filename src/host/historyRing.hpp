@@ -0,0 +1,80 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- historyRing.hpp
+
+Abstract:
+- The commands of a CommandHistory, oldest first, with an index for finding
+  commands by their text.
+- Commands are stored in a ring, so that dropping the oldest command when the
+  history is full doesn't move the rest of them. The ring only allocates when
+  it needs to grow, doubling its capacity each time, so a history that's
+  allowed a lot of commands doesn't allocate room for all of them up front.
+- The index keeps every command sorted by its text, ignoring case, which
+  turns the lookups of F8 and of duplicate suppression into searches of the
+  commands that actually match, instead of compares against all of them.
+- The members are named after their std::vector counterparts, since that's
+  what this replaces.
+--*/
+
+#pragma once
+
+#include <set>
+
+class HistoryRing final
+{
+public:
+    HistoryRing() noexcept;
+
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    const std::wstring& at(const size_t index) const;
+    const std::wstring& back() const;
+
+    void push_back(const std::wstring_view command);
+    void pop_front();
+    void pop_back();
+    std::wstring erase(const size_t index);
+    void swap(const size_t indexA, const size_t indexB);
+    void clear() noexcept;
+
+    std::optional<size_t> FindLatest(const std::wstring_view command,
+                                     const bool exactMatch,
+                                     const size_t lastIndex) const;
+
+private:
+    struct _Entry
+    {
+        std::wstring command;
+
+        // Entries are numbered in the order they were added, so that the
+        // numbers keep the order of the entries even as the ones before
+        // them are dropped, and the index can refer to them.
+        uint64_t sequence;
+    };
+
+    // Every command folded to lower case, with the sequence number of its entry.
+    using _IndexKey = std::pair<std::wstring, uint64_t>;
+
+    // The capacity is always zero or a power of two, so that an offset from
+    // the head can be wrapped with a mask instead of a division.
+    std::vector<_Entry> _entries;
+    size_t _head;
+    size_t _size;
+    uint64_t _nextSequence;
+
+    std::set<_IndexKey> _index;
+
+    static constexpr size_t s_MinimumCapacity = 16;
+
+    static std::wstring s_Fold(const std::wstring_view command);
+
+    _Entry& _At(const size_t index) noexcept;
+    const _Entry& _At(const size_t index) const noexcept;
+    size_t _IndexOf(const uint64_t sequence) const noexcept;
+    void _Unindex(const _Entry& entry);
+    void _Grow();
+};
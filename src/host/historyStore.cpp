@@ -0,0 +1,334 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "historyStore.hpp"
+
+#include <unordered_set>
+
+// Routine Description:
+// - Opens the file history is kept in, creating it if it doesn't exist yet.
+// Arguments:
+// - path - The path of the file
+// Note:
+// - Throws if the file can't be opened, or if it isn't a history file.
+HistoryStore::HistoryStore(const std::wstring& path) :
+    _file{ CreateFileW(path.c_str(),
+                       GENERIC_READ | GENERIC_WRITE,
+                       FILE_SHARE_READ | FILE_SHARE_WRITE,
+                       nullptr,
+                       OPEN_ALWAYS,
+                       FILE_ATTRIBUTE_NORMAL,
+                       nullptr) },
+    _mapping{},
+    _view{},
+    _viewSize{ 0 },
+    _pending{}
+{
+    THROW_LAST_ERROR_IF(!_file);
+
+    // Whichever console gets to a new file first writes its header.
+    {
+        _Lock();
+        auto unlock = wil::scope_exit([&]() noexcept { _Unlock(); });
+
+        if (_GetFileSize() == 0)
+        {
+            const auto header = std::make_unique<_FileHeader>();
+            header->magic = s_FileMagic;
+            header->version = s_Version;
+            header->bucketCount = s_BucketCount;
+            _WriteAt(0, header.get(), sizeof(_FileHeader));
+        }
+    }
+
+    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_FILE_CORRUPT), !_Map(sizeof(_FileHeader)));
+
+    const auto header = reinterpret_cast<const _FileHeader*>(_view.get());
+    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_FILE_CORRUPT),
+                header->magic != s_FileMagic || header->version != s_Version || header->bucketCount != s_BucketCount);
+}
+
+// Routine Description:
+// - Writes out any commands that are still waiting to be, and closes the file.
+HistoryStore::~HistoryStore()
+{
+    try
+    {
+        Flush();
+    }
+    CATCH_LOG();
+}
+
+// Routine Description:
+// - Reads the newest commands that were entered in the given app, in this
+//   console or any other sharing the file.
+// Arguments:
+// - appName - The name of the app's exe. Case doesn't matter.
+// - count - The most commands to read
+// - skipDuplicates - If true, a command that was entered more than once is
+//   only read where it was entered last.
+// Return Value:
+// - The commands, oldest first.
+std::vector<std::wstring> HistoryStore::Load(const std::wstring_view appName, const size_t count, const bool skipDuplicates)
+{
+    std::vector<std::wstring> commands;
+    std::unordered_set<std::wstring_view> seen;
+    if (count == 0)
+    {
+        return commands;
+    }
+
+    // Write out the commands that are waiting, so they're found too.
+    Flush();
+
+    const uint64_t appHash = s_HashAppName(appName);
+    const auto header = reinterpret_cast<const _FileHeader*>(_view.get());
+    uint64_t offset = header->buckets[appHash % s_BucketCount];
+
+    while (offset != 0 && commands.size() < count)
+    {
+        const auto record = _RecordAt(offset);
+        if (record == nullptr)
+        {
+            break;
+        }
+
+        if (record->appHash == appHash)
+        {
+            // The newest copy of a command is found first, so that's the one kept.
+            const std::wstring_view command{ reinterpret_cast<const wchar_t*>(record + 1), record->length };
+            if (!skipDuplicates || seen.insert(command).second)
+            {
+                commands.emplace_back(command);
+            }
+        }
+
+        // Records only ever point back at ones written before them, so
+        // anything else isn't followed, rather than risk going in circles.
+        offset = record->previous < offset ? record->previous : 0;
+    }
+
+    std::reverse(commands.begin(), commands.end());
+    return commands;
+}
+
+// Routine Description:
+// - Adds a command to the end of the history of the given app. It's written
+//   out along with the rest of its batch, or on Flush.
+// Arguments:
+// - appName - The name of the app's exe. Case doesn't matter.
+// - command - The command that was entered
+// Return Value:
+// - <none>
+void HistoryStore::Append(const std::wstring_view appName, const std::wstring_view command)
+{
+    _pending.push_back({ s_HashAppName(appName), std::wstring{ command } });
+    if (_pending.size() >= s_BatchSize)
+    {
+        Flush();
+    }
+}
+
+// Routine Description:
+// - Appends the commands that are waiting to the file, and flushes it to disk.
+// Note:
+// - The records are written, and flushed to disk, before the buckets that
+//   point at them, so that neither another console nor the file left behind
+//   by a crash ever has a bucket pointing at records that aren't there.
+// - Throws if the file can't be written, in which case the commands are
+//   kept to try again.
+void HistoryStore::Flush()
+{
+    if (_pending.empty())
+    {
+        return;
+    }
+
+    _Lock();
+    auto unlock = wil::scope_exit([&]() noexcept { _Unlock(); });
+
+    // Start on a multiple of 8, in case a write was cut short by a crash.
+    const uint64_t end = (_GetFileSize() + 7) & ~7ull;
+
+    const auto header = reinterpret_cast<const _FileHeader*>(_view.get());
+    std::vector<uint64_t> buckets(std::begin(header->buckets), std::end(header->buckets));
+
+    std::vector<BYTE> records;
+    for (const auto& pending : _pending)
+    {
+        uint64_t& bucket = buckets.at(pending.appHash % s_BucketCount);
+
+        _RecordHeader record{};
+        record.magic = s_RecordMagic;
+        record.length = gsl::narrow<uint32_t>(pending.command.size());
+        record.appHash = pending.appHash;
+        record.previous = bucket;
+
+        const size_t start = records.size();
+        records.resize(start + gsl::narrow<size_t>(s_RecordSize(pending.command.size())));
+        memcpy(records.data() + start, &record, sizeof(record));
+        memcpy(records.data() + start + sizeof(record), pending.command.data(), pending.command.size() * sizeof(wchar_t));
+
+        bucket = end + start;
+    }
+
+    _WriteAt(end, records.data(), records.size());
+    THROW_IF_WIN32_BOOL_FALSE(FlushFileBuffers(_file.get()));
+    _WriteAt(offsetof(_FileHeader, buckets), buckets.data(), buckets.size() * sizeof(uint64_t));
+    THROW_IF_WIN32_BOOL_FALSE(FlushFileBuffers(_file.get()));
+
+    _pending.clear();
+}
+
+// Routine Description:
+// - Returns the path of the file history is kept in for the current user,
+//   creating the folder it goes in if it doesn't exist yet.
+std::wstring HistoryStore::s_GetDefaultPath()
+{
+    std::wstring path(MAX_PATH, UNICODE_NULL);
+    DWORD length = GetEnvironmentVariableW(L"LOCALAPPDATA", path.data(), gsl::narrow<DWORD>(path.size()));
+    if (length > path.size())
+    {
+        path.resize(length);
+        length = GetEnvironmentVariableW(L"LOCALAPPDATA", path.data(), gsl::narrow<DWORD>(path.size()));
+    }
+    THROW_LAST_ERROR_IF(length == 0 || length > path.size());
+    path.resize(length);
+
+    for (const auto folder : { L"\\Microsoft", L"\\Console" })
+    {
+        path += folder;
+        if (!CreateDirectoryW(path.c_str(), nullptr))
+        {
+            THROW_LAST_ERROR_IF(GetLastError() != ERROR_ALREADY_EXISTS);
+        }
+    }
+
+    path += L"\\CommandHistory.dat";
+    return path;
+}
+
+// Routine Description:
+// - Hashes the name of an app's exe, ignoring case, with 64-bit FNV-1a.
+uint64_t HistoryStore::s_HashAppName(const std::wstring_view appName) noexcept
+{
+    uint64_t hash = 0xCBF29CE484222325;
+    for (const wchar_t wch : appName)
+    {
+        hash ^= static_cast<uint16_t>(::towlower(wch));
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
+
+// Routine Description:
+// - Returns the size of a record holding a command of the given length,
+//   padding included.
+uint64_t HistoryStore::s_RecordSize(const uint64_t length) noexcept
+{
+    return (sizeof(_RecordHeader) + length * sizeof(wchar_t) + 7) & ~7ull;
+}
+
+uint64_t HistoryStore::_GetFileSize() const
+{
+    LARGE_INTEGER size{};
+    THROW_IF_WIN32_BOOL_FALSE(GetFileSizeEx(_file.get(), &size));
+    return size.QuadPart;
+}
+
+// Routine Description:
+// - Waits for any other console writing to the file to finish, and then
+//   keeps the rest out until _Unlock.
+void HistoryStore::_Lock()
+{
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(s_LockOffset);
+    overlapped.OffsetHigh = static_cast<DWORD>(s_LockOffset >> 32);
+    THROW_IF_WIN32_BOOL_FALSE(LockFileEx(_file.get(), LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped));
+}
+
+void HistoryStore::_Unlock() noexcept
+{
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(s_LockOffset);
+    overlapped.OffsetHigh = static_cast<DWORD>(s_LockOffset >> 32);
+    LOG_IF_WIN32_BOOL_FALSE(UnlockFileEx(_file.get(), 0, 1, 0, &overlapped));
+}
+
+void HistoryStore::_WriteAt(const uint64_t offset, const void* const data, const size_t size)
+{
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+    DWORD written = 0;
+    THROW_IF_WIN32_BOOL_FALSE(WriteFile(_file.get(), data, gsl::narrow<DWORD>(size), &written, &overlapped));
+    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_WRITE_FAULT), written != size);
+}
+
+// Routine Description:
+// - Makes sure the view of the file covers at least the given number of
+//   bytes, mapping the whole file again if it's grown since it was mapped.
+// - Writes to the file show up in the view without mapping it again, since
+//   they go through the same cache, so it's only needed to see past the end.
+// Arguments:
+// - size - The number of bytes from the start of the file that are needed
+// Return Value:
+// - True if the view covers them, or false if the file isn't that big.
+bool HistoryStore::_Map(const uint64_t size)
+{
+    if (size <= _viewSize)
+    {
+        return true;
+    }
+
+    const uint64_t fileSize = _GetFileSize();
+    if (size > fileSize)
+    {
+        return false;
+    }
+
+    _viewSize = 0;
+    _view.reset();
+    _mapping.reset(CreateFileMappingW(_file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+    THROW_LAST_ERROR_IF_NULL(_mapping.get());
+    _view.reset(static_cast<BYTE*>(MapViewOfFile(_mapping.get(), FILE_MAP_READ, 0, 0, 0)));
+    THROW_LAST_ERROR_IF_NULL(_view.get());
+    _viewSize = fileSize;
+    return true;
+}
+
+// Routine Description:
+// - Returns the record at the given offset, mapping more of the file if it's
+//   past the end of the view.
+// Arguments:
+// - offset - The offset of the record from the start of the file
+// Return Value:
+// - The record, followed by its command, or nullptr if there isn't a whole
+//   record there.
+// Note:
+// - The record is only good until the next time the file is mapped.
+const HistoryStore::_RecordHeader* HistoryStore::_RecordAt(const uint64_t offset)
+{
+    if (offset < sizeof(_FileHeader) || offset % alignof(_RecordHeader) != 0 ||
+        !_Map(offset + sizeof(_RecordHeader)))
+    {
+        return nullptr;
+    }
+
+    const auto record = reinterpret_cast<const _RecordHeader*>(_view.get() + static_cast<size_t>(offset));
+    if (record->magic != s_RecordMagic)
+    {
+        return nullptr;
+    }
+
+    if (!_Map(offset + s_RecordSize(record->length)))
+    {
+        return nullptr;
+    }
+
+    // Mapping again may have moved the view.
+    return reinterpret_cast<const _RecordHeader*>(_view.get() + static_cast<size_t>(offset));
+}
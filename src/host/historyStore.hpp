@@ -0,0 +1,100 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- historyStore.hpp
+
+Abstract:
+- Keeps command history in a file, so that the commands of an app are still
+  there the next time it's started, in this console or in another one.
+- The file is a log that commands are only ever appended to. It starts with a
+  small hash table of app names, whose buckets hold the offset of the newest
+  command of the apps in them, and every command holds the offset of the one
+  before it in the same bucket. Loading the newest commands of an app reads
+  just those commands (and the few of other apps that share the bucket), no
+  matter how long the log has grown.
+- The file is mapped into memory rather than read, so opening it costs the
+  same whatever its size, and only the pages that loads look at are read.
+- Appended commands are collected and written in batches, each followed by
+  one flush to disk, instead of flushing every command as it's entered.
+- Any number of consoles can share the file. Writers take turns on a lock
+  and append at whatever the end of the file is at the time.
+--*/
+
+#pragma once
+
+class HistoryStore final
+{
+public:
+    HistoryStore(const std::wstring& path);
+    ~HistoryStore();
+
+    HistoryStore(const HistoryStore&) = delete;
+    HistoryStore& operator=(const HistoryStore&) = delete;
+
+    std::vector<std::wstring> Load(const std::wstring_view appName, const size_t count, const bool skipDuplicates);
+    void Append(const std::wstring_view appName, const std::wstring_view command);
+    void Flush();
+
+    static std::wstring s_GetDefaultPath();
+
+private:
+    static constexpr uint32_t s_FileMagic = 0x54534843; // "CHST"
+    static constexpr uint32_t s_RecordMagic = 0x44524D43; // "CMRD"
+    static constexpr uint32_t s_Version = 1;
+    static constexpr size_t s_BucketCount = 1024;
+
+    // How many commands are collected before they're written out.
+    static constexpr size_t s_BatchSize = 64;
+
+    // Writers lock this byte rather than any of the file, so that the lock
+    // keeps writers apart without getting in the way of anything else.
+    static constexpr uint64_t s_LockOffset = 0x7FFFFFFFFFFF0000;
+
+    struct _FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t bucketCount;
+        uint32_t reserved;
+
+        // The offset of the newest record in each bucket, or 0 if it's empty.
+        uint64_t buckets[s_BucketCount];
+    };
+
+    // Each record is followed by the chars of its command, and then padded
+    // out so that the next record starts on a multiple of 8 bytes.
+    struct _RecordHeader
+    {
+        uint32_t magic;
+        uint32_t length;
+        uint64_t appHash;
+
+        // The offset of the record before this one in the same bucket, or 0.
+        uint64_t previous;
+    };
+
+    struct _PendingCommand
+    {
+        uint64_t appHash;
+        std::wstring command;
+    };
+
+    static uint64_t s_HashAppName(const std::wstring_view appName) noexcept;
+    static uint64_t s_RecordSize(const uint64_t length) noexcept;
+
+    uint64_t _GetFileSize() const;
+    void _Lock();
+    void _Unlock() noexcept;
+    void _WriteAt(const uint64_t offset, const void* const data, const size_t size);
+    bool _Map(const uint64_t size);
+    const _RecordHeader* _RecordAt(const uint64_t offset);
+
+    wil::unique_hfile _file;
+    wil::unique_handle _mapping;
+    wil::unique_mapview_ptr<BYTE> _view;
+    uint64_t _viewSize;
+
+    std::vector<_PendingCommand> _pending;
+};
@@ -5,9 +5,13 @@
 #include "inputBuffer.hpp"
 #include "dbcs.h"
 #include "stream.h"
+#include "../types/inc/convert.hpp"
 #include "../types/inc/GlyphWidth.hpp"
+#include "../types/inc/PerfMetrics.hpp"
 
+#include <array>
 #include <functional>
+#include <numeric>
 
 #include "..\interactivity\inc\ServiceLocator.hpp"
 
@@ -22,6 +26,8 @@
 InputBuffer::InputBuffer() :
     InputMode{ INPUT_BUFFER_DEFAULT_INPUT_MODE },
     WaitQueue{},
+    _textRunOffset{ 0 },
+    _textRunKeyEvents{ 0 },
     _termInput(std::bind(&InputBuffer::_HandleTerminalInputCallback, this, std::placeholders::_1))
 {
     // The _termInput's constructor takes a reference to this object's _HandleTerminalInputCallback.
@@ -148,6 +154,10 @@ void InputBuffer::ReinitializeInputBuffer()
     ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
     InputMode = INPUT_BUFFER_DEFAULT_INPUT_MODE;
     _storage.clear();
+    _textRuns.clear();
+    _textRunOffset = 0;
+    _textRunKeyEvents = 0;
+    _postedInput.clear();
 }
 
 // Routine Description:
@@ -177,12 +187,13 @@ void InputBuffer::TerminateRead(_In_ WaitTerminationReason Flag)
 // Arguments:
 // - None
 // Return Value:
-// - The number of events currently in the input buffer.
+// - The number of events currently in the input buffer. Text runs count
+// as the number of key events they'll be read as.
 // Note:
 // - The console lock must be held when calling this routine.
-size_t InputBuffer::GetNumberOfReadyEvents() const noexcept
+size_t InputBuffer::GetNumberOfReadyEvents() const
 {
-    return _storage.size();
+    return _storage.size() - _textRuns.size() + _textRunKeyEvents;
 }
 
 // Routine Description:
@@ -196,6 +207,10 @@ size_t InputBuffer::GetNumberOfReadyEvents() const noexcept
 void InputBuffer::Flush()
 {
     _storage.clear();
+    _textRuns.clear();
+    _textRunOffset = 0;
+    _textRunKeyEvents = 0;
+    _postedInput.clear();
     ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
 }
 
@@ -209,11 +224,11 @@ void InputBuffer::Flush()
 // - The console lock must be held when calling this routine.
 void InputBuffer::FlushAllButKeys()
 {
-    auto newEnd = std::remove_if(_storage.begin(), _storage.end(), [](const std::unique_ptr<IInputEvent>& event)
+    // text runs are key events that haven't been materialized yet.
+    _storage.erase_if([](const INPUT_RECORD& record)
     {
-        return event->EventType() != InputEventType::KeyEvent;
+        return record.EventType != KEY_EVENT && record.EventType != s_TextRunEventType;
     });
-    _storage.erase(newEnd, _storage.end());
 }
 
 // Routine Description:
@@ -243,39 +258,19 @@ NTSTATUS InputBuffer::Read(_Out_ std::deque<std::unique_ptr<IInputEvent>>& OutEv
 {
     try
     {
-        if (_storage.empty())
-        {
-            if (!WaitForData)
-            {
-                return STATUS_SUCCESS;
-            }
-            return CONSOLE_STATUS_WAIT;
-        }
-
-        // read from buffer
-        std::deque<std::unique_ptr<IInputEvent>> events;
-        size_t eventsRead;
-        bool resetWaitEvent;
-        _ReadBuffer(events,
-                    AmountToRead,
-                    eventsRead,
-                    Peek,
-                    resetWaitEvent,
-                    Unicode,
-                    Stream);
-
-        // copy events to outEvents
-        while (!events.empty())
-        {
-            OutEvents.push_back(std::move(events.front()));
-            events.pop_front();
-        }
-
-        if (resetWaitEvent)
+        std::vector<INPUT_RECORD> records;
+        const NTSTATUS Status = Read(records,
+                                     AmountToRead,
+                                     Peek,
+                                     WaitForData,
+                                     Unicode,
+                                     Stream);
+
+        for (const auto& record : records)
         {
-            ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
+            OutEvents.push_back(IInputEvent::Create(record));
         }
-        return STATUS_SUCCESS;
+        return Status;
     }
     catch (...)
     {
@@ -309,16 +304,16 @@ NTSTATUS InputBuffer::Read(_Out_ std::unique_ptr<IInputEvent>& outEvent,
     NTSTATUS Status;
     try
     {
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
-        Status = Read(outEvents,
+        std::vector<INPUT_RECORD> outRecords;
+        Status = Read(outRecords,
                       1,
                       Peek,
                       WaitForData,
                       Unicode,
                       Stream);
-        if (!outEvents.empty())
+        if (!outRecords.empty())
         {
-            outEvent.swap(outEvents.front());
+            outEvent = IInputEvent::Create(outRecords.front());
         }
     }
     catch (...)
@@ -329,10 +324,75 @@ NTSTATUS InputBuffer::Read(_Out_ std::unique_ptr<IInputEvent>& outEvent,
     return Status;
 }
 
+// Routine Description:
+// - This routine reads records from the input buffer without wrapping each of them in an IInputEvent.
+// - It behaves like the IInputEvent version of Read in every other way.
+// Note:
+// - The console lock must be held when calling this routine.
+// Arguments:
+// - outRecords - the read records are appended to this
+// - AmountToRead - the amount of events to try to read
+// - Peek - If true, copy events to outRecords but don't remove them from the input buffer.
+// - WaitForData - if true, wait until an event is input (if there aren't enough to fill client buffer). if false, return immediately
+// - Unicode - true if the data in key events should be treated as unicode. false if they should be converted by the current input CP.
+// - Stream - true if read should unpack KeyEvents that have a >1 repeat count. AmountToRead must be 1 if Stream is true.
+// Return Value:
+// - STATUS_SUCCESS if records were read into the client buffer and everything is OK.
+// - CONSOLE_STATUS_WAIT if there weren't enough records to satisfy the request (and waits are allowed)
+// - otherwise a suitable memory/math/string error in NTSTATUS form.
+[[nodiscard]]
+NTSTATUS InputBuffer::Read(_Inout_ std::vector<INPUT_RECORD>& outRecords,
+                           const size_t AmountToRead,
+                           const bool Peek,
+                           const bool WaitForData,
+                           const bool Unicode,
+                           const bool Stream)
+{
+    try
+    {
+        bool setWaitEvent;
+        _DrainPostedInput(setWaitEvent);
+        if (setWaitEvent)
+        {
+            ServiceLocator::LocateGlobals().hInputEvent.SetEvent();
+        }
+
+        if (_storage.empty())
+        {
+            if (!WaitForData)
+            {
+                return STATUS_SUCCESS;
+            }
+            return CONSOLE_STATUS_WAIT;
+        }
+
+        // read from buffer
+        size_t eventsRead;
+        bool resetWaitEvent;
+        _ReadBuffer(outRecords,
+                    AmountToRead,
+                    eventsRead,
+                    Peek,
+                    resetWaitEvent,
+                    Unicode,
+                    Stream);
+
+        if (resetWaitEvent)
+        {
+            ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
+        }
+        return STATUS_SUCCESS;
+    }
+    catch (...)
+    {
+        return NTSTATUS_FROM_HRESULT(wil::ResultFromCaughtException());
+    }
+}
+
 // Routine Description:
 // - This routine reads from a buffer. It does the buffer manipulation.
 // Arguments:
-// - outEvents - where read events are placed
+// - outRecords - where read records are appended
 // - readCount - amount of events to read
 // - eventsRead - where to store number of events read
 // - peek - if true , don't remove data from buffer, just copy it.
@@ -343,7 +403,7 @@ NTSTATUS InputBuffer::Read(_Out_ std::unique_ptr<IInputEvent>& outEvent,
 // - <none>
 // Note:
 // - The console lock must be held when calling this routine.
-void InputBuffer::_ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& outEvents,
+void InputBuffer::_ReadBuffer(_Inout_ std::vector<INPUT_RECORD>& outRecords,
                               const size_t readCount,
                               _Out_ size_t& eventsRead,
                               const bool peek,
@@ -357,7 +417,8 @@ void InputBuffer::_ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& ou
 
     resetWaitEvent = false;
 
-    std::deque<std::unique_ptr<IInputEvent>> readEvents;
+    // the records read by this call start here, after anything the caller already had.
+    const size_t firstRead = outRecords.size();
     // we need another var to keep track of how many we've read
     // because dbcs records count for two when we aren't doing a
     // unicode read but the eventsRead count should return the number
@@ -366,84 +427,79 @@ void InputBuffer::_ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& ou
 
     while (!_storage.empty() && virtualReadCount < readCount)
     {
-        bool performNormalRead = true;
-        // for stream reads we need to split any key events that have been coalesced
-        if (streamRead)
+        // readers of records get the key events that a text run stands for.
+        if (_storage.front().EventType == s_TextRunEventType)
         {
-            if (_storage.front()->EventType() == InputEventType::KeyEvent)
-            {
-                KeyEvent* const pKeyEvent = static_cast<KeyEvent* const>(_storage.front().get());
-                if (pKeyEvent->GetRepeatCount() > 1)
-                {
-                    // split the key event
-                    std::unique_ptr<KeyEvent> streamKeyEvent = std::make_unique<KeyEvent>(*pKeyEvent);
-                    streamKeyEvent->SetRepeatCount(1);
-                    readEvents.push_back(std::move(streamKeyEvent));
-                    pKeyEvent->SetRepeatCount(pKeyEvent->GetRepeatCount() - 1);
-                    performNormalRead = false;
-                }
-            }
+            _MaterializeFrontTextRun();
+            continue;
         }
 
-        if (performNormalRead)
+        INPUT_RECORD& front = _storage.front();
+        // for stream reads we need to split any key events that have been coalesced
+        if (streamRead &&
+            front.EventType == KEY_EVENT &&
+            front.Event.KeyEvent.wRepeatCount > 1)
         {
-            readEvents.push_back(std::move(_storage.front()));
+            // split the key event
+            INPUT_RECORD streamRecord = front;
+            streamRecord.Event.KeyEvent.wRepeatCount = 1;
+            outRecords.push_back(streamRecord);
+            --front.Event.KeyEvent.wRepeatCount;
+        }
+        else
+        {
+            outRecords.push_back(front);
             _storage.pop_front();
         }
 
         ++virtualReadCount;
         if (!unicode)
         {
-            if (readEvents.back()->EventType() == InputEventType::KeyEvent)
+            const INPUT_RECORD& lastRead = outRecords.back();
+            if (lastRead.EventType == KEY_EVENT &&
+                IsGlyphFullWidth(lastRead.Event.KeyEvent.uChar.UnicodeChar))
             {
-                const KeyEvent* const pKeyEvent = static_cast<const KeyEvent* const>(readEvents.back().get());
-                if (IsGlyphFullWidth(pKeyEvent->GetCharData()))
-                {
-                    ++virtualReadCount;
-                }
+                ++virtualReadCount;
             }
         }
     }
 
     // the amount of events that were actually read
-    eventsRead = readEvents.size();
+    eventsRead = outRecords.size() - firstRead;
 
     // copy the events back if we were supposed to peek
-    if (peek)
+    if (peek && eventsRead > 0)
     {
         if (streamRead)
         {
             // we need to check and see if the event was split from a coalesced key event
             // or if it was unrelated to the current front event in storage
-            if (!readEvents.empty() &&
-                !_storage.empty() &&
-                readEvents.back()->EventType() == InputEventType::KeyEvent &&
-                _storage.front()->EventType() == InputEventType::KeyEvent &&
-                _CanCoalesce(static_cast<const KeyEvent&>(*readEvents.back()),
-                                static_cast<const KeyEvent&>(*_storage.front())))
+            const INPUT_RECORD& lastRead = outRecords.back();
+            if (!_storage.empty() &&
+                lastRead.EventType == KEY_EVENT &&
+                _storage.front().EventType == KEY_EVENT &&
+                _CanCoalesce(KeyEvent{ lastRead.Event.KeyEvent },
+                             KeyEvent{ _storage.front().Event.KeyEvent }))
             {
-                KeyEvent& keyEvent = static_cast<KeyEvent&>(*_storage.front());
-                keyEvent.SetRepeatCount(keyEvent.GetRepeatCount() + 1);
+                ++_storage.front().Event.KeyEvent.wRepeatCount;
             }
             else
             {
-                _storage.push_front(IInputEvent::Create(readEvents.back()->ToInputRecord()));
+                _storage.push_front(lastRead);
             }
         }
         else
         {
-            for (auto it = readEvents.crbegin(); it != readEvents.crend(); ++it)
+            for (size_t i = outRecords.size(); i > firstRead; --i)
             {
-                _storage.push_front(IInputEvent::Create((*it)->ToInputRecord()));
+                _storage.push_front(outRecords[i - 1]);
             }
         }
     }
 
-    // move events read to proper deque
-    while (!readEvents.empty())
+    if (!peek && eventsRead > 0)
     {
-        outEvents.push_back(std::move(readEvents.front()));
-        readEvents.pop_front();
+        _RecordReadEvents();
     }
 
     // signal if we emptied the buffer
@@ -453,56 +509,96 @@ void InputBuffer::_ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& ou
     }
 }
 
+// Routine Description:
+// - Records how long the oldest of the events that were just read had been
+// waiting in the input buffer, in the console's performance metrics.
+// - Events left over after a read aren't measured again until the next write,
+// so a paste that's read a character at a time is recorded once, not once
+// per character.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void InputBuffer::_RecordReadEvents() noexcept
+{
+    try
+    {
+        static auto& s_writeToRead = Microsoft::Console::Metrics::MetricsRegistry::Instance().GetHistogram(Microsoft::Console::Metrics::Names::InputWriteToReadMicroseconds);
+        _unreadInput.End(s_writeToRead);
+    }
+    CATCH_LOG();
+}
+
+// Routine Description:
+// - Counts events written to the buffer in the console's performance metrics.
+// Arguments:
+// - eventsWritten - the number of events written
+// Return Value:
+// - <none>
+static void _RecordWrittenEvents(const size_t eventsWritten)
+{
+    static auto& s_inputRecords = Microsoft::Console::Metrics::MetricsRegistry::Instance().GetCounter(Microsoft::Console::Metrics::Names::InputRecords);
+    s_inputRecords.Add(eventsWritten);
+}
+
 // Routine Description:
 // -  Writes events to the beginning of the input buffer.
 // Arguments:
 // - inEvents - events to write to buffer.
-// - eventsWritten - The number of events written to the buffer on exit.
 // Return Value:
-// S_OK if successful.
+// - The number of events that were written to the input buffer.
 // Note:
 // - The console lock must be held when calling this routine.
 size_t InputBuffer::Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
 {
     try
     {
-        _HandleConsoleSuspensionEvents(inEvents);
-        if (inEvents.empty())
-        {
-            return STATUS_SUCCESS;
-        }
-        // read all of the records out of the buffer, then write the
-        // prepend ones, then write the original set. We need to do it
-        // this way to handle any coalescing that might occur.
+        const std::vector<INPUT_RECORD> inRecords = IInputEvent::ToInputRecords(inEvents);
+        inEvents.clear();
+        return Prepend(inRecords);
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
+        return 0;
+    }
+}
 
-        // get all of the existing records, "emptying" the buffer
-        std::deque<std::unique_ptr<IInputEvent>> existingStorage;
+// Routine Description:
+// -  Writes records to the beginning of the input buffer.
+// Arguments:
+// - inRecords - records to write to buffer.
+// Return Value:
+// - The number of events that were written to the input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::Prepend(const gsl::span<const INPUT_RECORD> inRecords)
+{
+    try
+    {
+        // set aside all of the existing records, "emptying" the buffer, then
+        // write the prepended ones so that they're handled and coalesced
+        // exactly as they would be on an empty buffer.
+        InputRecordRing existingStorage;
         existingStorage.swap(_storage);
+        // keep the larger of the two allocations.
+        _storage.reserve(existingStorage.capacity());
 
-        // We will need this variable to pass to _WriteBuffer so it can attempt to determine wait status.
-        // However, because we swapped the storage out from under it with an empty deque, it will always
-        // return true after the first one (as it is filling the newly emptied backing deque.)
-        // Then after the second one, because we've inserted some input, it will always say false.
-        bool unusedWaitStatus = false;
-
-        // write the prepend records
         size_t prependEventsWritten;
-        _WriteBuffer(inEvents, prependEventsWritten, unusedWaitStatus);
-        FAIL_FAST_IF(!(unusedWaitStatus));
-
-        // write all previously existing records
-        size_t existingEventsWritten;
-        _WriteBuffer(existingStorage, existingEventsWritten, unusedWaitStatus);
-        FAIL_FAST_IF(!(!unusedWaitStatus));
-
-        // We need to set the wait event if there were 0 events in the
-        // input queue when we started.
-        // Because we did interesting manipulation of the wait queue
-        // in order to prepend, we can't trust what _WriteBuffer said
-        // and instead need to set the event if the original backing
-        // buffer (the one we swapped out at the top) was empty
-        // when this whole thing started.
-        if (existingStorage.empty())
+        bool unusedWaitStatus;
+        _WriteBuffer(inRecords, prependEventsWritten, unusedWaitStatus);
+        _RecordWrittenEvents(prependEventsWritten);
+
+        // The existing records have already been through _WriteBuffer once,
+        // so they're put back behind the new ones as they are.
+        for (size_t i = 0; i < existingStorage.size(); ++i)
+        {
+            _storage.push_back(existingStorage[i]);
+        }
+
+        // We can't trust what _WriteBuffer said about the wait event, since
+        // it wrote to an emptied buffer. Set it if anything's there to read.
+        if (!_storage.empty())
         {
             ServiceLocator::LocateGlobals().hInputEvent.SetEvent();
         }
@@ -532,9 +628,9 @@ size_t InputBuffer::Write(_Inout_ std::unique_ptr<IInputEvent> inEvent)
 {
     try
     {
-        std::deque<std::unique_ptr<IInputEvent>> inEvents;
-        inEvents.push_back(std::move(inEvent));
-        return Write(inEvents);
+        const INPUT_RECORD inRecord = inEvent->ToInputRecord();
+        inEvent.reset();
+        return Write(gsl::make_span(&inRecord, 1));
     }
     catch (...)
     {
@@ -547,7 +643,7 @@ size_t InputBuffer::Write(_Inout_ std::unique_ptr<IInputEvent> inEvent)
 // - Writes events to the input buffer. Wakes up any readers that are
 // waiting for additional input events.
 // Arguments:
-// - inEvents - input events to store in the buffer.
+// - inEvents - input events to store in the buffer. Emptied on return.
 // Return Value:
 // - The number of events that were written to input buffer.
 // Note:
@@ -556,18 +652,48 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
 {
     try
     {
-        _HandleConsoleSuspensionEvents(inEvents);
-        if (inEvents.empty())
+        const std::vector<INPUT_RECORD> inRecords = IInputEvent::ToInputRecords(inEvents);
+        inEvents.clear();
+        return Write(inRecords);
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
+        return 0;
+    }
+}
+
+// Routine Description:
+// - Writes records to the input buffer. Wakes up any readers that are
+// waiting for additional input events.
+// - This is the same as writing IInputEvents, without allocating one per record.
+// Arguments:
+// - inRecords - input records to store in the buffer.
+// Return Value:
+// - The number of events that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::Write(const gsl::span<const INPUT_RECORD> inRecords)
+{
+    try
+    {
+        if (inRecords.empty())
         {
             return 0;
         }
 
+        // Anything posted before this has to be stored ahead of it.
+        bool PostedWaitEvent;
+        _DrainPostedInput(PostedWaitEvent);
+
         // Write to buffer.
         size_t EventsWritten;
         bool SetWaitEvent;
-        _WriteBuffer(inEvents, EventsWritten, SetWaitEvent);
+        _WriteBuffer(inRecords, EventsWritten, SetWaitEvent);
+        _RecordWrittenEvents(EventsWritten);
+        _unreadInput.Begin();
 
-        if (SetWaitEvent)
+        if (SetWaitEvent || PostedWaitEvent)
         {
             ServiceLocator::LocateGlobals().hInputEvent.SetEvent();
         }
@@ -584,9 +710,329 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
 }
 
 // Routine Description:
-// - Coalesces input events and transfers them to storage queue.
+// - Queues records to be written to the input buffer, without taking the
+// console lock. They're stored, and readers are woken, by the next
+// FlushPostedInput, or by any write or read that comes first.
+// - Safe to call from any thread.
 // Arguments:
-// - inRecords - The events to store.
+// - inRecords - input records to queue.
+// Return Value:
+// - true if nothing else was queued, in which case the caller has to make
+// sure that FlushPostedInput is called. Producers that post while another
+// is on its way to flush just leave their records for that flush.
+// Note:
+// - If the queue is full, the records are written right away instead, under
+// the console lock, after everything that was queued before them.
+// - will throw on failure
+bool InputBuffer::Post(const gsl::span<const INPUT_RECORD> inRecords)
+{
+    bool firstPosted;
+    if (_postedInput.TryPush(inRecords, firstPosted))
+    {
+        _unreadInput.Begin();
+        return firstPosted;
+    }
+
+    CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    gci.LockConsole();
+    auto Unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+    Write(inRecords);
+    return false;
+}
+
+// Routine Description:
+// - Writes all of the posted records to the input buffer at once, and wakes
+// up the readers waiting for data once for all of them.
+// Arguments:
+// - <none>
+// Return Value:
+// - The number of events that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::FlushPostedInput() noexcept
+{
+    try
+    {
+        bool SetWaitEvent;
+        const size_t EventsWritten = _DrainPostedInput(SetWaitEvent);
+
+        if (SetWaitEvent)
+        {
+            ServiceLocator::LocateGlobals().hInputEvent.SetEvent();
+        }
+        if (EventsWritten > 0)
+        {
+            WakeUpReadersWaitingForData();
+        }
+        return EventsWritten;
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
+        return 0;
+    }
+}
+
+// Routine Description:
+// - Moves the posted records into storage, the same as if they had been
+// written when they were posted. Readers aren't woken.
+// Arguments:
+// - setWaitEvent - on exit, true if buffer became non-empty.
+// Return Value:
+// - The number of events that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+// - will throw on failure
+size_t InputBuffer::_DrainPostedInput(_Out_ bool& setWaitEvent)
+{
+    setWaitEvent = false;
+    if (_postedInput.empty())
+    {
+        return 0;
+    }
+
+    static auto& s_queueLatency = Microsoft::Console::Metrics::MetricsRegistry::Instance().GetHistogram(Microsoft::Console::Metrics::Names::InputQueueMicroseconds);
+
+    size_t eventsWritten = 0;
+    _postedInput.Drain([&](const gsl::span<const INPUT_RECORD> records, const std::chrono::steady_clock::time_point posted)
+    {
+        size_t batchWritten;
+        bool batchSetWaitEvent;
+        _WriteBuffer(records, batchWritten, batchSetWaitEvent);
+        eventsWritten += batchWritten;
+        setWaitEvent = setWaitEvent || batchSetWaitEvent;
+
+        const auto queued = std::chrono::steady_clock::now() - posted;
+        s_queueLatency.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(queued).count()));
+    });
+
+    _RecordWrittenEvents(eventsWritten);
+    return eventsWritten;
+}
+
+// Routine Description:
+// - Converts text into the key events that would type it, the same way text
+// written to the input as a string is converted.
+// Arguments:
+// - text - the text to convert
+// - codepage - the codepage to use for characters that have to be typed on the numpad
+// Return Value:
+// - the key event records
+// Note:
+// - will throw on failure
+static std::vector<INPUT_RECORD> _TextToKeyRecords(const std::wstring_view text, const unsigned int codepage)
+{
+    std::vector<INPUT_RECORD> records;
+    records.reserve(text.size() * 2);
+    for (const wchar_t wch : text)
+    {
+        for (const auto& keyEvent : CharToKeyEvents(wch, codepage))
+        {
+            records.push_back(keyEvent->ToInputRecord());
+        }
+    }
+    return records;
+}
+
+// Routine Description:
+// - Counts the key events each character of some text will be converted to
+// by _TextToKeyRecords, without creating them.
+// Arguments:
+// - text - the text to count
+// - codepage - the codepage to use for characters that have to be typed on the numpad
+// Return Value:
+// - the number of key events for each character
+// Note:
+// - will throw on failure
+static std::vector<BYTE> _CountKeyEvents(const std::wstring_view text, const unsigned int codepage)
+{
+    // Pasted text is mostly ASCII, so the count of each of those is only
+    // worked out the first time it comes up.
+    std::array<BYTE, 0x80> asciiCounts{};
+
+    std::vector<BYTE> counts;
+    counts.reserve(text.size());
+    for (const wchar_t wch : text)
+    {
+        if (wch < asciiCounts.size() && asciiCounts[wch] != 0)
+        {
+            counts.push_back(asciiCounts[wch]);
+            continue;
+        }
+
+        const auto count = gsl::narrow<BYTE>(CharToKeyEvents(wch, codepage).size());
+        if (wch < asciiCounts.size())
+        {
+            asciiCounts[wch] = count;
+        }
+        counts.push_back(count);
+    }
+    return counts;
+}
+
+// Routine Description:
+// - Writes text to the input buffer as one run, instead of as the key events
+// that would type it. Readers that take characters (see ReadText) get the
+// text as it is. Readers that take records get the key events, which are only
+// created when such a reader gets to the run.
+// - Wakes up any readers that are waiting for additional input events.
+// Arguments:
+// - text - the text to store. It should only contain printable characters,
+// which is all a character reader would take from their key events.
+// Return Value:
+// - The number of characters that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::WriteText(const std::wstring_view text)
+{
+    try
+    {
+        if (text.empty())
+        {
+            return 0;
+        }
+
+        // Key events are translated as they're written in VT input mode, and
+        // the first one written while output is suspended only resumes it.
+        // Those need the key events right away.
+        const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        if (IsInVirtualTerminalInputMode() || WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED))
+        {
+            Write(_TextToKeyRecords(text, gci.OutputCP));
+            return text.size();
+        }
+
+        const bool initiallyEmptyQueue = _storage.empty();
+
+        // Anything posted before this has to be stored ahead of it.
+        bool unusedWaitStatus;
+        _DrainPostedInput(unusedWaitStatus);
+
+        const std::vector<BYTE> keyEvents = _CountKeyEvents(text, gci.OutputCP);
+        const size_t keyEventCount = std::accumulate(keyEvents.begin(), keyEvents.end(), size_t{ 0 });
+
+        if (!_storage.empty() &&
+            _storage.back().EventType == s_TextRunEventType &&
+            _textRuns.back().codepage == gci.OutputCP)
+        {
+            // nothing came in since the last run, so this just continues it.
+            // make room first, so that the text and its counts can't get out of step.
+            _TextRun& run = _textRuns.back();
+            run.text.reserve(run.text.size() + text.size());
+            run.keyEvents.reserve(run.keyEvents.size() + keyEvents.size());
+            run.text.append(text);
+            run.keyEvents.insert(run.keyEvents.end(), keyEvents.begin(), keyEvents.end());
+        }
+        else
+        {
+            INPUT_RECORD marker{};
+            marker.EventType = s_TextRunEventType;
+
+            _textRuns.push_back({ std::wstring{ text }, keyEvents, gci.OutputCP });
+            try
+            {
+                _storage.push_back(marker);
+            }
+            catch (...)
+            {
+                _textRuns.pop_back();
+                throw;
+            }
+        }
+        _textRunKeyEvents += keyEventCount;
+        _RecordWrittenEvents(text.size());
+        _unreadInput.Begin();
+
+        if (initiallyEmptyQueue)
+        {
+            ServiceLocator::LocateGlobals().hInputEvent.SetEvent();
+        }
+        WakeUpReadersWaitingForData();
+        return text.size();
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
+        return 0;
+    }
+}
+
+// Routine Description:
+// - Reads text from a text run at the front of the input buffer, as many
+// characters as fit in the buffer at once.
+// Arguments:
+// - buffer - where the characters are copied to
+// Return Value:
+// - The number of characters read. This is 0 if the next event in the input
+// buffer isn't a text run, in which case it has to be read as a record.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::ReadText(const gsl::span<wchar_t> buffer) noexcept
+{
+    if (_storage.empty() || _storage.front().EventType != s_TextRunEventType)
+    {
+        return 0;
+    }
+
+    const _TextRun& run = _textRuns.front();
+    const size_t count = std::min(static_cast<size_t>(buffer.size()), run.text.size() - _textRunOffset);
+    std::copy_n(run.text.begin() + _textRunOffset, count, buffer.begin());
+
+    const auto readKeyEvents = run.keyEvents.begin() + _textRunOffset;
+    _textRunKeyEvents -= std::accumulate(readKeyEvents, readKeyEvents + count, size_t{ 0 });
+    _textRunOffset += count;
+
+    if (_textRunOffset == run.text.size())
+    {
+        _textRuns.pop_front();
+        _textRunOffset = 0;
+        _storage.pop_front();
+
+        if (_storage.empty())
+        {
+            ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
+        }
+    }
+
+    if (count > 0)
+    {
+        _RecordReadEvents();
+    }
+    return count;
+}
+
+// Routine Description:
+// - Replaces the text run at the front of the buffer with the key events it
+// stands for, for readers that take records.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+// Note:
+// - The front of the buffer must be a text run.
+// - will throw on failure, in which case the buffer is unchanged
+void InputBuffer::_MaterializeFrontTextRun()
+{
+    const _TextRun& run = _textRuns.front();
+    const std::vector<INPUT_RECORD> records = _TextToKeyRecords(std::wstring_view{ run.text }.substr(_textRunOffset), run.codepage);
+
+    // make room first, so that nothing below can fail.
+    _storage.reserve(_storage.size() - 1 + records.size());
+
+    _storage.pop_front();
+    for (auto it = records.crbegin(); it != records.crend(); ++it)
+    {
+        _storage.push_front(*it);
+    }
+    _textRunKeyEvents -= std::accumulate(run.keyEvents.begin() + _textRunOffset, run.keyEvents.end(), size_t{ 0 });
+    _textRuns.pop_front();
+    _textRunOffset = 0;
+}
+
+// Routine Description:
+// - Coalesces input records and transfers them to storage queue.
+// Arguments:
+// - inRecords - The records to store.
 // - eventsWritten - The number of events written since this function
 // was called.
 // - setWaitEvent - on exit, true if buffer became non-empty.
@@ -595,28 +1041,40 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
 // Note:
 // - The console lock must be held when calling this routine.
 // - will throw on failure
-void InputBuffer::_WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
+void InputBuffer::_WriteBuffer(const gsl::span<const INPUT_RECORD> inRecords,
                                _Out_ size_t& eventsWritten,
                                _Out_ bool& setWaitEvent)
 {
     eventsWritten = 0;
     setWaitEvent = false;
+
+    // Reject the whole run before storing any of it, the same as if the
+    // events couldn't have been created from the records.
+    THROW_HR_IF(E_INVALIDARG, !std::all_of(inRecords.begin(), inRecords.end(), s_IsValidRecord));
+
     const bool initiallyEmptyQueue = _storage.empty();
-    const size_t initialInEventsSize = inEvents.size();
     const bool vtInputMode = IsInVirtualTerminalInputMode();
 
-    while(!inEvents.empty())
+    // make room for the whole run up front, so that a large write grows the
+    // storage at most once.
+    _storage.reserve(_storage.size() + inRecords.size());
+
+    for (const INPUT_RECORD& inRecord : inRecords)
     {
-        // Pop the next event.
+        // Records that suspend or resume the console are consumed here.
         // If we're in vt mode, try and handle it with the vt input module.
         // If it was handled, do nothing else for it.
         // If there was one event passed in, try coalescing it with the previous event currently in the buffer.
         // If it's not coalesced, append it to the buffer.
-        std::unique_ptr<IInputEvent> inEvent = std::move(inEvents.front());
-        inEvents.pop_front();
-        if (vtInputMode)
+        if (_HandleConsoleSuspensionEvent(inRecord))
+        {
+            continue;
+        }
+
+        if (vtInputMode && inRecord.EventType == KEY_EVENT)
         {
-            const bool handled = _termInput.HandleKey(inEvent.get());
+            const KeyEvent keyEvent{ inRecord.Event.KeyEvent };
+            const bool handled = _termInput.HandleKey(&keyEvent);
             if (handled)
             {
                 eventsWritten++;
@@ -628,42 +1086,19 @@ void InputBuffer::_WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>&
         // record at a time because this is the original behavior of
         // the input buffer. Changing this behavior may break stuff
         // that was depending on it.
-        if (initialInEventsSize == 1 && !_storage.empty())
-        {
-            // coalescing requires a deque of events, so push it back onto the front.
-            inEvents.push_front(std::move(inEvent));
-
-            bool coalesced = false;
-            // this looks kinda weird but we don't want to coalesce a
-            // mouse event and then try to coalesce a key event right after.
-            //
-            // we also pass the whole deque to the coalescing methods
-            // even though they only want one event because it should
-            // be their responsibility to maintain the correct state
-            // of the deque if they process any records in it.
-            if (_CoalesceMouseMovedEvents(inEvents))
-            {
-                coalesced = true;
-            }
-            else if (_CoalesceRepeatedKeyPressEvents(inEvents))
-            {
-                coalesced = true;
-            }
-            if (coalesced)
-            {
-                eventsWritten = 1;
-                return;
-            }
-            else
-            {
-                // We didn't coalesce the event. pull it from the queue again,
-                //  to keep the state consistent with the start of this block.
-                inEvent = std::move(inEvents.front());
-                inEvents.pop_front();
-            }
+        //
+        // this looks kinda weird but we don't want to coalesce a
+        // mouse event and then try to coalesce a key event right after.
+        if (inRecords.size() == 1 &&
+            !_storage.empty() &&
+            (_CoalesceMouseMovedEvents(inRecord) || _CoalesceRepeatedKeyPressEvents(inRecord)))
+        {
+            eventsWritten = 1;
+            return;
         }
+
         // At this point, the event was neither coalesced, nor processed by VT.
-        _storage.push_back(std::move(inEvent));
+        _storage.push_back(inRecord);
         ++eventsWritten;
     }
     if (initiallyEmptyQueue && !_storage.empty())
@@ -673,44 +1108,53 @@ void InputBuffer::_WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>&
 }
 
 // Routine Description:
-// - Checks if the last saved event and the first event of inRecords are
-// both MOUSE_MOVED events. If they are, the last saved event is
-// updated with the new mouse position and the first event of inRecords is
-// dropped.
+// - Checks that a record is one of the events that can be written to the
+// input buffer, which are the ones an IInputEvent can be created from.
 // Arguments:
-// - inRecords - The incoming records to process.
+// - record - The record to check.
+// Return Value:
+// - true if the record can be stored, false if it has to be rejected.
+bool InputBuffer::s_IsValidRecord(const INPUT_RECORD& record) noexcept
+{
+    switch (record.EventType)
+    {
+    case KEY_EVENT:
+    case MOUSE_EVENT:
+    case WINDOW_BUFFER_SIZE_EVENT:
+    case MENU_EVENT:
+    case FOCUS_EVENT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Routine Description:
+// - Checks if the last saved record and inRecord are both MOUSE_MOVED
+// events. If they are, the last saved record is updated with the new
+// mouse position and inRecord is dropped.
+// Arguments:
+// - inRecord - The incoming record to process.
 // Return Value:
 // true if events were coalesced, false if they were not.
 // Note:
-// - The size of inRecords must be 1.
+// - The buffer must not be empty.
 // - Coalescing here means updating a record that already exists in
 // the buffer with updated values from an incoming event, instead of
 // storing the incoming event (which would make the original one
 // redundant/out of date with the most current state).
-bool InputBuffer::_CoalesceMouseMovedEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+bool InputBuffer::_CoalesceMouseMovedEvents(const INPUT_RECORD& inRecord) noexcept
 {
-    FAIL_FAST_IF(!(inEvents.size() == 1));
     FAIL_FAST_IF(_storage.empty());
-    const IInputEvent* const pFirstInEvent = inEvents.front().get();
-    const IInputEvent* const pLastStoredEvent = _storage.back().get();
-    if (pFirstInEvent->EventType() == InputEventType::MouseEvent &&
-        pLastStoredEvent->EventType() == InputEventType::MouseEvent)
+    INPUT_RECORD& lastRecord = _storage.back();
+    if (inRecord.EventType == MOUSE_EVENT &&
+        lastRecord.EventType == MOUSE_EVENT &&
+        MouseEvent{ inRecord.Event.MouseEvent }.IsMouseMoveEvent() &&
+        MouseEvent{ lastRecord.Event.MouseEvent }.IsMouseMoveEvent())
     {
-        const MouseEvent* const pInMouseEvent = static_cast<const MouseEvent* const>(pFirstInEvent);
-        const MouseEvent* const pLastMouseEvent = static_cast<const MouseEvent* const>(pLastStoredEvent);
-
-        if (pInMouseEvent->IsMouseMoveEvent() &&
-            pLastMouseEvent->IsMouseMoveEvent())
-        {
-            // update mouse moved position
-            MouseEvent* const pMouseEvent = static_cast<MouseEvent* const>(_storage.back().release());
-            pMouseEvent->SetPosition(pInMouseEvent->GetPosition());
-            std::unique_ptr<IInputEvent> tempPtr(pMouseEvent);
-            tempPtr.swap(_storage.back());
-
-            inEvents.pop_front();
-            return true;
-        }
+        // update mouse moved position
+        lastRecord.Event.MouseEvent.dwMousePosition = inRecord.Event.MouseEvent.dwMousePosition;
+        return true;
     }
     return false;
 }
@@ -741,44 +1185,36 @@ bool InputBuffer::_CanCoalesce(const KeyEvent& a, const KeyEvent& b) const noexc
 }
 
 // Routine Description::
-// - If the last input event saved and the first input event in inRecords
-// are both a keypress down event for the same key, update the repeat
-// count of the saved event and drop the first from inRecords.
+// - If the last input record saved and inRecord are both a keypress down
+// event for the same key, update the repeat count of the saved record
+// and drop inRecord.
 // Arguments:
-// - inRecords - The incoming records to process.
+// - inRecord - The incoming record to process.
 // Return Value:
 // true if events were coalesced, false if they were not.
 // Note:
-// - The size of inRecords must be 1.
+// - The buffer must not be empty.
 // - Coalescing here means updating a record that already exists in
 // the buffer with updated values from an incoming event, instead of
 // storing the incoming event (which would make the original one
 // redundant/out of date with the most current state).
-bool InputBuffer::_CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+bool InputBuffer::_CoalesceRepeatedKeyPressEvents(const INPUT_RECORD& inRecord) noexcept
 {
-    FAIL_FAST_IF(!(inEvents.size() == 1));
     FAIL_FAST_IF(_storage.empty());
-    const IInputEvent* const pFirstInEvent = inEvents.front().get();
-    const IInputEvent* const pLastStoredEvent = _storage.back().get();
-    if (pFirstInEvent->EventType() == InputEventType::KeyEvent &&
-        pLastStoredEvent->EventType() == InputEventType::KeyEvent)
+    INPUT_RECORD& lastRecord = _storage.back();
+    if (inRecord.EventType == KEY_EVENT &&
+        lastRecord.EventType == KEY_EVENT)
     {
-        const KeyEvent* const pInKeyEvent = static_cast<const KeyEvent* const>(pFirstInEvent);
-        const KeyEvent* const pLastKeyEvent = static_cast<const KeyEvent* const>(pLastStoredEvent);
+        const KeyEvent inKeyEvent{ inRecord.Event.KeyEvent };
+        const KeyEvent lastKeyEvent{ lastRecord.Event.KeyEvent };
 
-        if (pInKeyEvent->IsKeyDown() &&
-            pLastKeyEvent->IsKeyDown() &&
-            !IsGlyphFullWidth(pInKeyEvent->GetCharData()) &&
-            _CanCoalesce(*pInKeyEvent, *pLastKeyEvent))
+        if (inKeyEvent.IsKeyDown() &&
+            lastKeyEvent.IsKeyDown() &&
+            !IsGlyphFullWidth(inKeyEvent.GetCharData()) &&
+            _CanCoalesce(inKeyEvent, lastKeyEvent))
         {
             // increment repeat count
-            KeyEvent* const pKeyEvent = static_cast<KeyEvent* const>(_storage.back().release());
-            WORD repeatCount = pKeyEvent->GetRepeatCount() + pInKeyEvent->GetRepeatCount();
-            pKeyEvent->SetRepeatCount(repeatCount);
-            std::unique_ptr<IInputEvent> tempPtr(pKeyEvent);
-            tempPtr.swap(_storage.back());
-
-            inEvents.pop_front();
+            lastRecord.Event.KeyEvent.wRepeatCount += inRecord.Event.KeyEvent.wRepeatCount;
             return true;
         }
     }
@@ -786,44 +1222,32 @@ bool InputBuffer::_CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique
 }
 
 // Routine Description:
-// - Handles records that suspend/resume the console.
+// - Handles a record that suspends/resumes the console.
 // Arguments:
-// - records - records to check for pause/unpause events
+// - inRecord - record to check for a pause/unpause event
 // Return Value:
-// - None
+// - true if the record was consumed and shouldn't be stored, false otherwise
 // Note:
 // - The console lock must be held when calling this routine.
-// - will throw exception on error
-void InputBuffer::_HandleConsoleSuspensionEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+bool InputBuffer::_HandleConsoleSuspensionEvent(const INPUT_RECORD& inRecord)
 {
-    CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
-
-    std::deque<std::unique_ptr<IInputEvent>> outEvents;
-    while (!inEvents.empty())
+    if (inRecord.EventType == KEY_EVENT && inRecord.Event.KeyEvent.bKeyDown)
     {
-        std::unique_ptr<IInputEvent> currEvent = std::move(inEvents.front());
-        inEvents.pop_front();
-        if (currEvent->EventType() == InputEventType::KeyEvent)
+        CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const KeyEvent keyEvent{ inRecord.Event.KeyEvent };
+        if (WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED) &&
+            !IsSystemKey(keyEvent.GetVirtualKeyCode()))
         {
-            const KeyEvent* const pKeyEvent = static_cast<const KeyEvent* const>(currEvent.get());
-            if (pKeyEvent->IsKeyDown())
-            {
-                if (WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED) &&
-                    !IsSystemKey(pKeyEvent->GetVirtualKeyCode()))
-                {
-                    UnblockWriteConsole(CONSOLE_OUTPUT_SUSPENDED);
-                    continue;
-                }
-                else if (WI_IsFlagSet(InputMode, ENABLE_LINE_INPUT) && pKeyEvent->IsPauseKey())
-                {
-                    WI_SetFlag(gci.Flags, CONSOLE_SUSPENDED);
-                    continue;
-                }
-            }
+            UnblockWriteConsole(CONSOLE_OUTPUT_SUSPENDED);
+            return true;
+        }
+        else if (WI_IsFlagSet(InputMode, ENABLE_LINE_INPUT) && keyEvent.IsPauseKey())
+        {
+            WI_SetFlag(gci.Flags, CONSOLE_SUSPENDED);
+            return true;
         }
-        outEvents.push_back(std::move(currEvent));
     }
-    inEvents.swap(outEvents);
+    return false;
 }
 
 // Routine Description:
@@ -841,21 +1265,15 @@ bool InputBuffer::IsInVirtualTerminalInputMode() const
 // - Handler for inserting key sequences into the buffer when the terminal emulation layer
 //   has determined a key can be converted appropriately into a sequence of inputs
 // Arguments:
-// - rgInput - Series of input records to insert into the buffer
-// - cInput - Length of input records array
+// - records - Series of input records to insert into the buffer
 // Return Value:
 // - <none>
-void InputBuffer::_HandleTerminalInputCallback(std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+void InputBuffer::_HandleTerminalInputCallback(const gsl::span<const INPUT_RECORD> records)
 {
     try
     {
-        // add all input events to the storage queue
-        while (!inEvents.empty())
-        {
-            std::unique_ptr<IInputEvent> inEvent = std::move(inEvents.front());
-            inEvents.pop_front();
-            _storage.push_back(std::move(inEvent));
-        }
+        // add all input records to the storage queue
+        _storage.append(records);
     }
     catch (...)
     {
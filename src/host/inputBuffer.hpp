@@ -19,8 +19,11 @@ Revision History:
 #pragma once
 
 #include "inputReadHandleData.h"
+#include "inputPostQueue.hpp"
+#include "inputRecordRing.hpp"
 #include "readData.hpp"
 #include "../types/inc/IInputEvent.hpp"
+#include "../types/inc/PerfMetrics.hpp"
 
 #include "../server/ObjectHandle.h"
 #include "../server/ObjectHeader.h"
@@ -51,7 +54,7 @@ public:
     void ReinitializeInputBuffer();
     void WakeUpReadersWaitingForData();
     void TerminateRead(_In_ WaitTerminationReason Flag);
-    size_t GetNumberOfReadyEvents() const noexcept;
+    size_t GetNumberOfReadyEvents() const;
     void Flush();
     void FlushAllButKeys();
 
@@ -70,22 +73,73 @@ public:
                   const bool Unicode,
                   const bool Stream);
 
+    [[nodiscard]]
+    NTSTATUS Read(_Inout_ std::vector<INPUT_RECORD>& outRecords,
+                  const size_t AmountToRead,
+                  const bool Peek,
+                  const bool WaitForData,
+                  const bool Unicode,
+                  const bool Stream);
 
     size_t Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    size_t Prepend(const gsl::span<const INPUT_RECORD> inRecords);
 
     size_t Write(_Inout_ std::unique_ptr<IInputEvent> inEvent);
     size_t Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    size_t Write(const gsl::span<const INPUT_RECORD> inRecords);
+
+    bool Post(const gsl::span<const INPUT_RECORD> inRecords);
+    size_t FlushPostedInput() noexcept;
+
+    size_t WriteText(const std::wstring_view text);
+    size_t ReadText(const gsl::span<wchar_t> buffer) noexcept;
+
+    static bool s_IsValidRecord(const INPUT_RECORD& record) noexcept;
 
     bool IsInVirtualTerminalInputMode() const;
     Microsoft::Console::VirtualTerminal::TerminalInput& GetTerminalInput();
 
 private:
-    std::deque<std::unique_ptr<IInputEvent>> _storage;
+    InputRecordRing _storage;
+
+    // Text written with WriteText is kept as it is, rather than as the key
+    // events it stands for, until a reader asks for key events. Each run has a
+    // marker record in _storage, and the runs are kept in the same order as
+    // their markers. _textRunOffset is how much of the front run has been read.
+    // Only records with one of the public event types are ever stored (see
+    // s_IsValidRecord), so nothing written to the buffer can pass for a marker.
+    struct _TextRun
+    {
+        std::wstring text;
+
+        // The number of key events each char of the text is read as, counted
+        // when it's written so that the buffer can be counted without them.
+        std::vector<BYTE> keyEvents;
+
+        // The codepage the key events were counted with, and are created with.
+        unsigned int codepage;
+    };
+
+    std::deque<_TextRun> _textRuns;
+    size_t _textRunOffset;
+
+    // The number of key events the unread text of all the runs is read as.
+    size_t _textRunKeyEvents;
+
+    static constexpr WORD s_TextRunEventType = 0x8000;
+
+    // Records posted by producers that don't hold the console lock. They're
+    // moved into _storage, in order, before anything else is written to it.
+    InputPostQueue _postedInput;
+
+    // The time from the oldest unread event being written to it being read.
+    Microsoft::Console::Metrics::PendingLatency _unreadInput;
+
     std::unique_ptr<IInputEvent> _readPartialByteSequence;
     std::unique_ptr<IInputEvent> _writePartialByteSequence;
     Microsoft::Console::VirtualTerminal::TerminalInput _termInput;
 
-    void _ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& outEvents,
+    void _ReadBuffer(_Inout_ std::vector<INPUT_RECORD>& outRecords,
                      const size_t readCount,
                      _Out_ size_t& eventsRead,
                      const bool peek,
@@ -93,16 +147,21 @@ private:
                      const bool unicode,
                      const bool streamRead);
 
-    void _WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inRecords,
+    void _WriteBuffer(const gsl::span<const INPUT_RECORD> inRecords,
                       _Out_ size_t& eventsWritten,
                       _Out_ bool& setWaitEvent);
 
+    size_t _DrainPostedInput(_Out_ bool& setWaitEvent);
+    void _RecordReadEvents() noexcept;
+
     bool _CanCoalesce(const KeyEvent& a, const KeyEvent& b) const noexcept;
-    bool _CoalesceMouseMovedEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
-    bool _CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
-    void _HandleConsoleSuspensionEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    bool _CoalesceMouseMovedEvents(const INPUT_RECORD& inRecord) noexcept;
+    bool _CoalesceRepeatedKeyPressEvents(const INPUT_RECORD& inRecord) noexcept;
+    bool _HandleConsoleSuspensionEvent(const INPUT_RECORD& inRecord);
+
+    void _MaterializeFrontTextRun();
 
-    void _HandleTerminalInputCallback(_In_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    void _HandleTerminalInputCallback(const gsl::span<const INPUT_RECORD> records);
 
 #ifdef UNIT_TESTING
     friend class InputBufferTests;
@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "inputPostQueue.hpp"
+
+// Note:
+// - will throw on allocation failure
+InputPostQueue::InputPostQueue() :
+    _head{ 0 },
+    _tail{ 0 },
+    _records{ std::make_unique<INPUT_RECORD[]>(Capacity) },
+    _batches{ std::make_unique<_Batch[]>(Capacity) },
+    _unwrapped{ std::make_unique<INPUT_RECORD[]>(Capacity) }
+{
+}
+
+// Routine Description:
+// - Queues a copy of the records as one batch. Safe to call from any thread,
+//   without the console lock.
+// Arguments:
+// - records - the records to queue
+// - wasEmpty - on exit, true if nothing was queued before this batch, in which
+//   case the caller is the one that has to see that the queue gets drained.
+// Return Value:
+// - true if the batch was queued. false if there isn't room for it, in which
+//   case nothing is queued.
+bool InputPostQueue::TryPush(const gsl::span<const INPUT_RECORD> records, _Out_ bool& wasEmpty) noexcept
+{
+    wasEmpty = false;
+    const size_t size = records.size();
+    if (size == 0 || size > Capacity)
+    {
+        return size == 0;
+    }
+
+    // reserve the slots for the whole batch.
+    size_t position = _tail.load(std::memory_order_relaxed);
+    size_t head;
+    do
+    {
+        head = _head.load(std::memory_order_acquire);
+        if (position + size - head > Capacity)
+        {
+            return false;
+        }
+    } while (!_tail.compare_exchange_weak(position, position + size, std::memory_order_relaxed, std::memory_order_relaxed));
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        _records[(position + i) % Capacity] = records[i];
+    }
+
+    _Batch& batch = _batches[position % Capacity];
+    batch.size = size;
+    batch.posted = std::chrono::steady_clock::now();
+    batch.published.store(position + 1, std::memory_order_release);
+
+    wasEmpty = position == head;
+    return true;
+}
+
+// Routine Description:
+// - Returns true if nothing is queued. Another thread may push at any time,
+//   so this is only a hint unless the caller is the only producer.
+bool InputPostQueue::empty() const noexcept
+{
+    return _head.load(std::memory_order_relaxed) == _tail.load(std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Drops every batch published so far.
+void InputPostQueue::clear() noexcept
+{
+    const _Batch* batch;
+    while ((batch = _Front()) != nullptr)
+    {
+        _head.store(_head.load(std::memory_order_relaxed) + batch->size, std::memory_order_release);
+    }
+}
+
+// Routine Description:
+// - Returns the oldest batch, if it's been published.
+// Arguments:
+// - <none>
+// Return Value:
+// - The oldest batch. nullptr if nothing is queued, or if the oldest batch is
+//   still being copied in by its producer.
+// Note:
+// - Only the consumer may call this.
+const InputPostQueue::_Batch* InputPostQueue::_Front() const noexcept
+{
+    const size_t position = _head.load(std::memory_order_relaxed);
+    const _Batch& batch = _batches[position % Capacity];
+    if (batch.published.load(std::memory_order_acquire) != position + 1)
+    {
+        return nullptr;
+    }
+    return &batch;
+}
@@ -0,0 +1,103 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- inputPostQueue.hpp
+
+Abstract:
+- A lock-free queue of batches of INPUT_RECORDs, for producers that would
+  otherwise have to take the console lock just to hand input to the input buffer.
+- Any number of threads can push batches at once. A single consumer, holding
+  the console lock, takes every batch published so far in one go, in the order
+  they were pushed.
+- The records live in a ring that's allocated once, up front. A producer
+  reserves a contiguous run of slots for its whole batch with a
+  compare-exchange on the tail, copies its records in, and then publishes the
+  batch by stamping its first slot. The consumer stops at the first batch
+  that isn't published yet, and only gives slots back after it's done with
+  them, so neither side ever waits on the other, and nothing is allocated
+  once the queue exists.
+- A batch that doesn't fit in what's left of the ring isn't queued at all, and
+  the producer has to fall back to writing it under the console lock.
+--*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+class InputPostQueue final
+{
+public:
+    InputPostQueue();
+
+    InputPostQueue(const InputPostQueue&) = delete;
+    InputPostQueue& operator=(const InputPostQueue&) = delete;
+
+    // The most records that can be queued at once.
+    static constexpr size_t Capacity = 4096;
+
+    bool TryPush(const gsl::span<const INPUT_RECORD> records, _Out_ bool& wasEmpty) noexcept;
+    bool empty() const noexcept;
+    void clear() noexcept;
+
+    // Routine Description:
+    // - Takes every batch published so far, and hands them to the consumer in
+    //   the order they were pushed.
+    // Arguments:
+    // - consumer - called with the records of each batch, and the time it was pushed
+    // Return Value:
+    // - <none>
+    // Note:
+    // - Only one thread may drain the queue at a time.
+    // - If the consumer throws, the batch it threw on is dropped, and the rest
+    //   stay queued.
+    template<typename Consumer>
+    void Drain(Consumer consumer)
+    {
+        const _Batch* batch;
+        while ((batch = _Front()) != nullptr)
+        {
+            const size_t position = _head.load(std::memory_order_relaxed);
+            const size_t size = batch->size;
+            const auto posted = batch->posted;
+            auto pop = wil::scope_exit([&] { _head.store(position + size, std::memory_order_release); });
+
+            const size_t first = position % Capacity;
+            if (first + size <= Capacity)
+            {
+                consumer(gsl::make_span(&_records[first], size), posted);
+            }
+            else
+            {
+                // the batch wraps around the end of the ring.
+                const size_t beforeWrap = Capacity - first;
+                std::copy_n(&_records[first], beforeWrap, _unwrapped.get());
+                std::copy_n(&_records[0], size - beforeWrap, _unwrapped.get() + beforeWrap);
+                consumer(gsl::make_span(_unwrapped.get(), size), posted);
+            }
+        }
+    }
+
+private:
+    struct _Batch
+    {
+        // position + 1 once the batch that starts at position is published.
+        std::atomic<size_t> published{ 0 };
+        size_t size{ 0 };
+        std::chrono::steady_clock::time_point posted;
+    };
+
+    // Positions only ever grow; a position's slot is position % Capacity.
+    std::atomic<size_t> _head;
+    std::atomic<size_t> _tail;
+
+    std::unique_ptr<INPUT_RECORD[]> _records;
+    // Only the slot a batch starts at describes it.
+    std::unique_ptr<_Batch[]> _batches;
+    // Where a batch that wraps around the end of the ring is put back together.
+    std::unique_ptr<INPUT_RECORD[]> _unwrapped;
+
+    const _Batch* _Front() const noexcept;
+};
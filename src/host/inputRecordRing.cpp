@@ -0,0 +1,201 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "inputRecordRing.hpp"
+
+// Routine Description:
+// - Creates an empty ring. Nothing is allocated until the first record is stored.
+InputRecordRing::InputRecordRing() noexcept :
+    _records{},
+    _head{ 0 },
+    _size{ 0 }
+{
+}
+
+// Routine Description:
+// - Returns the number of records stored in the ring.
+size_t InputRecordRing::size() const noexcept
+{
+    return _size;
+}
+
+// Routine Description:
+// - Returns true if there are no records stored in the ring.
+bool InputRecordRing::empty() const noexcept
+{
+    return _size == 0;
+}
+
+// Routine Description:
+// - Returns the number of records the ring can hold before it has to grow.
+size_t InputRecordRing::capacity() const noexcept
+{
+    return _records.size();
+}
+
+// Routine Description:
+// - Makes room for at least count records, so that storing that many won't allocate.
+// Arguments:
+// - count - the number of records to make room for
+// Return Value:
+// - <none>
+// Note:
+// - will throw on allocation failure
+void InputRecordRing::reserve(const size_t count)
+{
+    if (count > capacity())
+    {
+        _Grow(count);
+    }
+}
+
+// Routine Description:
+// - Removes all of the records. The capacity is kept.
+void InputRecordRing::clear() noexcept
+{
+    _head = 0;
+    _size = 0;
+}
+
+INPUT_RECORD& InputRecordRing::front() noexcept
+{
+    return _records[_head];
+}
+
+const INPUT_RECORD& InputRecordRing::front() const noexcept
+{
+    return _records[_head];
+}
+
+INPUT_RECORD& InputRecordRing::back() noexcept
+{
+    return (*this)[_size - 1];
+}
+
+const INPUT_RECORD& InputRecordRing::back() const noexcept
+{
+    return (*this)[_size - 1];
+}
+
+// Routine Description:
+// - Returns the record at the given position, counting from the front of the queue.
+// Arguments:
+// - index - the position of the record. Must be less than size().
+INPUT_RECORD& InputRecordRing::operator[](const size_t index) noexcept
+{
+    return _records[_Wrap(_head + index)];
+}
+
+const INPUT_RECORD& InputRecordRing::operator[](const size_t index) const noexcept
+{
+    return _records[_Wrap(_head + index)];
+}
+
+// Routine Description:
+// - Stores a record at the back of the queue.
+// Arguments:
+// - record - the record to store
+// Return Value:
+// - <none>
+// Note:
+// - will throw on allocation failure, in which case the ring is unchanged
+void InputRecordRing::push_back(const INPUT_RECORD& record)
+{
+    if (_size == capacity())
+    {
+        _Grow(_size + 1);
+    }
+    _records[_Wrap(_head + _size)] = record;
+    ++_size;
+}
+
+// Routine Description:
+// - Stores a record at the front of the queue.
+// Arguments:
+// - record - the record to store
+// Return Value:
+// - <none>
+// Note:
+// - will throw on allocation failure, in which case the ring is unchanged
+void InputRecordRing::push_front(const INPUT_RECORD& record)
+{
+    if (_size == capacity())
+    {
+        _Grow(_size + 1);
+    }
+    _head = _Wrap(_head + capacity() - 1);
+    _records[_head] = record;
+    ++_size;
+}
+
+// Routine Description:
+// - Stores a run of records at the back of the queue, growing the ring at most once.
+// Arguments:
+// - records - the records to store, in order
+// Return Value:
+// - <none>
+// Note:
+// - will throw on allocation failure, in which case the ring is unchanged
+void InputRecordRing::append(const gsl::span<const INPUT_RECORD> records)
+{
+    reserve(_size + records.size());
+
+    // The free space starts just past the back and may wrap around the end
+    // of the storage, so the records are copied in at most two pieces.
+    const size_t start = _Wrap(_head + _size);
+    const size_t firstCount = std::min(records.size(), capacity() - start);
+    std::copy_n(records.begin(), firstCount, _records.begin() + start);
+    std::copy(records.begin() + firstCount, records.end(), _records.begin());
+
+    _size += records.size();
+}
+
+// Routine Description:
+// - Removes the record at the front of the queue. The ring must not be empty.
+void InputRecordRing::pop_front() noexcept
+{
+    _head = _Wrap(_head + 1);
+    --_size;
+}
+
+void InputRecordRing::swap(InputRecordRing& other) noexcept
+{
+    _records.swap(other._records);
+    std::swap(_head, other._head);
+    std::swap(_size, other._size);
+}
+
+// Routine Description:
+// - Maps a position past the head back into the storage.
+size_t InputRecordRing::_Wrap(const size_t index) const noexcept
+{
+    return index & (capacity() - 1);
+}
+
+// Routine Description:
+// - Moves the records into new storage that holds at least the given number
+//   of records, unwrapping them so that the front is at the start.
+// Arguments:
+// - minimumCapacity - the number of records the new storage must hold
+// Return Value:
+// - <none>
+// Note:
+// - will throw on allocation failure, in which case the ring is unchanged
+void InputRecordRing::_Grow(const size_t minimumCapacity)
+{
+    size_t newCapacity = std::max(capacity() * 2, s_MinimumCapacity);
+    while (newCapacity < minimumCapacity)
+    {
+        newCapacity *= 2;
+    }
+
+    std::vector<INPUT_RECORD> newRecords(newCapacity);
+    for (size_t i = 0; i < _size; ++i)
+    {
+        newRecords[i] = (*this)[i];
+    }
+
+    _records.swap(newRecords);
+    _head = 0;
+}
@@ -0,0 +1,85 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- inputRecordRing.hpp
+
+Abstract:
+- A first-in first-out queue of INPUT_RECORDs, used as the storage of the input buffer.
+- Records are stored by value in one contiguous ring, so queueing an event doesn't
+  allocate. The ring only allocates when it needs to grow, doubling its capacity
+  each time, and it never shrinks: a buffer that has taken a large paste keeps
+  the room for the next one.
+- The members are named after their std::deque counterparts, since that's what
+  this replaces.
+--*/
+
+#pragma once
+
+class InputRecordRing final
+{
+public:
+    InputRecordRing() noexcept;
+
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+    size_t capacity() const noexcept;
+
+    void reserve(const size_t count);
+    void clear() noexcept;
+
+    INPUT_RECORD& front() noexcept;
+    const INPUT_RECORD& front() const noexcept;
+    INPUT_RECORD& back() noexcept;
+    const INPUT_RECORD& back() const noexcept;
+    INPUT_RECORD& operator[](const size_t index) noexcept;
+    const INPUT_RECORD& operator[](const size_t index) const noexcept;
+
+    void push_back(const INPUT_RECORD& record);
+    void push_front(const INPUT_RECORD& record);
+    void append(const gsl::span<const INPUT_RECORD> records);
+    void pop_front() noexcept;
+
+    void swap(InputRecordRing& other) noexcept;
+
+    // Routine Description:
+    // - Removes every record that matches the predicate, keeping the order of the rest.
+    // Arguments:
+    // - predicate - called with each record, returns true if the record should be removed
+    // Return Value:
+    // - The number of records removed.
+    template<typename Predicate>
+    size_t erase_if(Predicate predicate)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < _size; ++i)
+        {
+            const INPUT_RECORD& record = (*this)[i];
+            if (!predicate(record))
+            {
+                if (kept != i)
+                {
+                    (*this)[kept] = record;
+                }
+                ++kept;
+            }
+        }
+
+        const size_t erased = _size - kept;
+        _size = kept;
+        return erased;
+    }
+
+private:
+    // The capacity is always zero or a power of two, so that an offset from
+    // the head can be wrapped with a mask instead of a division.
+    std::vector<INPUT_RECORD> _records;
+    size_t _head;
+    size_t _size;
+
+    static constexpr size_t s_MinimumCapacity = 32;
+
+    size_t _Wrap(const size_t index) const noexcept;
+    void _Grow(const size_t minimumCapacity);
+};
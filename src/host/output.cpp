@@ -280,10 +280,36 @@ static void _ScrollScreen(SCREEN_INFORMATION& screenInfo, const Viewport& source
     // Get the render target and send it commands.
     // It will figure out whether or not we're active and where the messages need to go.
     auto& render = screenInfo.GetRenderTarget();
-    // Redraw anything in the target area
-    render.TriggerRedraw(target);
-    // Also redraw anything that was filled.
-    render.TriggerRedraw(fill);
+
+    // If the rows only moved up or down, tell the renderer which region scrolled
+    //      and by how much. Some engines can replay that instead of repainting
+    //      the whole region. Then we only need to redraw the uncovered rows.
+    // This is only true if all of the source was filled. Otherwise, some rows
+    //      of the region kept their old contents.
+    const short dy = target.Top() - source.Top();
+    if (dy != 0 &&
+        target.Left() == source.Left() &&
+        target.Width() == source.Width() &&
+        fill.IsInBounds(source))
+    {
+        const auto region = Viewport::FromInclusive({ source.Left(),
+                                                      std::min(source.Top(), target.Top()),
+                                                      source.RightInclusive(),
+                                                      std::max(source.BottomInclusive(), target.BottomInclusive()) });
+        render.TriggerScrollRegion(region, dy);
+
+        for (const auto& uncovered : Viewport::Subtract(fill, target))
+        {
+            render.TriggerRedraw(uncovered);
+        }
+    }
+    else
+    {
+        // Redraw anything in the target area
+        render.TriggerRedraw(target);
+        // Also redraw anything that was filled.
+        render.TriggerRedraw(fill);
+    }
 }
 
 // Routine Description:
@@ -105,6 +105,20 @@ BOOL ConhostInternalGetSet::GetConsoleScreenBufferInfoEx(_Out_ CONSOLE_SCREEN_BU
     return TRUE;
 }
 
+// Routine Description:
+// - Connects the PrivateGetScreenBufferState call directly into our Driver Message servicing call inside Conhost.exe
+//   PrivateGetScreenBufferState is an internal-only "API" call that the vt commands can execute,
+//     but it is not represented as a function call on out public API surface.
+// Arguments:
+// - pState - Pointer to structure to hold the cursor position, viewport, buffer size, attributes and margins.
+// Return Value:
+// - TRUE if successful (see DoSrvPrivateGetScreenBufferState). FALSE otherwise.
+BOOL ConhostInternalGetSet::PrivateGetScreenBufferState(_Out_ Microsoft::Console::VirtualTerminal::ScreenBufferState* const pState) const
+{
+    DoSrvPrivateGetScreenBufferState(_io.GetActiveOutputBuffer(), *pState);
+    return TRUE;
+}
+
 // Routine Description:
 // - Connects the SetConsoleScreenBufferInfoEx API call directly into our Driver Message servicing call inside Conhost.exe
 // Arguments:
@@ -275,22 +289,59 @@ BOOL ConhostInternalGetSet::PrivateBoldText(const bool bolded)
 // Routine Description:
 // - Connects the WriteConsoleInput API call directly into our Driver Message servicing call inside Conhost.exe
 // Arguments:
-// - events - the input events to be copied into the head of the input
+// - records - the input records to be copied into the tail of the input
 // buffer for the underlying attached process
 // - eventsWritten - on output, the number of events written
 // Return Value:
 // - TRUE if successful (see DoSrvWriteConsoleInput). FALSE otherwise.
-BOOL ConhostInternalGetSet::PrivateWriteConsoleInputW(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& events,
+BOOL ConhostInternalGetSet::PrivateWriteConsoleInputW(const gsl::span<const INPUT_RECORD> records,
                                                       _Out_ size_t& eventsWritten)
 {
     eventsWritten = 0;
 
     return SUCCEEDED(DoSrvPrivateWriteConsoleInputW(_io.GetActiveInputBuffer(),
-                                                    events,
+                                                    records,
                                                     eventsWritten,
                                                     true)); // append
 }
 
+// Routine Description:
+// - Writes a run of text into the tail of the input buffer, without forming
+//   it into key events first.
+// Arguments:
+// - text - the text to be written
+// - charsWritten - on output, the number of characters written
+// Return Value:
+// - TRUE if successful (see DoSrvPrivateWriteConsoleInputText). FALSE otherwise.
+BOOL ConhostInternalGetSet::PrivateWriteConsoleInputText(const std::wstring_view text,
+                                                         _Out_ size_t& charsWritten)
+{
+    charsWritten = 0;
+
+    return SUCCEEDED(DoSrvPrivateWriteConsoleInputText(_io.GetActiveInputBuffer(),
+                                                       text,
+                                                       charsWritten));
+}
+
+// Routine Description:
+// - Posts input records to the input buffer, to be handed to readers with
+//   the next flush of posted input (see InputBuffer::Post). The VT input thread
+//   flushes once it's done with each chunk of input.
+// Arguments:
+// - records - the input records to be posted
+// Return Value:
+// - TRUE if successful. FALSE otherwise.
+BOOL ConhostInternalGetSet::PrivatePostConsoleInput(const gsl::span<const INPUT_RECORD> records)
+{
+    try
+    {
+        _io.GetActiveInputBuffer()->Post(records);
+        return TRUE;
+    }
+    CATCH_LOG();
+    return FALSE;
+}
+
 // Routine Description:
 // - Connects the ScrollConsoleScreenBuffer API call directly into our Driver Message servicing call inside Conhost.exe
 // Arguments:
@@ -607,6 +658,21 @@ BOOL ConhostInternalGetSet::PrivateEraseAll()
     return NT_SUCCESS(DoSrvPrivateEraseAll(_io.GetActiveOutputBuffer()));
 }
 
+// Routine Description:
+// - Connects the PrivateFillRect call directly into our Driver Message servicing call inside Conhost.exe
+//   PrivateFillRect is an internal-only "API" call that the vt commands can execute,
+//     but it is not represented as a function call on out public API surface.
+// Arguments:
+// - psrFill - The inclusive rectangle of the buffer to fill.
+// - wch - The character to fill the rectangle with.
+// - wAttributes - The attributes to fill the rectangle with.
+// Return Value:
+// - TRUE if successful (see DoSrvPrivateFillRect). FALSE otherwise.
+BOOL ConhostInternalGetSet::PrivateFillRect(const SMALL_RECT* const psrFill, const wchar_t wch, const WORD wAttributes)
+{
+    return SUCCEEDED(DoSrvPrivateFillRect(_io.GetActiveOutputBuffer(), *psrFill, wch, wAttributes));
+}
+
 // Routine Description:
 // - Connects the SetCursorStyle call directly into our Driver Message servicing call inside Conhost.exe
 //   SetCursorStyle is an internal-only "API" call that the vt commands can execute,
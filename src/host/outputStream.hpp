@@ -57,6 +57,7 @@ public:
     ConhostInternalGetSet(_In_ Microsoft::Console::IIoProvider& io);
 
     BOOL GetConsoleScreenBufferInfoEx(_Out_ CONSOLE_SCREEN_BUFFER_INFOEX* const pConsoleScreenBufferInfoEx) const override;
+    BOOL PrivateGetScreenBufferState(_Out_ Microsoft::Console::VirtualTerminal::ScreenBufferState* const pState) const override;
     BOOL SetConsoleScreenBufferInfoEx(const CONSOLE_SCREEN_BUFFER_INFOEX* const pConsoleScreenBufferInfoEx) override;
 
     BOOL SetConsoleCursorPosition(const COORD coordCursorPosition) override;
@@ -89,8 +90,13 @@ public:
 
     BOOL PrivateBoldText(const bool bolded) override;
 
-    BOOL PrivateWriteConsoleInputW(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& events,
-                            _Out_ size_t& eventsWritten) override;
+    BOOL PrivateWriteConsoleInputW(const gsl::span<const INPUT_RECORD> records,
+                                   _Out_ size_t& eventsWritten) override;
+
+    BOOL PrivateWriteConsoleInputText(const std::wstring_view text,
+                                      _Out_ size_t& charsWritten) override;
+
+    BOOL PrivatePostConsoleInput(const gsl::span<const INPUT_RECORD> records) override;
 
     BOOL ScrollConsoleScreenBufferW(const SMALL_RECT* pScrollRectangle,
                                     _In_opt_ const SMALL_RECT* pClipRectangle,
@@ -131,6 +137,7 @@ public:
     BOOL PrivateEnableAnyEventMouseMode(const bool fEnabled) override;
     BOOL PrivateEnableAlternateScroll(const bool fEnabled) override;
     BOOL PrivateEraseAll() override;
+    BOOL PrivateFillRect(const SMALL_RECT* const psrFill, const wchar_t wch, const WORD wAttributes) override;
 
     BOOL PrivateGetConsoleScreenBufferAttributes(_Out_ WORD* const pwAttributes) override;
 
@@ -578,6 +578,11 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
         bool CallWrite = true;
         const SHORT sScreenBufferSizeX = _screenInfo.GetBufferSize().Width();
 
+        // The line as it was echoed, before this char changes it, and the
+        // index of the first char that the change can have moved.
+        std::wstring before;
+        size_t firstChanged = 0;
+
         // processing in the middle of the line is more complex:
 
         // calculate new cursor position
@@ -594,6 +599,14 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
 
             if (_bufPtr != _backupLimit)
             {
+                if (_echoInput)
+                {
+                    try
+                    {
+                        before.assign(_backupLimit, _bytesRead / sizeof(WCHAR));
+                    }
+                    CATCH_LOG();
+                }
 
                 fStartFromDelim = IsWordDelim(_bufPtr[-1]);
 
@@ -642,6 +655,9 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
                         loop = true;
                     }
                 }
+
+                // The backspaces left the cursor on the first char that moved.
+                firstChanged = _currentPosition;
             }
             else
             {
@@ -665,6 +681,13 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
 
                 if (_echoInput)
                 {
+                    try
+                    {
+                        before.assign(_backupLimit, _bytesRead / sizeof(WCHAR));
+                    }
+                    CATCH_LOG();
+                    firstChanged = _currentPosition;
+
                     if (CheckBisectProcessW(_screenInfo,
                                             _backupLimit,
                                             _currentPosition + 1,
@@ -707,27 +730,29 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
             CursorPosition = _screenInfo.GetTextBuffer().GetCursor().GetPosition();
             CursorPosition.X = (SHORT)(CursorPosition.X + NumSpaces);
 
-            // clear the current command line from the screen
-#pragma prefast(suppress:__WARNING_BUFFER_OVERFLOW, "Not sure why prefast doesn't like this call.")
-            DeleteCommandLine(*this, FALSE);
-
-            // write the new command line to the screen
-            NumToWrite = _bytesRead;
-
-            DWORD dwFlags = WC_DESTRUCTIVE_BACKSPACE | WC_ECHO;
             if (wch == UNICODE_CARRIAGERETURN)
             {
-                dwFlags |= WC_KEEP_CURSOR_VISIBLE;
+                // clear the current command line from the screen
+#pragma prefast(suppress:__WARNING_BUFFER_OVERFLOW, "Not sure why prefast doesn't like this call.")
+                DeleteCommandLine(*this, FALSE);
+
+                // write the new command line to the screen
+                NumToWrite = _bytesRead;
+                status = WriteCharsLegacy(_screenInfo,
+                                          _backupLimit,
+                                          _backupLimit,
+                                          _backupLimit,
+                                          &NumToWrite,
+                                          &_visibleCharCount,
+                                          _originalCursorPosition.X,
+                                          WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_ECHO,
+                                          &ScrollY);
+            }
+            else
+            {
+                // write just the part of the command line that changed
+                status = EchoChangedTail(before, firstChanged, ScrollY);
             }
-            status = WriteCharsLegacy(_screenInfo,
-                                      _backupLimit,
-                                      _backupLimit,
-                                      _backupLimit,
-                                      &NumToWrite,
-                                      &_visibleCharCount,
-                                      _originalCursorPosition.X,
-                                      dwFlags,
-                                      &ScrollY);
             if (!NT_SUCCESS(status))
             {
                 RIPMSG1(RIP_WARNING, "WriteCharsLegacy failed 0x%x", status);
@@ -856,6 +881,87 @@ size_t COOKED_READ_DATA::Write(const std::wstring_view wstr)
     return charsInserted;
 }
 
+// Routine Description:
+// - Echoes an edit in the middle of the prompt by writing just the cells that
+//   changed, rather than erasing the whole line and writing it out again.
+// - The chars before the first one that changed are still in the right cells,
+//   so they're left alone. So are the chars after the last one that changed,
+//   if the ones in between take up as many cells as they did before, which is
+//   the case when overwriting narrow glyphs. Otherwise everything after the
+//   change has moved, and is written again, with blanks over the cells the
+//   line no longer reaches.
+// Arguments:
+// - before - the prompt text as it was echoed before the edit
+// - first - the index of the first char that the edit could have changed. The
+//           chars before it must be the same as before, and the cursor must be
+//           in the cell of this char.
+// - scrollY - receives how far the screen scrolled to fit the line
+// Return Value:
+// - STATUS_SUCCESS, or the failure from writing to the screen.
+// Note:
+// - The cursor is left after the last cell written. The callers put it back
+//   where it belongs.
+[[nodiscard]]
+NTSTATUS COOKED_READ_DATA::EchoChangedTail(const std::wstring_view before, const size_t first, SHORT& scrollY)
+{
+    scrollY = 0;
+
+    const std::wstring_view after{ _backupLimit, _bytesRead / sizeof(WCHAR) };
+    const auto oldTail = before.substr(std::min(first, before.size()));
+    const auto newTail = after.substr(std::min(first, after.size()));
+
+    size_t unchanged = 0;
+    while (unchanged < oldTail.size() &&
+           unchanged < newTail.size() &&
+           oldTail.at(oldTail.size() - 1 - unchanged) == newTail.at(newTail.size() - 1 - unchanged))
+    {
+        ++unchanged;
+    }
+    const auto oldChanged = oldTail.substr(0, oldTail.size() - unchanged);
+    const auto newChanged = newTail.substr(0, newTail.size() - unchanged);
+
+    const SHORT cursorX = _screenInfo.GetTextBuffer().GetCursor().GetPosition().X;
+    const size_t oldCells = RetrieveTotalNumberOfSpaces(cursorX, oldTail.data(), oldTail.size());
+    const size_t newCells = RetrieveTotalNumberOfSpaces(cursorX, newTail.data(), newTail.size());
+
+    const bool tailStays = oldChanged.size() == newChanged.size() &&
+                           IsGlyphRunNarrow(oldChanged) &&
+                           IsGlyphRunNarrow(newChanged);
+    const auto changed = tailStays ? newChanged : newTail;
+
+    if (!changed.empty())
+    {
+        size_t bytesToWrite = changed.size() * sizeof(WCHAR);
+        const NTSTATUS status = WriteCharsLegacy(_screenInfo,
+                                                 _backupLimit,
+                                                 changed.data(),
+                                                 changed.data(),
+                                                 &bytesToWrite,
+                                                 nullptr,
+                                                 _originalCursorPosition.X,
+                                                 WC_DESTRUCTIVE_BACKSPACE | WC_ECHO,
+                                                 &scrollY);
+        if (!NT_SUCCESS(status))
+        {
+            RIPMSG1(RIP_WARNING, "WriteCharsLegacy failed 0x%x", status);
+            return status;
+        }
+    }
+
+    if (oldCells > newCells)
+    {
+        try
+        {
+            const COORD lineEnd = _screenInfo.GetTextBuffer().GetCursor().GetPosition();
+            _screenInfo.Write(OutputCellIterator(UNICODE_SPACE, oldCells - newCells), lineEnd);
+        }
+        CATCH_LOG();
+    }
+
+    _visibleCharCount = _visibleCharCount + newCells >= oldCells ? _visibleCharCount + newCells - oldCells : 0;
+    return STATUS_SUCCESS;
+}
+
 // Routine Description:
 // - saves data in the prompt buffer to the outgoing user buffer
 // Arguments:
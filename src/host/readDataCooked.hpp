@@ -60,6 +60,9 @@ public:
 
     size_t Write(const std::wstring_view wstr);
 
+    [[nodiscard]]
+    NTSTATUS EchoChangedTail(const std::wstring_view before, const size_t first, SHORT& scrollY);
+
     void ProcessAliases(DWORD& lineCount);
 
     [[nodiscard]]
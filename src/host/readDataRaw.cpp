@@ -164,6 +164,19 @@ bool RAW_READ_DATA::Notify(const WaitTerminationReason TerminationReason,
             *pNumBytes += sizeof(WCHAR);
             while (*pNumBytes < _BufferSize)
             {
+                // take as much pasted text as fits at once.
+                const size_t textRead = _pInputBuffer->ReadText(gsl::make_span(lpBuffer, (_BufferSize - *pNumBytes) / sizeof(WCHAR)));
+                if (textRead != 0)
+                {
+                    for (size_t i = 0; i < textRead; ++i)
+                    {
+                        NumBytes += IsGlyphFullWidth(lpBuffer[i]) ? 2 : 1;
+                    }
+                    lpBuffer += textRead;
+                    *pNumBytes += textRead * sizeof(WCHAR);
+                    continue;
+                }
+
                 // This call to GetChar won't block.
                 *pReplyStatus = GetChar(_pInputBuffer,
                                         lpBuffer,
@@ -49,6 +49,7 @@ SCREEN_INFORMATION::SCREEN_INFORMATION(
     _viewport(Viewport::Empty()),
     _psiAlternateBuffer{ nullptr },
     _psiMainBuffer{ nullptr },
+    _psiCachedAltBuffer{ nullptr },
     _rcAltSavedClientNew{ 0 },
     _rcAltSavedClientOld{ 0 },
     _fAltWindowChanged{ false },
@@ -212,13 +213,29 @@ void SCREEN_INFORMATION::s_InsertScreenBuffer(_In_ SCREEN_INFORMATION* const pSc
 }
 
 // Routine Description:
-// - This routine removes the screen buffer pointer from the console's list of screen buffers.
+// - This routine removes the screen buffer pointer from the console's list of screen buffers, and frees it.
 // Arguments:
 // - ScreenInfo - Pointer to screen information structure.
 // Return Value:
 // Note:
 // - The console lock must be held when calling this routine.
 void SCREEN_INFORMATION::s_RemoveScreenBuffer(_In_ SCREEN_INFORMATION* const pScreenInfo)
+{
+    s_UnlinkScreenBuffer(pScreenInfo);
+
+    delete pScreenInfo;
+}
+
+// Routine Description:
+// - This routine removes the screen buffer pointer from the console's list of
+//   screen buffers, without freeing it. If it was the active buffer, another
+//   one is made active.
+// Arguments:
+// - ScreenInfo - Pointer to screen information structure.
+// Return Value:
+// Note:
+// - The console lock must be held when calling this routine.
+void SCREEN_INFORMATION::s_UnlinkScreenBuffer(_In_ SCREEN_INFORMATION* const pScreenInfo)
 {
     CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
     if (pScreenInfo == gci.ScreenBuffers)
@@ -256,8 +273,6 @@ void SCREEN_INFORMATION::s_RemoveScreenBuffer(_In_ SCREEN_INFORMATION* const pSc
             gci.pCurrentScreenBuffer = nullptr;
         }
     }
-
-    delete pScreenInfo;
 }
 
 #pragma endregion
@@ -300,6 +315,10 @@ void SCREEN_INFORMATION::_FreeOutputStateMachine()
             s_RemoveScreenBuffer(_psiAlternateBuffer);
         }
 
+        // The cached alt buffer isn't in the list of screen buffers anymore.
+        delete _psiCachedAltBuffer;
+        _psiCachedAltBuffer = nullptr;
+
         _stateMachine.reset();
     }
 }
@@ -1631,6 +1650,13 @@ NTSTATUS SCREEN_INFORMATION::ResizeWithReflow(const COORD coordNewScreenSize)
         // Save old cursor size before we delete it
         ULONG const ulSize = oldCursor.GetSize();
 
+        // Keep highlighting the matches of the search, where they are now.
+        try
+        {
+            newTextBuffer->TakeSearchSession(*_textBuffer);
+        }
+        CATCH_LOG();
+
         _textBuffer.swap(newTextBuffer);
 
         // Set size back to real size as it will be taking over the rendering duties.
@@ -2001,6 +2027,9 @@ const SCREEN_INFORMATION& SCREEN_INFORMATION::GetMainBuffer() const
 // - Instantiates a new buffer to be used as an alternate buffer. This buffer
 //     does not have a driver handle associated with it and shares a state
 //     machine with the main buffer it belongs to.
+// - If the main buffer kept the last alternate buffer around, and it's still
+//     the right size, it's cleared and reused instead, so that applications
+//     that switch buffers often don't allocate a whole buffer every time.
 // TODO: MSFT:19817348 Don't create alt screenbuffer's via an out SCREEN_INFORMATION**
 // Parameters:
 // - ppsiNewScreenBuffer - a pointer to recieve the newly created buffer.
@@ -2014,13 +2043,41 @@ NTSTATUS SCREEN_INFORMATION::_CreateAltBuffer(_Out_ SCREEN_INFORMATION** const p
 
     const FontInfo& existingFont = GetCurrentFont();
 
-    NTSTATUS Status = SCREEN_INFORMATION::CreateInstance(WindowSize,
-                                                         existingFont,
-                                                         WindowSize,
-                                                         GetAttributes(),
-                                                         *GetPopupAttributes(),
-                                                         CURSOR_SMALL_SIZE,
-                                                         ppsiNewScreenBuffer);
+    SCREEN_INFORMATION& siMain = GetMainBuffer();
+    SCREEN_INFORMATION* const psiCachedBuffer = siMain._psiCachedAltBuffer;
+    siMain._psiCachedAltBuffer = nullptr;
+
+    NTSTATUS Status = STATUS_SUCCESS;
+    if (psiCachedBuffer != nullptr &&
+        psiCachedBuffer->GetBufferSize().Dimensions() == WindowSize &&
+        psiCachedBuffer->GetCurrentFont() == existingFont)
+    {
+        psiCachedBuffer->_ResetCachedAltBuffer(WindowSize, GetAttributes(), *GetPopupAttributes());
+        *ppsiNewScreenBuffer = psiCachedBuffer;
+    }
+    else
+    {
+        // The cached buffer is the wrong size. It doesn't own the state machine, so this leaves ours alone.
+        delete psiCachedBuffer;
+
+        Status = SCREEN_INFORMATION::CreateInstance(WindowSize,
+                                                    existingFont,
+                                                    WindowSize,
+                                                    GetAttributes(),
+                                                    *GetPopupAttributes(),
+                                                    CURSOR_SMALL_SIZE,
+                                                    ppsiNewScreenBuffer);
+        if (NT_SUCCESS(Status))
+        {
+            // delete the alt buffer's state machine. We don't want it.
+            (*ppsiNewScreenBuffer)->_FreeOutputStateMachine(); // this has to be done before we give it a main buffer
+            // we'll attach the GetSet, etc once we successfully make this buffer the active buffer.
+
+            // Set up the new buffers references to our current state machine, dispatcher, getset, etc.
+            (*ppsiNewScreenBuffer)->_stateMachine = _stateMachine;
+        }
+    }
+
     if (NT_SUCCESS(Status))
     {
         // Update the alt buffer's cursor style to match our own.
@@ -2030,19 +2087,48 @@ NTSTATUS SCREEN_INFORMATION::_CreateAltBuffer(_Out_ SCREEN_INFORMATION** const p
 
         s_InsertScreenBuffer(createdBuffer);
 
-        // delete the alt buffer's state machine. We don't want it.
-        createdBuffer->_FreeOutputStateMachine(); // this has to be done before we give it a main buffer
-        // we'll attach the GetSet, etc once we successfully make this buffer the active buffer.
-
-        // Set up the new buffers references to our current state machine, dispatcher, getset, etc.
-        createdBuffer->_stateMachine = _stateMachine;
-
         // Setup the alt buffer's tabs stops with the default tab stop settings
         createdBuffer->SetDefaultVtTabStops();
     }
     return Status;
 }
 
+// Routine Description:
+// - Puts a cached alternate buffer back into the state of a newly created
+//     one: blank, with the cursor at the origin, and with the given size and
+//     attributes. Only the text in it is touched, nothing is allocated.
+// Parameters:
+// - coordSize - The size of the buffer, which is also the size of its viewport.
+// - attributes - The attributes to fill the buffer with.
+// - popupAttributes - The attributes to use for popups.
+// Return value:
+// - <none>
+void SCREEN_INFORMATION::_ResetCachedAltBuffer(const COORD coordSize,
+                                               const TextAttribute attributes,
+                                               const TextAttribute popupAttributes)
+{
+    // An app may have changed the mode of the buffer while it was active.
+    OutputMode = ENABLE_PROCESSED_OUTPUT | ENABLE_WRAP_AT_EOL_OUTPUT;
+    const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    if (gci.GetVirtTermLevel() != 0)
+    {
+        OutputMode |= ENABLE_VIRTUAL_TERMINAL_PROCESSING;
+    }
+
+    _viewport = Viewport::FromDimensions({ 0, 0 }, coordSize);
+    UpdateBottom();
+    _scrollMargins = Viewport::FromCoord({ 0 });
+
+    SetAttributes(attributes);
+    SetPopupAttributes(popupAttributes);
+    _textBuffer->Reset();
+
+    auto& cursor = _textBuffer->GetCursor();
+    cursor.SetPosition({ 0, 0 });
+    cursor.SetIsVisible(true);
+    cursor.ResetDelayEOLWrap();
+}
+
 // Routine Description:
 // - Creates an "alternate" screen buffer for this buffer. In virtual terminals, there exists both a "main"
 //     screen buffer and an alternate. ASBSET creates a new alternate, and switches to it. If there is an already
@@ -2117,10 +2203,14 @@ void SCREEN_INFORMATION::UseMainScreenBuffer()
         // send a _coordScreenBufferSizeChangeEvent for the new Sb viewport
         ScreenBufferSizeChange(psiMain->GetBufferSize().Dimensions());
 
+        // Keep the alt buffer around instead of deleting it, so the next
+        // alt buffer can reuse it. It still shares our state machine, but
+        // it's not in the list of screen buffers anymore.
         SCREEN_INFORMATION* psiAlt = psiMain->_psiAlternateBuffer;
         psiMain->_psiAlternateBuffer = nullptr;
-        s_RemoveScreenBuffer(psiAlt); // this will also delete the alt buffer
-        // deleting the alt buffer will give the GetSet back to it's main
+        s_UnlinkScreenBuffer(psiAlt);
+        delete psiMain->_psiCachedAltBuffer;
+        psiMain->_psiCachedAltBuffer = psiAlt;
 
         // Tell the VT MouseInput handler that we're in the main buffer now
         gci.terminalMouseInput.UseMainScreenBuffer();
@@ -2486,8 +2576,7 @@ HRESULT SCREEN_INFORMATION::VtEraseAll()
     RETURN_IF_FAILED(SetCursorPosition(relativeCursor, false));
 
     // Update all the rows in the current viewport with the currently active attributes.
-    OutputCellIterator it(GetAttributes());
-    WriteRect(it, _viewport);
+    _textBuffer->FillRect(_viewport, UNICODE_SPACE, GetAttributes());
 
     return S_OK;
 }
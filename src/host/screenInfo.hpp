@@ -126,6 +126,7 @@ public:
     // TODO: MSFT 9355062 these methods should probably be a part of construction/destruction. http://osgvsowi/9355062
     static void s_InsertScreenBuffer(_In_ SCREEN_INFORMATION* const pScreenInfo);
     static void s_RemoveScreenBuffer(_In_ SCREEN_INFORMATION* const pScreenInfo);
+    static void s_UnlinkScreenBuffer(_In_ SCREEN_INFORMATION* const pScreenInfo);
 
     OutputCellRect ReadRect(const Microsoft::Console::Types::Viewport location) const;
 
@@ -290,6 +291,7 @@ private:
 
     [[nodiscard]]
     NTSTATUS _CreateAltBuffer(_Out_ SCREEN_INFORMATION** const ppsiNewScreenBuffer);
+    void _ResetCachedAltBuffer(const COORD coordSize, const TextAttribute attributes, const TextAttribute popupAttributes);
 
     bool _IsAltBuffer() const;
     bool _IsInPtyMode() const;
@@ -304,6 +306,7 @@ private:
 
     SCREEN_INFORMATION* _psiAlternateBuffer; // The VT "Alternate" screen buffer.
     SCREEN_INFORMATION* _psiMainBuffer; // A pointer to the main buffer, if this is the alternate buffer.
+    SCREEN_INFORMATION* _psiCachedAltBuffer; // The last alternate buffer, kept after switching back to the main buffer so the next one can reuse it.
 
     RECT _rcAltSavedClientNew;
     RECT _rcAltSavedClientOld;
@@ -6,9 +6,6 @@
 #include "search.h"
 
 #include "dbcs.h"
-#include "../buffer/out/CharRow.hpp"
-#include "../types/inc/Utf16Parser.hpp"
-#include "../types/inc/GlyphWidth.hpp"
 
 // Routine Description:
 // - Constructs a Search object.
@@ -19,14 +16,20 @@
 // - str - The search term you want to find (the "needle")
 // - direction - The direction to search (upward or downward)
 // - sensitivity - Whether or not you care about case
+// - syntax - Whether the search term is plain text or a regular expression
+// Note:
+// - Throws E_INVALIDARG if the search term is a regular expression that can't
+//   be compiled. See RegexMatcher for the syntax that's supported.
 Search::Search(const SCREEN_INFORMATION& screenInfo,
                const std::wstring& str,
                const Direction direction,
-               const Sensitivity sensitivity) :
+               const Sensitivity sensitivity,
+               const Syntax syntax) :
     _direction(direction),
     _sensitivity(sensitivity),
     _screenInfo(screenInfo),
-    _needle(s_CreateNeedleFromString(str)),
+    _needle(syntax == Syntax::Literal ? str : std::wstring{}, sensitivity == Sensitivity::CaseInsensitive),
+    _regex(s_CreateRegex(str, sensitivity, syntax)),
     _coordAnchor(s_GetInitialAnchor(screenInfo, direction))
 {
     _coordNext = _coordAnchor;
@@ -42,15 +45,21 @@ Search::Search(const SCREEN_INFORMATION& screenInfo,
 // - direction - The direction to search (upward or downward)
 // - sensitivity - Whether or not you care about case
 // - anchor - starting search location in screenInfo
+// - syntax - Whether the search term is plain text or a regular expression
+// Note:
+// - Throws E_INVALIDARG if the search term is a regular expression that can't
+//   be compiled. See RegexMatcher for the syntax that's supported.
 Search::Search(const SCREEN_INFORMATION& screenInfo,
                const std::wstring& str,
                const Direction direction,
                const Sensitivity sensitivity,
-               const COORD anchor) :
+               const COORD anchor,
+               const Syntax syntax) :
     _direction(direction),
     _sensitivity(sensitivity),
     _screenInfo(screenInfo),
-    _needle(s_CreateNeedleFromString(str)),
+    _needle(syntax == Syntax::Literal ? str : std::wstring{}, sensitivity == Sensitivity::CaseInsensitive),
+    _regex(s_CreateRegex(str, sensitivity, syntax)),
     _coordAnchor(anchor)
 {
     _coordNext = _coordAnchor;
@@ -71,21 +80,39 @@ bool Search::FindNext()
         return false;
     }
 
-    do
+    std::optional<std::pair<COORD, COORD>> found;
+    if (_regex.has_value())
     {
-        if (_FindNeedleInHaystackAt(_coordNext, _coordSelStart, _coordSelEnd))
-        {
-            _UpdateNextPosition();
-            _reachedEnd = _coordNext == _coordAnchor;
-            return true;
-        }
-        else
+        found = _FindNextRegexMatch();
+    }
+    else
+    {
+        const auto& textBuffer = _screenInfo.GetTextBuffer();
+        const auto start = _needle.FindFirst(textBuffer,
+                                             _coordNext,
+                                             _CountPositionsToAnchor(),
+                                             _direction == Direction::Forward);
+        if (start.has_value())
         {
-            _UpdateNextPosition();
+            found = std::make_pair(start.value(), _needle.GetMatchEnd(textBuffer, start.value()));
         }
+    }
+
+    if (found.has_value())
+    {
+        _coordSelStart = found.value().first;
+        _coordSelEnd = found.value().second;
 
-    } while (_coordNext != _coordAnchor);
+        _coordNext = _coordSelStart;
+        _UpdateNextPosition();
+        _reachedEnd = _coordNext == _coordAnchor;
+        return true;
+    }
 
+    // Every position up to the anchor was checked, so the next search starts over from there.
+    _coordSelStart = { 0 };
+    _coordSelEnd = { 0 };
+    _coordNext = _coordAnchor;
     return false;
 }
 
@@ -164,91 +191,76 @@ COORD Search::s_GetInitialAnchor(const SCREEN_INFORMATION& screenInfo, const Dir
 }
 
 // Routine Description:
-// - Attempts to compare the search term (the needle) to the screen buffer (the haystack)
-//   at the given coordinate position of the screen buffer.
-// - Performs one comparison. Call again with new positions to check other spots.
-// Arguments:
-// - pos - The position in the haystack (screen buffer) to compare
-// - start - If we found it, this is filled with the coordinate of the first character of the needle.
-// - end - If we found it, this is filled with the coordinate of the last character of the needle.
+// - Counts the positions left to check, stepping from the next position in the
+//   direction of the search until we get back around to the anchor.
 // Return Value:
-// - True if we found it. False if not.
-bool Search::_FindNeedleInHaystackAt(const COORD pos, COORD& start, COORD& end) const
+// - The number of positions left. Every position in the buffer if the next
+//   position is the anchor.
+size_t Search::_CountPositionsToAnchor() const
 {
-    start = { 0 };
-    end = { 0 };
-
-    COORD bufferPos = pos;
-
-    for (const auto& needleCell : _needle)
-    {
-        // Haystack is the buffer. Needle is the string we were given.
-        const auto hayIter = _screenInfo.GetTextDataAt(bufferPos);
-        const auto hayChars = *hayIter;
-        const auto needleChars = std::wstring_view(needleCell.data(), needleCell.size());
-
-        // If we didn't match at any point of the needle, return false.
-        if (!_CompareChars(hayChars, needleChars))
-        {
-            return false;
-        }
-
-        _IncrementCoord(bufferPos);
-    }
-
-    _DecrementCoord(bufferPos);
+    const auto bufferSize = _screenInfo.GetBufferSize();
+    const size_t width = bufferSize.Width();
+    const size_t total = width * bufferSize.Height();
 
-    // If we made it the whole way through the needle, then it was in the haystack.
-    // Fill out the span that we found the result at and return true.
-    start = pos;
-    end = bufferPos;
+    const size_t next = _coordNext.Y * width + _coordNext.X;
+    const size_t anchor = _coordAnchor.Y * width + _coordAnchor.X;
 
-    return true;
+    const size_t count = _direction == Direction::Forward ? (anchor + total - next) % total : (next + total - anchor) % total;
+    return count == 0 ? total : count;
 }
 
 // Routine Description:
-// - Provides an abstraction for comparing two spans of text.
-// - Internally handles case sensitivity based on object construction.
-// Arguments:
-// - one - String view representing the first string of text
-// - two - String view representing the second string of text
+// - Finds the regular expression match that starts closest to the next
+//   position, in the direction of the search, without going past the anchor.
+// - A match depends on the whole line around it, so the matches can't be
+//   looked for from an arbitrary cell the way a plain string can. Instead,
+//   the whole buffer is searched the first time through, and the matches kept.
 // Return Value:
-// - True if they are the same. False otherwise.
-bool Search::_CompareChars(const std::wstring_view one, const std::wstring_view two) const
+// - The first and last cell of the match, or nullopt if there isn't one.
+std::optional<std::pair<COORD, COORD>> Search::_FindNextRegexMatch()
 {
-    if (one.size() != two.size())
+    if (!_regexMatches.has_value())
     {
-        return false;
+        _regexMatches = _regex.value().FindAll(_screenInfo.GetTextBuffer());
     }
 
-    for (size_t i = 0; i < one.size(); i++)
+    const auto bufferSize = _screenInfo.GetBufferSize();
+    const size_t width = bufferSize.Width();
+    const size_t total = width * bufferSize.Height();
+    const size_t next = _coordNext.Y * width + _coordNext.X;
+
+    std::optional<std::pair<COORD, COORD>> closest;
+    size_t closestDistance = _CountPositionsToAnchor();
+    for (const auto& match : _regexMatches.value())
     {
-        if (_ApplySensitivity(one[i]) != _ApplySensitivity(two[i]))
+        const size_t start = match.first.Y * width + match.first.X;
+        const size_t distance = _direction == Direction::Forward ? (start + total - next) % total : (next + total - start) % total;
+        if (distance < closestDistance)
         {
-            return false;
+            closest = match;
+            closestDistance = distance;
         }
     }
-
-    return true;
+    return closest;
 }
 
 // Routine Description:
-// - Provides an abstraction for conditionally applying case sensitivity
-//   based on object construction
+// - Compiles the search term if it's a regular expression.
 // Arguments:
-// - wch - Character to adjust if necessary
+// - str - The search term
+// - sensitivity - Whether or not you care about case
+// - syntax - Whether the search term is plain text or a regular expression
 // Return Value:
-// - Adjusted value (or not).
-wchar_t Search::_ApplySensitivity(const wchar_t wch) const
+// - The compiled search, or nullopt if the search term is plain text.
+std::optional<TextBufferRegexSearch> Search::s_CreateRegex(const std::wstring& str,
+                                                          const Sensitivity sensitivity,
+                                                          const Syntax syntax)
 {
-    if (_sensitivity == Sensitivity::CaseInsensitive)
-    {
-        return ::towlower(wch);
-    }
-    else
+    if (syntax == Syntax::RegularExpression)
     {
-        return wch;
+        return std::make_optional<TextBufferRegexSearch>(str, sensitivity == Sensitivity::CaseInsensitive);
     }
+    return std::nullopt;
 }
 
 // Routine Description:
@@ -288,25 +300,3 @@ void Search::_UpdateNextPosition()
         THROW_HR(E_NOTIMPL);
     }
 }
-
-// Routine Description:
-// - Creates a "needle" of the correct format for comparison to the screen buffer text data
-//   that we can use for our search
-// Arguments:
-// - wstr - String that will be our search term
-// Return Value:
-// - Structured text data for comparison to screen buffer text data.
-std::vector<std::vector<wchar_t>> Search::s_CreateNeedleFromString(const std::wstring& wstr)
-{
-    const auto charData = Utf16Parser::Parse(wstr);
-    std::vector<std::vector<wchar_t>> cells;
-    for (const auto chars : charData)
-    {
-        if (IsGlyphFullWidth(std::wstring_view{ chars.data(), chars.size() }))
-        {
-            cells.emplace_back(chars);
-        }
-        cells.emplace_back(chars);
-    }
-    return cells;
-}
@@ -17,6 +17,9 @@ Revision History:
 
 #pragma once
 
+#include "../buffer/out/textBufferSearch.hpp"
+#include "../buffer/out/textBufferRegexSearch.hpp"
+
 // This used to be in find.h.
 #define SEARCH_STRING_LENGTH    (80)
 
@@ -35,16 +38,24 @@ public:
         CaseSensitive
     };
 
+    enum class Syntax
+    {
+        Literal,
+        RegularExpression
+    };
+
     Search(const SCREEN_INFORMATION& ScreenInfo,
            const std::wstring& str,
            const Direction dir,
-           const Sensitivity sensitivity);
+           const Sensitivity sensitivity,
+           const Syntax syntax = Syntax::Literal);
 
     Search(const SCREEN_INFORMATION& ScreenInfo,
            const std::wstring& str,
            const Direction dir,
            const Sensitivity sensitivity,
-           const COORD anchor);
+           const COORD anchor,
+           const Syntax syntax = Syntax::Literal);
 
     bool FindNext();
     void Select() const;
@@ -54,16 +65,17 @@ public:
 
 private:
 
-    wchar_t _ApplySensitivity(const wchar_t wch) const;
-    bool Search::_FindNeedleInHaystackAt(const COORD pos, COORD& start, COORD& end) const;
-    bool _CompareChars(const std::wstring_view one, const std::wstring_view two) const;
+    size_t _CountPositionsToAnchor() const;
+    std::optional<std::pair<COORD, COORD>> _FindNextRegexMatch();
     void _UpdateNextPosition();
 
     void _IncrementCoord(COORD& coord) const;
     void _DecrementCoord(COORD& coord) const;
 
     static COORD s_GetInitialAnchor(const SCREEN_INFORMATION& screenInfo, const Direction dir);
-    static std::vector<std::vector<wchar_t>> s_CreateNeedleFromString(const std::wstring& wstr);
+    static std::optional<TextBufferRegexSearch> s_CreateRegex(const std::wstring& str,
+                                                              const Sensitivity sensitivity,
+                                                              const Syntax syntax);
 
     bool _reachedEnd = false;
     COORD _coordNext = { 0 };
@@ -71,7 +83,13 @@ private:
     COORD _coordSelEnd = { 0 };
 
     const COORD _coordAnchor;
-    const std::vector<std::vector<wchar_t>> _needle;
+    const TextBufferSearch _needle;
+
+    // Only set when searching for a regular expression. Its matches are all
+    // found the first time through, and kept for the rest of the search.
+    const std::optional<TextBufferRegexSearch> _regex;
+    std::optional<std::vector<TextBufferRegexSearch::Match>> _regexMatches;
+
     const Direction _direction;
     const Sensitivity _sensitivity;
     const SCREEN_INFORMATION& _screenInfo;
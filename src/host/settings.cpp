@@ -55,7 +55,9 @@ Settings::Settings() :
     _DefaultForeground(INVALID_COLOR),
     _DefaultBackground(INVALID_COLOR),
     _fUseDx(false),
-    _fCopyColor(false)
+    _fCopyColor(false),
+    _fPersistHistory(false),
+    _dwFrameLimit(0)
 {
     _dwScreenBufferSize.X = 80;
     _dwScreenBufferSize.Y = 25;
@@ -946,3 +948,16 @@ bool Settings::GetCopyColor() const noexcept
 {
     return _fCopyColor;
 }
+
+bool Settings::GetPersistHistory() const noexcept
+{
+    return _fPersistHistory;
+}
+
+// Routine Description:
+// - Gets the shortest time between two frames painted under sustained output,
+//      in milliseconds. 0 if it wasn't set, and the renderer's default applies.
+DWORD Settings::GetFrameLimit() const noexcept
+{
+    return _dwFrameLimit;
+}
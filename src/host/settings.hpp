@@ -184,6 +184,8 @@ public:
 
     bool GetUseDx() const noexcept;
     bool GetCopyColor() const noexcept;
+    bool GetPersistHistory() const noexcept;
+    DWORD GetFrameLimit() const noexcept;
 
     COLORREF CalculateDefaultForeground() const noexcept;
     COLORREF CalculateDefaultBackground() const noexcept;
@@ -233,6 +235,8 @@ private:
     bool _fRenderGridWorldwide;
     bool _fUseDx;
     bool _fCopyColor;
+    bool _fPersistHistory;
+    DWORD _dwFrameLimit;
 
     COLORREF _XtermColorTable[XTERM_COLOR_TABLE_SIZE];
 
@@ -211,6 +211,9 @@ NTSTATUS RemoveConsole(_In_ ConsoleProcessHandle* ProcessData)
 
     UnlockConsole();
 
+    // Leave a record of how this client's session performed.
+    Tracing::s_TraceMetrics();
+
     return Status;
 }
 
@@ -525,6 +528,11 @@ NTSTATUS ConsoleAllocateConsole(PCONSOLE_API_CONNECTINFO p)
 
         THROW_IF_FAILED(localPointerToThread->Initialize(g.pRender));
 
+        if (gci.GetFrameLimit() != 0)
+        {
+            localPointerToThread->SetFrameLimit(gci.GetFrameLimit());
+        }
+
         // Allow the renderer to paint.
         g.pRender->EnablePainting();
 
@@ -59,6 +59,13 @@ NTSTATUS GetChar(_Inout_ InputBuffer* const pInputBuffer,
     NTSTATUS Status;
     for (;;)
     {
+        // Pasted text is handed out as it is, without the key events that
+        // would otherwise carry it.
+        if (pInputBuffer->ReadText({ pwchOut, 1 }) != 0)
+        {
+            return STATUS_SUCCESS;
+        }
+
         std::unique_ptr<IInputEvent> inputEvent;
         Status = pInputBuffer->Read(inputEvent,
                                     false, // peek
@@ -598,6 +605,19 @@ static NTSTATUS _ReadCharacterInput(InputBuffer& inputBuffer,
 
         while (NumToWrite < static_cast<ULONG>(bufferRemaining))
         {
+            // take as much pasted text as fits at once.
+            const size_t textRead = inputBuffer.ReadText(gsl::make_span(pBuffer, (bufferRemaining - NumToWrite) / sizeof(wchar_t)));
+            if (textRead != 0)
+            {
+                for (size_t i = 0; i < textRead; ++i)
+                {
+                    bytesRead += IsGlyphFullWidth(pBuffer[i]) ? 2 : 1;
+                }
+                NumToWrite += textRead * sizeof(wchar_t);
+                pBuffer += textRead;
+                continue;
+            }
+
             Status = GetChar(&inputBuffer,
                              pBuffer,
                              false,
@@ -6,6 +6,7 @@
 #include "../interactivity/win32/UiaTextRange.hpp"
 #include "../interactivity/win32/screenInfoUiaProvider.hpp"
 #include "../interactivity/win32/windowUiaProvider.hpp"
+#include "../types/inc/PerfMetrics.hpp"
 
 using namespace Microsoft::Console::Interactivity::Win32;
 
@@ -19,7 +20,8 @@ enum TraceKeywords
     Input = 0x200,
     API = 0x400,
     UIA = 0x800,
-    All = 0xFFF
+    Performance = 0x1000,
+    All = 0x1FFF
 };
 DEFINE_ENUM_FLAG_OPERATORS(TraceKeywords);
 
@@ -291,6 +293,31 @@ void Tracing::s_TraceWindowMessage(const MSG& msg)
         TraceLoggingKeyword(TraceKeywords::Input));
 }
 
+// Routine Description:
+// - Writes the current value of every performance metric in the process, as a
+//   JSON document, if anyone is listening for them.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Tracing::s_TraceMetrics() noexcept
+{
+    if (TraceLoggingProviderEnabled(g_hConhostV2EventTraceProvider, WINEVENT_LEVEL_INFO, TraceKeywords::Performance))
+    {
+        try
+        {
+            const auto json = Microsoft::Console::Metrics::MetricsRegistry::Instance().ToJson();
+            TraceLoggingWrite(
+                g_hConhostV2EventTraceProvider,
+                "Performance Metrics",
+                TraceLoggingUtf8String(json.c_str(), "metrics"),
+                TraceLoggingLevel(WINEVENT_LEVEL_INFO),
+                TraceLoggingKeyword(TraceKeywords::Performance));
+        }
+        CATCH_LOG();
+    }
+}
+
 void Tracing::s_TraceInputRecord(const INPUT_RECORD& inputRecord)
 {
     switch (inputRecord.EventType)
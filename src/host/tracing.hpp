@@ -81,6 +81,8 @@ public:
     static void s_TraceWindowMessage(const MSG& msg);
     static void s_TraceInputRecord(const INPUT_RECORD& inputRecord);
 
+    static void s_TraceMetrics() noexcept;
+
     static void __stdcall TraceFailure(const wil::FailureInfo& failure) noexcept;
 
     static void s_TraceUia(const Microsoft::Console::Interactivity::Win32::UiaTextRange* const range,
@@ -12,6 +12,8 @@
 #include "dbcs.h"
 #include "misc.h"
 
+#include <chrono>
+
 #include "..\interactivity\inc\ServiceLocator.hpp"
 
 using namespace Microsoft::Console::Types;
@@ -854,4 +856,122 @@ class ApiRoutinesTests
 
         ValidateComplexScreen(si, background, fill, scrollRect, Viewport::FromInclusive(scroll), destination, clipViewport);
     }
+
+    TEST_METHOD(ApiWriteReadConsoleOutputWRoundTrip)
+    {
+        CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        SCREEN_INFORMATION& si = gci.GetActiveOutputBuffer();
+
+        VERIFY_SUCCEEDED(si.GetTextBuffer().ResizeTraditional({ 8, 4 }), L"Make the buffer small so every cell can be checked.");
+        si.GetActiveBuffer().ClearTextData();
+
+        Log::Comment(L"Write a rectangle hanging off the top left of the buffer, so only the part inside it is written.");
+        const auto request = Viewport::FromDimensions({ -1, -1 }, { 4, 3 });
+        std::vector<CHAR_INFO> written(4 * 3);
+        for (size_t i = 0; i < written.size(); ++i)
+        {
+            written[i].Char.UnicodeChar = static_cast<wchar_t>(L'a' + i);
+            written[i].Attributes = static_cast<WORD>(i % 3 == 0 ? FOREGROUND_RED : FOREGROUND_GREEN | BACKGROUND_BLUE);
+        }
+
+        auto writtenRectangle = Viewport::Empty();
+        VERIFY_SUCCEEDED(_pApiRoutines->WriteConsoleOutputWImpl(si, written, request, writtenRectangle));
+        VERIFY_ARE_EQUAL(Viewport::FromDimensions({ 0, 0 }, { 3, 2 }).ToInclusive(), writtenRectangle.ToInclusive());
+        VERIFY_ARE_EQUAL(String(L"fgh     "), String(si.GetTextBuffer().GetRowByOffset(0).GetText().c_str()));
+        VERIFY_ARE_EQUAL(String(L"jkl     "), String(si.GetTextBuffer().GetRowByOffset(1).GetText().c_str()));
+
+        Log::Comment(L"Reading the same rectangle back gives the cells that were written, and leaves the rest alone.");
+        CHAR_INFO untouched;
+        untouched.Char.UnicodeChar = L'?';
+        untouched.Attributes = 0;
+        std::vector<CHAR_INFO> read(written.size(), untouched);
+
+        auto readRectangle = Viewport::Empty();
+        VERIFY_SUCCEEDED(_pApiRoutines->ReadConsoleOutputWImpl(si, read, request, readRectangle));
+        VERIFY_ARE_EQUAL(writtenRectangle.ToInclusive(), readRectangle.ToInclusive());
+        for (size_t i = 0; i < read.size(); ++i)
+        {
+            const bool clipped = i < 4 || i % 4 == 0;
+            const auto& expected = clipped ? untouched : written[i];
+            VERIFY_ARE_EQUAL(expected.Char.UnicodeChar, read[i].Char.UnicodeChar);
+            VERIFY_ARE_EQUAL(expected.Attributes, read[i].Attributes);
+        }
+
+        Log::Comment(L"Cells with attributes that aren't legacy ones are read back with the nearest legacy attributes.");
+        const TextAttribute rgbAttr{ RGB(0xff, 0x10, 0x10), RGB(0x10, 0x10, 0xf0) };
+        si.GetTextBuffer().FillRect(Viewport::FromDimensions({ 0, 3 }, { 8, 1 }), L'r', rgbAttr);
+
+        std::vector<CHAR_INFO> row(8, untouched);
+        VERIFY_SUCCEEDED(_pApiRoutines->ReadConsoleOutputWImpl(si, row, Viewport::FromDimensions({ 0, 3 }, { 8, 1 }), readRectangle));
+        for (const auto& cell : row)
+        {
+            VERIFY_ARE_EQUAL(L'r', cell.Char.UnicodeChar);
+            VERIFY_ARE_EQUAL(gci.GenerateLegacyAttributes(rgbAttr), cell.Attributes);
+        }
+    }
+
+    TEST_METHOD(ApiWriteReadConsoleOutputWPerformance)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD_PROPERTIES()
+
+        CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        SCREEN_INFORMATION& si = gci.GetActiveOutputBuffer();
+
+        const COORD screenSize{ 200, 60 };
+        VERIFY_SUCCEEDED(si.GetTextBuffer().ResizeTraditional(screenSize));
+        const auto screen = Viewport::FromDimensions({ 0, 0 }, screenSize);
+        constexpr size_t roundTrips = 1000;
+
+        // A screen of text in a handful of colors, the way a full screen app draws itself.
+        std::vector<CHAR_INFO> frame(screenSize.X * screenSize.Y);
+        for (size_t i = 0; i < frame.size(); ++i)
+        {
+            frame[i].Char.UnicodeChar = static_cast<wchar_t>(L'!' + i % 90);
+            frame[i].Attributes = static_cast<WORD>((i / 12) % 16);
+        }
+        std::vector<CHAR_INFO> read(frame.size());
+
+        auto rectangle = Viewport::Empty();
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < roundTrips; ++i)
+        {
+            VERIFY_SUCCEEDED(_pApiRoutines->WriteConsoleOutputWImpl(si, frame, screen, rectangle));
+            VERIFY_SUCCEEDED(_pApiRoutines->ReadConsoleOutputWImpl(si, read, screen, rectangle));
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        for (size_t i = 0; i < frame.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(frame[i].Char.UnicodeChar, read[i].Char.UnicodeChar);
+            VERIFY_ARE_EQUAL(frame[i].Attributes, read[i].Attributes);
+        }
+
+        // The same round trips the way they were made before, one cell object at a time.
+        auto& storageBuffer = si.GetActiveBuffer();
+        const auto cellStart = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < roundTrips; ++i)
+        {
+            for (SHORT y = 0; y < screenSize.Y; ++y)
+            {
+                const std::basic_string_view<CHAR_INFO> cells{ frame.data() + y * screenSize.X, static_cast<size_t>(screenSize.X) };
+                storageBuffer.Write(OutputCellIterator(cells), { 0, y });
+            }
+
+            auto targetIter = read.begin();
+            for (auto sourceIter = storageBuffer.GetCellDataAt({ 0, 0 }, screen); sourceIter; ++sourceIter, ++targetIter)
+            {
+                *targetIter = gci.AsCharInfo(*sourceIter);
+            }
+        }
+        const auto cellElapsed = std::chrono::steady_clock::now() - cellStart;
+
+        Log::Comment(NoThrowString().Format(L"%zu round trips of a %dx%d screen: %lld us each converting rows, %lld us each going through cell objects",
+                                            roundTrips,
+                                            screenSize.X,
+                                            screenSize.Y,
+                                            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / static_cast<long long>(roundTrips),
+                                            std::chrono::duration_cast<std::chrono::microseconds>(cellElapsed).count() / static_cast<long long>(roundTrips)));
+    }
 };
@@ -8,6 +8,9 @@
 
 #include "../types/inc/CodepointWidthDetector.hpp"
 
+#include <chrono>
+#include <thread>
+
 using namespace WEX::Logging;
 
 static const std::wstring emoji = L"\xD83E\xDD22"; // U+1F922 nauseated face
@@ -34,30 +37,126 @@ class CodepointWidthDetectorTests
     TEST_CLASS(CodepointWidthDetectorTests);
 
 
-    TEST_METHOD(CodepointWidthDetectDefersMapPopulation)
+    TEST_METHOD(CanLookUpEmoji)
     {
         CodepointWidthDetector widthDetector;
-        VERIFY_IS_TRUE(widthDetector._map.empty());
-        widthDetector.IsWide(UNICODE_SPACE);
-        VERIFY_IS_TRUE(widthDetector._map.empty());
-        // now force checking
-        widthDetector.GetWidth(emoji);
-        VERIFY_IS_FALSE(widthDetector._map.empty());
+        VERIFY_IS_TRUE(widthDetector.IsWide(emoji));
     }
 
-    TEST_METHOD(CanLookUpEmoji)
+    // builds the map that the widths used to be looked up in, to check the table against
+    static std::map<unsigned int, std::pair<unsigned int, CodepointWidth>> MakeRangeMap()
     {
-        CodepointWidthDetector widthDetector;
-        VERIFY_IS_TRUE(widthDetector.IsWide(emoji));
+        std::map<unsigned int, std::pair<unsigned int, CodepointWidth>> map;
+        for (const auto& range : CodepointWidthDetector::_getUnicodeRanges())
+        {
+            map.emplace(range.upperBound, std::make_pair(range.lowerBound, range.width));
+        }
+        return map;
+    }
+
+    static CodepointWidth MapLookup(const std::map<unsigned int, std::pair<unsigned int, CodepointWidth>>& map,
+                                    const unsigned int codepoint)
+    {
+        const auto it = map.lower_bound(codepoint);
+        if (it == map.end() || codepoint < it->second.first)
+        {
+            return CodepointWidth::Invalid;
+        }
+        return it->second.second;
+    }
+
+    TEST_METHOD(TableAgreesWithRangesForEveryCodepoint)
+    {
+        const auto map = MakeRangeMap();
+
+        unsigned int mismatches = 0;
+        for (unsigned int codepoint = 0; codepoint <= 0x10FFFF; ++codepoint)
+        {
+            const auto expected = MapLookup(map, codepoint);
+            const auto actual = CodepointWidthDetector::_lookupWidth(codepoint);
+            if (expected != actual)
+            {
+                if (mismatches++ < 10)
+                {
+                    Log::Error(NoThrowString().Format(L"U+%06X: expected %d, got %d",
+                                                      codepoint,
+                                                      static_cast<int>(expected),
+                                                      static_cast<int>(actual)));
+                }
+            }
+        }
+        VERIFY_ARE_EQUAL(0u, mismatches);
+        VERIFY_ARE_EQUAL(CodepointWidth::Invalid, CodepointWidthDetector::_lookupWidth(0x110000));
+    }
+
+    TEST_METHOD(TableLookupPerformance)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD_PROPERTIES()
+
+        const auto map = MakeRangeMap();
+        constexpr unsigned int passes = 4;
+
+        unsigned int mapWide = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int pass = 0; pass < passes; ++pass)
+        {
+            for (unsigned int codepoint = 0; codepoint <= 0x10FFFF; ++codepoint)
+            {
+                mapWide += MapLookup(map, codepoint) == CodepointWidth::Wide;
+            }
+        }
+        const auto mapDelta = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        unsigned int tableWide = 0;
+        start = std::chrono::steady_clock::now();
+        for (unsigned int pass = 0; pass < passes; ++pass)
+        {
+            for (unsigned int codepoint = 0; codepoint <= 0x10FFFF; ++codepoint)
+            {
+                tableWide += CodepointWidthDetector::_lookupWidth(codepoint) == CodepointWidth::Wide;
+            }
+        }
+        const auto tableDelta = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        VERIFY_ARE_EQUAL(mapWide, tableWide);
+        Log::Comment(NoThrowString().Format(L"%u passes over every codepoint: map took %lld ms, table took %lld ms",
+                                            passes,
+                                            static_cast<long long>(mapDelta),
+                                            static_cast<long long>(tableDelta)));
     }
 
-    TEST_METHOD(TestUnicodeRangeCompare)
+    TEST_METHOD(CanCheckRunsAreNarrow)
     {
-        CodepointWidthDetector::UnicodeRangeCompare compare;
-        // test comparing 2 search terms
-        CodepointWidthDetector::UnicodeRange a{ 0x10 };
-        CodepointWidthDetector::UnicodeRange b{ 0x15 };
-        VERIFY_IS_TRUE(static_cast<bool>(compare(a, b)));
+        CodepointWidthDetector widthDetector;
+
+        VERIFY_IS_TRUE(widthDetector.IsAllNarrow(L""));
+        VERIFY_IS_TRUE(widthDetector.IsAllNarrow(L"The quick brown fox jumps over the lazy dog"));
+        VERIFY_IS_TRUE(widthDetector.IsAllNarrow(L"\x0905\x0906\x0907\x0908\x0909\x090A\x090B\x090C\x090D")); // devanagari
+
+        // a wide char anywhere in the run, including in the part checked one by one
+        std::wstring run(21, L'a');
+        for (size_t i = 0; i < run.size(); ++i)
+        {
+            std::wstring wide = run;
+            wide[i] = L'\x30CA'; // U+30CA katakana na
+            VERIFY_IS_FALSE(widthDetector.IsAllNarrow(wide));
+        }
+
+        // chars that need a closer look aren't reported as narrow
+        VERIFY_IS_FALSE(widthDetector.IsAllNarrow(L"abcdefg\a"));
+        VERIFY_IS_FALSE(widthDetector.IsAllNarrow(L"abcdefghijklmno" + ambiguous));
+        VERIFY_IS_FALSE(widthDetector.IsAllNarrow(L"abcdefghijklmno" + emoji));
+
+        // the narrow run stops right before the first char that isn't narrow
+        for (size_t i = 0; i < run.size(); ++i)
+        {
+            std::wstring wide = run;
+            wide[i] = L'\x30CA'; // U+30CA katakana na
+            VERIFY_ARE_EQUAL(i, widthDetector.GetNarrowRunLength(wide));
+        }
+        VERIFY_ARE_EQUAL(run.size(), widthDetector.GetNarrowRunLength(run));
     }
 
     TEST_METHOD(CanExtractCodepoint)
@@ -103,22 +202,107 @@ class CodepointWidthDetectorTests
         widthDetector.SetFallbackMethod(std::bind(&FallbackMethod, std::placeholders::_1));
 
         // Ensure fallback cache is empty.
-        VERIFY_ARE_EQUAL(0u, widthDetector._fallbackCache.size());
+        const auto codepoint = widthDetector._extractCodepoint(ambiguous);
+        VERIFY_IS_FALSE(widthDetector._fallbackCache.Find(codepoint).has_value());
 
         // Lookup ambiguous width character.
         widthDetector.IsWide(ambiguous);
 
-        // Cache should hold it.
-        VERIFY_ARE_EQUAL(1u, widthDetector._fallbackCache.size());
+        // Cache should hold it, and the cached item should match what we expect
+        const auto cached = widthDetector._fallbackCache.Find(codepoint);
+        VERIFY_IS_TRUE(cached.has_value());
+        VERIFY_ARE_EQUAL(FallbackMethod(ambiguous), cached.value());
 
-        // Cached item should match what we expect
-        const auto it = widthDetector._fallbackCache.begin();
-        VERIFY_ARE_EQUAL(ambiguous, it->first);
-        VERIFY_ARE_EQUAL(FallbackMethod(ambiguous), it->second);
+        // Looking it up again should come from the cache.
+        const auto hits = widthDetector._fallbackCache.Hits();
+        widthDetector.IsWide(ambiguous);
+        VERIFY_ARE_EQUAL(hits + 1, widthDetector._fallbackCache.Hits());
 
         // Cache should empty when font changes.
         widthDetector.NotifyFontChanged();
-        VERIFY_ARE_EQUAL(0u, widthDetector._fallbackCache.size());
+        VERIFY_IS_FALSE(widthDetector._fallbackCache.Find(codepoint).has_value());
+    }
+
+    TEST_METHOD(FallbackCacheIsBounded)
+    {
+        FallbackWidthCache cache;
+        const auto generation = cache.Generation();
+        const auto hits = cache.Hits();
+        const auto misses = cache.Misses();
+
+        // Two codepoints that share a slot replace each other.
+        const unsigned int first = 0x414;
+        const unsigned int second = first + FallbackWidthCache::s_Capacity;
+        cache.Store(first, true, generation);
+        VERIFY_IS_TRUE(cache.Find(first).value_or(false));
+        cache.Store(second, false, generation);
+        VERIFY_IS_FALSE(cache.Find(second).value_or(true));
+        VERIFY_IS_FALSE(cache.Find(first).has_value());
+
+        VERIFY_ARE_EQUAL(hits + 2, cache.Hits());
+        VERIFY_ARE_EQUAL(misses + 1, cache.Misses());
+    }
+
+    TEST_METHOD(FallbackCacheDropsWidthsFromOldFont)
+    {
+        FallbackWidthCache cache;
+
+        // A width that was worked out before the font changed isn't kept.
+        const auto generation = cache.Generation();
+        cache.Invalidate();
+        cache.Store(0x414, true, generation);
+        VERIFY_IS_FALSE(cache.Find(0x414).has_value());
+
+        cache.Store(0x414, true, cache.Generation());
+        VERIFY_IS_TRUE(cache.Find(0x414).has_value());
+    }
+
+    TEST_METHOD(FallbackCacheIsThreadSafe)
+    {
+        // Every thread asks about the same ambiguous codepoints while the font
+        // keeps changing. The answers never change, so every one should match.
+        CodepointWidthDetector widthDetector;
+        widthDetector.SetFallbackMethod(std::bind(&FallbackMethod, std::placeholders::_1));
+
+        constexpr size_t threadCount = 4;
+        constexpr unsigned int lookupsPerThread = 20000;
+        const auto lookupsBefore = widthDetector._fallbackCache.Hits() + widthDetector._fallbackCache.Misses();
+        std::atomic<unsigned int> mismatches{ 0 };
+        std::atomic<bool> done{ false };
+
+        std::thread invalidator([&] {
+            while (!done.load())
+            {
+                widthDetector.NotifyFontChanged();
+                std::this_thread::yield();
+            }
+        });
+
+        std::vector<std::thread> readers;
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            readers.emplace_back([&] {
+                for (unsigned int j = 0; j < lookupsPerThread; ++j)
+                {
+                    const wchar_t wch = static_cast<wchar_t>(0x410 + j % 32); // cyrillic capitals are ambiguous
+                    if (widthDetector.IsWide(wch) != FallbackMethod({ &wch, 1 }))
+                    {
+                        ++mismatches;
+                    }
+                }
+            });
+        }
+
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+        done.store(true);
+        invalidator.join();
+
+        VERIFY_ARE_EQUAL(0u, mismatches.load());
+        VERIFY_ARE_EQUAL(lookupsBefore + static_cast<uint64_t>(threadCount) * lookupsPerThread,
+                         widthDetector._fallbackCache.Hits() + widthDetector._fallbackCache.Misses());
     }
 
 };
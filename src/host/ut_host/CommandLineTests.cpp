@@ -11,6 +11,7 @@
 
 #include "../cmdline.h"
 
+#include <chrono>
 
 using namespace WEX::Common;
 using namespace WEX::Logging;
@@ -103,6 +104,53 @@ class CommandLineTests
         cookedReadData._bufPtr = cookedReadData._backupLimit + column;
     }
 
+    // Moves the cursor on the screen to the cell of the given char of a prompt
+    // of narrow chars, the way the editing keys would have.
+    void MoveScreenCursor(COOKED_READ_DATA& cookedReadData, const size_t column)
+    {
+        auto& screenInfo = cookedReadData.ScreenInfo();
+        auto position = cookedReadData.OriginalCursorPosition();
+        for (size_t i = 0; i < column; ++i)
+        {
+            screenInfo.GetBufferSize().IncrementInBounds(position);
+        }
+        screenInfo.GetTextBuffer().GetCursor().SetPosition(position);
+    }
+
+    // Sets the attributes of the cells from the start of the prompt on to one
+    // that echoing never writes, so that the cells that were written since can be told apart.
+    void MarkPromptCells(COOKED_READ_DATA& cookedReadData, const size_t cells)
+    {
+        cookedReadData.ScreenInfo().Write(OutputCellIterator(TextAttribute{ s_markerAttributes }, cells), cookedReadData.OriginalCursorPosition());
+    }
+
+    std::vector<bool> GetRewrittenCells(COOKED_READ_DATA& cookedReadData, const size_t cells)
+    {
+        std::vector<bool> rewritten;
+        auto& screenInfo = cookedReadData.ScreenInfo();
+        auto position = cookedReadData.OriginalCursorPosition();
+        for (size_t i = 0; i < cells; ++i)
+        {
+            rewritten.push_back(screenInfo.GetCellDataAt(position)->TextAttr() != s_markerAttributes);
+            screenInfo.GetBufferSize().IncrementInBounds(position);
+        }
+        return rewritten;
+    }
+
+    // Checks that the screen shows the prompt text, followed by blanks.
+    void VerifyEchoedText(COOKED_READ_DATA& cookedReadData, const std::wstring& text, const size_t cells)
+    {
+        auto& screenInfo = cookedReadData.ScreenInfo();
+        auto position = cookedReadData.OriginalCursorPosition();
+        for (size_t i = 0; i < cells; ++i)
+        {
+            const wchar_t expected = i < text.size() ? text.at(i) : UNICODE_SPACE;
+            const auto actual = screenInfo.GetCellDataAt(position)->Chars();
+            VERIFY_ARE_EQUAL(String(&expected, 1), String(actual.data(), gsl::narrow<int>(actual.size())));
+            screenInfo.GetBufferSize().IncrementInBounds(position);
+        }
+    }
+
     TEST_METHOD(CanCycleCommandHistory)
     {
         auto buffer = std::make_unique<wchar_t[]>(PROMPT_SIZE);
@@ -538,4 +586,122 @@ class CommandLineTests
             }
         }
     }
+
+    TEST_METHOD(EchoRewritesOnlyTheCellsThatChanged)
+    {
+        auto buffer = std::make_unique<wchar_t[]>(PROMPT_SIZE);
+        VERIFY_IS_NOT_NULL(buffer.get());
+
+        auto& cookedReadData = ServiceLocator::LocateGlobals().getConsoleInformation().CookedReadData();
+        InitCookedReadData(cookedReadData, m_pHistory, buffer.get(), PROMPT_SIZE);
+        cookedReadData.ScreenInfo().GetTextBuffer().GetCursor().SetPosition(cookedReadData.OriginalCursorPosition());
+        cookedReadData.SetInsertMode(true);
+
+        const std::wstring text{ L"the quick brown fox" };
+        const size_t cells = text.size() + 2;
+        cookedReadData.Write(text);
+        MoveCursor(cookedReadData, 4);
+        MoveScreenCursor(cookedReadData, 4);
+
+        Log::Comment(L"Inserting a char rewrites the chars from it on, and none before it.");
+        NTSTATUS status = STATUS_SUCCESS;
+        MarkPromptCells(cookedReadData, cells);
+        VERIFY_IS_FALSE(cookedReadData.ProcessInput(L'X', 0, status));
+        VERIFY_NT_SUCCESS(status);
+        VerifyPromptText(cookedReadData, L"the Xquick brown fox");
+        VerifyEchoedText(cookedReadData, L"the Xquick brown fox", cells);
+        auto rewritten = GetRewrittenCells(cookedReadData, cells);
+        VERIFY_ARE_EQUAL(static_cast<ptrdiff_t>(16), std::count(rewritten.begin(), rewritten.end(), true));
+        VERIFY_IS_FALSE(rewritten.at(3));
+        VERIFY_IS_TRUE(rewritten.at(4));
+
+        Log::Comment(L"Backspacing over it moves the rest back and blanks the cell the line no longer reaches.");
+        VERIFY_IS_FALSE(cookedReadData.ProcessInput(UNICODE_BACKSPACE, 0, status));
+        VERIFY_NT_SUCCESS(status);
+        VerifyPromptText(cookedReadData, text);
+        VerifyEchoedText(cookedReadData, text, cells);
+
+        Log::Comment(L"Overwriting a narrow char with another rewrites just that cell.");
+        cookedReadData.SetInsertMode(false);
+        MarkPromptCells(cookedReadData, cells);
+        VERIFY_IS_FALSE(cookedReadData.ProcessInput(L'Q', 0, status));
+        VERIFY_NT_SUCCESS(status);
+        VerifyPromptText(cookedReadData, L"the Quick brown fox");
+        VerifyEchoedText(cookedReadData, L"the Quick brown fox", cells);
+        rewritten = GetRewrittenCells(cookedReadData, cells);
+        VERIFY_ARE_EQUAL(static_cast<ptrdiff_t>(1), std::count(rewritten.begin(), rewritten.end(), true));
+        VERIFY_IS_TRUE(rewritten.at(4));
+
+        Log::Comment(L"Deleting the char right of the cursor moves the rest back too.");
+        auto& commandLine = CommandLine::Instance();
+        commandLine.DeleteFromRightOfCursor(cookedReadData);
+        VerifyPromptText(cookedReadData, L"the Qick brown fox");
+        VerifyEchoedText(cookedReadData, L"the Qick brown fox", cells);
+
+        Log::Comment(L"Deleting everything right of the cursor leaves the text before it.");
+        MoveCursor(cookedReadData, 9);
+        MoveScreenCursor(cookedReadData, 9);
+        commandLine.DeletePromptAfterCursor(cookedReadData);
+        VerifyPromptText(cookedReadData, L"the Qick ");
+        VerifyEchoedText(cookedReadData, L"the Qick ", cells);
+    }
+
+    TEST_METHOD(EchoCellsWrittenPerKeystrokePerformance)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD_PROPERTIES()
+
+        constexpr size_t promptSize = 4096;
+        constexpr size_t lineLength = 2000;
+        constexpr size_t keystrokes = 100;
+
+        auto buffer = std::make_unique<wchar_t[]>(promptSize);
+        VERIFY_IS_NOT_NULL(buffer.get());
+
+        auto& cookedReadData = ServiceLocator::LocateGlobals().getConsoleInformation().CookedReadData();
+        InitCookedReadData(cookedReadData, m_pHistory, buffer.get(), promptSize);
+        cookedReadData.ScreenInfo().GetTextBuffer().GetCursor().SetPosition(cookedReadData.OriginalCursorPosition());
+        cookedReadData.SetInsertMode(true);
+
+        // A long PATH like line, edited in the middle.
+        std::wstring text;
+        for (size_t i = 0; i < lineLength; ++i)
+        {
+            text.push_back(i % 40 == 39 ? L';' : static_cast<wchar_t>(L'a' + i % 26));
+        }
+        cookedReadData.Write(text);
+        MoveCursor(cookedReadData, lineLength / 2);
+        MoveScreenCursor(cookedReadData, lineLength / 2);
+
+        const size_t cells = lineLength + keystrokes + 1;
+        size_t cellsWritten = 0;
+        std::chrono::steady_clock::duration elapsed{};
+        for (size_t i = 0; i < keystrokes; ++i)
+        {
+            MarkPromptCells(cookedReadData, cells);
+
+            NTSTATUS status = STATUS_SUCCESS;
+            const auto start = std::chrono::steady_clock::now();
+            VERIFY_IS_FALSE(cookedReadData.ProcessInput(L'x', 0, status));
+            elapsed += std::chrono::steady_clock::now() - start;
+            VERIFY_NT_SUCCESS(status);
+
+            const auto rewritten = GetRewrittenCells(cookedReadData, cells);
+            cellsWritten += static_cast<size_t>(std::count(rewritten.begin(), rewritten.end(), true));
+        }
+
+        text.insert(lineLength / 2, keystrokes, L'x');
+        VerifyPromptText(cookedReadData, text);
+        VerifyEchoedText(cookedReadData, text, cells);
+
+        Log::Comment(NoThrowString().Format(L"Inserted %zu chars in the middle of a %zu char line: %zu cells rewritten per keystroke, %lld us per keystroke",
+                                            keystrokes,
+                                            lineLength,
+                                            cellsWritten / keystrokes,
+                                            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / static_cast<long long>(keystrokes)));
+    }
+
+private:
+    static constexpr WORD s_markerAttributes = FOREGROUND_GREEN | BACKGROUND_BLUE;
 };
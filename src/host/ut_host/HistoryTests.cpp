@@ -8,6 +8,9 @@
 #include "CommonState.hpp"
 
 #include "search.h"
+#include "historyStore.hpp"
+
+#include <chrono>
 
 using namespace WEX::Common;
 using namespace WEX::Logging;
@@ -241,6 +244,241 @@ class HistoryTests
         VERIFY_ARE_EQUAL(2ul, history->GetNumberOfCommands());
     }
 
+    TEST_METHOD(AddDropsOldestWhenFull)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+
+        for (const auto& item : _manyHistoryItems)
+        {
+            VERIFY_SUCCEEDED(history->Add(item, false));
+        }
+
+        // The first two items went to make room for the last two.
+        VERIFY_ARE_EQUAL(static_cast<size_t>(s_BufferSize), history->GetNumberOfCommands());
+        for (SHORT i = 0; i < gsl::narrow<SHORT>(s_BufferSize); ++i)
+        {
+            VERIFY_ARE_EQUAL(std::wstring_view{ _manyHistoryItems.at(i + 2) }, history->GetNth(i));
+        }
+    }
+
+    TEST_METHOD(FindMatchingCommandFindsMostRecentPrefix)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+
+        for (const auto& item : _manyHistoryItems)
+        {
+            VERIFY_SUCCEEDED(history->Add(item, false));
+        }
+
+        // Now "ipconfig" is at 2 and "ipconfig /all" at 3. Just looking starts
+        // from the command before the starting index, and goes backwards.
+        SHORT index = 0;
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"IPCONFIG", 9, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(3, index);
+
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"IPCONFIG", 9, index, CommandHistory::MatchOptions::JustLooking | CommandHistory::MatchOptions::ExactMatch));
+        VERIFY_ARE_EQUAL(2, index);
+
+        // With nothing before the start that matches, it goes around to the newest.
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"ipconfig", 2, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(3, index);
+
+        VERIFY_IS_FALSE(history->FindMatchingCommand(L"ssh", 9, index, CommandHistory::MatchOptions::JustLooking));
+    }
+
+    TEST_METHOD(RemoveAndSwapKeepLookupsInStep)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+
+        for (const auto& item : _manyHistoryItems)
+        {
+            VERIFY_SUCCEEDED(history->Add(item, false));
+        }
+
+        VERIFY_ARE_EQUAL(std::wstring{ L"ping 127.0.0.1" }, history->Remove(5));
+        VERIFY_ARE_EQUAL(static_cast<size_t>(s_BufferSize - 1), history->GetNumberOfCommands());
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"cd .." }, history->GetNth(5));
+
+        SHORT index = 0;
+        VERIFY_IS_FALSE(history->FindMatchingCommand(L"ping", 8, index, CommandHistory::MatchOptions::JustLooking));
+
+        history->Swap(0, 1);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"telnet 127.0.0.1" }, history->GetNth(0));
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"dir", 8, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(1, index);
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"telnet", 8, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(0, index);
+    }
+
+    TEST_METHOD(AddToLargeHistoryPerformance)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD_PROPERTIES()
+
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+
+        constexpr size_t historySize = 20000;
+        constexpr size_t commandCount = 200000;
+        history->Realloc(historySize);
+
+        // Half of the commands are new, so the history fills up and has to
+        // drop its oldest, and the other half repeat one of a few, which
+        // have to be found and moved to the end.
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < commandCount; ++i)
+        {
+            const auto command = i % 2 == 0 ? L"echo " + std::to_wstring(i) : L"cd project" + std::to_wstring(i % 100);
+            VERIFY_SUCCEEDED(history->Add(command, true));
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        VERIFY_ARE_EQUAL(historySize, history->GetNumberOfCommands());
+
+        Log::Comment(NoThrowString().Format(L"Added %zu commands to a history of %zu, suppressing duplicates: %lld ms",
+                                            commandCount,
+                                            historySize,
+                                            std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+    }
+
+    TEST_METHOD(StoreLoadsCommandsAfterReopen)
+    {
+        const auto path = _MakeStorePath();
+        auto deleteFile = wil::scope_exit([&]() noexcept { DeleteFileW(path.c_str()); });
+
+        {
+            HistoryStore store{ path };
+            store.Append(L"cmd.exe", L"dir");
+            store.Append(L"powershell.exe", L"Get-ChildItem");
+            store.Append(L"CMD.EXE", L"cd ..");
+            store.Append(L"cmd.exe", L"git push");
+        }
+
+        HistoryStore store{ path };
+
+        const auto commands = store.Load(L"Cmd.exe", 10, false);
+        VERIFY_ARE_EQUAL(3u, commands.size());
+        VERIFY_ARE_EQUAL(std::wstring{ L"dir" }, commands.at(0));
+        VERIFY_ARE_EQUAL(std::wstring{ L"cd .." }, commands.at(1));
+        VERIFY_ARE_EQUAL(std::wstring{ L"git push" }, commands.at(2));
+
+        const auto newest = store.Load(L"cmd.exe", 2, false);
+        VERIFY_ARE_EQUAL(2u, newest.size());
+        VERIFY_ARE_EQUAL(std::wstring{ L"cd .." }, newest.at(0));
+        VERIFY_ARE_EQUAL(std::wstring{ L"git push" }, newest.at(1));
+
+        VERIFY_ARE_EQUAL(1u, store.Load(L"powershell.exe", 10, false).size());
+        VERIFY_IS_TRUE(store.Load(L"bash.exe", 10, false).empty());
+    }
+
+    TEST_METHOD(StoreSkipsOlderCopiesOfDuplicates)
+    {
+        const auto path = _MakeStorePath();
+        auto deleteFile = wil::scope_exit([&]() noexcept { DeleteFileW(path.c_str()); });
+
+        HistoryStore store{ path };
+        store.Append(L"cmd.exe", L"dir");
+        store.Append(L"cmd.exe", L"cd ..");
+        store.Append(L"cmd.exe", L"dir");
+        store.Append(L"cmd.exe", L"git push");
+        store.Append(L"cmd.exe", L"dir");
+
+        VERIFY_ARE_EQUAL(5u, store.Load(L"cmd.exe", 10, false).size());
+
+        Log::Comment(L"Only the newest copy is kept, and it still counts as one command.");
+        const auto commands = store.Load(L"cmd.exe", 3, true);
+        VERIFY_ARE_EQUAL(3u, commands.size());
+        VERIFY_ARE_EQUAL(std::wstring{ L"cd .." }, commands.at(0));
+        VERIFY_ARE_EQUAL(std::wstring{ L"git push" }, commands.at(1));
+        VERIFY_ARE_EQUAL(std::wstring{ L"dir" }, commands.at(2));
+    }
+
+    TEST_METHOD(StoreLoadsCommandsAppendedByAnotherConsole)
+    {
+        const auto path = _MakeStorePath();
+        auto deleteFile = wil::scope_exit([&]() noexcept { DeleteFileW(path.c_str()); });
+
+        HistoryStore first{ path };
+        HistoryStore second{ path };
+
+        first.Append(_manyApps[0], L"first");
+        first.Flush();
+
+        // The second has to see past the end of the file it mapped.
+        second.Append(_manyApps[0], L"second");
+        second.Flush();
+
+        first.Append(_manyApps[0], L"third");
+
+        const auto commands = first.Load(_manyApps[0], 10, false);
+        VERIFY_ARE_EQUAL(3u, commands.size());
+        VERIFY_ARE_EQUAL(std::wstring{ L"first" }, commands.at(0));
+        VERIFY_ARE_EQUAL(std::wstring{ L"second" }, commands.at(1));
+        VERIFY_ARE_EQUAL(std::wstring{ L"third" }, commands.at(2));
+    }
+
+    TEST_METHOD(StoreWithMillionCommandsPerformance)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD_PROPERTIES()
+
+        const auto path = _MakeStorePath();
+        auto deleteFile = wil::scope_exit([&]() noexcept { DeleteFileW(path.c_str()); });
+
+        constexpr size_t commandCount = 1000000;
+        constexpr size_t loadCount = 1000;
+        constexpr size_t commandsPerLoad = 50;
+
+        // The commands take turns between the apps, so each app's are
+        // spread out over the whole file.
+        const auto appendStart = std::chrono::steady_clock::now();
+        {
+            HistoryStore store{ path };
+            for (size_t i = 0; i < commandCount; ++i)
+            {
+                store.Append(_manyApps.at(i % _manyApps.size()), L"echo " + std::to_wstring(i));
+            }
+        }
+        const auto appendElapsed = std::chrono::steady_clock::now() - appendStart;
+
+        const auto openStart = std::chrono::steady_clock::now();
+        HistoryStore store{ path };
+        const auto openElapsed = std::chrono::steady_clock::now() - openStart;
+
+        const auto loadStart = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < loadCount; ++i)
+        {
+            const auto commands = store.Load(_manyApps.at(i % _manyApps.size()), commandsPerLoad, false);
+            VERIFY_ARE_EQUAL(commandsPerLoad, commands.size());
+        }
+        const auto loadElapsed = std::chrono::steady_clock::now() - loadStart;
+
+        for (size_t app = 0; app < _manyApps.size(); ++app)
+        {
+            const auto commands = store.Load(_manyApps.at(app), commandsPerLoad, false);
+            const size_t newest = commandCount - _manyApps.size() + app;
+            for (size_t i = 0; i < commandsPerLoad; ++i)
+            {
+                const size_t expected = newest - (commandsPerLoad - 1 - i) * _manyApps.size();
+                VERIFY_ARE_EQUAL(L"echo " + std::to_wstring(expected), commands.at(i));
+            }
+        }
+
+        Log::Comment(NoThrowString().Format(L"Appended %zu commands: %lld ms",
+                                            commandCount,
+                                            std::chrono::duration_cast<std::chrono::milliseconds>(appendElapsed).count()));
+        Log::Comment(NoThrowString().Format(L"Opened the store: %lld us",
+                                            std::chrono::duration_cast<std::chrono::microseconds>(openElapsed).count()));
+        Log::Comment(NoThrowString().Format(L"Loaded the newest %zu commands of an app: %lld us on average",
+                                            commandsPerLoad,
+                                            std::chrono::duration_cast<std::chrono::microseconds>(loadElapsed).count() / static_cast<long long>(loadCount)));
+    }
+
 private:
 
     const std::array<std::wstring, 5> _manyApps =
@@ -275,4 +513,15 @@ private:
     {
         return reinterpret_cast<HANDLE>((index + 1) * 4);
     }
+
+    std::wstring _MakeStorePath()
+    {
+        wchar_t folder[MAX_PATH + 1]{};
+        THROW_LAST_ERROR_IF(GetTempPathW(ARRAYSIZE(folder), folder) == 0);
+
+        // This creates the file empty, which the store fills in like a new one.
+        wchar_t path[MAX_PATH]{};
+        THROW_LAST_ERROR_IF(GetTempFileNameW(folder, L"chs", 0, path) == 0);
+        return path;
+    }
 };
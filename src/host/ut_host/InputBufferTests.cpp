@@ -8,6 +8,9 @@
 
 #include "..\interactivity\inc\ServiceLocator.hpp"
 #include "..\types\inc\IInputEvent.hpp"
+#include "..\types\inc\convert.hpp"
+
+#include <thread>
 
 using namespace WEX::Logging;
 
@@ -77,7 +80,7 @@ class InputBufferTests
             INPUT_RECORD record;
             record.EventType = MENU_EVENT;
             VERIFY_IS_GREATER_THAN(inputBuffer.Write(IInputEvent::Create(record)), 0u);
-            VERIFY_ARE_EQUAL(record, inputBuffer._storage.back()->ToInputRecord());
+            VERIFY_ARE_EQUAL(record, inputBuffer._storage.back());
         }
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT);
     }
@@ -97,7 +100,7 @@ class InputBufferTests
         // verify that the events are the same in storage
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inputBuffer._storage[i]->ToInputRecord(), record);
+            VERIFY_ARE_EQUAL(inputBuffer._storage[i], record);
         }
     }
 
@@ -120,10 +123,9 @@ class InputBufferTests
         // check that they coalesced
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 1u);
         // check that the mouse position is being updated correctly
-        const IInputEvent* const pOutEvent = inputBuffer._storage.front().get();
-        const MouseEvent* const pMouseEvent = static_cast<const MouseEvent* const>(pOutEvent);
-        VERIFY_ARE_EQUAL(pMouseEvent->GetPosition().X, static_cast<SHORT>(RECORD_INSERT_COUNT));
-        VERIFY_ARE_EQUAL(pMouseEvent->GetPosition().Y, static_cast<SHORT>(RECORD_INSERT_COUNT * 2));
+        const INPUT_RECORD& outRecord = inputBuffer._storage.front();
+        VERIFY_ARE_EQUAL(outRecord.Event.MouseEvent.dwMousePosition.X, static_cast<SHORT>(RECORD_INSERT_COUNT));
+        VERIFY_ARE_EQUAL(outRecord.Event.MouseEvent.dwMousePosition.Y, static_cast<SHORT>(RECORD_INSERT_COUNT * 2));
 
         // add a key event and another mouse event to make sure that
         // an event between two mouse events stopped the coalescing.
@@ -161,10 +163,10 @@ class InputBufferTests
         // no events should have been coalesced
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT + 1);
         // check that the events stored match those inserted
-        VERIFY_ARE_EQUAL(inputBuffer._storage.front()->ToInputRecord(), mouseRecords[0]);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.front(), mouseRecords[0]);
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1]->ToInputRecord(), mouseRecords[i]);
+            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1], mouseRecords[i]);
         }
     }
 
@@ -220,10 +222,10 @@ class InputBufferTests
         // no events should have been coalesced
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT + 1);
         // check that the events stored match those inserted
-        VERIFY_ARE_EQUAL(inputBuffer._storage.front()->ToInputRecord(), keyRecords[0]);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.front(), keyRecords[0]);
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1]->ToInputRecord(), keyRecords[i]);
+            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1], keyRecords[i]);
         }
     }
 
@@ -238,7 +240,7 @@ class InputBufferTests
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
             VERIFY_IS_GREATER_THAN(inputBuffer.Write(IInputEvent::Create(record)), 0u);
-            VERIFY_ARE_EQUAL(inputBuffer._storage.back()->ToInputRecord(), record);
+            VERIFY_ARE_EQUAL(inputBuffer._storage.back(), record);
         }
 
         // The events shouldn't be coalesced
@@ -381,10 +383,10 @@ class InputBufferTests
         VERIFY_IS_GREATER_THAN(inputBuffer.Write(inEvents), 0u);
 
         // read one record, make sure ResetWaitEvent isn't set
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        std::vector<INPUT_RECORD> outRecords;
         size_t eventsRead = 0;
         bool resetWaitEvent = false;
-        inputBuffer._ReadBuffer(outEvents,
+        inputBuffer._ReadBuffer(outRecords,
                                 1,
                                 eventsRead,
                                 false,
@@ -395,8 +397,8 @@ class InputBufferTests
         VERIFY_IS_FALSE(!!resetWaitEvent);
 
         // read the rest, resetWaitEvent should be set to true
-        outEvents.clear();
-        inputBuffer._ReadBuffer(outEvents,
+        outRecords.clear();
+        inputBuffer._ReadBuffer(outRecords,
                                 RECORD_INSERT_COUNT - 1,
                                 eventsRead,
                                 false,
@@ -430,10 +432,10 @@ class InputBufferTests
         VERIFY_IS_GREATER_THAN(inputBuffer.Write(inEvents), 0u);
 
         // read them out non-unicode style and compare
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        std::vector<INPUT_RECORD> outRecords;
         size_t eventsRead = 0;
         bool resetWaitEvent = false;
-        inputBuffer._ReadBuffer(outEvents,
+        inputBuffer._ReadBuffer(outRecords,
                                 recordInsertCount,
                                 eventsRead,
                                 false,
@@ -443,10 +445,10 @@ class InputBufferTests
         // the dbcs record should have counted for two elements in
         // the array, making it so that we get less events read
         VERIFY_ARE_EQUAL(eventsRead, recordInsertCount - 1);
-        VERIFY_ARE_EQUAL(eventsRead, outEvents.size());
+        VERIFY_ARE_EQUAL(eventsRead, outRecords.size());
         for (size_t i = 0; i < eventsRead; ++i)
         {
-            VERIFY_ARE_EQUAL(outEvents[i]->ToInputRecord(), inRecords[i]);
+            VERIFY_ARE_EQUAL(outRecords[i], inRecords[i]);
         }
     }
 
@@ -588,22 +590,17 @@ class InputBufferTests
     {
         InputBuffer inputBuffer;
         INPUT_RECORD record = MakeKeyEvent(true, 1, L'a', 0, L'a', 0);
-        std::unique_ptr<IInputEvent> inputEvent = IInputEvent::Create(record);
         size_t eventsWritten;
         bool waitEvent = false;
         inputBuffer.Flush();
         // write one event to an empty buffer
-        std::deque<std::unique_ptr<IInputEvent>> storage;
-        storage.push_back(std::move(inputEvent));
-        inputBuffer._WriteBuffer(storage, eventsWritten, waitEvent);
+        inputBuffer._WriteBuffer(gsl::make_span(&record, 1), eventsWritten, waitEvent);
         VERIFY_IS_TRUE(waitEvent);
         // write another, it shouldn't signal this time
         INPUT_RECORD record2 = MakeKeyEvent(true, 1, L'b', 0, L'b', 0);
-        std::unique_ptr<IInputEvent> inputEvent2 = IInputEvent::Create(record2);
         // write another event to a non-empty buffer
         waitEvent = false;
-        storage.push_back(std::move(inputEvent2));
-        inputBuffer._WriteBuffer(storage, eventsWritten, waitEvent);
+        inputBuffer._WriteBuffer(gsl::make_span(&record2, 1), eventsWritten, waitEvent);
 
         VERIFY_IS_FALSE(waitEvent);
     }
@@ -624,7 +621,7 @@ class InputBufferTests
                                                  true));
         VERIFY_ARE_EQUAL(outEvents.size(), 1u);
         VERIFY_ARE_EQUAL(inputBuffer._storage.size(), 1u);
-        VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*inputBuffer._storage.front()).GetRepeatCount(), repeatCount - 1);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.front().Event.KeyEvent.wRepeatCount, repeatCount - 1);
         VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*outEvents.front()).GetRepeatCount(), 1u);
     }
 
@@ -644,8 +641,320 @@ class InputBufferTests
                                                  true));
         VERIFY_ARE_EQUAL(outEvents.size(), 1u);
         VERIFY_ARE_EQUAL(inputBuffer._storage.size(), 1u);
-        VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*inputBuffer._storage.front()).GetRepeatCount(), repeatCount);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.front().Event.KeyEvent.wRepeatCount, repeatCount);
         VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*outEvents.front()).GetRepeatCount(), 1u);
     }
 
+    TEST_METHOD(CanWriteAndReadRecordsInBulk)
+    {
+        InputBuffer inputBuffer;
+
+        // more than fit in the ring's initial allocation, so that it has to grow
+        std::vector<INPUT_RECORD> records;
+        for (size_t i = 0; i < RECORD_INSERT_COUNT * 10; ++i)
+        {
+            records.push_back(MakeKeyEvent(TRUE, 1, static_cast<WCHAR>(L'A' + i), 0, static_cast<WCHAR>(L'A' + i), 0));
+        }
+        VERIFY_ARE_EQUAL(inputBuffer.Write(records), records.size());
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), records.size());
+
+        Log::Comment(L"Peeking copies the records out without removing them.");
+        std::vector<INPUT_RECORD> outRecords;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords,
+                                                 RECORD_INSERT_COUNT,
+                                                 true,
+                                                 false,
+                                                 true,
+                                                 false));
+        VERIFY_ARE_EQUAL(outRecords.size(), RECORD_INSERT_COUNT);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), records.size());
+
+        Log::Comment(L"Reading appends to the records already in the output.");
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords,
+                                                 records.size(),
+                                                 false,
+                                                 false,
+                                                 true,
+                                                 false));
+        VERIFY_ARE_EQUAL(outRecords.size(), RECORD_INSERT_COUNT + records.size());
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(records[i], outRecords[RECORD_INSERT_COUNT + i]);
+        }
+    }
+
+    TEST_METHOD(PrependingRecordsWrapsAroundStorage)
+    {
+        InputBuffer inputBuffer;
+
+        // read some records out first, so that the front of the storage
+        // isn't at the start of its allocation when we prepend
+        INPUT_RECORD records[RECORD_INSERT_COUNT];
+        for (unsigned int i = 0; i < RECORD_INSERT_COUNT; ++i)
+        {
+            records[i] = MakeKeyEvent(TRUE, 1, static_cast<WCHAR>(L'A' + i), 0, static_cast<WCHAR>(L'A' + i), 0);
+        }
+        VERIFY_ARE_EQUAL(inputBuffer.Write(gsl::make_span(records)), RECORD_INSERT_COUNT);
+
+        std::vector<INPUT_RECORD> outRecords;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords, 2, false, false, true, false));
+
+        INPUT_RECORD prependRecords[RECORD_INSERT_COUNT];
+        for (unsigned int i = 0; i < RECORD_INSERT_COUNT; ++i)
+        {
+            prependRecords[i] = MakeKeyEvent(TRUE, 1, static_cast<WCHAR>(L'a' + i), 0, static_cast<WCHAR>(L'a' + i), 0);
+        }
+        VERIFY_ARE_EQUAL(inputBuffer.Prepend(gsl::make_span(prependRecords)), RECORD_INSERT_COUNT);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT * 2 - 2);
+
+        for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
+        {
+            VERIFY_ARE_EQUAL(prependRecords[i], inputBuffer._storage[i]);
+        }
+        for (size_t i = 2; i < RECORD_INSERT_COUNT; ++i)
+        {
+            VERIFY_ARE_EQUAL(records[i], inputBuffer._storage[RECORD_INSERT_COUNT + i - 2]);
+        }
+
+        Log::Comment(L"Only the mouse events are dropped by FlushAllButKeys, and the keys stay in order.");
+        INPUT_RECORD mouseRecord;
+        mouseRecord.EventType = MOUSE_EVENT;
+        mouseRecord.Event.MouseEvent.dwEventFlags = 0;
+        VERIFY_ARE_EQUAL(inputBuffer.Prepend(gsl::make_span(&mouseRecord, 1)), 1u);
+        inputBuffer.FlushAllButKeys();
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT * 2 - 2);
+        VERIFY_ARE_EQUAL(prependRecords[0], inputBuffer._storage.front());
+        VERIFY_ARE_EQUAL(records[RECORD_INSERT_COUNT - 1], inputBuffer._storage.back());
+    }
+
+    TEST_METHOD(CanWriteAndReadTextRuns)
+    {
+        InputBuffer inputBuffer;
+        const std::wstring text = L"pasted text";
+
+        Log::Comment(L"Consecutive runs are stored as one.");
+        VERIFY_ARE_EQUAL(inputBuffer.WriteText(text.substr(0, 6)), 6u);
+        VERIFY_ARE_EQUAL(inputBuffer.WriteText(text.substr(6)), text.size() - 6);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.size(), 1u);
+        VERIFY_ARE_EQUAL(inputBuffer._textRuns.size(), 1u);
+
+        Log::Comment(L"The run is read back in as many pieces as the reader asks for.");
+        std::wstring readText(text.size(), L'\0');
+        VERIFY_ARE_EQUAL(inputBuffer.ReadText(gsl::make_span(&readText[0], 4)), 4u);
+        VERIFY_ARE_EQUAL(inputBuffer.ReadText(gsl::make_span(&readText[4], readText.size() - 4)), text.size() - 4);
+        VERIFY_ARE_EQUAL(text, readText);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+        VERIFY_IS_TRUE(inputBuffer._textRuns.empty());
+
+        Log::Comment(L"There's no text to read when the next event is a record.");
+        const INPUT_RECORD record = MakeKeyEvent(TRUE, 1, L'A', 0, L'A', 0);
+        VERIFY_ARE_EQUAL(inputBuffer.Write(gsl::make_span(&record, 1)), 1u);
+        VERIFY_ARE_EQUAL(inputBuffer.WriteText(text), text.size());
+        VERIFY_ARE_EQUAL(inputBuffer.ReadText(gsl::make_span(&readText[0], readText.size())), 0u);
+
+        std::vector<INPUT_RECORD> outRecords;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords, 1, false, false, true, false));
+        VERIFY_ARE_EQUAL(outRecords.size(), 1u);
+        VERIFY_ARE_EQUAL(record, outRecords[0]);
+        VERIFY_ARE_EQUAL(inputBuffer.ReadText(gsl::make_span(&readText[0], readText.size())), text.size());
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+    }
+
+    TEST_METHOD(TextRunsAreReadAsKeyEvents)
+    {
+        CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        InputBuffer inputBuffer;
+        const std::wstring text = L"Ab1 ";
+
+        std::vector<INPUT_RECORD> expectedRecords;
+        for (const wchar_t wch : text)
+        {
+            for (const auto& keyEvent : CharToKeyEvents(wch, gci.OutputCP))
+            {
+                expectedRecords.push_back(keyEvent->ToInputRecord());
+            }
+        }
+
+        VERIFY_ARE_EQUAL(inputBuffer.WriteText(text), text.size());
+        const INPUT_RECORD record = MakeKeyEvent(TRUE, 1, L'Z', 0, L'Z', 0);
+        VERIFY_ARE_EQUAL(inputBuffer.Write(gsl::make_span(&record, 1)), 1u);
+
+        Log::Comment(L"The run counts as the key events that it stands for.");
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), expectedRecords.size() + 1);
+
+        Log::Comment(L"Reading records gets the key events, followed by what was written after the run.");
+        std::vector<INPUT_RECORD> outRecords;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords,
+                                                 expectedRecords.size() + 1,
+                                                 false,
+                                                 false,
+                                                 true,
+                                                 false));
+        VERIFY_ARE_EQUAL(outRecords.size(), expectedRecords.size() + 1);
+        for (size_t i = 0; i < expectedRecords.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(expectedRecords[i], outRecords[i]);
+        }
+        VERIFY_ARE_EQUAL(record, outRecords.back());
+        VERIFY_IS_TRUE(inputBuffer._textRuns.empty());
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+    }
+
+    TEST_METHOD(TextRunCountsFollowReads)
+    {
+        CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        InputBuffer inputBuffer;
+        const std::wstring text = L"Ab1 Cd2 ";
+
+        const auto keyEvents = [&](const std::wstring_view chars) {
+            size_t count = 0;
+            for (const wchar_t wch : chars)
+            {
+                count += CharToKeyEvents(wch, gci.OutputCP).size();
+            }
+            return count;
+        };
+
+        VERIFY_ARE_EQUAL(inputBuffer.WriteText(text.substr(0, 4)), 4u);
+        VERIFY_ARE_EQUAL(inputBuffer.WriteText(text.substr(4)), text.size() - 4);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), keyEvents(text));
+
+        Log::Comment(L"Reading some of the text leaves the key events of the rest.");
+        std::wstring readText(3, L'\0');
+        VERIFY_ARE_EQUAL(inputBuffer.ReadText(gsl::make_span(&readText[0], readText.size())), 3u);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), keyEvents(std::wstring_view{ text }.substr(3)));
+
+        Log::Comment(L"Reading the rest as records leaves nothing.");
+        std::vector<INPUT_RECORD> outRecords;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords, 1, false, false, true, false));
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), keyEvents(std::wstring_view{ text }.substr(3)) - 1);
+        VERIFY_IS_TRUE(inputBuffer._textRuns.empty());
+        VERIFY_ARE_EQUAL(inputBuffer._textRunKeyEvents, 0u);
+    }
+
+    TEST_METHOD(RecordsThatArentEventsAreRejected)
+    {
+        InputBuffer inputBuffer;
+        const INPUT_RECORD key = MakeKeyEvent(TRUE, 1, L'A', 0, L'A', 0);
+
+        Log::Comment(L"A run with a record of an unknown type is rejected as a whole, whether it's written or prepended.");
+        for (const WORD eventType : { WORD{ 0 }, WORD{ 0x20 }, WORD{ 0x8000 } })
+        {
+            INPUT_RECORD records[2] = { key, key };
+            records[1].EventType = eventType;
+
+            VERIFY_ARE_EQUAL(inputBuffer.Write(records), 0u);
+            VERIFY_ARE_EQUAL(inputBuffer.Prepend(records), 0u);
+            VERIFY_IS_TRUE(inputBuffer._storage.empty());
+        }
+
+        Log::Comment(L"So nothing in the buffer can be taken for a text run.");
+        wchar_t wch;
+        VERIFY_ARE_EQUAL(inputBuffer.ReadText(gsl::make_span(&wch, 1)), 0u);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+    }
+
+    TEST_METHOD(PostedRecordsAreStoredInOrder)
+    {
+        InputBuffer inputBuffer;
+        INPUT_RECORD records[RECORD_INSERT_COUNT];
+        for (unsigned int i = 0; i < RECORD_INSERT_COUNT; ++i)
+        {
+            records[i] = MakeKeyEvent(TRUE, 1, static_cast<WCHAR>(L'A' + i), 0, static_cast<WCHAR>(L'A' + i), 0);
+        }
+
+        Log::Comment(L"Only the first post into an empty queue has to flush it.");
+        VERIFY_IS_TRUE(inputBuffer.Post(gsl::make_span(&records[0], 2)));
+        VERIFY_IS_FALSE(inputBuffer.Post(gsl::make_span(&records[2], 2)));
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+
+        VERIFY_ARE_EQUAL(inputBuffer.FlushPostedInput(), 4u);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 4u);
+        VERIFY_IS_TRUE(inputBuffer.Post(gsl::make_span(&records[4], 2)));
+
+        Log::Comment(L"A write stores what was posted before it first.");
+        VERIFY_ARE_EQUAL(inputBuffer.Write(gsl::make_span(&records[6], RECORD_INSERT_COUNT - 6)), RECORD_INSERT_COUNT - 6);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT);
+        for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
+        {
+            VERIFY_ARE_EQUAL(records[i], inputBuffer._storage[i]);
+        }
+
+        Log::Comment(L"A read sees what was posted, even before it's flushed.");
+        inputBuffer.Flush();
+        VERIFY_IS_TRUE(inputBuffer.Post(gsl::make_span(records)));
+        std::vector<INPUT_RECORD> outRecords;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords, RECORD_INSERT_COUNT, false, false, true, false));
+        VERIFY_ARE_EQUAL(outRecords.size(), RECORD_INSERT_COUNT);
+        VERIFY_ARE_EQUAL(inputBuffer.FlushPostedInput(), 0u);
+    }
+
+    TEST_METHOD(PostingToAFullQueueWritesInOrder)
+    {
+        InputBuffer inputBuffer;
+        std::vector<INPUT_RECORD> records;
+        for (size_t i = 0; i < InputPostQueue::Capacity + 2; ++i)
+        {
+            records.push_back(MakeKeyEvent(TRUE, 1, 0, static_cast<WORD>(i), L'A', 0));
+        }
+
+        VERIFY_IS_TRUE(inputBuffer.Post(gsl::make_span(records.data(), InputPostQueue::Capacity - 1)));
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+
+        Log::Comment(L"A batch that doesn't fit is written right away, after what was queued before it.");
+        VERIFY_IS_FALSE(inputBuffer.Post(gsl::make_span(records.data() + InputPostQueue::Capacity - 1, 3)));
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), records.size());
+        VERIFY_ARE_EQUAL(inputBuffer.FlushPostedInput(), 0u);
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(records[i], inputBuffer._storage[i]);
+        }
+
+        Log::Comment(L"The ring is reused once it's drained, including batches that wrap around its end.");
+        inputBuffer.Flush();
+        VERIFY_IS_TRUE(inputBuffer.Post(gsl::make_span(records.data(), 5)));
+        VERIFY_ARE_EQUAL(inputBuffer.FlushPostedInput(), 5u);
+        for (size_t i = 0; i < 5; ++i)
+        {
+            VERIFY_ARE_EQUAL(records[i], inputBuffer._storage[i]);
+        }
+    }
+
+    TEST_METHOD(CanPostFromManyThreads)
+    {
+        InputBuffer inputBuffer;
+        constexpr size_t threadCount = 4;
+        constexpr size_t postsPerThread = 1000;
+
+        std::vector<std::thread> producers;
+        for (size_t t = 0; t < threadCount; ++t)
+        {
+            producers.emplace_back([this, &inputBuffer, t]() {
+                for (size_t i = 0; i < postsPerThread; ++i)
+                {
+                    // each thread types its own character, with the count in the scan code.
+                    const INPUT_RECORD record = MakeKeyEvent(TRUE, 1, 0, static_cast<WORD>(i), static_cast<WCHAR>(L'A' + t), 0);
+                    inputBuffer.Post(gsl::make_span(&record, 1));
+                }
+            });
+        }
+        for (auto& producer : producers)
+        {
+            producer.join();
+        }
+
+        VERIFY_ARE_EQUAL(inputBuffer.FlushPostedInput(), threadCount * postsPerThread);
+
+        Log::Comment(L"Every record is there, and each thread's records are in the order it posted them.");
+        std::array<WORD, threadCount> nextExpected{};
+        for (size_t i = 0; i < inputBuffer._storage.size(); ++i)
+        {
+            const KEY_EVENT_RECORD& keyEvent = inputBuffer._storage[i].Event.KeyEvent;
+            const size_t t = keyEvent.uChar.UnicodeChar - L'A';
+            VERIFY_IS_LESS_THAN(t, threadCount);
+            VERIFY_ARE_EQUAL(nextExpected[t], keyEvent.wVirtualScanCode);
+            ++nextExpected[t];
+        }
+    }
 };
@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "..\..\inc\consoletaeftemplates.hpp"
+
+#include "../../types/inc/PerfMetrics.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+using namespace Microsoft::Console::Metrics;
+
+class PerfMetricsTests
+{
+    TEST_CLASS(PerfMetricsTests);
+
+    TEST_METHOD(BucketsContainTheirValues)
+    {
+        const uint64_t values[] = { 0, 1, 7, 8, 9, 15, 16, 17, 100, 1000, 65535, 65536, 123456789, UINT64_MAX };
+        for (const auto value : values)
+        {
+            const auto index = Histogram::s_BucketIndex(value);
+            Log::Comment(NoThrowString().Format(L"%llu is in bucket %zu", value, index));
+
+            VERIFY_IS_LESS_THAN(index, Histogram::s_BucketCount);
+            VERIFY_IS_LESS_THAN_OR_EQUAL(Histogram::s_BucketLowestValue(index), value);
+            VERIFY_IS_GREATER_THAN_OR_EQUAL(Histogram::s_BucketHighestValue(index), value);
+        }
+
+        Log::Comment(L"Small values are recorded exactly.");
+        for (uint64_t value = 0; value < Histogram::s_SubBucketCount; value++)
+        {
+            const auto index = Histogram::s_BucketIndex(value);
+            VERIFY_ARE_EQUAL(value, Histogram::s_BucketLowestValue(index));
+            VERIFY_ARE_EQUAL(value, Histogram::s_BucketHighestValue(index));
+        }
+    }
+
+    TEST_METHOD(PercentilesAreWithinPrecision)
+    {
+        Histogram histogram;
+        VERIFY_ARE_EQUAL(0ull, histogram.ValueAtPercentile(50.0));
+
+        for (uint64_t value = 1; value <= 1000; value++)
+        {
+            histogram.Record(value);
+        }
+
+        VERIFY_ARE_EQUAL(1000ull, histogram.Count());
+
+        const auto snapshot = histogram.GetSnapshot();
+        VERIFY_ARE_EQUAL(1ull, snapshot.min);
+        VERIFY_ARE_EQUAL(1000ull, snapshot.max);
+        VERIFY_ARE_EQUAL(500500ull, snapshot.sum);
+
+        // Every bucket is at most 1/s_SubBucketCount of its value wide.
+        VERIFY_IS_GREATER_THAN_OR_EQUAL(snapshot.p50, 500ull);
+        VERIFY_IS_LESS_THAN_OR_EQUAL(snapshot.p50, 500ull + 500ull / Histogram::s_SubBucketCount);
+        VERIFY_IS_GREATER_THAN_OR_EQUAL(snapshot.p90, 900ull);
+        VERIFY_IS_LESS_THAN_OR_EQUAL(snapshot.p90, 900ull + 900ull / Histogram::s_SubBucketCount);
+        VERIFY_ARE_EQUAL(1000ull, histogram.ValueAtPercentile(100.0));
+
+        histogram.Reset();
+        VERIFY_ARE_EQUAL(0ull, histogram.Count());
+        VERIFY_ARE_EQUAL(0ull, histogram.GetSnapshot().min);
+    }
+
+    TEST_METHOD(RegistryReturnsTheSameMetric)
+    {
+        MetricsRegistry registry;
+
+        auto& counter = registry.GetCounter("test.counter");
+        counter.Add(3);
+        counter.Increment();
+        VERIFY_ARE_EQUAL(&counter, &registry.GetCounter("test.counter"));
+        VERIFY_ARE_EQUAL(4ull, registry.GetCounter("test.counter").Get());
+
+        auto& histogram = registry.GetHistogram("test.histogram");
+        VERIFY_ARE_EQUAL(&histogram, &registry.GetHistogram("test.histogram"));
+
+        registry.Reset();
+        VERIFY_ARE_EQUAL(0ull, counter.Get());
+    }
+
+    TEST_METHOD(RegistryDumpsJson)
+    {
+        MetricsRegistry registry;
+
+        registry.GetCounter("bytes").Add(42);
+        registry.GetCounter("quote\"d").Add(1);
+        auto& histogram = registry.GetHistogram("latency");
+        histogram.Record(5);
+        histogram.Record(7);
+
+        const std::string expected =
+            "{\"counters\":{\"bytes\":42,\"quote\\\"d\":1},"
+            "\"histograms\":{\"latency\":{\"count\":2,\"sum\":12,\"min\":5,\"max\":7,\"p50\":5,\"p90\":7,\"p99\":7,\"p999\":7}}}";
+        VERIFY_ARE_EQUAL(expected, registry.ToJson());
+    }
+
+    TEST_METHOD(PendingLatencyMeasuresFromTheEarliestEvent)
+    {
+        Histogram histogram;
+        PendingLatency pending;
+
+        Log::Comment(L"Nothing is recorded if nothing is pending.");
+        pending.End(histogram);
+        VERIFY_ARE_EQUAL(0ull, histogram.Count());
+
+        pending.Begin();
+        Sleep(20);
+        pending.Begin();
+        pending.End(histogram);
+
+        VERIFY_ARE_EQUAL(1ull, histogram.Count());
+        VERIFY_IS_GREATER_THAN_OR_EQUAL(histogram.GetSnapshot().max, 15000ull);
+
+        Log::Comment(L"Ending resets the pending event.");
+        pending.End(histogram);
+        VERIFY_ARE_EQUAL(1ull, histogram.Count());
+    }
+
+    TEST_METHOD(LockWaitsAreRecorded)
+    {
+        Histogram histogram;
+        Counter uncontended;
+        std::mutex mutex;
+
+        Log::Comment(L"Taking a free lock is only counted.");
+        {
+            std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+            LockAndMeasureWait(lock, histogram, uncontended);
+            VERIFY_IS_TRUE(lock.owns_lock());
+        }
+
+        VERIFY_ARE_EQUAL(1ull, uncontended.Get());
+        VERIFY_ARE_EQUAL(0ull, histogram.Count());
+
+        Log::Comment(L"Waiting for a held lock records the wait.");
+        {
+            std::atomic<bool> locked{ false };
+            std::thread holder([&]() {
+                std::lock_guard<std::mutex> held(mutex);
+                locked = true;
+                Sleep(15);
+            });
+            while (!locked)
+            {
+                Sleep(1);
+            }
+
+            std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+            LockAndMeasureWait(lock, histogram, uncontended);
+            VERIFY_IS_TRUE(lock.owns_lock());
+            lock.unlock();
+            holder.join();
+        }
+
+        VERIFY_ARE_EQUAL(1ull, uncontended.Get());
+        VERIFY_ARE_EQUAL(1ull, histogram.Count());
+    }
+};
@@ -85,6 +85,7 @@ class ScreenBufferTests
     TEST_METHOD(MultipleAlternateBufferCreationTest);
 
     TEST_METHOD(MultipleAlternateBuffersFromMainCreationTest);
+    TEST_METHOD(AlternateBufferIsReused);
 
     TEST_METHOD(TestReverseLineFeed);
 
@@ -142,6 +143,7 @@ class ScreenBufferTests
 
     TEST_METHOD(BackspaceDefaultAttrs);
     TEST_METHOD(BackspaceDefaultAttrsWriteCharsLegacy);
+    TEST_METHOD(WriteCharsLegacyNarrowAndWideRuns);
 
     TEST_METHOD(BackspaceDefaultAttrsInPrompt);
 
@@ -286,6 +288,57 @@ void ScreenBufferTests::MultipleAlternateBuffersFromMainCreationTest()
     }
 }
 
+void ScreenBufferTests::AlternateBufferIsReused()
+{
+    CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    gci.LockConsole(); // Lock must be taken to manipulate buffer.
+    auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+
+    Log::Comment(
+        L"Testing that an alternate buffer left behind is reused, blank, by "
+        L"the next alternate buffer of the same size."
+    );
+    SCREEN_INFORMATION* const psiOriginal = &gci.GetActiveOutputBuffer();
+    VERIFY_IS_NULL(psiOriginal->_psiCachedAltBuffer);
+
+    VERIFY_IS_TRUE(NT_SUCCESS(psiOriginal->UseAlternateScreenBuffer()));
+    SCREEN_INFORMATION* const psiFirstAlternate = &gci.GetActiveOutputBuffer();
+    VERIFY_ARE_NOT_EQUAL(psiOriginal, psiFirstAlternate);
+
+    auto& stateMachine = psiFirstAlternate->GetStateMachine();
+    std::wstring seq = L"\x1b[3;5Hfoo";
+    stateMachine.ProcessString(seq);
+    psiFirstAlternate->OutputMode |= DISABLE_NEWLINE_AUTO_RETURN;
+
+    psiFirstAlternate->UseMainScreenBuffer();
+    VERIFY_ARE_EQUAL(psiOriginal, &gci.GetActiveOutputBuffer());
+    VERIFY_IS_NULL(psiOriginal->_psiAlternateBuffer);
+    VERIFY_ARE_EQUAL(psiFirstAlternate, psiOriginal->_psiCachedAltBuffer);
+
+    Log::Comment(L"The cached buffer isn't in the list of screen buffers.");
+    for (auto* psi = gci.ScreenBuffers; psi != nullptr; psi = psi->Next)
+    {
+        VERIFY_ARE_NOT_EQUAL(psiFirstAlternate, psi);
+    }
+
+    VERIFY_IS_TRUE(NT_SUCCESS(psiOriginal->UseAlternateScreenBuffer()));
+    SCREEN_INFORMATION* const psiSecondAlternate = &gci.GetActiveOutputBuffer();
+    VERIFY_ARE_EQUAL(psiFirstAlternate, psiSecondAlternate);
+    VERIFY_ARE_EQUAL(psiSecondAlternate, psiOriginal->_psiAlternateBuffer);
+    VERIFY_ARE_EQUAL(psiOriginal, psiSecondAlternate->_psiMainBuffer);
+    VERIFY_IS_NULL(psiOriginal->_psiCachedAltBuffer);
+
+    Log::Comment(L"The reused buffer is blank, with the cursor at the origin, and in the default mode.");
+    const auto& textBuffer = psiSecondAlternate->GetTextBuffer();
+    VERIFY_ARE_EQUAL(COORD({ 0, 0 }), textBuffer.GetCursor().GetPosition());
+    const auto text = *textBuffer.GetTextDataAt({ 4, 2 });
+    VERIFY_ARE_EQUAL(String(L" "), String(text.data(), gsl::narrow<int>(text.size())));
+    VERIFY_IS_TRUE(WI_IsFlagClear(psiSecondAlternate->OutputMode, DISABLE_NEWLINE_AUTO_RETURN));
+
+    psiSecondAlternate->UseMainScreenBuffer();
+    VERIFY_ARE_EQUAL(psiOriginal, &gci.GetActiveOutputBuffer());
+}
+
 void ScreenBufferTests::TestReverseLineFeed()
 {
     CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
@@ -2212,6 +2265,53 @@ void ScreenBufferTests::BackspaceDefaultAttrsWriteCharsLegacy()
     VERIFY_ARE_EQUAL(magenta, gci.LookupBackgroundColor(attrB));
 }
 
+void ScreenBufferTests::WriteCharsLegacyNarrowAndWideRuns()
+{
+    CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    SCREEN_INFORMATION& si = gci.GetActiveOutputBuffer().GetActiveBuffer();
+    const TextBuffer& tbi = si.GetTextBuffer();
+    Cursor& cursor = si.GetTextBuffer().GetCursor();
+    const auto width = si.GetBufferSize().Width();
+
+    VERIFY_SUCCEEDED(si.SetViewportOrigin(true, COORD({0, 0}), true));
+    cursor.SetPosition({0, 0});
+
+    Log::Comment(L"A wide char in the middle of narrow ones takes two cells.");
+    {
+        wchar_t* str = L"abc\x30CA" L"def";
+        size_t seqCb = 7 * sizeof(wchar_t);
+        VERIFY_SUCCESS_NTSTATUS(WriteCharsLegacy(si, str, str, str, &seqCb, nullptr, cursor.GetPosition().X, 0, nullptr));
+        VERIFY_ARE_EQUAL(7u * sizeof(wchar_t), seqCb);
+        VERIFY_ARE_EQUAL(COORD({8, 0}), cursor.GetPosition());
+
+        const std::wstring_view expected[] = { L"a", L"b", L"c", L"\x30CA", L"\x30CA", L"d", L"e", L"f" };
+        auto iter = tbi.GetCellDataAt({0, 0});
+        for (const auto& glyph : expected)
+        {
+            VERIFY_ARE_EQUAL(String(glyph.data(), gsl::narrow<int>(glyph.size())),
+                             String(iter->Chars().data(), gsl::narrow<int>(iter->Chars().size())));
+            iter++;
+        }
+    }
+
+    Log::Comment(L"A narrow run longer than the row is wrapped onto the next one.");
+    {
+        cursor.SetPosition({0, 1});
+        std::wstring run(width + 5, L'Z');
+        size_t seqCb = run.size() * sizeof(wchar_t);
+        VERIFY_SUCCESS_NTSTATUS(WriteCharsLegacy(si, run.data(), run.data(), run.data(), &seqCb, nullptr, cursor.GetPosition().X, 0, nullptr));
+        VERIFY_ARE_EQUAL(COORD({5, 2}), cursor.GetPosition());
+
+        auto iter = tbi.GetCellDataAt({0, 1});
+        for (int x = 0; x < width + 5; x++)
+        {
+            SetVerifyOutput settings(VerifyOutputSettings::LogOnlyFailures);
+            VERIFY_ARE_EQUAL(L"Z", iter->Chars());
+            iter++;
+        }
+    }
+}
+
 void ScreenBufferTests::BackspaceDefaultAttrsInPrompt()
 {
     // Tests MSFT:19853701 - when you edit the prompt line at a bash prompt,
@@ -9,6 +9,14 @@
 
 #include "search.h"
 
+#include "../../renderer/inc/DummyRenderTarget.hpp"
+
+#include "../../types/inc/Utf16Parser.hpp"
+#include "../../types/inc/GlyphWidth.hpp"
+
+#include <chrono>
+#include <thread>
+
 using namespace WEX::Common;
 using namespace WEX::Logging;
 using namespace WEX::TestExecution;
@@ -84,6 +92,325 @@ class SearchTests
         VERIFY_IS_FALSE(s.FindNext());
     }
 
+    // Splits a string into the cells it would take up in the buffer, the way
+    // the search has always done it: one cell per glyph, two for a wide one.
+    static std::vector<std::wstring> s_CellsFromString(const std::wstring_view str)
+    {
+        std::vector<std::wstring> cells;
+        for (const auto& chars : Utf16Parser::Parse(str))
+        {
+            const std::wstring glyph{ chars.data(), chars.size() };
+            if (IsGlyphFullWidth(glyph))
+            {
+                cells.push_back(glyph);
+            }
+            cells.push_back(glyph);
+        }
+        return cells;
+    }
+
+    // Compares the needle to the buffer at one position, a cell at a time.
+    static bool s_MatchesCellByCell(const TextBuffer& textBuffer,
+                                    const COORD pos,
+                                    const std::vector<std::wstring>& cells,
+                                    const bool caseInsensitive)
+    {
+        const auto fold = [=](const wchar_t wch) {
+            return caseInsensitive ? static_cast<wchar_t>(::towlower(wch)) : wch;
+        };
+
+        COORD bufferPos = pos;
+        for (const auto& cell : cells)
+        {
+            const std::wstring_view hayChars = *textBuffer.GetTextDataAt(bufferPos);
+            if (hayChars.size() != cell.size() ||
+                !std::equal(hayChars.begin(), hayChars.end(), cell.begin(), [&](const wchar_t a, const wchar_t b) { return fold(a) == fold(b); }))
+            {
+                return false;
+            }
+            textBuffer.GetSize().IncrementInBoundsCircular(bufferPos);
+        }
+        return true;
+    }
+
+    TEST_METHOD(ForwardAcrossRowEnd)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& outputBuffer = gci.GetActiveOutputBuffer();
+        auto& textBuffer = outputBuffer.GetTextBuffer();
+        const SHORT column = gsl::narrow<SHORT>(textBuffer.GetSize().RightInclusive() - 1);
+
+        textBuffer.Write(OutputCellIterator(L"XYZ"), { column, 10 });
+
+        Search s(outputBuffer, L"xyz", Search::Direction::Forward, Search::Sensitivity::CaseInsensitive);
+        VERIFY_IS_TRUE(s.FindNext());
+        VERIFY_ARE_EQUAL(COORD({ column, 10 }), s._coordSelStart);
+        VERIFY_ARE_EQUAL(COORD({ 0, 11 }), s._coordSelEnd);
+        VERIFY_IS_FALSE(s.FindNext());
+    }
+
+    TEST_METHOD(BackwardAcrossBufferEnd)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& outputBuffer = gci.GetActiveOutputBuffer();
+        auto& textBuffer = outputBuffer.GetTextBuffer();
+        const COORD bottomRight = { textBuffer.GetSize().RightInclusive(), textBuffer.GetSize().BottomInclusive() };
+
+        // The search goes around from the bottom right of the buffer to the top
+        // left, so a match may start on the last row and end on the first.
+        textBuffer.Write(OutputCellIterator(L"Q"), bottomRight);
+        textBuffer.Write(OutputCellIterator(L"R"), { 0, 0 });
+
+        Search s(outputBuffer, L"QR", Search::Direction::Backward, Search::Sensitivity::CaseSensitive);
+        VERIFY_IS_TRUE(s.FindNext());
+        VERIFY_ARE_EQUAL(bottomRight, s._coordSelStart);
+        VERIFY_ARE_EQUAL(COORD({ 0, 0 }), s._coordSelEnd);
+        VERIFY_IS_FALSE(s.FindNext());
+    }
+
+    TEST_METHOD(BufferSearchAgreesWithCellByCellSearch)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+        const SHORT column = gsl::narrow<SHORT>(textBuffer.GetSize().RightInclusive() - 2);
+
+        // A surrogate pair, a run that wraps onto the next row, and the wide
+        // glyphs that FillTextBuffer left on the first rows.
+        textBuffer.Write(OutputCellIterator(L"a\xD83D\xDE00" L"b"), { 5, 6 });
+        textBuffer.Write(OutputCellIterator(L"\x304b\x304b" L"AbC"), { column, 7 });
+
+        const std::wstring_view needles[] = {
+            L"AB",
+            L"DE ",
+            L"\x304b",
+            L"\x304b" L"C",
+            L"\xD83D\xDE00",
+            L"a\xD83D\xDE00" L"B",
+            L"\x304b" L"abc",
+            L"E      A",
+            L"not there",
+        };
+
+        for (const auto needle : needles)
+        {
+            for (const bool caseInsensitive : { false, true })
+            {
+                Log::Comment(NoThrowString().Format(L"Needle '%.*s', case insensitive: %d", gsl::narrow<int>(needle.size()), needle.data(), caseInsensitive));
+
+                const TextBufferSearch search{ needle, caseInsensitive };
+                const auto cells = s_CellsFromString(needle);
+                VERIFY_ARE_EQUAL(cells.size(), search.CellCount());
+
+                const auto bufferSize = textBuffer.GetSize();
+                COORD pos = { 0, 0 };
+                do
+                {
+                    const bool expected = s_MatchesCellByCell(textBuffer, pos, cells, caseInsensitive);
+                    const auto found = search.FindFirst(textBuffer, pos, 1, true);
+                    if (found.has_value() != expected)
+                    {
+                        VERIFY_FAIL(NoThrowString().Format(L"Disagreed at (%d, %d)", pos.X, pos.Y));
+                    }
+                } while (bufferSize.IncrementInBoundsCircular(pos));
+            }
+        }
+    }
+
+    TEST_METHOD(FindFirstReturnsClosestMatch)
+    {
+        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+
+        // FillTextBuffer puts "AB" at the start of each of the first four rows.
+        const TextBufferSearch search{ L"AB", false };
+
+        VERIFY_ARE_EQUAL(COORD({ 0, 1 }), search.FindFirst(textBuffer, { 1, 0 }, 0x10000, true).value_or(COORD{ -1, -1 }));
+        VERIFY_ARE_EQUAL(COORD({ 0, 2 }), search.FindFirst(textBuffer, { 79, 2 }, 0x10000, false).value_or(COORD{ -1, -1 }));
+        VERIFY_ARE_EQUAL(COORD({ 0, 0 }), search.FindFirst(textBuffer, { 5, 200 }, 0x10000, true).value_or(COORD{ -1, -1 }));
+        VERIFY_ARE_EQUAL(COORD({ 0, 3 }), search.FindFirst(textBuffer, { 5, 200 }, 0x10000, false).value_or(COORD{ -1, -1 }));
+
+        // Only as many positions as asked for are tried.
+        VERIFY_IS_FALSE(search.FindFirst(textBuffer, { 1, 0 }, 79, true).has_value());
+        VERIFY_IS_TRUE(search.FindFirst(textBuffer, { 1, 0 }, 80, true).has_value());
+        VERIFY_IS_FALSE(search.FindFirst(textBuffer, { 0, 0 }, 0, true).has_value());
+
+        VERIFY_ARE_EQUAL(COORD({ 1, 2 }), search.GetMatchEnd(textBuffer, { 0, 2 }));
+    }
+
+    TEST_METHOD(SearchWholeBufferPerformance)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD_PROPERTIES()
+
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+        const auto bufferSize = textBuffer.GetSize();
+
+        // Fill every row of the buffer with text that nearly matches, and put
+        // the one real match at the very end.
+        const std::wstring filler(gsl::narrow<size_t>(bufferSize.Width()) * bufferSize.Height(), L'x');
+        textBuffer.Write(OutputCellIterator(filler), { 0, 0 });
+        const std::wstring_view needle{ L"xxxxxxxxyzzy" };
+        textBuffer.Write(OutputCellIterator(needle), { gsl::narrow<SHORT>(bufferSize.Width() - needle.size()), bufferSize.BottomInclusive() });
+
+        const auto cells = s_CellsFromString(needle);
+        const TextBufferSearch search{ needle, true };
+        const auto total = gsl::narrow<size_t>(bufferSize.Width()) * bufferSize.Height();
+        constexpr size_t iterations = 20;
+
+        const auto bufferStart = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            VERIFY_IS_TRUE(search.FindFirst(textBuffer, { 0, 0 }, total, true).has_value());
+        }
+        const auto bufferElapsed = std::chrono::steady_clock::now() - bufferStart;
+
+        const auto cellStart = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            COORD pos = { 0, 0 };
+            while (!s_MatchesCellByCell(textBuffer, pos, cells, true))
+            {
+                bufferSize.IncrementInBoundsCircular(pos);
+            }
+        }
+        const auto cellElapsed = std::chrono::steady_clock::now() - cellStart;
+
+        Log::Comment(NoThrowString().Format(L"Searched %zu cells %zu times: %lld us with the buffer search, %lld us cell by cell",
+                                            total,
+                                            iterations,
+                                            std::chrono::duration_cast<std::chrono::microseconds>(bufferElapsed).count(),
+                                            std::chrono::duration_cast<std::chrono::microseconds>(cellElapsed).count()));
+    }
+
+    TEST_METHOD(RegexMatchesEachLine)
+    {
+        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto& outputBuffer = gci.GetActiveOutputBuffer();
+
+        // Each of the filled rows is "ABかCきDE", where the wide glyphs take up
+        // two cells each, and the rest of the row is spaces.
+        Search s(outputBuffer, L"^ab.c", Search::Direction::Forward, Search::Sensitivity::CaseInsensitive, Search::Syntax::RegularExpression);
+        for (SHORT row = 0; row < 4; ++row)
+        {
+            VERIFY_IS_TRUE(s.FindNext());
+            VERIFY_ARE_EQUAL(COORD({ 0, row }), s._coordSelStart);
+            VERIFY_ARE_EQUAL(COORD({ 4, row }), s._coordSelEnd);
+        }
+        VERIFY_IS_FALSE(s.FindNext());
+
+        // The spaces past the end of the text aren't part of the line.
+        Search end(outputBuffer, L"\x304d" L"DE$", Search::Direction::Backward, Search::Sensitivity::CaseSensitive, Search::Syntax::RegularExpression);
+        for (SHORT row = 3; row >= 0; --row)
+        {
+            VERIFY_IS_TRUE(end.FindNext());
+            VERIFY_ARE_EQUAL(COORD({ 5, row }), end._coordSelStart);
+            VERIFY_ARE_EQUAL(COORD({ 8, row }), end._coordSelEnd);
+        }
+        VERIFY_IS_FALSE(end.FindNext());
+    }
+
+    TEST_METHOD(RegexMatchesAcrossWrappedRows)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& outputBuffer = gci.GetActiveOutputBuffer();
+        auto& textBuffer = outputBuffer.GetTextBuffer();
+        const SHORT column = gsl::narrow<SHORT>(textBuffer.GetSize().RightInclusive() - 1);
+
+        textBuffer.Write(OutputCellIterator(L"XY"), { column, 10 });
+        textBuffer.Write(OutputCellIterator(L"Z"), { 0, 11 });
+
+        // Rows that end where the text just happened to end are separate lines.
+        {
+            Search s(outputBuffer, L"XYZ", Search::Direction::Forward, Search::Sensitivity::CaseSensitive, Search::Syntax::RegularExpression);
+            VERIFY_IS_FALSE(s.FindNext());
+        }
+
+        // Rows that the text wrapped past the end of are joined to the next row.
+        textBuffer.GetRowByOffset(10).GetCharRow().SetWrapForced(true);
+        {
+            Search s(outputBuffer, L"XYZ$", Search::Direction::Forward, Search::Sensitivity::CaseSensitive, Search::Syntax::RegularExpression);
+            VERIFY_IS_TRUE(s.FindNext());
+            VERIFY_ARE_EQUAL(COORD({ column, 10 }), s._coordSelStart);
+            VERIFY_ARE_EQUAL(COORD({ 0, 11 }), s._coordSelEnd);
+            VERIFY_IS_FALSE(s.FindNext());
+        }
+    }
+
+    TEST_METHOD(RegexRejectsInvalidPattern)
+    {
+        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto& outputBuffer = gci.GetActiveOutputBuffer();
+
+        VERIFY_THROWS_SPECIFIC(Search(outputBuffer, L"(AB", Search::Direction::Forward, Search::Sensitivity::CaseSensitive, Search::Syntax::RegularExpression),
+                               wil::ResultException,
+                               [](wil::ResultException& e) { return e.GetErrorCode() == E_INVALIDARG; });
+    }
+
+    TEST_METHOD(RegexSearchThroughput)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD_PROPERTIES()
+
+        const COORD bufferSize{ 120, 9001 };
+        DummyRenderTarget renderTarget;
+        TextBuffer textBuffer{ bufferSize, TextAttribute{ 0x7f }, 12, renderTarget };
+
+        // Saturate the buffer: every cell of every row has text, and every
+        // other row wraps onto the next, the way long log lines do.
+        std::wstring row;
+        for (SHORT y = 0; y < bufferSize.Y; ++y)
+        {
+            row = L"2019-05-01 12:00:00.000 ";
+            row += y % 89 == 0 ? L"ERROR" : L"INFO";
+            row += L" request " + std::to_wstring(y) + L" handled in " + std::to_wstring(y % 250) + L"ms ";
+            while (row.size() < static_cast<size_t>(bufferSize.X))
+            {
+                row += row;
+            }
+            row.resize(bufferSize.X);
+
+            textBuffer.Write(OutputCellIterator(row), { 0, y });
+            textBuffer.GetRowByOffset(y).GetCharRow().SetWrapForced(y % 2 == 0);
+        }
+
+        const TextBufferRegexSearch search{ L"error request \\d+ handled in [0-9]{2,3}ms", true };
+        const double megabytes = static_cast<double>(bufferSize.X) * bufferSize.Y * sizeof(wchar_t) / (1024 * 1024);
+        constexpr size_t iterations = 5;
+
+        const auto measure = [&](const size_t threadCount, std::vector<TextBufferRegexSearch::Match>& matches) {
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                matches = search.FindAll(textBuffer, threadCount);
+            }
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            return megabytes * iterations / elapsed.count();
+        };
+
+        std::vector<TextBufferRegexSearch::Match> serialMatches;
+        std::vector<TextBufferRegexSearch::Match> parallelMatches;
+        const double serialThroughput = measure(1, serialMatches);
+        const double parallelThroughput = measure(0, parallelMatches);
+
+        VERIFY_IS_FALSE(serialMatches.empty());
+        VERIFY_ARE_EQUAL(serialMatches.size(), parallelMatches.size());
+        for (size_t i = 0; i < serialMatches.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(serialMatches.at(i).first, parallelMatches.at(i).first);
+            VERIFY_ARE_EQUAL(serialMatches.at(i).second, parallelMatches.at(i).second);
+        }
+
+        Log::Comment(NoThrowString().Format(L"Searched %.1f MB of text for %zu matches: %.1f MB/s on one thread, %.1f MB/s on %u threads",
+                                            megabytes,
+                                            serialMatches.size(),
+                                            serialThroughput,
+                                            parallelThroughput,
+                                            std::thread::hardware_concurrency()));
+    }
+
     TEST_METHOD(ForwardCaseSensitive)
     {
         const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
@@ -17,6 +17,8 @@
 #include "../interactivity/inc/ServiceLocator.hpp"
 #include "../renderer/inc/DummyRenderTarget.hpp"
 
+#include <chrono>
+
 using namespace Microsoft::Console::Types;
 using namespace WEX::Common;
 using namespace WEX::Logging;
@@ -142,6 +144,15 @@ class TextBufferTests
 
     TEST_METHOD(TestBurrito);
 
+    TEST_METHOD(FillRectResetsRowsAndUnicodeStorage);
+
+    TEST_METHOD(WriteAndReadCharInfoRects);
+
+    TEST_METHOD(ScrollRowsInCircledBuffer);
+
+    TEST_METHOD(SearchSessionFollowsBufferChanges);
+    TEST_METHOD(SearchSessionStreamingPerformance);
+
 };
 
 void TextBufferTests::TestBufferCreate()
@@ -1964,3 +1975,311 @@ void TextBufferTests::TestBurrito()
     _buffer->IncrementCursor();
     VERIFY_IS_FALSE(afterBurritoIter);
 }
+
+void TextBufferTests::FillRectResetsRowsAndUnicodeStorage()
+{
+    const COORD bufferSize{ 10, 5 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    // Put a glyph that lives in the unicode storage in each of the first two rows.
+    const auto fire = L"\xD83D\xDD25";
+    _buffer->_storage[0].GetCharRow().GlyphAt(3) = fire;
+    _buffer->_storage[1].GetCharRow().GlyphAt(8) = fire;
+    VERIFY_ARE_EQUAL(2u, _buffer->GetUnicodeStorage()._map.size());
+
+    Log::Comment(L"Filling whole rows leaves a single attribute run in each.");
+    const TextAttribute fillAttr{ 0x1e };
+    _buffer->FillRect(Viewport::FromDimensions({ 0, 0 }, { bufferSize.X, 2 }), L'x', fillAttr);
+
+    for (short y = 0; y < 2; y++)
+    {
+        const auto& row = _buffer->GetRowByOffset(y);
+        VERIFY_ARE_EQUAL(String(L"xxxxxxxxxx"), String(row.GetText().c_str()));
+        VERIFY_ARE_EQUAL(1u, row.GetAttrRow().GetNumberOfRuns());
+        VERIFY_ARE_EQUAL(fillAttr, row.GetAttrRow().GetAttrByColumn(0));
+    }
+    VERIFY_IS_TRUE(_buffer->GetUnicodeStorage()._map.empty(), L"The map should now be empty.");
+
+    Log::Comment(L"Filling part of a row leaves the rest of it alone.");
+    _buffer->FillRect(Viewport::FromDimensions({ 2, 1 }, { 3, 3 }), L' ', attr);
+
+    for (short y = 1; y < 4; y++)
+    {
+        const auto& row = _buffer->GetRowByOffset(y);
+        VERIFY_ARE_EQUAL(attr, row.GetAttrRow().GetAttrByColumn(2));
+        VERIFY_ARE_EQUAL(attr, row.GetAttrRow().GetAttrByColumn(4));
+    }
+    VERIFY_ARE_EQUAL(String(L"xx   xxxxx"), String(_buffer->GetRowByOffset(1).GetText().c_str()));
+    VERIFY_ARE_EQUAL(fillAttr, _buffer->GetRowByOffset(1).GetAttrRow().GetAttrByColumn(1));
+    VERIFY_ARE_EQUAL(fillAttr, _buffer->GetRowByOffset(1).GetAttrRow().GetAttrByColumn(5));
+    VERIFY_ARE_EQUAL(String(L"xxxxxxxxxx"), String(_buffer->GetRowByOffset(0).GetText().c_str()));
+}
+
+// This tests that rectangles of CHAR_INFOs go into and come back out of the rows
+// as given, with the DBCS halves kept and the attributes packed into runs.
+void TextBufferTests::WriteAndReadCharInfoRects()
+{
+    const COORD bufferSize{ 10, 3 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    // Put a glyph that lives in the unicode storage where the rectangle goes.
+    const auto fire = L"\xD83D\xDD25";
+    _buffer->_storage[0].GetCharRow().GlyphAt(3) = fire;
+    VERIFY_ARE_EQUAL(1u, _buffer->GetUnicodeStorage()._map.size());
+
+    // Two rows of 5 cells, kept 6 cells apart.
+    const size_t width = 6;
+    std::vector<CHAR_INFO> source(width * 2);
+    const std::pair<wchar_t, WORD> cells[] = {
+        { L'a', WORD{ 0x1e } },
+        { L'b', WORD{ 0x1e } },
+        { L'\x3042', WORD{ 0x2f | COMMON_LVB_LEADING_BYTE } },
+        { L'\x3042', WORD{ 0x2f | COMMON_LVB_TRAILING_BYTE } },
+        { L'c', WORD{ 0x2f } },
+        { L'!', WORD{ 0x00 } },
+    };
+    for (size_t i = 0; i < source.size(); ++i)
+    {
+        source[i].Char.UnicodeChar = i < width ? cells[i].first : L'x';
+        source[i].Attributes = i < width ? cells[i].second : WORD{ 0x1e };
+    }
+
+    const auto rect = Viewport::FromDimensions({ 1, 0 }, { 5, 2 });
+    _buffer->WriteCharInfos(rect, source, width);
+
+    const auto& firstRow = _buffer->GetRowByOffset(0);
+    VERIFY_ARE_EQUAL(String(L" ab\x3042" L"c    "), String(firstRow.GetText().c_str()));
+    VERIFY_IS_TRUE(firstRow.GetCharRow().DbcsAttrAt(3).IsLeading());
+    VERIFY_IS_TRUE(firstRow.GetCharRow().DbcsAttrAt(4).IsTrailing());
+    VERIFY_IS_TRUE(_buffer->GetUnicodeStorage()._map.empty(), L"The glyph that was written over should be gone from the map.");
+
+    Log::Comment(L"The DBCS flags don't split the attribute runs.");
+    VERIFY_ARE_EQUAL(4u, firstRow.GetAttrRow().GetNumberOfRuns());
+    VERIFY_ARE_EQUAL(attr, firstRow.GetAttrRow().GetAttrByColumn(0));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x1e }, firstRow.GetAttrRow().GetAttrByColumn(2));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x2f }, firstRow.GetAttrRow().GetAttrByColumn(5));
+    VERIFY_ARE_EQUAL(attr, firstRow.GetAttrRow().GetAttrByColumn(6));
+    VERIFY_ARE_EQUAL(String(L" xxxxx    "), String(_buffer->GetRowByOffset(1).GetText().c_str()));
+    VERIFY_ARE_EQUAL(3u, _buffer->GetRowByOffset(1).GetAttrRow().GetNumberOfRuns());
+
+    Log::Comment(L"Reading the rectangle back gives the same cells, and leaves the ones between the rows alone.");
+    CHAR_INFO untouched;
+    untouched.Char.UnicodeChar = L'?';
+    untouched.Attributes = 0;
+    std::vector<CHAR_INFO> target(source.size(), untouched);
+    _buffer->ReadCharInfos(rect, target, width, [](const TextAttribute& cellAttr) {
+        return cellAttr.GetLegacyAttributes();
+    });
+
+    for (size_t i = 0; i < target.size(); ++i)
+    {
+        const auto& expected = i % width == width - 1 ? untouched : source[i];
+        VERIFY_ARE_EQUAL(expected.Char.UnicodeChar, target[i].Char.UnicodeChar);
+        VERIFY_ARE_EQUAL(expected.Attributes, target[i].Attributes);
+    }
+
+    Log::Comment(L"A leading half in the last column is padded out, like any other write would.");
+    CHAR_INFO leading;
+    leading.Char.UnicodeChar = L'\x3042';
+    leading.Attributes = 0x2f | COMMON_LVB_LEADING_BYTE;
+    _buffer->WriteCharInfos(Viewport::FromDimensions({ 9, 2 }, { 1, 1 }), { &leading, 1 }, 1);
+
+    const auto& lastRow = _buffer->GetRowByOffset(2);
+    VERIFY_IS_TRUE(lastRow.GetCharRow().WasDoubleBytePadded());
+    VERIFY_IS_TRUE(lastRow.GetCharRow().DbcsAttrAt(9).IsSingle());
+    VERIFY_ARE_EQUAL(String(L"          "), String(lastRow.GetText().c_str()));
+}
+
+// This tests that scrolling rows in a buffer that has circled moves just the rows
+// in the region, whether or not the region wraps around the end of the storage.
+void TextBufferTests::ScrollRowsInCircledBuffer()
+{
+    const COORD bufferSize{ 10, 6 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    _buffer->IncrementCircularBuffer();
+    _buffer->IncrementCircularBuffer();
+    _buffer->IncrementCircularBuffer();
+    VERIFY_ARE_EQUAL(SHORT{ 3 }, _buffer->GetFirstRowIndex());
+
+    const wchar_t* const labels[] = { L"0", L"1", L"2", L"3", L"4", L"5" };
+    for (short y = 0; y < bufferSize.Y; y++)
+    {
+        _buffer->GetRowByOffset(y).GetCharRow().GlyphAt(0) = labels[y];
+    }
+
+    const auto fire = L"\xD83D\xDD25";
+    _buffer->GetRowByOffset(1).GetCharRow().GlyphAt(4) = fire;
+
+    auto verifyRows = [&](const std::wstring_view expected) {
+        for (short y = 0; y < bufferSize.Y; y++)
+        {
+            const auto text = *_buffer->GetTextDataAt({ 0, y });
+            VERIFY_ARE_EQUAL(String(expected.substr(y, 1).data(), 1), String(text.data(), gsl::narrow<int>(text.size())));
+        }
+        for (size_t i = 0; i < _buffer->_storage.size(); i++)
+        {
+            VERIFY_ARE_EQUAL(gsl::narrow<SHORT>(i), _buffer->_storage[i].GetId());
+        }
+    };
+
+    Log::Comment(L"A region that doesn't wrap around the storage is moved in place.");
+    _buffer->ScrollRows(0, 2, 1);
+    VERIFY_ARE_EQUAL(SHORT{ 3 }, _buffer->GetFirstRowIndex());
+    verifyRows(L"201345");
+
+    const auto movedFire = *_buffer->GetTextDataAt({ 4, 2 });
+    VERIFY_ARE_EQUAL(String(fire), String(movedFire.data(), gsl::narrow<int>(movedFire.size())));
+
+    Log::Comment(L"A region that wraps around the storage still ends up in order.");
+    _buffer->ScrollRows(3, 2, -2);
+    verifyRows(L"234015");
+
+    const auto wrappedFire = *_buffer->GetTextDataAt({ 4, 4 });
+    VERIFY_ARE_EQUAL(String(fire), String(wrappedFire.data(), gsl::narrow<int>(wrappedFire.size())));
+}
+
+void TextBufferTests::SearchSessionFollowsBufferChanges()
+{
+    const COORD bufferSize{ 10, 5 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+    const auto everything = _buffer->GetSize();
+
+    VERIFY_IS_FALSE(_buffer->HasSearchSession());
+    VERIFY_ARE_EQUAL(0u, _buffer->GetSearchMatchCount());
+
+    _buffer->Write(OutputCellIterator(L"ab"), { 0, 0 });
+    _buffer->StartSearchSession(L"AB", true);
+    VERIFY_IS_TRUE(_buffer->HasSearchSession());
+    VERIFY_ARE_EQUAL(1u, _buffer->GetSearchMatchCount());
+
+    Log::Comment(L"A match written after the session started is found, even across the end of a row.");
+    _buffer->Write(OutputCellIterator(L"a"), { 9, 1 });
+    _buffer->Write(OutputCellIterator(L"b"), { 0, 2 });
+    VERIFY_ARE_EQUAL(2u, _buffer->GetSearchMatchCount());
+
+    auto highlights = _buffer->GetSearchHighlights(everything);
+    VERIFY_ARE_EQUAL(3u, highlights.size());
+    VERIFY_ARE_EQUAL(SMALL_RECT({ 0, 0, 1, 0 }), highlights.at(0));
+    VERIFY_ARE_EQUAL(SMALL_RECT({ 9, 1, 9, 1 }), highlights.at(1));
+    VERIFY_ARE_EQUAL(SMALL_RECT({ 0, 2, 0, 2 }), highlights.at(2));
+
+    Log::Comment(L"Only the part of a match in the area is highlighted.");
+    highlights = _buffer->GetSearchHighlights(Viewport::FromInclusive({ 0, 2, 9, 4 }));
+    VERIFY_ARE_EQUAL(1u, highlights.size());
+    VERIFY_ARE_EQUAL(SMALL_RECT({ 0, 2, 0, 2 }), highlights.at(0));
+
+    Log::Comment(L"Overwriting a match drops it.");
+    _buffer->Write(OutputCellIterator(L"x"), { 1, 0 });
+    VERIFY_ARE_EQUAL(1u, _buffer->GetSearchMatchCount());
+
+    Log::Comment(L"The matches move up with the rows when the circular buffer moves on.");
+    _buffer->Write(OutputCellIterator(L"ab"), { 3, 0 });
+    VERIFY_ARE_EQUAL(2u, _buffer->GetSearchMatchCount());
+    VERIFY_IS_TRUE(_buffer->IncrementCircularBuffer());
+    VERIFY_ARE_EQUAL(1u, _buffer->GetSearchMatchCount());
+    highlights = _buffer->GetSearchHighlights(everything);
+    VERIFY_ARE_EQUAL(2u, highlights.size());
+    VERIFY_ARE_EQUAL(SMALL_RECT({ 9, 0, 9, 0 }), highlights.at(0));
+    VERIFY_ARE_EQUAL(SMALL_RECT({ 0, 1, 0, 1 }), highlights.at(1));
+
+    Log::Comment(L"The row that came around to the bottom is searched again when it's written.");
+    _buffer->Write(OutputCellIterator(L"zzzzzzzzzAb"), { 0, 3 });
+    VERIFY_ARE_EQUAL(2u, _buffer->GetSearchMatchCount());
+    highlights = _buffer->GetSearchHighlights(Viewport::FromInclusive({ 0, 4, 9, 4 }));
+    VERIFY_ARE_EQUAL(1u, highlights.size());
+    VERIFY_ARE_EQUAL(SMALL_RECT({ 0, 4, 0, 4 }), highlights.at(0));
+
+    Log::Comment(L"Rows that are scrolled are searched again where they end up.");
+    _buffer->ScrollRows(0, 2, 2);
+    VERIFY_ARE_EQUAL(1u, _buffer->GetSearchMatchCount());
+    highlights = _buffer->GetSearchHighlights(everything);
+    VERIFY_ARE_EQUAL(2u, highlights.size());
+    VERIFY_ARE_EQUAL(SMALL_RECT({ 9, 2, 9, 2 }), highlights.at(0));
+    VERIFY_ARE_EQUAL(SMALL_RECT({ 0, 3, 0, 3 }), highlights.at(1));
+
+    Log::Comment(L"Resizing and resetting the buffer start the search over.");
+    VERIFY_SUCCEEDED(_buffer->ResizeTraditional({ 10, 6 }));
+    VERIFY_ARE_EQUAL(1u, _buffer->GetSearchMatchCount());
+
+    Log::Comment(L"A buffer that replaces this one when it's reflowed takes the session over.");
+    auto reflowed = std::make_unique<TextBuffer>(COORD{ 12, 6 }, attr, cursorSize, _renderTarget);
+    reflowed->Write(OutputCellIterator(L"ab ab"), { 0, 0 });
+    reflowed->TakeSearchSession(*_buffer);
+    VERIFY_IS_FALSE(_buffer->HasSearchSession());
+    VERIFY_IS_TRUE(reflowed->HasSearchSession());
+    VERIFY_ARE_EQUAL(2u, reflowed->GetSearchMatchCount());
+    _buffer->TakeSearchSession(*reflowed);
+    VERIFY_ARE_EQUAL(1u, _buffer->GetSearchMatchCount());
+
+    _buffer->Reset();
+    VERIFY_ARE_EQUAL(0u, _buffer->GetSearchMatchCount());
+
+    _buffer->Write(OutputCellIterator(L"ab"), { 0, 0 });
+    _buffer->StopSearchSession();
+    VERIFY_IS_FALSE(_buffer->HasSearchSession());
+    VERIFY_ARE_EQUAL(0u, _buffer->GetSearchMatchCount());
+    VERIFY_ARE_EQUAL(0u, _buffer->GetSearchHighlights(everything).size());
+}
+
+void TextBufferTests::SearchSessionStreamingPerformance()
+{
+    BEGIN_TEST_METHOD_PROPERTIES()
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD_PROPERTIES()
+
+    const COORD bufferSize{ 120, 9001 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+    const SHORT viewHeight = 100;
+    const auto view = Viewport::FromDimensions({ 0, gsl::narrow<SHORT>(bufferSize.Y - viewHeight) }, { bufferSize.X, viewHeight });
+
+    const std::wstring line = L"2019-05-01 12:00:00.000 INFO  request handled in 12ms, nothing to see here";
+    const std::wstring errorLine = L"2019-05-01 12:00:00.000 ERROR request failed: connection reset by peer";
+    constexpr size_t lineCount = 20000;
+    constexpr size_t linesPerFrame = 100;
+
+    // Stream lines into the bottom of a full buffer, the way a log being tailed
+    // scrolls, and ask for the highlights in view after every "frame" of output.
+    const auto stream = [&](const std::function<void()>& afterFrame) {
+        for (size_t i = 0; i < lineCount; ++i)
+        {
+            VERIFY_IS_TRUE(_buffer->IncrementCircularBuffer());
+            _buffer->Write(OutputCellIterator(i % 97 == 0 ? errorLine : line), { 0, bufferSize.Y - 1 });
+            if (i % linesPerFrame == linesPerFrame - 1)
+            {
+                afterFrame();
+            }
+        }
+    };
+
+    _buffer->StartSearchSession(L"error", true);
+    const auto sessionStart = std::chrono::steady_clock::now();
+    stream([&]() {
+        VERIFY_IS_FALSE(_buffer->GetSearchHighlights(view).empty());
+    });
+    const auto sessionElapsed = std::chrono::steady_clock::now() - sessionStart;
+    _buffer->StopSearchSession();
+
+    const TextBufferSearch search{ L"error", true };
+    const auto rescanStart = std::chrono::steady_clock::now();
+    stream([&]() {
+        VERIFY_IS_FALSE(search.FindAll(*_buffer, 0, bufferSize.Y).empty());
+    });
+    const auto rescanElapsed = std::chrono::steady_clock::now() - rescanStart;
+
+    Log::Comment(NoThrowString().Format(L"Streamed %zu lines: %lld ms keeping a search session, %lld ms searching the whole buffer every %zu lines",
+                                        lineCount,
+                                        std::chrono::duration_cast<std::chrono::milliseconds>(sessionElapsed).count(),
+                                        std::chrono::duration_cast<std::chrono::milliseconds>(rescanElapsed).count(),
+                                        linesPerFrame));
+}
@@ -95,7 +95,10 @@ class Microsoft::Console::Render::VtRendererTest
 
     TEST_METHOD(Xterm256TestInvalidate);
     TEST_METHOD(Xterm256TestColors);
+    TEST_METHOD(Xterm256TestMinimalColors);
+    TEST_METHOD(Xterm256TestColorByteSavings);
     TEST_METHOD(Xterm256TestCursor);
+    TEST_METHOD(Xterm256TestScrollRegion);
 
     TEST_METHOD(XtermTestInvalidate);
     TEST_METHOD(XtermTestColors);
@@ -428,8 +431,7 @@ void VtRendererTest::Xterm256TestColors()
         L"Begin by setting some test values - FG,BG = (1,2,3), (4,5,6) to start"
         L"These values were picked for ease of formatting raw COLORREF values."
     ));
-    qExpectedInput.push_back("\x1b[38;2;1;2;3m");
-    qExpectedInput.push_back("\x1b[48;2;5;6;7m");
+    qExpectedInput.push_back("\x1b[38;2;1;2;3;48;2;5;6;7m");
     VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(0x00030201, 0x00070605, 0, false, false));
 
     TestPaint(*engine, [&]()
@@ -517,6 +519,163 @@ void VtRendererTest::Xterm256TestColors()
     });
 }
 
+void VtRendererTest::Xterm256TestMinimalColors()
+{
+    wil::unique_hfile hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    std::unique_ptr<Xterm256Engine> engine = std::make_unique<Xterm256Engine>(std::move(hFile), p, SetUpViewport(), g_ColorTable, static_cast<WORD>(COLOR_TABLE_SIZE));
+    auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
+    engine->SetTestCallback(pfn);
+
+    // Verify the first paint emits a clear and go home
+    qExpectedInput.push_back("\x1b[2J");
+    VERIFY_IS_TRUE(engine->_firstPaint);
+    TestPaint(*engine, [&]() {
+        VERIFY_IS_FALSE(engine->_firstPaint);
+    });
+
+    qExpectedInput.push_back("\x1b[m");
+    VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(g_ColorTable[15], g_ColorTable[0], 0, false, false));
+
+    TestPaint(*engine, [&]()
+    {
+        Log::Comment(NoThrowString().Format(
+            L"----Colors from the xterm color cube use the 256 color table----"
+        ));
+        qExpectedInput.push_back("\x1b[38;5;196m");
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(RGB(255, 0, 0), g_ColorTable[0], 0, false, false));
+
+        qExpectedInput.push_back("\x1b[48;5;67m");
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(RGB(255, 0, 0), RGB(95, 135, 175), 0, false, false));
+
+        Log::Comment(NoThrowString().Format(
+            L"----Colors from the gray ramp use the 256 color table----"
+        ));
+        qExpectedInput.push_back("\x1b[38;5;244m");
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(RGB(128, 128, 128), RGB(95, 135, 175), 0, false, false));
+
+        Log::Comment(NoThrowString().Format(
+            L"----Bold, underline and both colors change in one sequence----"
+        ));
+        qExpectedInput.push_back("\x1b[1;4;32;48;2;1;2;3m");
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(g_ColorTable[2], RGB(1, 2, 3), COMMON_LVB_UNDERSCORE, true, false));
+
+        Log::Comment(NoThrowString().Format(
+            L"----Resetting is shorter than turning everything off one at a time----"
+        ));
+        qExpectedInput.push_back("\x1b[m");
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(g_ColorTable[15], g_ColorTable[0], 0, false, false));
+
+        Log::Comment(NoThrowString().Format(
+            L"----Resetting keeps the attributes that are still set----"
+        ));
+        qExpectedInput.push_back("\x1b[1;4;91m");
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(g_ColorTable[12], g_ColorTable[0], COMMON_LVB_UNDERSCORE, true, false));
+
+        qExpectedInput.push_back("\x1b[0;4m");
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(g_ColorTable[15], g_ColorTable[0], COMMON_LVB_UNDERSCORE, false, false));
+
+        Log::Comment(NoThrowString().Format(
+            L"----Nothing changed, nothing written----"
+        ));
+        qExpectedInput.push_back(EMPTY_CALLBACK_SENTINEL);
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(g_ColorTable[15], g_ColorTable[0], COMMON_LVB_UNDERSCORE, false, false));
+        WriteCallback(EMPTY_CALLBACK_SENTINEL, 1); // This will make sure nothing was written to the callback
+    });
+}
+
+void VtRendererTest::Xterm256TestColorByteSavings()
+{
+    Log::Comment(NoThrowString().Format(
+        L"Paint a corpus of colorful output and compare the bytes written against "
+        L"emitting every changed attribute as its own sequence, with true RGB colors."
+    ));
+
+    wil::unique_hfile hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    std::unique_ptr<Xterm256Engine> engine = std::make_unique<Xterm256Engine>(std::move(hFile), p, SetUpViewport(), g_ColorTable, static_cast<WORD>(COLOR_TABLE_SIZE));
+
+    size_t bytesWritten = 0;
+    engine->SetTestCallback([&](const char* const /*pch*/, size_t const cch) {
+        bytesWritten += cch;
+        return true;
+    });
+
+    struct Attr
+    {
+        COLORREF fg;
+        COLORREF bg;
+        WORD legacy;
+        bool bold;
+    };
+    std::vector<Attr> corpus;
+
+    const Attr defaults{ g_ColorTable[15], g_ColorTable[0], 0, false };
+
+    // `ls --color`: directories in bold blue, executables in green, links in cyan.
+    for (int i = 0; i < 64; i++)
+    {
+        corpus.push_back({ g_ColorTable[9], g_ColorTable[0], 0, true });
+        corpus.push_back(defaults);
+        corpus.push_back({ g_ColorTable[10], g_ColorTable[0], 0, false });
+        corpus.push_back(defaults);
+        corpus.push_back({ g_ColorTable[11], g_ColorTable[0], COMMON_LVB_UNDERSCORE, false });
+        corpus.push_back(defaults);
+    }
+
+    // A 256 color rainbow, as drawn by color test scripts and themed prompts.
+    for (BYTE r = 0; r < 6; r++)
+    {
+        for (BYTE g = 0; g < 6; g++)
+        {
+            for (BYTE b = 0; b < 6; b++)
+            {
+                const auto level = [](const BYTE l) -> BYTE { return l == 0 ? 0 : static_cast<BYTE>(55 + 40 * l); };
+                corpus.push_back({ defaults.fg, RGB(level(r), level(g), level(b)), 0, false });
+            }
+        }
+    }
+    for (BYTE i = 0; i < 24; i++)
+    {
+        const BYTE gray = static_cast<BYTE>(8 + 10 * i);
+        corpus.push_back({ RGB(gray, gray, gray), defaults.bg, 0, false });
+    }
+
+    // A true color gradient (a powerline prompt) that can't be compressed.
+    for (int i = 0; i < 64; i++)
+    {
+        corpus.push_back({ RGB(i, 64 + i, 128 + i), RGB(255 - i, 1, 2 * i + 1), 0, i % 2 == 0 });
+    }
+
+    // This is what we'd write if every change were its own sequence with a true RGB color.
+    const auto rgbLength = [](const COLORREF color) {
+        return std::to_string(GetRValue(color)).size() + std::to_string(GetGValue(color)).size() + std::to_string(GetBValue(color)).size() + 10; // \x1b[38;2;;;m
+    };
+    size_t naiveBytes = 0;
+    Attr last{ INVALID_COLOR, INVALID_COLOR, 0, false };
+    for (const auto& attr : corpus)
+    {
+        naiveBytes += attr.bold != last.bold ? (attr.bold ? 4 : 5) : 0;
+        naiveBytes += (attr.legacy != last.legacy) ? (attr.legacy ? 4 : 5) : 0;
+        naiveBytes += attr.fg != last.fg ? (attr.fg == defaults.fg ? 5 : rgbLength(attr.fg)) : 0;
+        naiveBytes += attr.bg != last.bg ? (attr.bg == defaults.bg ? 5 : rgbLength(attr.bg)) : 0;
+        last = attr;
+    }
+
+    for (const auto& attr : corpus)
+    {
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(attr.fg, attr.bg, attr.legacy, attr.bold, false));
+    }
+
+    Log::Comment(NoThrowString().Format(
+        L"%zu attribute changes: %zu bytes written, %zu bytes with one RGB sequence per attribute (%zu%% saved)",
+        corpus.size(),
+        bytesWritten,
+        naiveBytes,
+        100 - (bytesWritten * 100 / naiveBytes)
+    ));
+
+    VERIFY_IS_LESS_THAN(bytesWritten, naiveBytes);
+}
+
 void VtRendererTest::Xterm256TestCursor()
 {
     wil::unique_hfile hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
@@ -645,6 +804,103 @@ void VtRendererTest::Xterm256TestCursor()
     });
 }
 
+void VtRendererTest::Xterm256TestScrollRegion()
+{
+    wil::unique_hfile hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    std::unique_ptr<Xterm256Engine> engine = std::make_unique<Xterm256Engine>(std::move(hFile), p, SetUpViewport(), g_ColorTable, static_cast<WORD>(COLOR_TABLE_SIZE));
+    auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
+    engine->SetTestCallback(pfn);
+
+    // Verify the first paint emits a clear and go home
+    qExpectedInput.push_back("\x1b[2J");
+    VERIFY_IS_TRUE(engine->_firstPaint);
+    TestPaint(*engine, [&]() {
+        VERIFY_IS_FALSE(engine->_firstPaint);
+    });
+
+    Log::Comment(NoThrowString().Format(
+        L"Scrolling a full-width band up should only invalidate the uncovered line, and scroll the margins"
+    ));
+    SMALL_RECT region = { 0, 2, 80, 10 };
+    SMALL_RECT uncovered = { 0, 9, 80, 10 };
+    VERIFY_SUCCEEDED(engine->InvalidateScrollRegion(&region, -1));
+    VERIFY_SUCCEEDED(engine->Invalidate(&uncovered));
+    TestPaintXterm(*engine, [&]()
+    {
+        VERIFY_ARE_EQUAL(uncovered, engine->_invalidRect.ToExclusive());
+
+        qExpectedInput.push_back("\x1b[3;10r"); // Set the margins to the band
+        qExpectedInput.push_back("\x1b[S"); // Scroll up one line
+        qExpectedInput.push_back("\x1b[r"); // Reset the margins
+        VERIFY_SUCCEEDED(engine->ScrollFrame());
+        VERIFY_ARE_EQUAL(COORD({ 0, 0 }), engine->_lastText);
+    });
+
+    Log::Comment(NoThrowString().Format(
+        L"Consecutive scrolls of the same band in the same direction are sent as one"
+    ));
+    uncovered = { 0, 2, 80, 4 };
+    VERIFY_SUCCEEDED(engine->InvalidateScrollRegion(&region, 1));
+    VERIFY_SUCCEEDED(engine->InvalidateScrollRegion(&region, 1));
+    VERIFY_SUCCEEDED(engine->Invalidate(&uncovered));
+    TestPaintXterm(*engine, [&]()
+    {
+        VERIFY_ARE_EQUAL(uncovered, engine->_invalidRect.ToExclusive());
+
+        qExpectedInput.push_back("\x1b[3;10r");
+        qExpectedInput.push_back("\x1b[2T"); // Scroll down two lines
+        qExpectedInput.push_back("\x1b[r");
+        VERIFY_SUCCEEDED(engine->ScrollFrame());
+    });
+
+    Log::Comment(NoThrowString().Format(
+        L"Anything already invalid within the band moves with the text"
+    ));
+    SMALL_RECT pending = { 5, 4, 6, 5 };
+    VERIFY_SUCCEEDED(engine->Invalidate(&pending));
+    VERIFY_SUCCEEDED(engine->InvalidateScrollRegion(&region, -1));
+    TestPaintXterm(*engine, [&]()
+    {
+        const SMALL_RECT expected = { 5, 3, 6, 5 };
+        VERIFY_ARE_EQUAL(expected, engine->_invalidRect.ToExclusive());
+
+        qExpectedInput.push_back("\x1b[3;10r");
+        qExpectedInput.push_back("\x1b[S");
+        qExpectedInput.push_back("\x1b[r");
+        VERIFY_SUCCEEDED(engine->ScrollFrame());
+    });
+
+    Log::Comment(NoThrowString().Format(
+        L"A band that isn't the full width of the viewport is just repainted"
+    ));
+    region = { 0, 2, 40, 10 };
+    VERIFY_SUCCEEDED(engine->InvalidateScrollRegion(&region, -1));
+    TestPaintXterm(*engine, [&]()
+    {
+        VERIFY_ARE_EQUAL(region, engine->_invalidRect.ToExclusive());
+        VERIFY_IS_TRUE(engine->_regionScrolls.empty());
+
+        VERIFY_SUCCEEDED(engine->ScrollFrame());
+    });
+
+    Log::Comment(NoThrowString().Format(
+        L"Scrolling the whole viewport in the same frame repaints the band instead"
+    ));
+    region = { 0, 2, 80, 10 };
+    VERIFY_SUCCEEDED(engine->InvalidateScrollRegion(&region, -1));
+    COORD scrollDelta = { 0, 1 };
+    VERIFY_SUCCEEDED(engine->InvalidateScroll(&scrollDelta));
+    TestPaintXterm(*engine, [&]()
+    {
+        VERIFY_IS_TRUE(engine->_regionScrolls.empty());
+        const SMALL_RECT expected = { 0, 0, 80, 11 };
+        VERIFY_ARE_EQUAL(expected, engine->_invalidRect.ToExclusive());
+
+        qExpectedInput.push_back("\x1b[L"); // insert a line
+        VERIFY_SUCCEEDED(engine->ScrollFrame());
+    });
+}
+
 void VtRendererTest::XtermTestInvalidate()
 {
     wil::unique_hfile hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
@@ -15,6 +15,21 @@
 
 #pragma hdrstop
 
+// Routine Description:
+// - Stops the search session the dialog started. It's on the buffer that was
+//   active when it was started, which may not be the active one any longer,
+//   so it's stopped on every buffer, and on their alternate buffers.
+// Note:
+// - The console lock must be held when calling this routine.
+static void StopSearchSessions(CONSOLE_INFORMATION& gci)
+{
+    for (SCREEN_INFORMATION* pScreenInfo = gci.ScreenBuffers; pScreenInfo != nullptr; pScreenInfo = pScreenInfo->Next)
+    {
+        pScreenInfo->GetTextBuffer().StopSearchSession();
+        pScreenInfo->GetActiveBuffer().GetTextBuffer().StopSearchSession();
+    }
+}
+
 INT_PTR FindDialogProc(HWND hWnd, UINT Message, WPARAM wParam, LPARAM lParam)
 {
     CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
@@ -42,6 +57,7 @@ INT_PTR FindDialogProc(HWND hWnd, UINT Message, WPARAM wParam, LPARAM lParam)
                     }
                     bool const IgnoreCase = IsDlgButtonChecked(hWnd, ID_CONSOLE_FINDCASE) == 0;
                     bool const Reverse = IsDlgButtonChecked(hWnd, ID_CONSOLE_FINDDOWN) == 0;
+                    bool const Regex = IsDlgButtonChecked(hWnd, ID_CONSOLE_FINDREGEX) != 0;
                     fFindSearchUp = !!Reverse;
                     SCREEN_INFORMATION& ScreenInfo = gci.GetActiveOutputBuffer();
 
@@ -50,15 +66,36 @@ INT_PTR FindDialogProc(HWND hWnd, UINT Message, WPARAM wParam, LPARAM lParam)
                     LockConsole();
                     auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
 
-                    Search search(ScreenInfo,
-                                  wstr,
-                                  Reverse ? Search::Direction::Backward : Search::Direction::Forward,
-                                  IgnoreCase ? Search::Sensitivity::CaseInsensitive : Search::Sensitivity::CaseSensitive);
+                    // Highlight every match while the dialog is open, including
+                    // the ones in output that arrives after this. The highlights
+                    // only know how to look for plain text.
+                    StopSearchSessions(gci);
+                    if (!Regex)
+                    {
+                        ScreenInfo.GetTextBuffer().StartSearchSession(wstr, IgnoreCase);
+                    }
+
+                    std::optional<Search> search;
+                    try
+                    {
+                        search.emplace(ScreenInfo,
+                                       wstr,
+                                       Reverse ? Search::Direction::Backward : Search::Direction::Forward,
+                                       IgnoreCase ? Search::Sensitivity::CaseInsensitive : Search::Sensitivity::CaseSensitive,
+                                       Regex ? Search::Syntax::RegularExpression : Search::Syntax::Literal);
+                    }
+                    catch (...)
+                    {
+                        // The pattern isn't one we can search for.
+                        LOG_CAUGHT_EXCEPTION();
+                        ScreenInfo.SendNotifyBeep();
+                        break;
+                    }
 
-                    if (search.FindNext())
+                    if (search->FindNext())
                     {
                         Telemetry::Instance().LogFindDialogNextClicked(StringLength, (Reverse != 0), (IgnoreCase == 0));
-                        search.Select();
+                        search->Select();
                         return TRUE;
                     }
                     else
@@ -69,9 +106,18 @@ INT_PTR FindDialogProc(HWND hWnd, UINT Message, WPARAM wParam, LPARAM lParam)
                     break;
                 }
                 case IDCANCEL:
+                {
                     Telemetry::Instance().FindDialogClosed();
+
+                    {
+                        LockConsole();
+                        auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+                        StopSearchSessions(gci);
+                    }
+
                     EndDialog(hWnd, 0);
                     return TRUE;
+                }
             }
             break;
         }
@@ -37,3 +37,32 @@ HRESULT RenderEngineBase::UpdateTitle(const std::wstring& newTitle) noexcept
     }
     return hr;
 }
+
+// Method Description:
+// - Notifies us that the contents of a region of the screen have moved
+//      vertically by the given number of rows, and that the rows uncovered by
+//      the move will be invalidated separately.
+// - By default, engines have no cheaper way of representing this than to
+//      redraw the whole region.
+// Arguments:
+// - psrRegion - The region (relative to the viewport, exclusive) that scrolled.
+// - sDelta - The number of rows the contents moved. Negative is up.
+// Return Value:
+// - S_OK, else an appropriate HRESULT for failing to invalidate.
+[[nodiscard]]
+HRESULT RenderEngineBase::InvalidateScrollRegion(const SMALL_RECT* const psrRegion, const short /*sDelta*/) noexcept
+{
+    return Invalidate(psrRegion);
+}
+
+// Method Description:
+// - Gets the lock that serializes a frame with calls made on this engine from
+//      outside of the renderer.
+// Arguments:
+// - <none>
+// Return Value:
+// - The engine's lock.
+std::recursive_mutex& RenderEngineBase::GetEngineLock() noexcept
+{
+    return _engineLock;
+}
@@ -0,0 +1,67 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- RenderFrame.hpp
+
+Abstract:
+- This is an immutable description of everything a render engine needs to paint one frame.
+- It is captured once from the console data structures, so that the engines can then paint
+  it concurrently with each other without any of them touching those structures.
+--*/
+
+#pragma once
+
+#include "../inc/IRenderEngine.hpp"
+#include "../../buffer/out/TextAttribute.hpp"
+
+namespace Microsoft::Console::Render
+{
+    struct RenderFrame final
+    {
+        // One drawing cluster. The text lives in RenderFrame::text at [offset, offset + length).
+        struct Glyph
+        {
+            size_t offset;
+            size_t length;
+            size_t columns;
+        };
+
+        // A horizontal run of glyphs sharing the same attributes, ready to be handed to PaintBufferLine.
+        struct Run
+        {
+            TextAttribute attr;
+            COLORREF foreground;
+            COLORREF background;
+            COORD target;
+            size_t columns;
+            size_t firstGlyph;
+            size_t glyphCount;
+        };
+
+        // The dirty region (in screen character coordinates, inclusive) this frame was captured for.
+        SMALL_RECT dirty;
+
+        TextAttribute defaultAttr;
+        COLORREF defaultForeground;
+        COLORREF defaultBackground;
+
+        bool isGridLineDrawingAllowed;
+
+        std::wstring text;
+        std::vector<Glyph> glyphs;
+
+        std::vector<Run> bufferRuns;
+        std::vector<Run> overlayRuns;
+
+        std::vector<SMALL_RECT> selection;
+
+        // The matches of the text buffer's search session, less the ones the selection covers.
+        std::vector<SMALL_RECT> searchHighlights;
+
+        std::optional<IRenderEngine::CursorOptions> cursor;
+
+        std::wstring title;
+    };
+}
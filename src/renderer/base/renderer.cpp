@@ -63,81 +63,325 @@ HRESULT Renderer::PaintFrame()
         return S_FALSE;
     }
 
-    for (IRenderEngine* const pEngine : _rgpEngines)
-    {
-        LOG_IF_FAILED(_PaintFrameForEngine(pEngine));
-    }
-
-    return S_OK;
+    return _PaintFrameForEngines(_GetEngines());
 }
 
-
 [[nodiscard]]
 HRESULT Renderer::_PaintFrameForEngine(_In_ IRenderEngine* const pEngine)
 {
     FAIL_FAST_IF_NULL(pEngine); // This is a programming error. Fail fast.
 
+    return _PaintFrameForEngines({ pEngine });
+}
+
+// Routine Description:
+// - Paints one frame to each of the given engines.
+// - The frame description is captured once out of the console data
+//      structures, and the engines then paint from that capture, each on its
+//      own worker, so the frame time is that of the slowest engine rather than
+//      the sum of all of them.
+// - The console lock is only held while the frame is captured. Each engine's
+//      own lock is held until it has presented, which keeps the calls made on
+//      it directly (the VT engine by VtIo, and every engine by glyph width and
+//      font queries) out of a frame in flight.
+// Arguments:
+// - engines - The engines to paint.
+// Return Value:
+// - S_OK. Failures of individual engines are logged.
+[[nodiscard]]
+HRESULT Renderer::_PaintFrameForEngines(const std::vector<IRenderEngine*>& engines)
+{
+    if (engines.empty())
+    {
+        return S_OK;
+    }
+
+    static auto& s_arrivalToPaint = Metrics::MetricsRegistry::Instance().GetHistogram(Metrics::Names::ArrivalToPaintMicroseconds);
+    Metrics::UnpaintedOutput().End(s_arrivalToPaint);
+
     _pData->LockConsole();
     auto unlock = wil::scope_exit([&]()
     {
         _pData->UnlockConsole();
     });
 
+    std::lock_guard<std::recursive_mutex> frameLock(_frameLock);
+
     // Last chance check if anything scrolled without an explicit invalidate notification since the last frame.
     _CheckViewportAndScroll();
 
-    // Try to start painting a frame
-    HRESULT const hr = pEngine->StartPaint();
-    RETURN_IF_FAILED(hr);
+    // While we're painting, the engines belong to us. Invalidations that
+    //      arrive in the meantime are folded together and applied when we're
+    //      done, before the engine locks are released.
+    {
+        std::lock_guard<std::mutex> lock(_invalidationLock);
+        _fPainting = true;
+    }
+    std::vector<std::unique_lock<std::recursive_mutex>> engineLocks;
+    auto stopPainting = wil::scope_exit([&]()
+    {
+        _FlushPendingInvalidations();
+    });
+
+    // Start each engine's frame and capture what it needs to paint. Engines
+    //      with identical dirty regions share a single capture.
+    std::vector<std::pair<IRenderEngine*, std::shared_ptr<const RenderFrame>>> work;
+    engineLocks.reserve(engines.size());
+    work.reserve(engines.size());
+    for (IRenderEngine* const pEngine : engines)
+    {
+        engineLocks.emplace_back(pEngine->GetEngineLock());
+
+        // Try to start painting a frame
+        HRESULT const hr = pEngine->StartPaint();
+        if (FAILED(hr))
+        {
+            LOG_HR(hr);
+            continue;
+        }
+
+        // Skip this engine if there's nothing to paint.
+        // The renderer itself tracks if there's something to do with the title, the
+        //      engine won't know that.
+        if (S_FALSE == hr)
+        {
+            continue;
+        }
+
+        try
+        {
+            const SMALL_RECT dirty = pEngine->GetDirtyRectInChars();
+            const auto existing = std::find_if(work.cbegin(), work.cend(), [&](const auto& item) {
+                return item.second->dirty == dirty;
+            });
 
-    // Return early if there's nothing to paint.
-    // The renderer itself tracks if there's something to do with the title, the
-    //      engine won't know that.
-    if (S_FALSE == hr)
+            work.emplace_back(pEngine, existing != work.cend() ? existing->second : _CaptureFrame(dirty));
+        }
+        catch (...)
+        {
+            LOG_CAUGHT_EXCEPTION();
+            LOG_IF_FAILED(pEngine->EndPaint());
+        }
+    }
+
+    // Everything the engines need is in the capture now. Let the console go
+    //      so output can carry on while they paint.
+    unlock.reset();
+
+    if (work.empty())
     {
         return S_OK;
     }
 
-    auto endPaint = wil::scope_exit([&]()
+    // Hand every engine but the first to a worker, and paint the first one
+    //      right here. If we couldn't start enough workers, the rest are
+    //      painted here too.
+    try
     {
-        LOG_IF_FAILED(pEngine->EndPaint());
-    });
+        while (_workers.size() < work.size() - 1)
+        {
+            _workers.emplace_back(std::make_unique<_PaintWorker>(*this));
+        }
+    }
+    CATCH_LOG();
 
-    // A. Prep Colors
-    RETURN_IF_FAILED(_UpdateDrawingBrushes(pEngine, _pData->GetDefaultBrushColors(), true));
+    const size_t workerCount = std::min(_workers.size(), work.size() - 1);
+    for (size_t i = 0; i < workerCount; i++)
+    {
+        const auto& item = work.at(i + 1);
+        _workers.at(i)->Start(item.first, item.second);
+    }
 
-    // B. Perform Scroll Operations
-    RETURN_IF_FAILED(_PerformScrolling(pEngine));
+    for (size_t i = workerCount + 1; i < work.size(); i++)
+    {
+        const auto& item = work.at(i);
+        LOG_IF_FAILED(_PaintFrameFromCapture(item.first, *item.second));
+    }
 
-    // 1. Paint Background
-    RETURN_IF_FAILED(_PaintBackground(pEngine));
+    LOG_IF_FAILED(_PaintFrameFromCapture(work.front().first, *work.front().second));
 
-    // 2. Paint Rows of Text
-    _PaintBufferOutput(pEngine);
+    for (size_t i = 0; i < workerCount; i++)
+    {
+        LOG_IF_FAILED(_workers.at(i)->Wait());
+    }
 
-    // 3. Paint overlays that reside above the text buffer
-    _PaintOverlays(pEngine);
+    return S_OK;
+}
 
-    // 4. Paint Selection
-    _PaintSelection(pEngine);
+// Routine Description:
+// - Starts a worker thread that waits to be handed frames to paint.
+// Arguments:
+// - renderer - The renderer to paint the frames with.
+// Return Value:
+// - An instance of a paint worker.
+// NOTE: CAN THROW IF THE THREAD CAN'T BE CREATED.
+Renderer::_PaintWorker::_PaintWorker(Renderer& renderer) :
+    _renderer{ renderer },
+    _thread{ [this]() { _Run(); } }
+{
+}
 
-    // 5. Paint Cursor
-    _PaintCursor(pEngine);
+// Routine Description:
+// - Stops the worker thread and waits for it to exit.
+Renderer::_PaintWorker::~_PaintWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _exiting = true;
+    }
+    _wake.notify_all();
+    _thread.join();
+}
 
-    // 6. Paint window title
-    RETURN_IF_FAILED(_PaintTitle(pEngine));
+// Routine Description:
+// - Hands the worker a captured frame to paint. The worker must be idle.
+// Arguments:
+// - pEngine - The engine to paint. It must have already started its frame.
+// - frame - The captured description of the frame.
+// Return Value:
+// - <none>
+void Renderer::_PaintWorker::Start(_In_ IRenderEngine* const pEngine, std::shared_ptr<const RenderFrame> frame) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _pEngine = pEngine;
+        _frame = std::move(frame);
+        _busy = true;
+    }
+    _wake.notify_all();
+}
 
-    // Force scope exit end paint to finish up collecting information and possibly painting
-    endPaint.reset();
+// Routine Description:
+// - Waits for the worker to finish painting the frame it was last handed.
+// Arguments:
+// - <none>
+// Return Value:
+// - The result of painting the frame.
+[[nodiscard]]
+HRESULT Renderer::_PaintWorker::Wait() noexcept
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    _wake.wait(lock, [this]() { return !_busy; });
+    _frame.reset();
+    return _hr;
+}
 
-    // Force scope exit unlock to let go of global lock so other threads can run
-    unlock.reset();
+// Routine Description:
+// - The body of the worker thread. Paints each frame it's handed until the
+//      worker is destroyed.
+void Renderer::_PaintWorker::_Run() noexcept
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    for (;;)
+    {
+        _wake.wait(lock, [this]() { return _busy || _exiting; });
+        if (_exiting)
+        {
+            return;
+        }
 
-    // Trigger out-of-lock presentation for renderers that can support it
-    RETURN_IF_FAILED(pEngine->Present());
+        IRenderEngine* const pEngine = _pEngine;
+        const std::shared_ptr<const RenderFrame> frame = _frame;
 
-    // As we leave the scope, EndPaint will be called (declared above)
-    return S_OK;
+        lock.unlock();
+        const HRESULT hr = _renderer._PaintFrameFromCapture(pEngine, *frame);
+        lock.lock();
+
+        _hr = hr;
+        _busy = false;
+        _wake.notify_all();
+    }
+}
+
+// Routine Description:
+// - Paints a previously captured frame to the given engine. The engine must
+//      have already successfully started its frame with StartPaint.
+// - This does not touch the console data structures, so it can run on any
+//      thread and without the console lock.
+// Arguments:
+// - pEngine - The engine to paint.
+// - frame - The captured description of the frame.
+// Return Value:
+// - S_OK or the failure from the engine.
+[[nodiscard]]
+HRESULT Renderer::_PaintFrameFromCapture(_In_ IRenderEngine* const pEngine, const RenderFrame& frame) noexcept
+{
+    try
+    {
+        std::optional<Metrics::ScopedLatency> measure;
+        if (auto* const paintTime = _GetPaintTime(pEngine))
+        {
+            measure.emplace(*paintTime);
+        }
+
+        auto endPaint = wil::scope_exit([&]()
+        {
+            LOG_IF_FAILED(pEngine->EndPaint());
+        });
+
+        // A. Prep Colors
+        RETURN_IF_FAILED(_UpdateDrawingBrushes(pEngine, frame.defaultAttr, frame.defaultForeground, frame.defaultBackground, true));
+
+        // B. Perform Scroll Operations
+        RETURN_IF_FAILED(_PerformScrolling(pEngine));
+
+        // 1. Paint Background
+        RETURN_IF_FAILED(_PaintBackground(pEngine));
+
+        // 2. Paint Rows of Text
+        _PaintRuns(pEngine, frame, frame.bufferRuns);
+
+        // 3. Paint overlays that reside above the text buffer
+        _PaintRuns(pEngine, frame, frame.overlayRuns);
+
+        // 4. Paint Selection (and the search highlights under it)
+        _PaintSelection(pEngine, frame);
+
+        // 5. Paint Cursor
+        _PaintCursor(pEngine, frame);
+
+        // 6. Paint window title
+        RETURN_IF_FAILED(_PaintTitle(pEngine, frame));
+
+        // Force scope exit end paint to finish up collecting information and possibly painting
+        endPaint.reset();
+
+        // Trigger presentation for renderers that can support it
+        RETURN_IF_FAILED(pEngine->Present());
+
+        return S_OK;
+    }
+    CATCH_RETURN();
+}
+
+// Routine Description:
+// - Captures everything needed to paint the given dirty region out of the
+//      console data structures. Must be called with the console lock held.
+// Arguments:
+// - dirty - The region of the screen (in characters, inclusive) that needs to be painted.
+// Return Value:
+// - The immutable description of the frame.
+std::shared_ptr<const RenderFrame> Renderer::_CaptureFrame(const SMALL_RECT dirty)
+{
+    auto frame = std::make_shared<RenderFrame>();
+
+    frame->dirty = dirty;
+
+    frame->defaultAttr = _pData->GetDefaultBrushColors();
+    frame->defaultForeground = _pData->GetForegroundColor(frame->defaultAttr);
+    frame->defaultBackground = _pData->GetBackgroundColor(frame->defaultAttr);
+
+    frame->isGridLineDrawingAllowed = _pData->IsGridLineDrawingAllowed();
+
+    _CaptureBufferOutput(*frame);
+    _CaptureOverlays(*frame);
+
+    frame->selection = _GetSelectionRects();
+    frame->searchHighlights = _GetSearchHighlightRects(frame->selection);
+    frame->cursor = _CaptureCursor();
+    frame->title = _pData->GetConsoleTitle();
+
+    return frame;
 }
 
 void Renderer::_NotifyPaintFrame()
@@ -146,6 +390,19 @@ void Renderer::_NotifyPaintFrame()
     _pThread->NotifyPaint();
 }
 
+// Routine Description:
+// - Notifies the thread that a small, input-driven change (like a cursor move
+//      or the echo of a single keystroke) is ready to be painted. The thread
+//      will try to get it on the screen without waiting for the frame limit.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_NotifyPaintFrameLowLatency()
+{
+    _pThread->NotifyPaintLowLatency();
+}
+
 // Routine Description:
 // - Called when the system has requested we redraw a portion of the console.
 // Arguments:
@@ -154,8 +411,11 @@ void Renderer::_NotifyPaintFrame()
 // - <none>
 void Renderer::TriggerSystemRedraw(const RECT* const prcDirtyClient)
 {
-    std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
-        LOG_IF_FAILED(pEngine->InvalidateSystem(prcDirtyClient));
+    const RECT rcDirtyClient = *prcDirtyClient;
+    _InvalidateEngines([&](IRenderEngine* const pEngine) {
+        LOG_IF_FAILED(pEngine->InvalidateSystem(&rcDirtyClient));
+    }, [&](_PendingInvalidations& pending) {
+        pending.AddSystem(rcDirtyClient);
     });
 
     _NotifyPaintFrame();
@@ -175,11 +435,21 @@ void Renderer::TriggerRedraw(const Viewport& region)
     if (view.TrimToViewport(&srUpdateRegion))
     {
         view.ConvertToOrigin(&srUpdateRegion);
-        std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+        _InvalidateEngines([&](IRenderEngine* const pEngine) {
             LOG_IF_FAILED(pEngine->Invalidate(&srUpdateRegion));
+        }, [&](_PendingInvalidations& pending) {
+            pending.AddRegion(srUpdateRegion);
         });
 
-        _NotifyPaintFrame();
+        // A change confined to a single row is most likely echo. Let it jump the frame limit.
+        if (srUpdateRegion.Bottom - srUpdateRegion.Top <= 1)
+        {
+            _NotifyPaintFrameLowLatency();
+        }
+        else
+        {
+            _NotifyPaintFrame();
+        }
     }
 }
 
@@ -211,19 +481,22 @@ void Renderer::TriggerRedrawCursor(const COORD* const pcoord)
     if (view.IsInBounds(updateCoord))
     {
         view.ConvertToOrigin(&updateCoord);
-        for (IRenderEngine* pEngine : _rgpEngines)
-        {
-            LOG_IF_FAILED(pEngine->InvalidateCursor(&updateCoord));
+        const bool fIsDoubleWidth = _pData->IsCursorDoubleWidth();
+        _InvalidateEngines([&](IRenderEngine* const pEngine) {
+            COORD coord = updateCoord;
+            LOG_IF_FAILED(pEngine->InvalidateCursor(&coord));
 
             // Double-wide cursors need to invalidate the right half as well.
-            if (_pData->IsCursorDoubleWidth())
+            if (fIsDoubleWidth)
             {
-                updateCoord.X++;
-                LOG_IF_FAILED(pEngine->InvalidateCursor(&updateCoord));
+                coord.X++;
+                LOG_IF_FAILED(pEngine->InvalidateCursor(&coord));
             }
-        }
+        }, [&](_PendingInvalidations& pending) {
+            pending.AddCursor(updateCoord, fIsDoubleWidth);
+        });
 
-        _NotifyPaintFrame();
+        _NotifyPaintFrameLowLatency();
     }
 }
 
@@ -236,8 +509,11 @@ void Renderer::TriggerRedrawCursor(const COORD* const pcoord)
 // - <none>
 void Renderer::TriggerRedrawAll()
 {
-    std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+    _InvalidateEngines([](IRenderEngine* const pEngine) {
         LOG_IF_FAILED(pEngine->InvalidateAll());
+    }, [](_PendingInvalidations& pending) {
+        pending.all = true;
+        pending.any = true;
     });
 
     _NotifyPaintFrame();
@@ -256,10 +532,14 @@ void Renderer::TriggerTeardown()
     _pThread->WaitForPaintCompletionAndDisable(INFINITE);
 
     // Then walk through and do one final paint on the caller's thread.
-    for (IRenderEngine* const pEngine : _rgpEngines)
+    for (IRenderEngine* const pEngine : _GetEngines())
     {
         bool fEngineRequestsRepaint = false;
-        HRESULT hr = pEngine->PrepareForTeardown(&fEngineRequestsRepaint);
+        HRESULT hr = S_OK;
+        {
+            std::lock_guard<std::recursive_mutex> engineLock(pEngine->GetEngineLock());
+            hr = pEngine->PrepareForTeardown(&fEngineRequestsRepaint);
+        }
         LOG_IF_FAILED(hr);
 
         if (SUCCEEDED(hr) && fEngineRequestsRepaint)
@@ -282,9 +562,19 @@ void Renderer::TriggerSelection()
         // Get selection rectangles
         const auto rects = _GetSelectionRects();
 
-        std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+        _InvalidateEngines([&](IRenderEngine* const pEngine) {
             LOG_IF_FAILED(pEngine->InvalidateSelection(_previousSelection));
             LOG_IF_FAILED(pEngine->InvalidateSelection(rects));
+        }, [&](_PendingInvalidations& pending) {
+            // Engines invalidate selection rectangles like any other region.
+            for (const auto& rect : _previousSelection)
+            {
+                pending.AddRegion(rect);
+            }
+            for (const auto& rect : rects)
+            {
+                pending.AddRegion(rect);
+            }
         });
 
         _previousSelection = rects;
@@ -302,20 +592,38 @@ void Renderer::TriggerSelection()
 // - True if something changed and we scrolled. False otherwise.
 bool Renderer::_CheckViewportAndScroll()
 {
-    SMALL_RECT const srOldViewport = _srViewportPrevious;
     SMALL_RECT const srNewViewport = _pData->GetViewport().ToInclusive();
+    COORD const coordDelta = _UpdateViewportPrevious(srNewViewport);
+
+    _InvalidateEngines([&](IRenderEngine* const pEngine) {
+        COORD delta = coordDelta;
+        LOG_IF_FAILED(pEngine->UpdateViewport(srNewViewport));
+        LOG_IF_FAILED(pEngine->InvalidateScroll(&delta));
+    }, [&](_PendingInvalidations& pending) {
+        pending.viewport = srNewViewport;
+        pending.AddScroll(coordDelta);
+    });
+
+    return coordDelta.X != 0 || coordDelta.Y != 0;
+}
+
+// Routine Description:
+// - Records the new viewport and returns how far it moved from the previous one.
+// Arguments:
+// - srNewViewport - The current viewport.
+// Return Value:
+// - The distance from the previous viewport to the new one.
+COORD Renderer::_UpdateViewportPrevious(const SMALL_RECT srNewViewport) noexcept
+{
+    SMALL_RECT const srOldViewport = _srViewportPrevious;
 
     COORD coordDelta;
     coordDelta.X = srOldViewport.Left - srNewViewport.Left;
     coordDelta.Y = srOldViewport.Top - srNewViewport.Top;
 
-    std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
-        LOG_IF_FAILED(pEngine->UpdateViewport(srNewViewport));
-        LOG_IF_FAILED(pEngine->InvalidateScroll(&coordDelta));
-    });
     _srViewportPrevious = srNewViewport;
 
-    return coordDelta.X != 0 || coordDelta.Y != 0;
+    return coordDelta;
 }
 
 // Routine Description:
@@ -344,8 +652,47 @@ void Renderer::TriggerScroll()
 // - <none>
 void Renderer::TriggerScroll(const COORD* const pcoordDelta)
 {
-    std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
-        LOG_IF_FAILED(pEngine->InvalidateScroll(pcoordDelta));
+    const COORD coordDelta = *pcoordDelta;
+    _InvalidateEngines([&](IRenderEngine* const pEngine) {
+        COORD delta = coordDelta;
+        LOG_IF_FAILED(pEngine->InvalidateScroll(&delta));
+    }, [&](_PendingInvalidations& pending) {
+        pending.AddScroll(coordDelta);
+    });
+
+    _NotifyPaintFrame();
+}
+
+// Routine Description:
+// - Called when the contents of a region of the buffer have been moved
+//      vertically, as by a scroll within the DECSTBM margins.
+// - The caller is responsible for separately redrawing the rows uncovered by
+//      the move.
+// - Engines that can move the region on their target (like the VT engine) can
+//      then avoid repainting it.
+// Arguments:
+// - region - The buffer region whose contents moved.
+// - sDelta - The number of rows the contents moved. Negative is up.
+// Return Value:
+// - <none>
+void Renderer::TriggerScrollRegion(const Viewport& region, const short sDelta)
+{
+    const Viewport view = _pData->GetViewport();
+
+    // If any of the region is outside the viewport, the contents that moved
+    //      into view were never painted. Just redraw it.
+    if (!view.IsInBounds(region))
+    {
+        TriggerRedraw(region);
+        return;
+    }
+
+    const SMALL_RECT srRegion = view.ConvertToOrigin(region).ToExclusive();
+    _InvalidateEngines([&](IRenderEngine* const pEngine) {
+        LOG_IF_FAILED(pEngine->InvalidateScrollRegion(&srRegion, sDelta));
+    }, [&](_PendingInvalidations& pending) {
+        // Repainting the whole region is always correct, if not as cheap.
+        pending.AddRegion(srRegion);
     });
 
     _NotifyPaintFrame();
@@ -360,17 +707,27 @@ void Renderer::TriggerScroll(const COORD* const pcoordDelta)
 // - <none>
 void Renderer::TriggerCircling()
 {
-    for (IRenderEngine* const pEngine : _rgpEngines)
+    std::vector<IRenderEngine*> repaint;
+    for (IRenderEngine* const pEngine : _GetEngines())
     {
         bool fEngineRequestsRepaint = false;
-        HRESULT hr = pEngine->InvalidateCircling(&fEngineRequestsRepaint);
+        HRESULT hr = S_OK;
+        {
+            std::lock_guard<std::recursive_mutex> engineLock(pEngine->GetEngineLock());
+            hr = pEngine->InvalidateCircling(&fEngineRequestsRepaint);
+        }
         LOG_IF_FAILED(hr);
 
         if (SUCCEEDED(hr) && fEngineRequestsRepaint)
         {
-            LOG_IF_FAILED(_PaintFrameForEngine(pEngine));
+            repaint.push_back(pEngine);
         }
     }
+
+    if (!repaint.empty())
+    {
+        LOG_IF_FAILED(_PaintFrameForEngines(repaint));
+    }
 }
 
 // Routine Description:
@@ -383,10 +740,12 @@ void Renderer::TriggerCircling()
 void Renderer::TriggerTitleChange()
 {
     const std::wstring newTitle = _pData->GetConsoleTitle();
-    for (IRenderEngine* const pEngine : _rgpEngines)
-    {
+    _InvalidateEngines([&](IRenderEngine* const pEngine) {
         LOG_IF_FAILED(pEngine->InvalidateTitle(newTitle));
-    }
+    }, [&](_PendingInvalidations& pending) {
+        pending.title = newTitle;
+        pending.any = true;
+    });
     _NotifyPaintFrame();
 }
 
@@ -394,12 +753,12 @@ void Renderer::TriggerTitleChange()
 // - Update the title for a particular engine.
 // Arguments:
 // - pEngine: the engine to update the title for.
+// - frame: the captured frame holding the title.
 // Return Value:
 // - the HRESULT of the underlying engine's UpdateTitle call.
-HRESULT Renderer::_PaintTitle(IRenderEngine* const pEngine)
+HRESULT Renderer::_PaintTitle(IRenderEngine* const pEngine, const RenderFrame& frame)
 {
-    const std::wstring newTitle = _pData->GetConsoleTitle();
-    return pEngine->UpdateTitle(newTitle);
+    return pEngine->UpdateTitle(frame.title);
 }
 
 // Routine Description:
@@ -412,10 +771,12 @@ HRESULT Renderer::_PaintTitle(IRenderEngine* const pEngine)
 // - <none>
 void Renderer::TriggerFontChange(const int iDpi, const FontInfoDesired& FontInfoDesired, _Out_ FontInfo& FontInfo)
 {
-    std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+    for (IRenderEngine* const pEngine : _GetEngines())
+    {
+        std::lock_guard<std::recursive_mutex> engineLock(pEngine->GetEngineLock());
         LOG_IF_FAILED(pEngine->UpdateDpi(iDpi));
         LOG_IF_FAILED(pEngine->UpdateFont(FontInfoDesired, FontInfo));
-    });
+    }
 
     _NotifyPaintFrame();
 }
@@ -436,7 +797,8 @@ HRESULT Renderer::GetProposedFont(const int iDpi, const FontInfoDesired& FontInf
     //      handle this.
     // Currently, the only caller is the WindowProc:WM_GETDPISCALEDSIZE handler.
     //      It will assume that the proposed font is 1x1, regardless of DPI.
-    if (_rgpEngines.size() < 1)
+    const std::vector<IRenderEngine*> engines = _GetEngines();
+    if (engines.size() < 1)
     {
         return E_FAIL;
     }
@@ -445,9 +807,10 @@ HRESULT Renderer::GetProposedFont(const int iDpi, const FontInfoDesired& FontInf
     //      renderer. We won't know which is which, so iterate over them.
     //      Only return the result of the successful one if it's not S_FALSE (which is the VT renderer)
     // TODO: 14560740 - The Window might be able to get at this info in a more sane manner
-    FAIL_FAST_IF(!(_rgpEngines.size() <= 2));
-    for (IRenderEngine* const pEngine : _rgpEngines)
+    FAIL_FAST_IF(!(engines.size() <= 2));
+    for (IRenderEngine* const pEngine : engines)
     {
+        std::lock_guard<std::recursive_mutex> engineLock(pEngine->GetEngineLock());
         const HRESULT hr = LOG_IF_FAILED(pEngine->GetProposedFont(FontInfoDesired, FontInfo, iDpi));
         // We're looking for specifically S_OK, S_FALSE is not good enough.
         if (hr == S_OK)
@@ -477,9 +840,11 @@ bool Renderer::IsGlyphWideByFont(const std::wstring_view glyph)
     //      renderer. We won't know which is which, so iterate over them.
     //      Only return the result of the successful one if it's not S_FALSE (which is the VT renderer)
     // TODO: 14560740 - The Window might be able to get at this info in a more sane manner
-    FAIL_FAST_IF(!(_rgpEngines.size() <= 2));
-    for (IRenderEngine* const pEngine : _rgpEngines)
+    const std::vector<IRenderEngine*> engines = _GetEngines();
+    FAIL_FAST_IF(!(engines.size() <= 2));
+    for (IRenderEngine* const pEngine : engines)
     {
+        std::lock_guard<std::recursive_mutex> engineLock(pEngine->GetEngineLock());
         const HRESULT hr = LOG_IF_FAILED(pEngine->IsGlyphWideByFont(glyph, &fIsFullWidth));
         // We're looking for specifically S_OK, S_FALSE is not good enough.
         if (hr == S_OK)
@@ -528,14 +893,14 @@ HRESULT Renderer::_PaintBackground(_In_ IRenderEngine* const pEngine)
 }
 
 // Routine Description:
-// - Paint helper to copy the primary console buffer text onto the screen.
+// - Capture helper to copy the primary console buffer text into the frame.
 // - This portion primarily handles figuring the current viewport, comparing it/trimming it versus the invalid portion of the frame, and queuing up, row by row, which pieces of text need to be further processed.
 // - See also: Helper functions that seperate out each complexity of text rendering.
 // Arguments:
-// - <none>
+// - frame - The frame being captured. Its dirty region must already be set.
 // Return Value:
 // - <none>
-void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
+void Renderer::_CaptureBufferOutput(RenderFrame& frame)
 {
     // This is the subsection of the entire screen buffer that is currently being presented.
     // It can move left/right or top/bottom depending on how the viewport is scrolled
@@ -544,7 +909,7 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
 
     // This is effectively the number of cells on the visible screen that need to be redrawn.
     // The origin is always 0, 0 because it represents the screen itself, not the underlying buffer.
-    auto dirty = Viewport::FromInclusive(pEngine->GetDirtyRectInChars());
+    auto dirty = Viewport::FromInclusive(frame.dirty);
 
     // Shift the origin of the dirty region to match the underlying buffer so we can
     // compare the two regions directly for intersection.
@@ -578,24 +943,20 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
             // Retrieve the cell information iterator limited to just this line we want to redraw.
             auto it = buffer.GetCellDataAt(bufferLine.Origin(), bufferLine);
 
-            // Ask the helper to paint through this specific line.
-            _PaintBufferOutputHelper(pEngine, it, screenLine.Origin());
+            // Ask the helper to capture this specific line.
+            _CaptureBufferOutputHelper(frame, frame.bufferRuns, it, screenLine.Origin());
         }
     }
 }
 
-void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
-                                        TextBufferCellIterator it,
-                                        const COORD target)
+void Renderer::_CaptureBufferOutputHelper(RenderFrame& frame,
+                                          std::vector<RenderFrame::Run>& runs,
+                                          TextBufferCellIterator it,
+                                          const COORD target)
 {
     // If we have valid data, let's figure out how to draw it.
     if (it)
     {
-        // TODO: MSFT: 20961091 -  This is a perf issue. Instead of rebuilding this and allocing memory to hold the reinterpretation,
-        // we should have an iterator/view adapter for the rendering.
-        // That would probably also eliminate the RenderData needing to give us the entire TextBuffer as well...
-        // Retrieve the iterator for one line of information.
-        std::vector<Cluster> clusters;
         size_t cols = 0;
 
         // Retrieve the first color.
@@ -613,15 +974,11 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
             // when we go to draw gridlines for the length of the run.
             const auto currentRunColor = color;
 
-            // Update the drawing brushes with our color.
-            THROW_IF_FAILED(_UpdateDrawingBrushes(pEngine, currentRunColor, false));
-
-            // Advance the point by however many columns we've just outputted and reset the accumulator.
+            // Advance the point by however many columns we've just captured and reset the accumulator.
             screenPoint.X += gsl::narrow<SHORT>(cols);
             cols = 0;
 
-            // Ensure that our cluster vector is clear.
-            clusters.clear();
+            const size_t firstGlyph = frame.glyphs.size();
 
             // This inner loop will accumulate clusters until the color changes.
             // When the color changes, it will save the new color off and break.
@@ -633,26 +990,65 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
                     break;
                 }
 
-                // Walk through the text data and turn it into rendering clusters.
-                clusters.emplace_back(it->Chars(), it->Columns());
+                // Walk through the text data and copy it into the frame.
+                const auto chars = it->Chars();
+                const auto columnCount = it->Columns();
+                frame.glyphs.push_back({ frame.text.size(), chars.size(), columnCount });
+                frame.text.append(chars);
 
                 // Advance the cluster and column counts.
-                const auto columnCount = clusters.back().GetColumns();
                 it += columnCount > 0 ? columnCount : 1; // prevent infinite loop for no visible columns
                 cols += columnCount;
 
             } while (it);
 
-            // Do the painting.
-            // TODO: Calculate when trim left should be TRUE
-            THROW_IF_FAILED(pEngine->PaintBufferLine({ clusters.data(), clusters.size() }, screenPoint, false));
+            runs.push_back({ currentRunColor,
+                             _pData->GetForegroundColor(currentRunColor),
+                             _pData->GetBackgroundColor(currentRunColor),
+                             screenPoint,
+                             cols,
+                             firstGlyph,
+                             frame.glyphs.size() - firstGlyph });
+        }
+    }
+}
 
-            // If we're allowed to do grid drawing, draw that now too (since it will be coupled with the color data)
-            if (_pData->IsGridLineDrawingAllowed())
-            {
-                // We're only allowed to draw the grid lines under certain circumstances.
-                _PaintBufferOutputGridLineHelper(pEngine, currentRunColor, cols, screenPoint);
-            }
+// Routine Description:
+// - Paint helper to draw runs of text that were captured into the frame.
+// Arguments:
+// - pEngine - The engine to paint.
+// - frame - The captured frame holding the text.
+// - runs - The runs to paint.
+// Return Value:
+// - <none>
+void Renderer::_PaintRuns(_In_ IRenderEngine* const pEngine,
+                          const RenderFrame& frame,
+                          const std::vector<RenderFrame::Run>& runs)
+{
+    // The frame owns the text, so the clusters only need to view it.
+    std::vector<Cluster> clusters;
+
+    for (const auto& run : runs)
+    {
+        // Update the drawing brushes with our color.
+        THROW_IF_FAILED(_UpdateDrawingBrushes(pEngine, run.attr, run.foreground, run.background, false));
+
+        clusters.clear();
+        for (size_t i = run.firstGlyph; i < run.firstGlyph + run.glyphCount; i++)
+        {
+            const auto& glyph = frame.glyphs.at(i);
+            clusters.emplace_back(std::wstring_view(frame.text).substr(glyph.offset, glyph.length), glyph.columns);
+        }
+
+        // Do the painting.
+        // TODO: Calculate when trim left should be TRUE
+        THROW_IF_FAILED(pEngine->PaintBufferLine({ clusters.data(), clusters.size() }, run.target, false));
+
+        // If we're allowed to do grid drawing, draw that now too (since it will be coupled with the color data)
+        if (frame.isGridLineDrawingAllowed)
+        {
+            // We're only allowed to draw the grid lines under certain circumstances.
+            _PaintBufferOutputGridLineHelper(pEngine, run.attr, run.foreground, run.columns, run.target);
         }
     }
 }
@@ -697,17 +1093,17 @@ IRenderEngine::GridLines Renderer::s_GetGridlines(const TextAttribute& textAttri
 // - See also: All related helpers and buffer output functions.
 // Arguments:
 // - textAttribute - The line/box drawing attributes to use for this particular run.
+// - rgb - The color to draw the lines in.
 // - cchLine - The length of both pwsLine and pbKAttrsLine.
 // - coordTarget - The X/Y coordinate position in the buffer which we're attempting to start rendering from.
 // Return Value:
 // - <none>
 void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngine,
                                                 const TextAttribute textAttribute,
+                                                const COLORREF rgb,
                                                 const size_t cchLine,
                                                 const COORD coordTarget)
 {
-    const COLORREF rgb = _pData->GetForegroundColor(textAttribute);
-
     // Convert console grid line representations into rendering engine enum representations.
     IRenderEngine::GridLines lines = Renderer::s_GetGridlines(textAttribute);
 
@@ -716,12 +1112,12 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
 }
 
 // Routine Description:
-// - Paint helper to draw the cursor within the buffer.
+// - Capture helper to get the parameters for drawing the cursor within the buffer.
 // Arguments:
 // - <none>
 // Return Value:
-// - <none>
-void Renderer::_PaintCursor(_In_ IRenderEngine* const pEngine)
+// - The cursor parameters, or nothing if the cursor is not visible.
+std::optional<IRenderEngine::CursorOptions> Renderer::_CaptureCursor()
 {
     if (_pData->IsCursorVisible())
     {
@@ -745,22 +1141,38 @@ void Renderer::_PaintCursor(_In_ IRenderEngine* const pEngine)
         options.cursorColor = cursorColor;
         options.isOn = _pData->IsCursorOn();
 
-        // Draw it within the viewport
-        LOG_IF_FAILED(pEngine->PaintCursor(options));
+        return options;
+    }
 
+    return std::nullopt;
+}
+
+// Routine Description:
+// - Paint helper to draw the cursor within the buffer.
+// Arguments:
+// - pEngine - The engine to paint.
+// - frame - The captured frame holding the cursor parameters.
+// Return Value:
+// - <none>
+void Renderer::_PaintCursor(_In_ IRenderEngine* const pEngine, const RenderFrame& frame)
+{
+    if (frame.cursor.has_value())
+    {
+        // Draw it within the viewport
+        LOG_IF_FAILED(pEngine->PaintCursor(frame.cursor.value()));
     }
 }
 
 // Routine Description:
-// - Paint helper to draw text that overlays the main buffer to provide user interactivity regions
+// - Capture helper to copy text that overlays the main buffer to provide user interactivity regions
 // - This supports IME composition.
 // Arguments:
-// - engine - The render engine that we're targeting.
-// - overlay - The overlay to draw.
+// - frame - The frame being captured.
+// - overlay - The overlay to capture.
 // Return Value:
 // - <none>
-void Renderer::_PaintOverlay(IRenderEngine& engine,
-                             const RenderOverlay& overlay)
+void Renderer::_CaptureOverlay(RenderFrame& frame,
+                               const RenderOverlay& overlay)
 {
     try
     {
@@ -778,7 +1190,7 @@ void Renderer::_PaintOverlay(IRenderEngine& engine,
         // Set it up in a Viewport helper structure and trim it the IME viewport to be within the full console viewport.
         Viewport viewConv = Viewport::FromInclusive(srCaView);
 
-        SMALL_RECT srDirty = engine.GetDirtyRectInChars();
+        SMALL_RECT srDirty = frame.dirty;
 
         // Dirty is an inclusive rectangle, but oddly enough the IME was an exclusive one, so correct it.
         srDirty.Bottom++;
@@ -795,7 +1207,7 @@ void Renderer::_PaintOverlay(IRenderEngine& engine,
 
                 auto it = overlay.buffer.GetCellLineDataAt(source);
 
-                _PaintBufferOutputHelper(&engine, it, target);
+                _CaptureBufferOutputHelper(frame, frame.overlayRuns, it, target);
             }
         }
     }
@@ -803,14 +1215,14 @@ void Renderer::_PaintOverlay(IRenderEngine& engine,
 }
 
 // Routine Description:
-// - Paint helper to draw the composition string portion of the IME.
+// - Capture helper to copy the composition string portion of the IME.
 // - This specifically is the string that appears at the cursor on the input line showing what the user is currently typing.
-// - See also: Generic Paint IME helper method.
+// - See also: Generic capture IME helper method.
 // Arguments:
-// - <none>
+// - frame - The frame being captured.
 // Return Value:
 // - <none>
-void Renderer::_PaintOverlays(_In_ IRenderEngine* const pEngine)
+void Renderer::_CaptureOverlays(RenderFrame& frame)
 {
     try
     {
@@ -818,7 +1230,7 @@ void Renderer::_PaintOverlays(_In_ IRenderEngine* const pEngine)
 
         for (const auto& overlay : overlays)
         {
-            _PaintOverlay(*pEngine, overlay);
+            _CaptureOverlay(frame, overlay);
         }
     }
     CATCH_LOG();
@@ -827,19 +1239,29 @@ void Renderer::_PaintOverlays(_In_ IRenderEngine* const pEngine)
 // Routine Description:
 // - Paint helper to draw the selected area of the window.
 // Arguments:
-// - <none>
+// - pEngine - The engine to paint.
+// - frame - The captured frame holding the selection.
 // Return Value:
 // - <none>
-void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
+void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine, const RenderFrame& frame)
 {
     try
     {
         SMALL_RECT srDirty = pEngine->GetDirtyRectInChars();
         Viewport dirtyView = Viewport::FromInclusive(srDirty);
 
-        // Get selection rectangles
-        const auto rectangles = _GetSelectionRects();
-        for (auto rect : rectangles)
+        // Search highlights are painted the same way as the selection. They
+        // never overlap it, since engines like GDI paint a selection by
+        // inverting it, and two inversions would cancel out.
+        for (auto rect : frame.searchHighlights)
+        {
+            if (dirtyView.TrimToViewport(&rect))
+            {
+                LOG_IF_FAILED(pEngine->PaintSelection(rect));
+            }
+        }
+
+        for (auto rect : frame.selection)
         {
             if (dirtyView.TrimToViewport(&rect))
             {
@@ -851,10 +1273,12 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
 }
 
 // Routine Description:
-// - Helper to convert the text attributes to actual RGB colors and update the rendering pen/brush within the rendering engine before the next draw operation.
+// - Helper to update the rendering pen/brush within the rendering engine before the next draw operation.
 // Arguments:
 // - pEngine - Which engine is being updated
 // - textAttributes - The 16 color foreground/background combination to set
+// - rgbForeground - The foreground color the attributes resolved to when the frame was captured
+// - rgbBackground - The background color the attributes resolved to when the frame was captured
 // - isSettingDefaultBrushes - Alerts that the default brushes are being set which will
 //                             impact whether or not to include the hung window/erase window brushes in this operation
 //                             and can affect other draw state that wants to know the default color scheme.
@@ -862,10 +1286,12 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
 // Return Value:
 // - <none>
 [[nodiscard]]
-HRESULT Renderer::_UpdateDrawingBrushes(_In_ IRenderEngine* const pEngine, const TextAttribute textAttributes, const bool isSettingDefaultBrushes)
+HRESULT Renderer::_UpdateDrawingBrushes(_In_ IRenderEngine* const pEngine,
+                                        const TextAttribute textAttributes,
+                                        const COLORREF rgbForeground,
+                                        const COLORREF rgbBackground,
+                                        const bool isSettingDefaultBrushes)
 {
-    const COLORREF rgbForeground = _pData->GetForegroundColor(textAttributes);
-    const COLORREF rgbBackground = _pData->GetBackgroundColor(textAttributes);
     const WORD legacyAttributes = textAttributes.GetLegacyAttributes();
     const bool isBold = textAttributes.IsBold();
 
@@ -916,6 +1342,44 @@ std::vector<SMALL_RECT> Renderer::_GetSelectionRects() const
     return result;
 }
 
+// Routine Description:
+// - Gets the matches of the text buffer's search session that are in view, adjusted
+//   to the viewport the same way as the selection.
+// - Matches that overlap the selection are left out, so that the selection shows.
+// Arguments:
+// - selection - The selection rectangles, from _GetSelectionRects
+// Return Value:
+// - Rectangles to highlight, one for each row of each match.
+std::vector<SMALL_RECT> Renderer::_GetSearchHighlightRects(const std::vector<SMALL_RECT>& selection) const
+{
+    const auto& textBuffer = _pData->GetTextBuffer();
+    if (!textBuffer.HasSearchSession())
+    {
+        return {};
+    }
+
+    const Viewport view = _pData->GetViewport();
+
+    std::vector<SMALL_RECT> result;
+    for (const auto& rect : textBuffer.GetSearchHighlights(view))
+    {
+        auto sr = view.ConvertToOrigin(Viewport::FromInclusive(rect)).ToInclusive();
+        sr.Right++;
+        sr.Bottom++;
+
+        const bool selected = std::any_of(selection.cbegin(), selection.cend(), [&](const SMALL_RECT& other) {
+            return sr.Left < other.Right && other.Left < sr.Right && sr.Top < other.Bottom && other.Top < sr.Bottom;
+        });
+
+        if (!selected)
+        {
+            result.emplace_back(sr);
+        }
+    }
+
+    return result;
+}
+
 // Method Description:
 // - Adds another Render engine to this renderer. Future rendering calls will
 //      also be sent to the new renderer.
@@ -928,5 +1392,224 @@ std::vector<SMALL_RECT> Renderer::_GetSelectionRects() const
 void Renderer::AddRenderEngine(_In_ IRenderEngine* const pEngine)
 {
     THROW_IF_NULL_ALLOC(pEngine);
+    std::lock_guard<std::mutex> lock(_invalidationLock);
+
+    std::string name{ Metrics::Names::PaintMicroseconds };
+    name.append(".").append(std::to_string(_rgpEngines.size()));
+    _paintTimes.push_back(&Metrics::MetricsRegistry::Instance().GetHistogram(name));
+
     _rgpEngines.push_back(pEngine);
 }
+
+// Method Description:
+// - Finds the histogram that the paint durations of the given engine are recorded in.
+// Arguments:
+// - pEngine: The engine to find the histogram for.
+// Return Value:
+// - The histogram, or nullptr if the engine isn't one of ours.
+Microsoft::Console::Metrics::Histogram* Renderer::_GetPaintTime(const IRenderEngine* const pEngine)
+{
+    std::lock_guard<std::mutex> lock(_invalidationLock);
+    const auto it = std::find(_rgpEngines.cbegin(), _rgpEngines.cend(), pEngine);
+    return it == _rgpEngines.cend() ? nullptr : _paintTimes.at(it - _rgpEngines.cbegin());
+}
+
+// Method Description:
+// - Applies an invalidation to every engine.
+// - If a frame is currently being painted, the engines are busy and can't be
+//      touched. The invalidation is then folded into the pending invalidations,
+//      which are applied as soon as the frame is done.
+// Arguments:
+// - apply: Applies the invalidation to one engine.
+// - fold: Folds the invalidation into the pending ones.
+// Return Value:
+// - <none>
+template<typename Apply, typename Fold>
+void Renderer::_InvalidateEngines(const Apply& apply, const Fold& fold)
+{
+    std::lock_guard<std::mutex> lock(_invalidationLock);
+    if (_fPainting)
+    {
+        fold(_pendingInvalidations);
+    }
+    else
+    {
+        for (IRenderEngine* const pEngine : _rgpEngines)
+        {
+            std::lock_guard<std::recursive_mutex> engineLock(pEngine->GetEngineLock());
+            apply(pEngine);
+        }
+    }
+}
+
+// Method Description:
+// - Gets a copy of the engine list, to call the engines without holding the
+//      invalidation lock. Engine locks must never be taken while holding it
+//      unless no frame is in flight.
+// Arguments:
+// - <none>
+// Return Value:
+// - The engines.
+std::vector<IRenderEngine*> Renderer::_GetEngines()
+{
+    std::lock_guard<std::mutex> lock(_invalidationLock);
+    return { _rgpEngines.begin(), _rgpEngines.end() };
+}
+
+// Method Description:
+// - Called when a frame is done painting. Applies all the invalidations that
+//      arrived while it was in flight and schedules another frame for them.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_FlushPendingInvalidations()
+{
+    bool fNeedsPaint = false;
+    {
+        std::lock_guard<std::mutex> lock(_invalidationLock);
+        const _PendingInvalidations& pending = _pendingInvalidations;
+        fNeedsPaint = pending.any;
+
+        if (fNeedsPaint)
+        {
+            // The engines in this frame are still locked by this thread, but
+            //      the others may be in use by someone who isn't painting.
+            for (IRenderEngine* const pEngine : _rgpEngines)
+            {
+                std::lock_guard<std::recursive_mutex> engineLock(pEngine->GetEngineLock());
+                pending.ApplyTo(pEngine);
+            }
+        }
+
+        _pendingInvalidations = {};
+        _fPainting = false;
+    }
+
+    if (fNeedsPaint)
+    {
+        _NotifyPaintFrame();
+    }
+}
+
+// Method Description:
+// - Applies the pending invalidations to the given engine.
+void Renderer::_PendingInvalidations::ApplyTo(IRenderEngine* const pEngine) const noexcept
+{
+    // Scrolls move what was invalidated before them, which the pending
+    //      region already accounts for, so they go first.
+    if (viewport.has_value())
+    {
+        LOG_IF_FAILED(pEngine->UpdateViewport(*viewport));
+    }
+    if (scroll.X != 0 || scroll.Y != 0)
+    {
+        COORD delta = scroll;
+        LOG_IF_FAILED(pEngine->InvalidateScroll(&delta));
+    }
+
+    if (all)
+    {
+        LOG_IF_FAILED(pEngine->InvalidateAll());
+    }
+    else if (region.has_value())
+    {
+        LOG_IF_FAILED(pEngine->Invalidate(&*region));
+    }
+
+    if (system.has_value())
+    {
+        LOG_IF_FAILED(pEngine->InvalidateSystem(&*system));
+    }
+
+    if (cursor.has_value())
+    {
+        COORD coord = *cursor;
+        LOG_IF_FAILED(pEngine->InvalidateCursor(&coord));
+        if (cursorDoubleWidth)
+        {
+            coord.X++;
+            LOG_IF_FAILED(pEngine->InvalidateCursor(&coord));
+        }
+    }
+
+    if (title.has_value())
+    {
+        LOG_IF_FAILED(pEngine->InvalidateTitle(*title));
+    }
+}
+
+// Method Description:
+// - Adds a region of the viewport (exclusive, relative to its origin) to the
+//      pending invalidations.
+void Renderer::_PendingInvalidations::AddRegion(const SMALL_RECT& rect) noexcept
+{
+    if (region.has_value())
+    {
+        SMALL_RECT& bounds = *region;
+        bounds.Left = std::min(bounds.Left, rect.Left);
+        bounds.Top = std::min(bounds.Top, rect.Top);
+        bounds.Right = std::max(bounds.Right, rect.Right);
+        bounds.Bottom = std::max(bounds.Bottom, rect.Bottom);
+    }
+    else
+    {
+        region = rect;
+    }
+    any = true;
+}
+
+// Method Description:
+// - Adds a region of the window's client area to the pending invalidations.
+void Renderer::_PendingInvalidations::AddSystem(const RECT& rect) noexcept
+{
+    if (system.has_value())
+    {
+        UnionRect(&*system, &*system, &rect);
+    }
+    else
+    {
+        system = rect;
+    }
+    any = true;
+}
+
+// Method Description:
+// - Adds a cursor position (relative to the viewport origin) to the pending
+//      invalidations. Every position the cursor was at is repainted, and the
+//      engines are told where it ended up.
+void Renderer::_PendingInvalidations::AddCursor(const COORD coord, const bool doubleWidth) noexcept
+{
+    const SHORT width = doubleWidth ? 2 : 1;
+    AddRegion({ coord.X, coord.Y, gsl::narrow_cast<SHORT>(coord.X + width), gsl::narrow_cast<SHORT>(coord.Y + 1) });
+    cursor = coord;
+    cursorDoubleWidth = doubleWidth;
+}
+
+// Method Description:
+// - Adds a scroll of the viewport's contents to the pending invalidations.
+//      What was already invalidated moves along with the contents.
+void Renderer::_PendingInvalidations::AddScroll(const COORD delta) noexcept
+{
+    if (delta.X == 0 && delta.Y == 0)
+    {
+        return;
+    }
+
+    if (region.has_value())
+    {
+        SMALL_RECT& bounds = *region;
+        bounds.Left += delta.X;
+        bounds.Right += delta.X;
+        bounds.Top += delta.Y;
+        bounds.Bottom += delta.Y;
+    }
+    if (cursor.has_value())
+    {
+        cursor->X += delta.X;
+        cursor->Y += delta.Y;
+    }
+    scroll.X += delta.X;
+    scroll.Y += delta.Y;
+    any = true;
+}
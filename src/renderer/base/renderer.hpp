@@ -21,9 +21,13 @@ Author(s):
 #include "../inc/IRenderData.hpp"
 
 #include "thread.hpp"
+#include "RenderFrame.hpp"
+
+#include <condition_variable>
 
 #include "../../buffer/out/textBuffer.hpp"
 #include "../../buffer/out/CharRow.hpp"
+#include "../../types/inc/PerfMetrics.hpp"
 
 namespace Microsoft::Console::Render
 {
@@ -60,6 +64,7 @@ namespace Microsoft::Console::Render
         void TriggerSelection() override;
         void TriggerScroll() override;
         void TriggerScroll(const COORD* const pcoordDelta) override;
+        void TriggerScrollRegion(const Microsoft::Console::Types::Viewport& region, const short sDelta) override;
 
         void TriggerCircling() override;
         void TriggerTitleChange() override;
@@ -83,42 +88,132 @@ namespace Microsoft::Console::Render
     private:
         std::deque<IRenderEngine*> _rgpEngines;
 
+        // The paint duration histogram of each engine, in the same order as _rgpEngines.
+        std::deque<Microsoft::Console::Metrics::Histogram*> _paintTimes;
+
         IRenderData* _pData; // Non-ownership pointer
 
         std::unique_ptr<IRenderThread> _pThread;
         bool _destructing = false;
 
+        // Invalidations that arrived while a frame was in flight, folded
+        //      together to be applied to every engine once it's done.
+        struct _PendingInvalidations
+        {
+            bool any = false;
+            bool all = false;
+            // Exclusive, relative to the viewport origin.
+            std::optional<SMALL_RECT> region;
+            std::optional<RECT> system;
+            std::optional<SMALL_RECT> viewport;
+            COORD scroll{ 0, 0 };
+            std::optional<COORD> cursor;
+            bool cursorDoubleWidth = false;
+            std::optional<std::wstring> title;
+
+            void AddRegion(const SMALL_RECT& rect) noexcept;
+            void AddSystem(const RECT& rect) noexcept;
+            void AddCursor(const COORD coord, const bool doubleWidth) noexcept;
+            void AddScroll(const COORD delta) noexcept;
+            void ApplyTo(IRenderEngine* const pEngine) const noexcept;
+        };
+
+        // Guards the engines against invalidation while a frame is in flight.
+        std::mutex _invalidationLock;
+        bool _fPainting = false;
+        _PendingInvalidations _pendingInvalidations;
+
+        // Only one frame is in flight at a time. This is recursive because an
+        //      engine can tear the host down from within a frame, and teardown
+        //      paints one last frame on the same thread.
+        std::recursive_mutex _frameLock;
+
+        // A thread that paints captured frames to one engine at a time, kept
+        //      for the lifetime of the renderer so a frame doesn't have to
+        //      create one per engine.
+        class _PaintWorker
+        {
+        public:
+            _PaintWorker(Renderer& renderer);
+            ~_PaintWorker();
+
+            void Start(_In_ IRenderEngine* const pEngine, std::shared_ptr<const RenderFrame> frame) noexcept;
+            [[nodiscard]]
+            HRESULT Wait() noexcept;
+
+        private:
+            void _Run() noexcept;
+
+            Renderer& _renderer;
+            std::mutex _lock;
+            std::condition_variable _wake;
+            IRenderEngine* _pEngine = nullptr;
+            std::shared_ptr<const RenderFrame> _frame;
+            bool _busy = false;
+            bool _exiting = false;
+            HRESULT _hr = S_OK;
+            std::thread _thread;
+        };
+
+        template<typename Apply, typename Fold>
+        void _InvalidateEngines(const Apply& apply, const Fold& fold);
+        Microsoft::Console::Metrics::Histogram* _GetPaintTime(const IRenderEngine* const pEngine);
+        std::vector<IRenderEngine*> _GetEngines();
+        void _FlushPendingInvalidations();
+
         void _NotifyPaintFrame();
+        void _NotifyPaintFrameLowLatency();
 
         [[nodiscard]]
         HRESULT _PaintFrameForEngine(_In_ IRenderEngine* const pEngine);
 
+        [[nodiscard]]
+        HRESULT _PaintFrameForEngines(const std::vector<IRenderEngine*>& engines);
+
+        [[nodiscard]]
+        HRESULT _PaintFrameFromCapture(_In_ IRenderEngine* const pEngine, const RenderFrame& frame) noexcept;
+
+        std::shared_ptr<const RenderFrame> _CaptureFrame(const SMALL_RECT dirty);
+
         bool _CheckViewportAndScroll();
+        COORD _UpdateViewportPrevious(const SMALL_RECT srNewViewport) noexcept;
 
         [[nodiscard]]
         HRESULT _PaintBackground(_In_ IRenderEngine* const pEngine);
 
-        void _PaintBufferOutput(_In_ IRenderEngine* const pEngine);
+        void _CaptureBufferOutput(RenderFrame& frame);
+
+        void _CaptureBufferOutputHelper(RenderFrame& frame,
+                                        std::vector<RenderFrame::Run>& runs,
+                                        TextBufferCellIterator it,
+                                        const COORD target);
 
-        void _PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
-                                      TextBufferCellIterator it,
-                                      const COORD target);
+        void _PaintRuns(_In_ IRenderEngine* const pEngine,
+                        const RenderFrame& frame,
+                        const std::vector<RenderFrame::Run>& runs);
 
         static IRenderEngine::GridLines s_GetGridlines(const TextAttribute& textAttribute) noexcept;
 
         void _PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngine,
                                               const TextAttribute textAttribute,
+                                              const COLORREF rgb,
                                               const size_t cchLine,
                                               const COORD coordTarget);
 
-        void _PaintSelection(_In_ IRenderEngine* const pEngine);
-        void _PaintCursor(_In_ IRenderEngine* const pEngine);
+        void _PaintSelection(_In_ IRenderEngine* const pEngine, const RenderFrame& frame);
 
-        void _PaintOverlays(_In_ IRenderEngine* const pEngine);
-        void _PaintOverlay(IRenderEngine& engine, const RenderOverlay& overlay);
+        std::optional<IRenderEngine::CursorOptions> _CaptureCursor();
+        void _PaintCursor(_In_ IRenderEngine* const pEngine, const RenderFrame& frame);
+
+        void _CaptureOverlays(RenderFrame& frame);
+        void _CaptureOverlay(RenderFrame& frame, const RenderOverlay& overlay);
 
         [[nodiscard]]
-        HRESULT _UpdateDrawingBrushes(_In_ IRenderEngine* const pEngine, const TextAttribute attr, const bool isSettingDefaultBrushes);
+        HRESULT _UpdateDrawingBrushes(_In_ IRenderEngine* const pEngine,
+                                      const TextAttribute attr,
+                                      const COLORREF rgbForeground,
+                                      const COLORREF rgbBackground,
+                                      const bool isSettingDefaultBrushes);
 
         [[nodiscard]]
         HRESULT _PerformScrolling(_In_ IRenderEngine* const pEngine);
@@ -126,13 +221,17 @@ namespace Microsoft::Console::Render
         SMALL_RECT _srViewportPrevious;
 
         std::vector<SMALL_RECT> _GetSelectionRects() const;
+        std::vector<SMALL_RECT> _GetSearchHighlightRects(const std::vector<SMALL_RECT>& selection) const;
         std::vector<SMALL_RECT> _previousSelection;
 
         [[nodiscard]]
-        HRESULT _PaintTitle(IRenderEngine* const pEngine);
+        HRESULT _PaintTitle(IRenderEngine* const pEngine, const RenderFrame& frame);
 
         // Helper functions to diagnose issues with painting and layout.
         // These are only actually effective/on in Debug builds when the flag is set using an attached debugger.
         bool _fDebug = false;
+
+        // Declared last so the workers are stopped before anything they paint with is destroyed.
+        std::vector<std::unique_ptr<_PaintWorker>> _workers;
     };
 }
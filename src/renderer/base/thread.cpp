@@ -6,9 +6,12 @@
 
 #include "thread.hpp"
 
+#include "../../types/inc/PerfMetrics.hpp"
+
 #pragma hdrstop
 
 using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::Metrics;
 
 RenderThread::RenderThread() :
     _pRenderer(nullptr),
@@ -16,7 +19,11 @@ RenderThread::RenderThread() :
     _hEvent(INVALID_HANDLE_VALUE),
     _hPaintCompletedEvent(INVALID_HANDLE_VALUE),
     _fKeepRunning(true),
-    _hPaintEnabledEvent(INVALID_HANDLE_VALUE)
+    _hPaintEnabledEvent(INVALID_HANDLE_VALUE),
+    _dwFrameLimitMs(s_FrameLimitMilliseconds),
+    _fLowLatencyRequested(false),
+    _cNotifications(0),
+    _lastPaintStart()
 {
 
 }
@@ -163,27 +170,120 @@ DWORD WINAPI RenderThread::_ThreadProc()
         WaitForSingleObject(_hPaintEnabledEvent, INFINITE);
         WaitForSingleObject(_hEvent, INFINITE);
 
-        ResetEvent(_hPaintCompletedEvent);
+        // Decide whether this frame can go out right away (keystroke echo) or
+        //      whether we should hold it back to let a burst of output pile up.
+        const bool fLowLatency = _fLowLatencyRequested.exchange(false);
 
-        LOG_IF_FAILED(_pRenderer->PaintFrame());
+        // extra check before we wait since it's a "long" activity, relatively speaking.
+        if (_fKeepRunning)
+        {
+            _WaitForFrameBudget(fLowLatency);
+        }
 
-        SetEvent(_hPaintCompletedEvent);
+        ResetEvent(_hPaintCompletedEvent);
 
-        // extra check before we sleep since it's a "long" activity, relatively speaking.
-        if (_fKeepRunning)
+        static auto& s_frameTimes = MetricsRegistry::Instance().GetHistogram(Names::FrameMicroseconds);
+
+        _lastPaintStart = std::chrono::steady_clock::now();
         {
-            Sleep(s_FrameLimitMilliseconds);
+            ScopedLatency measure{ s_frameTimes };
+            LOG_IF_FAILED(_pRenderer->PaintFrame());
         }
+
+        SetEvent(_hPaintCompletedEvent);
     }
 
     return S_OK;
 }
 
+// Method Description:
+// - Holds the render thread back until the frame budget since the start of the
+//      previous frame has elapsed.
+// - If the thread has been idle for at least one frame interval, we paint
+//      immediately. This is the interactive case: a keystroke arrives, gets
+//      echoed, and we put it on the screen without any dead time.
+// - If the caller asked for a low-latency frame (small, input-driven dirty
+//      area) and we're not in the middle of a burst of output, we also paint
+//      immediately.
+// - Otherwise, we're under sustained output. Sleep out the rest of the frame
+//      budget so the parser can keep the lock and more of the burst gets
+//      coalesced into the next frame.
+// Arguments:
+// - fLowLatency: true if a low-latency frame was requested since the last frame.
+// Return Value:
+// - <none>
+void RenderThread::_WaitForFrameBudget(const bool fLowLatency)
+{
+    const ULONG cNotifications = _cNotifications.exchange(0);
+    const bool fInBurst = cNotifications > s_BurstNotificationThreshold;
+
+    static auto& s_lowLatencyFrames = MetricsRegistry::Instance().GetCounter(Names::LowLatencyFrames);
+    static auto& s_throttledFrames = MetricsRegistry::Instance().GetCounter(Names::ThrottledFrames);
+    static auto& s_coalescedNotifications = MetricsRegistry::Instance().GetCounter(Names::CoalescedPaintNotifications);
+
+    const auto frameLimit = std::chrono::milliseconds(_dwFrameLimitMs.load());
+    const auto elapsed = std::chrono::steady_clock::now() - _lastPaintStart;
+
+    if (elapsed >= frameLimit)
+    {
+        return;
+    }
+
+    if (fLowLatency && !fInBurst)
+    {
+        s_lowLatencyFrames.Increment();
+        return;
+    }
+
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(frameLimit - elapsed);
+    Sleep(static_cast<DWORD>(std::max<std::chrono::milliseconds::rep>(remaining.count(), 1)));
+
+    // Everything that piled up while we slept will be picked up by this frame.
+    // Consume the wakeup so we don't immediately paint a second, redundant frame.
+    const ULONG cCoalesced = _cNotifications.exchange(0);
+    if (cCoalesced > 0)
+    {
+        ResetEvent(_hEvent);
+        _fLowLatencyRequested = false;
+    }
+
+    s_throttledFrames.Increment();
+    s_coalescedNotifications.Add(cCoalesced);
+}
+
 void RenderThread::NotifyPaint()
 {
+    _cNotifications++;
     SetEvent(_hEvent);
 }
 
+// Method Description:
+// - Requests a paint, hinting that the change was small and input-driven (like
+//      the echo of a keystroke), so it should reach the screen as soon as
+//      possible rather than waiting out the frame limit.
+// - The hint is ignored while the output is bursting.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void RenderThread::NotifyPaintLowLatency()
+{
+    _fLowLatencyRequested = true;
+    NotifyPaint();
+}
+
+// Method Description:
+// - Sets the shortest time between the starts of two frames while output is
+//      sustained. Interactive frames are not held back by it.
+// Arguments:
+// - dwFrameLimitMs - The frame limit in milliseconds. 0 doesn't throttle at all.
+// Return Value:
+// - <none>
+void RenderThread::SetFrameLimit(const DWORD dwFrameLimitMs)
+{
+    _dwFrameLimitMs = dwFrameLimitMs;
+}
+
 void RenderThread::EnablePainting()
 {
     SetEvent(_hPaintEnabledEvent);
@@ -29,16 +29,32 @@ namespace Microsoft::Console::Render
         HRESULT Initialize(_In_ IRenderer* const pRendererParent) noexcept;
 
         void NotifyPaint() override;
+        void NotifyPaintLowLatency() override;
 
         void EnablePainting() override;
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) override;
-        
+        void SetFrameLimit(const DWORD dwFrameLimitMs) override;
+
     private:
         static DWORD WINAPI s_ThreadProc(_In_ LPVOID lpParameter);
         DWORD WINAPI _ThreadProc();
 
+        void _WaitForFrameBudget(const bool fLowLatency);
+
+        // The default for _dwFrameLimitMs.
         static DWORD const s_FrameLimitMilliseconds = 8;
 
+        // If more than this many paint notifications arrive between two frames,
+        // the output is considered to be a burst (flood output) rather than
+        // interactive echo, and low-latency hints are ignored.
+        static ULONG const s_BurstNotificationThreshold = 16;
+
+        std::atomic<DWORD> _dwFrameLimitMs;
+        std::atomic<bool> _fLowLatencyRequested;
+        std::atomic<ULONG> _cNotifications;
+
+        std::chrono::steady_clock::time_point _lastPaintStart;
+
         HANDLE _hThread;
         HANDLE _hEvent;
 
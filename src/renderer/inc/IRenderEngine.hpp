@@ -89,6 +89,8 @@ namespace Microsoft::Console::Render
         [[nodiscard]]
         virtual HRESULT InvalidateScroll(const COORD* const pcoordDelta) noexcept = 0;
         [[nodiscard]]
+        virtual HRESULT InvalidateScrollRegion(const SMALL_RECT* const psrRegion, const short sDelta) noexcept = 0;
+        [[nodiscard]]
         virtual HRESULT InvalidateAll() noexcept = 0;
         [[nodiscard]]
         virtual HRESULT InvalidateCircling(_Out_ bool* const pForcePaint) noexcept = 0;
@@ -139,6 +141,11 @@ namespace Microsoft::Console::Render
         virtual HRESULT IsGlyphWideByFont(const std::wstring_view glyph, _Out_ bool* const pResult) noexcept = 0;
         [[nodiscard]]
         virtual HRESULT UpdateTitle(const std::wstring& newTitle) noexcept = 0;
+
+        // Held by the renderer for the whole of a frame, from StartPaint to
+        //      Present. Anything that calls into the engine from outside of the
+        //      renderer must hold it too.
+        virtual std::recursive_mutex& GetEngineLock() noexcept = 0;
     };
 
     inline Microsoft::Console::Render::IRenderEngine::~IRenderEngine() { }
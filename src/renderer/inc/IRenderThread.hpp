@@ -20,8 +20,10 @@ namespace Microsoft::Console::Render
     public:
         virtual ~IRenderThread() = 0;
         virtual void NotifyPaint() = 0;
+        virtual void NotifyPaintLowLatency() = 0;
         virtual void EnablePainting() = 0;
         virtual void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) = 0;
+        virtual void SetFrameLimit(const DWORD dwFrameLimitMs) = 0;
     };
 
     inline Microsoft::Console::Render::IRenderThread::~IRenderThread() { };
@@ -33,6 +33,11 @@ namespace Microsoft::Console::Render
         [[nodiscard]]
         HRESULT UpdateTitle(const std::wstring& newTitle) noexcept override;
 
+        [[nodiscard]]
+        HRESULT InvalidateScrollRegion(const SMALL_RECT* const psrRegion, const short sDelta) noexcept override;
+
+        std::recursive_mutex& GetEngineLock() noexcept override;
+
     protected:
         [[nodiscard]]
         virtual HRESULT _DoUpdateTitle(const std::wstring& newTitle) noexcept = 0;
@@ -40,6 +45,8 @@ namespace Microsoft::Console::Render
         bool _titleChanged;
         std::wstring _lastFrameTitle;
 
+        std::recursive_mutex _engineLock;
+
     };
 
     inline Microsoft::Console::Render::RenderEngineBase::~RenderEngineBase() { }
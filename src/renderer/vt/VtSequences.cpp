@@ -170,6 +170,62 @@ HRESULT VtEngine::_InsertLine(const short sLines) noexcept
     return _InsertDeleteLine(sLines, true);
 }
 
+// Method Description:
+// - Formats and writes a sequence to scroll the contents of the scrolling
+//      region up or down by a number of lines. Lines scrolled into the region
+//      are blank.
+// Arguments:
+// - sLines: a number of lines to scroll by
+// - fScrollUp: true iff the contents should move up, false to move them down.
+// Return Value:
+// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
+[[nodiscard]]
+HRESULT VtEngine::_ScrollUpDown(const short sLines, const bool fScrollUp) noexcept
+{
+    if (sLines <= 0)
+    {
+        return S_OK;
+    }
+    if (sLines == 1)
+    {
+        return _Write(fScrollUp ? "\x1b[S" : "\x1b[T");
+    }
+    const std::string format = fScrollUp ? "\x1b[%dS" : "\x1b[%dT";
+
+    return _WriteFormattedString(&format, sLines);
+}
+
+// Method Description:
+// - Formats and writes a sequence to set the top and bottom scrolling margins
+//      (DECSTBM). The input rows should be in console coordinates, where
+//      origin=(0,0). Note that this also moves the cursor to the origin.
+// Arguments:
+// - sTop: The first row of the scrolling region.
+// - sBottom: The last row of the scrolling region (inclusive).
+// Return Value:
+// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
+[[nodiscard]]
+HRESULT VtEngine::_SetScrollingRegion(const short sTop, const short sBottom) noexcept
+{
+    static const std::string marginsFormat = "\x1b[%d;%dr";
+
+    // VT rows start at 1
+    return _WriteFormattedString(&marginsFormat, sTop + 1, sBottom + 1);
+}
+
+// Method Description:
+// - Formats and writes a sequence to reset the scrolling margins to the whole
+//      screen. Note that this also moves the cursor to the origin.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
+[[nodiscard]]
+HRESULT VtEngine::_ResetScrollingRegion() noexcept
+{
+    return _Write("\x1b[r");
+}
+
 // Method Description:
 // - Formats and writes a sequence to move the cursor to the specified
 //      coordinate position. The input coord should be in console coordinates,
@@ -112,5 +112,6 @@ HRESULT WinTelnetEngine::InvalidateScroll(const COORD* const /*pcoordDelta*/) no
 [[nodiscard]]
 HRESULT WinTelnetEngine::WriteTerminalW(_In_ const std::wstring& wstr) noexcept
 {
+    std::lock_guard<std::recursive_mutex> lock(_engineLock);
     return VtEngine::_WriteTerminalAscii(wstr);
 }
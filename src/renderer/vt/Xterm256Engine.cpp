@@ -3,6 +3,7 @@
 
 #include "precomp.h"
 #include "Xterm256Engine.hpp"
+#include "../../inc/conattrs.hpp"
 #pragma hdrstop
 using namespace Microsoft::Console;
 using namespace Microsoft::Console::Render;
@@ -19,7 +20,9 @@ Xterm256Engine::Xterm256Engine(_In_ wil::unique_hfile hPipe,
 
 // Routine Description:
 // - Write a VT sequence to change the current colors of text. Writes true RGB
-//      color sequences.
+//      color sequences, unless the color can be expressed more compactly with
+//      an entry from the 16 or 256 color tables.
+// - All of the changed attributes are written in a single SGR sequence.
 // Arguments:
 // - colorForeground: The RGB Color to use to paint the foreground text.
 // - colorBackground: The RGB Color to use to paint the background of the text.
@@ -36,17 +39,228 @@ HRESULT Xterm256Engine::UpdateDrawingBrushes(const COLORREF colorForeground,
                                              const bool isBold,
                                              const bool /*isSettingDefaultBrushes*/) noexcept
 {
-    //When we update the brushes, check the wAttrs to see if the LVB_UNDERSCORE
-    //      flag is there. If the state of that flag is different then our
-    //      current state, change the underlining state.
-    // We have to do this here, instead of in PaintBufferGridLines, because
-    //      we'll have already painted the text by the time PaintBufferGridLines
-    //      is called.
-    RETURN_IF_FAILED(_UpdateUnderline(legacyColorAttribute));
-
-    return VtEngine::_RgbUpdateDrawingBrushes(colorForeground,
-                                              colorBackground,
-                                              isBold,
-                                              _ColorTable,
-                                              _cColorTable);
+    // We check the wAttrs to see if the LVB_UNDERSCORE flag is there here,
+    //      instead of in PaintBufferGridLines, because we'll have already
+    //      painted the text by the time PaintBufferGridLines is called.
+    const bool isUnderlined = WI_IsFlagSet(legacyColorAttribute, COMMON_LVB_UNDERSCORE);
+
+    return _UpdateGraphicsRendition(colorForeground, colorBackground, isBold, isUnderlined);
+}
+
+// Routine Description:
+// - Computes the shortest SGR sequence that transitions the terminal from the
+//      attributes we last emitted to the requested ones, and writes it.
+// - There are two ways to get there: change only the attributes that differ,
+//      or reset everything with SGR 0 and then set every non-default
+//      attribute. We build both and write whichever is shorter.
+// Arguments:
+// - colorForeground: The RGB Color to use to paint the foreground text.
+// - colorBackground: The RGB Color to use to paint the background of the text.
+// - isBold: Whether the text should be bold.
+// - isUnderlined: Whether the text should be underlined.
+// Return Value:
+// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
+[[nodiscard]]
+HRESULT Xterm256Engine::_UpdateGraphicsRendition(const COLORREF colorForeground,
+                                                 const COLORREF colorBackground,
+                                                 const bool isBold,
+                                                 const bool isUnderlined) noexcept
+{
+    const bool fgChanged = colorForeground != _LastFG;
+    const bool bgChanged = colorBackground != _LastBG;
+    const bool boldChanged = isBold != _lastWasBold;
+    const bool underlineChanged = isUnderlined != _usingUnderLine;
+
+    if (!(fgChanged || bgChanged || boldChanged || underlineChanged))
+    {
+        return S_OK;
+    }
+
+    try
+    {
+        const bool fgIsDefault = colorForeground == _colorProvider.GetDefaultForeground();
+        const bool bgIsDefault = colorBackground == _colorProvider.GetDefaultBackground();
+
+        // Option 1: Only change what's different.
+        std::string delta;
+        if (boldChanged)
+        {
+            s_AppendParameter(delta, isBold ? "1" : "22");
+        }
+        if (underlineChanged)
+        {
+            s_AppendParameter(delta, isUnderlined ? "4" : "24");
+        }
+        if (fgChanged)
+        {
+            _AppendColorParameters(delta, colorForeground, true);
+        }
+        if (bgChanged)
+        {
+            _AppendColorParameters(delta, colorBackground, false);
+        }
+
+        // Option 2: Reset, then set whatever isn't the default. A reset with no
+        //      other parameters can be written as just "\x1b[m".
+        std::string reset;
+        if (isBold)
+        {
+            s_AppendParameter(reset, "1");
+        }
+        if (isUnderlined)
+        {
+            s_AppendParameter(reset, "4");
+        }
+        if (!fgIsDefault)
+        {
+            _AppendColorParameters(reset, colorForeground, true);
+        }
+        if (!bgIsDefault)
+        {
+            _AppendColorParameters(reset, colorBackground, false);
+        }
+        if (!reset.empty())
+        {
+            reset.insert(0, "0;");
+        }
+
+        const std::string& params = reset.size() < delta.size() ? reset : delta;
+
+        std::string sequence;
+        sequence.reserve(params.size() + 3);
+        sequence.append("\x1b[");
+        sequence.append(params);
+        sequence.append("m");
+
+        RETURN_IF_FAILED(_Write(sequence));
+
+        _LastFG = colorForeground;
+        _LastBG = colorBackground;
+        _lastWasBold = isBold;
+        _usingUnderLine = isUnderlined;
+
+        return S_OK;
+    }
+    CATCH_RETURN();
+}
+
+// Routine Description:
+// - Appends the SGR parameters for the given color, using the shortest
+//      encoding that exactly represents it:
+//   - 39/49 for the default color,
+//   - 30-37, 90-97 (40-47, 100-107) for an entry in the 16 color table,
+//   - 38;5;n (48;5;n) for an entry in the xterm 256 color cube or gray ramp,
+//   - 38;2;r;g;b (48;2;r;g;b) for anything else.
+// Arguments:
+// - params: The parameter string to append to.
+// - color: The color to encode.
+// - fIsForeground: true to encode a foreground color, false for background.
+// Return Value:
+// - <none>
+void Xterm256Engine::_AppendColorParameters(std::string& params,
+                                            const COLORREF color,
+                                            const bool fIsForeground) const
+{
+    const COLORREF defaultColor = fIsForeground ? _colorProvider.GetDefaultForeground() : _colorProvider.GetDefaultBackground();
+    if (color == defaultColor)
+    {
+        s_AppendParameter(params, fIsForeground ? "39" : "49");
+        return;
+    }
+
+    WORD wFoundColor = 0;
+    if (::FindTableIndex(color, _ColorTable, _cColorTable, &wFoundColor))
+    {
+        // Always check using the foreground flags, because the bg flags constants
+        //  are a higher byte. See also VtEngine::_SetGraphicsRendition16Color.
+        const int vtIndex = 30
+                            + (fIsForeground ? 0 : 10)
+                            + (WI_IsFlagSet(wFoundColor, FOREGROUND_INTENSITY) ? 60 : 0)
+                            + (WI_IsFlagSet(wFoundColor, FOREGROUND_RED) ? 1 : 0)
+                            + (WI_IsFlagSet(wFoundColor, FOREGROUND_GREEN) ? 2 : 0)
+                            + (WI_IsFlagSet(wFoundColor, FOREGROUND_BLUE) ? 4 : 0);
+        s_AppendParameter(params, std::to_string(vtIndex));
+        return;
+    }
+
+    BYTE index = 0;
+    if (s_FindXterm256Index(color, &index))
+    {
+        s_AppendParameter(params, fIsForeground ? "38;5;" : "48;5;");
+        params.append(std::to_string(index));
+        return;
+    }
+
+    s_AppendParameter(params, fIsForeground ? "38;2;" : "48;2;");
+    params.append(std::to_string(GetRValue(color)));
+    params.append(";");
+    params.append(std::to_string(GetGValue(color)));
+    params.append(";");
+    params.append(std::to_string(GetBValue(color)));
+}
+
+// Routine Description:
+// - Appends a parameter to a list of SGR parameters, separating it from any
+//      previous ones.
+// Arguments:
+// - params: The parameter string to append to.
+// - param: The parameter to append.
+// Return Value:
+// - <none>
+void Xterm256Engine::s_AppendParameter(std::string& params, const std::string_view param)
+{
+    if (!params.empty())
+    {
+        params.append(";");
+    }
+    params.append(param);
+}
+
+// Routine Description:
+// - Finds the index of the given color in the fixed part (16-255) of the xterm
+//      256 color palette: the 6x6x6 color cube and the 24 step gray ramp.
+// Arguments:
+// - color: The color to look for.
+// - pIndex: Receives the palette index if the color was found.
+// Return Value:
+// - true if the color exactly matches a palette entry.
+bool Xterm256Engine::s_FindXterm256Index(const COLORREF color,
+                                         _Out_ BYTE* const pIndex) noexcept
+{
+    *pIndex = 0;
+
+    const BYTE r = GetRValue(color);
+    const BYTE g = GetGValue(color);
+    const BYTE b = GetBValue(color);
+
+    // The color cube uses the levels 0, 95, 135, 175, 215, 255.
+    const auto cubeLevel = [](const BYTE value) -> int {
+        if (value == 0)
+        {
+            return 0;
+        }
+        if (value >= 95 && (value - 95) % 40 == 0)
+        {
+            return 1 + (value - 95) / 40;
+        }
+        return -1;
+    };
+
+    const int rLevel = cubeLevel(r);
+    const int gLevel = cubeLevel(g);
+    const int bLevel = cubeLevel(b);
+    if (rLevel >= 0 && gLevel >= 0 && bLevel >= 0)
+    {
+        *pIndex = static_cast<BYTE>(16 + (36 * rLevel) + (6 * gLevel) + bLevel);
+        return true;
+    }
+
+    // The gray ramp goes from 8 to 238 in steps of 10.
+    if (r == g && g == b && r >= 8 && r <= 238 && (r - 8) % 10 == 0)
+    {
+        *pIndex = static_cast<BYTE>(232 + (r - 8) / 10);
+        return true;
+    }
+
+    return false;
 }
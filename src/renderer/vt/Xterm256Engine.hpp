@@ -39,6 +39,20 @@ namespace Microsoft::Console::Render
                                     const bool isSettingDefaultBrushes) noexcept override;
 
     private:
+        [[nodiscard]]
+        HRESULT _UpdateGraphicsRendition(const COLORREF colorForeground,
+                                         const COLORREF colorBackground,
+                                         const bool isBold,
+                                         const bool isUnderlined) noexcept;
+
+        void _AppendColorParameters(std::string& params,
+                                    const COLORREF color,
+                                    const bool fIsForeground) const;
+
+        static void s_AppendParameter(std::string& params, const std::string_view param);
+
+        static bool s_FindXterm256Index(const COLORREF color,
+                                        _Out_ BYTE* const pIndex) noexcept;
 
     #ifdef UNIT_TESTING
         friend class VtRendererTest;
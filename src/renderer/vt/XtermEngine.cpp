@@ -280,6 +280,8 @@ HRESULT XtermEngine::_MoveCursor(COORD const coord) noexcept
 [[nodiscard]]
 HRESULT XtermEngine::ScrollFrame() noexcept
 {
+    RETURN_IF_FAILED(_ScrollRegions());
+
     if (_scrollDelta.X != 0)
     {
         // No easy way to shift left-right. Everything needs repainting.
@@ -328,6 +330,119 @@ HRESULT XtermEngine::ScrollFrame() noexcept
     return hr;
 }
 
+// Routine Description:
+// - Replays the scrolls of bands of rows that happened this frame on the
+//      terminal. For each one, we set the scrolling margins to the band, then
+//      scroll the margins up or down. This moves the text the terminal already
+//      has, instead of us repainting all of it. Only the rows uncovered by each
+//      scroll were invalidated, and those will later be written by
+//      PaintBufferLine.
+// - If the whole viewport is going to be repainted anyways, we skip this.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
+[[nodiscard]]
+HRESULT XtermEngine::_ScrollRegions() noexcept
+{
+    if (_regionScrolls.empty())
+    {
+        return S_OK;
+    }
+
+    if (!_AllIsInvalid())
+    {
+        for (const auto& [region, dy] : _regionScrolls)
+        {
+            RETURN_IF_FAILED(_SetScrollingRegion(region.Top, region.Bottom - 1));
+            RETURN_IF_FAILED(_ScrollUpDown(static_cast<short>(abs(dy)), dy < 0));
+        }
+        RETURN_IF_FAILED(_ResetScrollingRegion());
+
+        // Setting (and resetting) the margins moves the cursor home.
+        _lastText = { 0, 0 };
+        _previousLineWrapped = false;
+        _needToDisableCursor = true;
+    }
+
+    _regionScrolls.clear();
+    return S_OK;
+}
+
+// Routine Description:
+// - Notifies us that the contents of a band of rows moved up or down by sDelta
+//      rows. If the band spans the whole width of the viewport, we can replay
+//      it on the terminal with the scrolling margins (see _ScrollRegions).
+//      Anything already invalid within the band moves along with the text. The
+//      rows uncovered by the move are invalidated separately by the caller.
+// - Otherwise, we invalidate the whole band, as the base implementation would.
+// Arguments:
+// - psrRegion - The band of rows (relative to the viewport, exclusive) that moved.
+// - sDelta - The number of rows the contents moved. Negative is up.
+// Return Value:
+// - S_OK if we succeeded, else an appropriate HRESULT for failing to invalidate.
+[[nodiscard]]
+HRESULT XtermEngine::InvalidateScrollRegion(const SMALL_RECT* const psrRegion, const short sDelta) noexcept
+{
+    const SMALL_RECT view = _lastViewport.ToOrigin().ToExclusive();
+    const SMALL_RECT region = *psrRegion;
+    const short height = region.Bottom - region.Top;
+
+    const bool canScroll = sDelta != 0 &&
+                           abs(sDelta) < height &&
+                           region.Left == view.Left &&
+                           region.Right == view.Right &&
+                           region.Top >= view.Top &&
+                           region.Bottom <= view.Bottom &&
+                           _scrollDelta.X == 0 &&
+                           _scrollDelta.Y == 0 &&
+                           _regionScrolls.size() < s_MaxRegionScrollsPerFrame;
+    if (!canScroll)
+    {
+        return Invalidate(psrRegion);
+    }
+
+    try
+    {
+        // Whatever was waiting to be painted within the band now lives sDelta
+        //      rows away. Keep both, since we only track a single rectangle.
+        if (_fInvalidRectUsed)
+        {
+            const auto regionView = Viewport::FromExclusive(region);
+            const auto pending = Viewport::Intersect(_invalidRect, regionView);
+            if (pending.IsValid())
+            {
+                SMALL_RECT moved = pending.ToExclusive();
+                moved.Top = std::clamp<short>(moved.Top + sDelta, region.Top, region.Bottom);
+                moved.Bottom = std::clamp<short>(moved.Bottom + sDelta, region.Top, region.Bottom);
+                if (moved.Bottom > moved.Top)
+                {
+                    RETURN_IF_FAILED(_InvalidCombine(Viewport::FromExclusive(moved)));
+                }
+            }
+        }
+
+        // Consecutive scrolls of the same band in the same direction can be
+        //      sent as one.
+        if (!_regionScrolls.empty())
+        {
+            auto& [lastRegion, lastDelta] = _regionScrolls.back();
+            const bool sameRegion = lastRegion.Top == region.Top && lastRegion.Bottom == region.Bottom;
+            const bool sameDirection = (lastDelta < 0) == (sDelta < 0);
+            if (sameRegion && sameDirection && abs(lastDelta + sDelta) < height)
+            {
+                lastDelta += sDelta;
+                return S_OK;
+            }
+        }
+
+        _regionScrolls.emplace_back(region, sDelta);
+    }
+    CATCH_RETURN();
+
+    return S_OK;
+}
+
 // Routine Description:
 // - Notifies us that the console is attempting to scroll the existing screen
 //      area. Add the top or bottom rows to the invalid region, and update the
@@ -345,6 +460,14 @@ HRESULT XtermEngine::InvalidateScroll(const COORD* const pcoordDelta) noexcept
 
     if (dx != 0 || dy != 0)
     {
+        // We can't mix scrolling the bands of rows with scrolling the whole
+        //      viewport in one frame. Repaint those bands instead.
+        for (const auto& [region, regionDelta] : _regionScrolls)
+        {
+            RETURN_IF_FAILED(_InvalidCombine(Viewport::FromExclusive(region)));
+        }
+        _regionScrolls.clear();
+
         // Scroll the current offset
         RETURN_IF_FAILED(_InvalidOffset(pcoordDelta));
 
@@ -405,6 +528,7 @@ HRESULT XtermEngine::PaintBufferLine(std::basic_string_view<Cluster> const clust
 [[nodiscard]]
 HRESULT XtermEngine::WriteTerminalW(const std::wstring& wstr) noexcept
 {
+    std::lock_guard<std::recursive_mutex> lock(_engineLock);
     return _fUseAsciiOnly ?
         VtEngine::_WriteTerminalAscii(wstr) :
         VtEngine::_WriteTerminalUtf8(wstr);
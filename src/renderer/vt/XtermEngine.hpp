@@ -56,11 +56,17 @@ namespace Microsoft::Console::Render
 
         [[nodiscard]]
         HRESULT InvalidateScroll(const COORD* const pcoordDelta) noexcept override;
+        [[nodiscard]]
+        HRESULT InvalidateScrollRegion(const SMALL_RECT* const psrRegion, const short sDelta) noexcept override;
 
         [[nodiscard]]
         HRESULT WriteTerminalW(_In_ const std::wstring& str) noexcept override;
 
     protected:
+        // Past this many scrolled regions in a single frame, it's cheaper to
+        //      just repaint the affected rows.
+        static constexpr size_t s_MaxRegionScrollsPerFrame = 8;
+
         const COLORREF* const _ColorTable;
         const WORD _cColorTable;
         const bool _fUseAsciiOnly;
@@ -74,6 +80,9 @@ namespace Microsoft::Console::Render
         [[nodiscard]]
         HRESULT _UpdateUnderline(const WORD wLegacyAttrs) noexcept;
 
+        [[nodiscard]]
+        HRESULT _ScrollRegions() noexcept;
+
         [[nodiscard]]
         HRESULT _DoUpdateTitle(const std::wstring& newTitle) noexcept override;
 
@@ -23,12 +23,15 @@ HRESULT VtEngine::StartPaint() noexcept
 {
     if (_pipeBroken)
     {
+        // The renderer holds the console lock while starting the frame.
+        _CloseOutputIfBroken();
         return S_FALSE;
     }
 
     // If there's nothing to do, quick return
     bool somethingToDo = _fInvalidRectUsed ||
         (_scrollDelta.X != 0 || _scrollDelta.Y != 0) ||
+        !_regionScrolls.empty() ||
         _cursorMoved ||
         _titleChanged;
 
@@ -55,6 +58,7 @@ HRESULT VtEngine::EndPaint() noexcept
     _invalidRect = Viewport::Empty();
     _fInvalidRectUsed = false;
     _scrollDelta = {0};
+    _regionScrolls.clear();
     _clearedAllThisFrame = false;
     _cursorMoved = false;
     _firstPaint = false;
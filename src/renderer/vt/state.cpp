@@ -111,12 +111,11 @@ HRESULT VtEngine::_Flush() noexcept
         _buffer.clear();
         if (!fSuccess)
         {
+            // Our owner is told about this by _CloseOutputIfBroken, once we're
+            //      somewhere the console lock is held. The renderer doesn't hold
+            //      it while the frame is painted.
             _exitResult = HRESULT_FROM_WIN32(GetLastError());
             _pipeBroken = true;
-            if (_terminalOwner)
-            {
-                _terminalOwner->CloseOutput();
-            }
             return _exitResult;
         }
     }
@@ -129,6 +128,7 @@ HRESULT VtEngine::_Flush() noexcept
 [[nodiscard]]
 HRESULT VtEngine::WriteTerminalUtf8(const std::string& str) noexcept
 {
+    std::lock_guard<std::recursive_mutex> lock(_engineLock);
     return _Write(str);
 }
 
@@ -390,6 +390,7 @@ bool VtEngine::_AllIsInvalid() const
 [[nodiscard]]
 HRESULT VtEngine::SuppressResizeRepaint() noexcept
 {
+    std::lock_guard<std::recursive_mutex> lock(_engineLock);
     _suppressResizeRepaint = true;
     return S_OK;
 }
@@ -407,6 +408,7 @@ HRESULT VtEngine::SuppressResizeRepaint() noexcept
 [[nodiscard]]
 HRESULT VtEngine::InheritCursor(const COORD coordCursor) noexcept
 {
+    std::lock_guard<std::recursive_mutex> lock(_engineLock);
     _virtualTop = coordCursor.Y;
     _lastText = coordCursor;
     _skipCursor = true;
@@ -430,7 +432,27 @@ void VtEngine::SetTerminalOwner(Microsoft::Console::ITerminalOwner* const termin
 // - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
 HRESULT VtEngine::RequestCursor() noexcept
 {
+    std::lock_guard<std::recursive_mutex> lock(_engineLock);
+    auto closeOutput = wil::scope_exit([&]() {
+        _CloseOutputIfBroken();
+    });
     RETURN_IF_FAILED(_RequestCursor());
     RETURN_IF_FAILED(_Flush());
     return S_OK;
 }
+
+// Method Description:
+// - Lets our owner know that the pipe to the terminal broke, the first time
+//      we're called after it did. This has to be called with the console lock
+//      held, as the owner will lock it to shut the console down.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::_CloseOutputIfBroken() noexcept
+{
+    if (_pipeBroken && _terminalOwner)
+    {
+        std::exchange(_terminalOwner, nullptr)->CloseOutput();
+    }
+}
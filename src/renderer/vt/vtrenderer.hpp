@@ -142,6 +142,11 @@ namespace Microsoft::Console::Render
         COORD _lastText;
         COORD _scrollDelta;
 
+        // Scrolls of a band of rows (the full width of the viewport) that
+        //      happened this frame, in order. Each is the exclusive region
+        //      (relative to the viewport origin) and the number of rows moved.
+        std::vector<std::pair<SMALL_RECT, short>> _regionScrolls;
+
         bool _quickReturn;
         bool _clearedAllThisFrame;
         bool _cursorMoved;
@@ -168,6 +173,7 @@ namespace Microsoft::Console::Render
         HRESULT _WriteFormattedString(const std::string* const pFormat, ...) noexcept;
         [[nodiscard]]
         HRESULT _Flush() noexcept;
+        void _CloseOutputIfBroken() noexcept;
 
         void _OrRect(_Inout_ SMALL_RECT* const pRectExisting, const SMALL_RECT* const pRectToOr) const;
         [[nodiscard]]
@@ -195,6 +201,12 @@ namespace Microsoft::Console::Render
         [[nodiscard]]
         HRESULT _InsertLine(const short sLines) noexcept;
         [[nodiscard]]
+        HRESULT _ScrollUpDown(const short sLines, const bool fScrollUp) noexcept;
+        [[nodiscard]]
+        HRESULT _SetScrollingRegion(const short sTop, const short sBottom) noexcept;
+        [[nodiscard]]
+        HRESULT _ResetScrollingRegion() noexcept;
+        [[nodiscard]]
         HRESULT _CursorForward(const short chars) noexcept;
         [[nodiscard]]
         HRESULT _EraseCharacter(const short chars) noexcept;
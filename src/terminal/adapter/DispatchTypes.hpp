@@ -89,7 +89,25 @@ namespace Microsoft::Console::VirtualTerminal::DispatchTypes
     enum VTCharacterSets : wchar_t
     {
         DEC_LineDrawing = L'0',
-        USASCII = L'B'
+        USASCII = L'B',
+        // National Replacement Character Sets
+        British = L'A',
+        Dutch = L'4',
+        Finnish = L'C',
+        Finnish2 = L'5',
+        French = L'R',
+        French2 = L'f',
+        FrenchCanadian = L'Q',
+        FrenchCanadian2 = L'9',
+        German = L'K',
+        Italian = L'Y',
+        NorwegianDanish = L'E',
+        NorwegianDanish2 = L'6',
+        NorwegianDanish3 = L'`',
+        Spanish = L'Z',
+        Swedish = L'H',
+        Swedish2 = L'7',
+        Swiss = L'='
     };
 
     enum TabClearType : unsigned short
@@ -25,12 +25,14 @@ namespace Microsoft::Console::VirtualTerminal
     public:
         virtual ~IInteractDispatch() = default;
 
-        virtual bool WriteInput(_In_ std::deque<std::unique_ptr<IInputEvent>>& inputEvents) = 0;
+        virtual bool WriteInput(const gsl::span<const INPUT_RECORD> inputRecords) = 0;
 
         virtual bool WriteCtrlC() = 0;
 
         virtual bool WriteString(_In_reads_(cch) const wchar_t* const pws, const size_t cch) = 0;
 
+        virtual bool WriteTextRun(_In_reads_(cch) const wchar_t* const pws, const size_t cch) = 0;
+
         virtual bool WindowManipulation(const DispatchTypes::WindowManipulationType uiFunction,
                                         _In_reads_(cParams) const unsigned short* const rgusParams,
                                         const size_t cParams) = 0;
@@ -82,7 +82,9 @@ public:
     virtual bool DeviceStatusReport(const DispatchTypes::AnsiStatusType statusType) = 0; // DSR
     virtual bool DeviceAttributes() = 0; // DA
 
-    virtual bool DesignateCharset(const wchar_t wchCharset) = 0; // DesignateCharset
+    virtual bool DesignateCharset(const size_t gsetNumber, const wchar_t wchCharset) = 0; // DesignateCharset
+    virtual bool LockingShift(const size_t gsetNumber) = 0; // SI, SO, LS2, LS3
+    virtual bool SingleShift(const size_t gsetNumber) = 0; // SS2, SS3
 
     virtual bool SoftReset() = 0; // DECSTR
     virtual bool HardReset() = 0; // RIS
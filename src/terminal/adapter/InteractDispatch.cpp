@@ -26,14 +26,16 @@ InteractDispatch::InteractDispatch(ConGetSet* const pConApi)
 //  If Ctrl+C is written with this function, it will not trigger a Ctrl-C
 //      interrupt in the client, but instead write a Ctrl+C to the input buffer
 //      to be read by the client.
+//  The input is posted, rather than written: it's handed to readers along with
+//      the rest of the input from the same sequence of characters, once the
+//      host is done with all of it.
 // Arguments:
-// - inputEvents: a collection of IInputEvents
+// - inputRecords: a collection of INPUT_RECORDs
 // Return Value:
 // True if handled successfully. False otherwise.
-bool InteractDispatch::WriteInput(_In_ std::deque<std::unique_ptr<IInputEvent>>& inputEvents)
+bool InteractDispatch::WriteInput(const gsl::span<const INPUT_RECORD> inputRecords)
 {
-    size_t dwWritten = 0;
-    return !!_pConApi->PrivateWriteConsoleInputW(inputEvents, dwWritten);
+    return !!_pConApi->PrivatePostConsoleInput(inputRecords);
 }
 
 // Method Description:
@@ -70,22 +72,45 @@ bool InteractDispatch::WriteString(_In_reads_(cch) const wchar_t* const pws,
     bool fSuccess = !!_pConApi->GetConsoleOutputCP(&codepage);
     if (fSuccess)
     {
-        std::deque<std::unique_ptr<IInputEvent>> keyEvents;
+        std::vector<INPUT_RECORD> keyRecords;
+        keyRecords.reserve(cch * 2);
 
         for (size_t i = 0; i < cch; ++i)
         {
             std::deque<std::unique_ptr<KeyEvent>> convertedEvents = CharToKeyEvents(pws[i], codepage);
 
-            std::move(convertedEvents.begin(),
-                      convertedEvents.end(),
-                      std::back_inserter(keyEvents));
+            for (const auto& keyEvent : convertedEvents)
+            {
+                keyRecords.push_back(keyEvent->ToInputRecord());
+            }
         }
 
-        fSuccess = WriteInput(keyEvents);
+        fSuccess = WriteInput(keyRecords);
     }
     return fSuccess;
 }
 
+// Method Description:
+// - Writes a run of pasted text to the host. Unlike WriteString, the text is
+//      stored as it is, and is only converted to keystrokes if a client reads
+//      it back as input records.
+// Arguments:
+// - pws: a string to write to the console.
+// - cch: the number of chars in pws.
+// Return Value:
+// True if handled successfully. False otherwise.
+bool InteractDispatch::WriteTextRun(_In_reads_(cch) const wchar_t* const pws,
+                                    const size_t cch)
+{
+    if (cch == 0)
+    {
+        return true;
+    }
+
+    size_t written = 0;
+    return !!_pConApi->PrivateWriteConsoleInputText({ pws, cch }, written);
+}
+
 //Method Description:
 // Window Manipulation - Performs a variety of actions relating to the window,
 //      such as moving the window position, resizing the window, querying
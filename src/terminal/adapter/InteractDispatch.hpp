@@ -28,9 +28,10 @@ namespace Microsoft::Console::VirtualTerminal
 
         virtual ~InteractDispatch() override = default;
 
-        virtual bool WriteInput(_In_ std::deque<std::unique_ptr<IInputEvent>>& inputEvents) override;
+        virtual bool WriteInput(const gsl::span<const INPUT_RECORD> inputRecords) override;
         virtual bool WriteCtrlC() override;
         virtual bool WriteString(_In_reads_(cch) const wchar_t* const pws, const size_t cch) override;
+        virtual bool WriteTextRun(_In_reads_(cch) const wchar_t* const pws, const size_t cch) override;
         virtual bool WindowManipulation(const DispatchTypes::WindowManipulationType uiFunction,
                                         _In_reads_(cParams) const unsigned short* const rgusParams,
                                         const size_t cParams) override; // DTTERM_WindowManipulation
@@ -36,7 +36,6 @@ AdaptDispatch::AdaptDispatch(ConGetSet* const pConApi,
     // The top-left corner in VT-speak is 1,1. Our internal array uses 0 indexes, but VT uses 1,1 for top left corner.
     _coordSavedCursor.X = 1;
     _coordSavedCursor.Y = 1;
-    _srScrollMargins = {0}; // initially, there are no scroll margins.
     _fIsSetColumnsEnabled = false; // by default, DECSCPP is disabled.
     // TODO:10086990 - Create a setting to re-enable this.
 
@@ -53,12 +52,10 @@ void AdaptDispatch::PrintString(const wchar_t* const rgwch, const size_t cch)
     {
         if (_TermOutput.NeedToTranslate())
         {
-            std::unique_ptr<wchar_t[]> tempArray = std::make_unique<wchar_t[]>(cch);
-            for (size_t i = 0; i < cch; i++)
-            {
-                tempArray[i] = _TermOutput.TranslateKey(rgwch[i]);
-            }
-            _pDefaults->PrintString(tempArray.get(), cch);
+            // This is either the original string, if nothing in it needs to
+            //      change, or a buffer owned by _TermOutput.
+            const std::wstring_view translated = _TermOutput.TranslateString({ rgwch, cch });
+            _pDefaults->PrintString(translated.data(), translated.size());
         }
         else
         {
@@ -79,22 +76,21 @@ void AdaptDispatch::PrintString(const wchar_t* const rgwch, const size_t cch)
 bool AdaptDispatch::_CursorMovement(const CursorDirection dir, _In_ unsigned int const uiDistance) const
 {
     // First retrieve some information about the buffer
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    ScreenBufferState state = { 0 };
     // Make sure to reset the viewport (with MoveToBottom )to where it was
     //      before the user scrolled the console output
-    bool fSuccess = !!(_conApi->MoveToBottom() && _conApi->GetConsoleScreenBufferInfoEx(&csbiex));
+    bool fSuccess = !!(_conApi->MoveToBottom() && _conApi->PrivateGetScreenBufferState(&state));
 
     if (fSuccess)
     {
-        COORD coordCursor = csbiex.dwCursorPosition;
+        COORD coordCursor = state.dwCursorPosition;
 
         // For next/previous line, we unconditionally need to move the X position to the left edge of the viewport.
         switch (dir)
         {
         case CursorDirection::NextLine:
         case CursorDirection::PrevLine:
-            coordCursor.X = csbiex.srWindow.Left;
+            coordCursor.X = state.srWindow.Left;
             break;
         }
 
@@ -131,17 +127,17 @@ bool AdaptDispatch::_CursorMovement(const CursorDirection dir, _In_ unsigned int
             {
             case CursorDirection::Up:
             case CursorDirection::PrevLine:
-                sBoundaryVal = csbiex.srWindow.Top;
+                sBoundaryVal = state.srWindow.Top;
                 break;
             case CursorDirection::Down:
             case CursorDirection::NextLine:
-                sBoundaryVal = csbiex.srWindow.Bottom;
+                sBoundaryVal = state.srWindow.Bottom;
                 break;
             case CursorDirection::Left:
-                sBoundaryVal = csbiex.srWindow.Left;
+                sBoundaryVal = state.srWindow.Left;
                 break;
             case CursorDirection::Right:
-                sBoundaryVal = csbiex.srWindow.Right;
+                sBoundaryVal = state.srWindow.Right;
                 break;
             default:
                 fSuccess = false;
@@ -301,11 +297,10 @@ bool AdaptDispatch::_CursorMovePosition(_In_opt_ const unsigned int* const puiRo
     bool fSuccess = true;
 
     // First retrieve some information about the buffer
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    ScreenBufferState state = { 0 };
     // Make sure to reset the viewport (with MoveToBottom )to where it was
     //      before the user scrolled the console output
-    fSuccess = !!(_conApi->MoveToBottom() && _conApi->GetConsoleScreenBufferInfoEx(&csbiex));
+    fSuccess = !!(_conApi->MoveToBottom() && _conApi->PrivateGetScreenBufferState(&state));
 
     if (fSuccess)
     {
@@ -326,7 +321,7 @@ bool AdaptDispatch::_CursorMovePosition(_In_opt_ const unsigned int* const puiRo
         }
         else
         {
-            uiRow = csbiex.dwCursorPosition.Y - csbiex.srWindow.Top; // remember, in VT speak, this is relative to the viewport. not absolute.
+            uiRow = state.dwCursorPosition.Y - state.srWindow.Top; // remember, in VT speak, this is relative to the viewport. not absolute.
         }
 
         if (puiCol != nullptr)
@@ -342,12 +337,12 @@ bool AdaptDispatch::_CursorMovePosition(_In_opt_ const unsigned int* const puiRo
         }
         else
         {
-            uiCol = csbiex.dwCursorPosition.X - csbiex.srWindow.Left; // remember, in VT speak, this is relative to the viewport. not absolute.
+            uiCol = state.dwCursorPosition.X - state.srWindow.Left; // remember, in VT speak, this is relative to the viewport. not absolute.
         }
 
         if (fSuccess)
         {
-            COORD coordCursor = csbiex.dwCursorPosition;
+            COORD coordCursor = state.dwCursorPosition;
 
             // Safely convert the UINT positions we were given into shorts (which is the size the console deals with)
             fSuccess = SUCCEEDED(UIntToShort(uiRow, &coordCursor.Y)) && SUCCEEDED(UIntToShort(uiCol, &coordCursor.X));
@@ -355,14 +350,14 @@ bool AdaptDispatch::_CursorMovePosition(_In_opt_ const unsigned int* const puiRo
             if (fSuccess)
             {
                 // Set the line and column values as offsets from the viewport edge. Use safe math to prevent overflow.
-                fSuccess = SUCCEEDED(ShortAdd(coordCursor.Y, csbiex.srWindow.Top, &coordCursor.Y)) &&
-                    SUCCEEDED(ShortAdd(coordCursor.X, csbiex.srWindow.Left, &coordCursor.X));
+                fSuccess = SUCCEEDED(ShortAdd(coordCursor.Y, state.srWindow.Top, &coordCursor.Y)) &&
+                    SUCCEEDED(ShortAdd(coordCursor.X, state.srWindow.Left, &coordCursor.X));
 
                 if (fSuccess)
                 {
                     // Apply boundary tests to ensure the cursor isn't outside the viewport rectangle.
-                    coordCursor.Y = std::clamp(coordCursor.Y, csbiex.srWindow.Top, gsl::narrow<SHORT>(csbiex.srWindow.Bottom - 1));
-                    coordCursor.X = std::clamp(coordCursor.X, csbiex.srWindow.Left, gsl::narrow<SHORT>(csbiex.srWindow.Right - 1));
+                    coordCursor.Y = std::clamp(coordCursor.Y, state.srWindow.Top, gsl::narrow<SHORT>(state.srWindow.Bottom - 1));
+                    coordCursor.X = std::clamp(coordCursor.X, state.srWindow.Left, gsl::narrow<SHORT>(state.srWindow.Right - 1));
 
                     // Finally, attempt to set the adjusted cursor position back into the console.
                     fSuccess = !!_conApi->SetConsoleCursorPosition(coordCursor);
@@ -417,19 +412,18 @@ bool AdaptDispatch::CursorPosition(_In_ unsigned int const uiLine, _In_ unsigned
 bool AdaptDispatch::CursorSavePosition()
 {
     // First retrieve some information about the buffer
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    ScreenBufferState state = { 0 };
     // Make sure to reset the viewport (with MoveToBottom )to where it was
     //      before the user scrolled the console output
-    bool fSuccess = !!(_conApi->MoveToBottom() && _conApi->GetConsoleScreenBufferInfoEx(&csbiex));
+    bool fSuccess = !!(_conApi->MoveToBottom() && _conApi->PrivateGetScreenBufferState(&state));
 
     if (fSuccess)
     {
         // The cursor is given to us by the API as relative to the whole buffer.
         // But in VT speak, the cursor should be relative to the current viewport. Adjust.
-        COORD const coordCursor = csbiex.dwCursorPosition;
+        COORD const coordCursor = state.dwCursorPosition;
 
-        SMALL_RECT const srViewport = csbiex.srWindow;
+        SMALL_RECT const srViewport = state.srWindow;
 
         // VT is also 1 based, not 0 based, so correct by 1.
         _coordSavedCursor.X = coordCursor.X - srViewport.Left + 1;
@@ -482,15 +476,14 @@ bool AdaptDispatch::_InsertDeleteHelper(_In_ unsigned int const uiCount, const b
     RETURN_IF_FALSE(SUCCEEDED(UIntToShort(uiCount, &sDistance)));
 
     // get current cursor, viewport
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    ScreenBufferState state = { 0 };
     // Make sure to reset the viewport (with MoveToBottom )to where it was
     //      before the user scrolled the console output
     RETURN_IF_FALSE(_conApi->MoveToBottom());
-    RETURN_IF_FALSE(_conApi->GetConsoleScreenBufferInfoEx(&csbiex));
+    RETURN_IF_FALSE(_conApi->PrivateGetScreenBufferState(&state));
 
-    const auto cursor = csbiex.dwCursorPosition;
-    const auto viewport = Viewport::FromExclusive(csbiex.srWindow);
+    const auto cursor = state.dwCursorPosition;
+    const auto viewport = Viewport::FromExclusive(state.srWindow);
     // Rectangle to cut out of the existing buffer
     SMALL_RECT srScroll;
     srScroll.Left = cursor.X;
@@ -505,7 +498,7 @@ bool AdaptDispatch::_InsertDeleteHelper(_In_ unsigned int const uiCount, const b
 
     // Fill character for remaining space left behind by "cut" operation (or for fill if we "cut" the entire line)
     CHAR_INFO ciFill;
-    ciFill.Attributes = csbiex.wAttributes;
+    ciFill.Attributes = state.wAttributes;
     ciFill.Char.UnicodeChar = L' ';
 
     bool fSuccess = false;
@@ -547,7 +540,7 @@ bool AdaptDispatch::_InsertDeleteHelper(_In_ unsigned int const uiCount, const b
         {
             // clip inside the viewport.
             fSuccess = !!_conApi->ScrollConsoleScreenBufferW(&srScroll,
-                                                             &csbiex.srWindow,
+                                                             &state.srWindow,
                                                              coordDestination,
                                                              &ciFill);
 
@@ -637,53 +630,51 @@ bool AdaptDispatch::_EraseSingleLineDistanceHelper(const COORD coordStartPositio
 {
     WCHAR const wchSpace = static_cast<WCHAR>(0x20); // space character. use 0x20 instead of literal space because we can't assume the compiler will always turn ' ' into 0x20.
 
-    size_t written = 0;
-    bool fSuccess = !!_conApi->FillConsoleOutputCharacterW(wchSpace, dwLength, coordStartPosition, written);
+    SMALL_RECT srFill;
+    srFill.Left = coordStartPosition.X;
+    srFill.Top = coordStartPosition.Y;
+    srFill.Right = gsl::narrow<SHORT>(coordStartPosition.X + static_cast<int>(dwLength) - 1); // The fill rectangle is inclusive.
+    srFill.Bottom = coordStartPosition.Y;
 
-    if (fSuccess)
-    {
-        fSuccess = !!_conApi->FillConsoleOutputAttribute(wFillColor, dwLength, coordStartPosition, written);
-    }
-
-    return fSuccess;
+    return !!_conApi->PrivateFillRect(&srFill, wchSpace, wFillColor);
 }
 
+// Routine Description:
+// - Internal helper to erase a rectangular area of the buffer.
+//     Erased positions are replaced with spaces.
+// Arguments:
+// - coordStartPosition - The top-left corner of the area to erase.
+// - coordLastPosition - The bottom-right corner of the area to erase, exclusive.
+// - wFillColor - The attributes to apply to the erased positions.
+// Return Value:
+// - True if handled successfully. False otherwise.
 bool AdaptDispatch::_EraseAreaHelper(const COORD coordStartPosition, const COORD coordLastPosition, const WORD wFillColor)
 {
     WCHAR const wchSpace = static_cast<WCHAR>(0x20); // space character. use 0x20 instead of literal space because we can't assume the compiler will always turn ' ' into 0x20.
 
-    size_t written = 0;
     FAIL_FAST_IF(!(coordStartPosition.X < coordLastPosition.X));
     FAIL_FAST_IF(!(coordStartPosition.Y < coordLastPosition.Y));
-    bool fSuccess = false;
-    for (short y = coordStartPosition.Y; y < coordLastPosition.Y; y++)
-    {
-        const COORD coordLine = {coordStartPosition.X, y};
-        fSuccess = !!_conApi->FillConsoleOutputCharacterW(wchSpace, coordLastPosition.X - coordStartPosition.X, coordLine, written);
-        if (fSuccess)
-        {
-            fSuccess = !!_conApi->FillConsoleOutputAttribute(wFillColor, coordLastPosition.X - coordStartPosition.X, coordLine, written);
-        }
 
-        if (!fSuccess)
-        {
-            break;
-        }
-    }
-    return fSuccess;
+    SMALL_RECT srFill;
+    srFill.Left = coordStartPosition.X;
+    srFill.Top = coordStartPosition.Y;
+    srFill.Right = coordLastPosition.X - 1;
+    srFill.Bottom = coordLastPosition.Y - 1;
+
+    return !!_conApi->PrivateFillRect(&srFill, wchSpace, wFillColor);
 }
 
 // Routine Description:
 // - Internal helper to erase one particular line of the buffer. Either from beginning to the cursor, from the cursor to the end, or the entire line.
 // - Used by both erase line (used just once) and by erase screen (used in a loop) to erase a portion of the buffer.
 // Arguments:
-// - pcsbiex - Pointer to the console screen buffer that we will be erasing (and getting cursor data from within)
+// - pState - The state of the console screen buffer that we will be erasing (and getting cursor data from within)
 // - DispatchTypes::EraseType - Enumeration mode of which kind of erase to perform: beginning to cursor, cursor to end, or entire line.
 // - sLineId - The line number (array index value, starts at 0) of the line to operate on within the buffer.
 //           - This is not aware of circular buffer. Line 0 is always the top visible line if you scrolled the whole way up the window.
 // Return Value:
 // - True if handled successfully. False otherwise.
-bool AdaptDispatch::_EraseSingleLineHelper(const CONSOLE_SCREEN_BUFFER_INFOEX* const pcsbiex, const DispatchTypes::EraseType eraseType, const SHORT sLineId, const WORD wFillColor) const
+bool AdaptDispatch::_EraseSingleLineHelper(const ScreenBufferState* const pState, const DispatchTypes::EraseType eraseType, const SHORT sLineId, const WORD wFillColor) const
 {
     COORD coordStartPosition = { 0 };
     coordStartPosition.Y = sLineId;
@@ -694,10 +685,10 @@ bool AdaptDispatch::_EraseSingleLineHelper(const CONSOLE_SCREEN_BUFFER_INFOEX* c
     {
     case DispatchTypes::EraseType::FromBeginning:
     case DispatchTypes::EraseType::All:
-        coordStartPosition.X = pcsbiex->srWindow.Left; // from beginning and the whole line start from the left viewport edge.
+        coordStartPosition.X = pState->srWindow.Left; // from beginning and the whole line start from the left viewport edge.
         break;
     case DispatchTypes::EraseType::ToEnd:
-        coordStartPosition.X = pcsbiex->dwCursorPosition.X; // from the current cursor position (including it)
+        coordStartPosition.X = pState->dwCursorPosition.X; // from the current cursor position (including it)
         break;
     }
 
@@ -708,12 +699,12 @@ bool AdaptDispatch::_EraseSingleLineHelper(const CONSOLE_SCREEN_BUFFER_INFOEX* c
     {
     case DispatchTypes::EraseType::FromBeginning:
         // +1 because if cursor were at the left edge, the length would be 0 and we want to paint at least the 1 character the cursor is on.
-        nLength = (pcsbiex->dwCursorPosition.X - pcsbiex->srWindow.Left) + 1;
+        nLength = (pState->dwCursorPosition.X - pState->srWindow.Left) + 1;
         break;
     case DispatchTypes::EraseType::ToEnd:
     case DispatchTypes::EraseType::All:
         // Remember the .Right value is 1 farther than the right most displayed character in the viewport. Therefore no +1.
-        nLength = pcsbiex->srWindow.Right - coordStartPosition.X;
+        nLength = pState->srWindow.Right - coordStartPosition.X;
         break;
     }
 
@@ -732,20 +723,19 @@ bool AdaptDispatch::_EraseSingleLineHelper(const CONSOLE_SCREEN_BUFFER_INFOEX* c
 // - True if handled successfully. False otherwise.
 bool AdaptDispatch::EraseCharacters(_In_ unsigned int const uiNumChars)
 {
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
-    bool fSuccess = !!_conApi->GetConsoleScreenBufferInfoEx(&csbiex);
+    ScreenBufferState state = { 0 };
+    bool fSuccess = !!_conApi->PrivateGetScreenBufferState(&state);
 
     if (fSuccess)
     {
-        const COORD coordStartPosition = csbiex.dwCursorPosition;
+        const COORD coordStartPosition = state.dwCursorPosition;
 
-        const SHORT sRemainingSpaces = csbiex.srWindow.Right - coordStartPosition.X;
+        const SHORT sRemainingSpaces = state.srWindow.Right - coordStartPosition.X;
         const unsigned short usActualRemaining = (sRemainingSpaces < 0)? 0 : sRemainingSpaces;
         // erase at max the number of characters remaining in the line from the current position.
         const DWORD dwEraseLength = (uiNumChars <= usActualRemaining)? uiNumChars : usActualRemaining;
 
-        fSuccess = _EraseSingleLineDistanceHelper(coordStartPosition, dwEraseLength, csbiex.wAttributes);
+        fSuccess = _EraseSingleLineDistanceHelper(coordStartPosition, dwEraseLength, state.wAttributes);
     }
     return fSuccess;
 }
@@ -776,11 +766,10 @@ bool AdaptDispatch::EraseInDisplay(const DispatchTypes::EraseType eraseType)
         return _EraseAll();
     }
 
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    ScreenBufferState state = { 0 };
     // Make sure to reset the viewport (with MoveToBottom )to where it was
     //      before the user scrolled the console output
-    bool fSuccess = !!(_conApi->MoveToBottom() && _conApi->GetConsoleScreenBufferInfoEx(&csbiex));
+    bool fSuccess = !!(_conApi->MoveToBottom() && _conApi->PrivateGetScreenBufferState(&state));
 
     if (fSuccess)
     {
@@ -797,21 +786,18 @@ bool AdaptDispatch::EraseInDisplay(const DispatchTypes::EraseType eraseType)
         if (eraseType == DispatchTypes::EraseType::FromBeginning)
         {
             // For beginning and all, erase all complete lines before (above vertically) from the cursor position.
-            for (SHORT sStartLine = csbiex.srWindow.Top; sStartLine < csbiex.dwCursorPosition.Y; sStartLine++)
+            if (state.dwCursorPosition.Y > state.srWindow.Top)
             {
-                fSuccess = _EraseSingleLineHelper(&csbiex, DispatchTypes::EraseType::All, sStartLine, csbiex.wAttributes);
-
-                if (!fSuccess)
-                {
-                    break;
-                }
+                const COORD coordStartPosition = { state.srWindow.Left, state.srWindow.Top };
+                const COORD coordLastPosition = { state.srWindow.Right, state.dwCursorPosition.Y };
+                fSuccess = _EraseAreaHelper(coordStartPosition, coordLastPosition, state.wAttributes);
             }
         }
 
         if (fSuccess)
         {
             // 2. Cursor Line
-            fSuccess = _EraseSingleLineHelper(&csbiex, eraseType, csbiex.dwCursorPosition.Y, csbiex.wAttributes);
+            fSuccess = _EraseSingleLineHelper(&state, eraseType, state.dwCursorPosition.Y, state.wAttributes);
         }
 
         if (fSuccess)
@@ -821,14 +807,11 @@ bool AdaptDispatch::EraseInDisplay(const DispatchTypes::EraseType eraseType)
             {
                 // For beginning and all, erase all complete lines after (below vertically) the cursor position.
                 // Remember that the viewport bottom value is 1 beyond the viewable area of the viewport.
-                for (SHORT sStartLine = csbiex.dwCursorPosition.Y + 1; sStartLine < csbiex.srWindow.Bottom; sStartLine++)
+                if (state.dwCursorPosition.Y + 1 < state.srWindow.Bottom)
                 {
-                    fSuccess = _EraseSingleLineHelper(&csbiex, DispatchTypes::EraseType::All, sStartLine, csbiex.wAttributes);
-
-                    if (!fSuccess)
-                    {
-                        break;
-                    }
+                    const COORD coordStartPosition = { state.srWindow.Left, static_cast<SHORT>(state.dwCursorPosition.Y + 1) };
+                    const COORD coordLastPosition = { state.srWindow.Right, state.srWindow.Bottom };
+                    fSuccess = _EraseAreaHelper(coordStartPosition, coordLastPosition, state.wAttributes);
                 }
             }
         }
@@ -845,13 +828,12 @@ bool AdaptDispatch::EraseInDisplay(const DispatchTypes::EraseType eraseType)
 // - True if handled successfully. False otherwise.
 bool AdaptDispatch::EraseInLine(const DispatchTypes::EraseType eraseType)
 {
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
-    bool fSuccess = !!_conApi->GetConsoleScreenBufferInfoEx(&csbiex);
+    ScreenBufferState state = { 0 };
+    bool fSuccess = !!_conApi->PrivateGetScreenBufferState(&state);
 
     if (fSuccess)
     {
-        fSuccess = _EraseSingleLineHelper(&csbiex, eraseType, csbiex.dwCursorPosition.Y, csbiex.wAttributes);
+        fSuccess = _EraseSingleLineHelper(&state, eraseType, state.dwCursorPosition.Y, state.wAttributes);
     }
 
     return fSuccess;
@@ -902,20 +884,19 @@ bool AdaptDispatch::DeviceAttributes()
 // - True if handled successfully. False otherwise.
 bool AdaptDispatch::_CursorPositionReport() const
 {
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    ScreenBufferState state = { 0 };
     // Make sure to reset the viewport (with MoveToBottom )to where it was
     //      before the user scrolled the console output
-    bool fSuccess = !!(_conApi->MoveToBottom() && _conApi->GetConsoleScreenBufferInfoEx(&csbiex));
+    bool fSuccess = !!(_conApi->MoveToBottom() && _conApi->PrivateGetScreenBufferState(&state));
 
     if (fSuccess)
     {
         // First pull the cursor position relative to the entire buffer out of the console.
-        COORD coordCursorPos = csbiex.dwCursorPosition;
+        COORD coordCursorPos = state.dwCursorPosition;
 
         // Now adjust it for its position in respect to the current viewport.
-        coordCursorPos.X -= csbiex.srWindow.Left;
-        coordCursorPos.Y -= csbiex.srWindow.Top;
+        coordCursorPos.X -= state.srWindow.Left;
+        coordCursorPos.Y -= state.srWindow.Top;
 
         // NOTE: 1,1 is the top-left corner of the viewport in VT-speak, so add 1.
         coordCursorPos.X++;
@@ -989,26 +970,25 @@ bool AdaptDispatch::_ScrollMovement(const ScrollDirection sdDirection, _In_ unsi
     if (fSuccess)
     {
         // get current cursor
-        CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-        csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+        ScreenBufferState state = { 0 };
         // Make sure to reset the viewport (with MoveToBottom )to where it was
         //      before the user scrolled the console output
-        fSuccess = !!(_conApi->MoveToBottom() && _conApi->GetConsoleScreenBufferInfoEx(&csbiex));
+        fSuccess = !!(_conApi->MoveToBottom() && _conApi->PrivateGetScreenBufferState(&state));
 
         if (fSuccess)
         {
-            SMALL_RECT srScreen = csbiex.srWindow;
+            SMALL_RECT srScreen = state.srWindow;
 
             // Paste coordinate for cut text above
             COORD coordDestination;
             coordDestination.X = srScreen.Left;
             // Scroll starting from the top of the scroll margins.
-            coordDestination.Y = (_srScrollMargins.Top + srScreen.Top) + sDistance * (sdDirection == ScrollDirection::Up? -1 : 1);
+            coordDestination.Y = (state.srScrollMargins.Top + srScreen.Top) + sDistance * (sdDirection == ScrollDirection::Up? -1 : 1);
             // We don't need to worry about clipping the margins at all, ScrollRegion inside conhost will do that correctly for us
 
             // Fill character for remaining space left behind by "cut" operation (or for fill if we "cut" the entire line)
             CHAR_INFO ciFill;
-            ciFill.Attributes = csbiex.wAttributes;
+            ciFill.Attributes = state.wAttributes;
             ciFill.Char.UnicodeChar = L' ';
             fSuccess = !!_conApi->ScrollConsoleScreenBufferW(&srScreen, &srScreen, coordDestination, &ciFill);
         }
@@ -1262,11 +1242,10 @@ bool AdaptDispatch::DeleteLine(_In_ unsigned int const uiDistance)
 bool AdaptDispatch::_DoSetTopBottomScrollingMargins(const SHORT sTopMargin,
                                                     const SHORT sBottomMargin)
 {
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    ScreenBufferState state = { 0 };
     // Make sure to reset the viewport (with MoveToBottom )to where it was
     //      before the user scrolled the console output
-    bool fSuccess = !!(_conApi->MoveToBottom() && _conApi->GetConsoleScreenBufferInfoEx(&csbiex));
+    bool fSuccess = !!(_conApi->MoveToBottom() && _conApi->PrivateGetScreenBufferState(&state));
 
     // so notes time: (input -> state machine out -> adapter out -> conhost internal)
     // having only a top param is legal         ([3;r   -> 3,0   -> 3,h  -> 3,h,true)
@@ -1277,7 +1256,7 @@ bool AdaptDispatch::_DoSetTopBottomScrollingMargins(const SHORT sTopMargin,
     {
         SHORT sActualTop = sTopMargin;
         SHORT sActualBottom = sBottomMargin;
-        SHORT sScreenHeight = csbiex.srWindow.Bottom - csbiex.srWindow.Top;
+        SHORT sScreenHeight = state.srWindow.Bottom - state.srWindow.Top;
         if ( sActualTop == 0 && sActualBottom == 0)
         {
             // Disable Margins
@@ -1311,9 +1290,10 @@ bool AdaptDispatch::_DoSetTopBottomScrollingMargins(const SHORT sTopMargin,
         }
         if (fSuccess)
         {
-            _srScrollMargins.Top = sActualTop;
-            _srScrollMargins.Bottom = sActualBottom;
-            fSuccess = !!_conApi->PrivateSetScrollingRegion(&_srScrollMargins);
+            SMALL_RECT srScrollMargins = { 0 };
+            srScrollMargins.Top = sActualTop;
+            srScrollMargins.Bottom = sActualBottom;
+            fSuccess = !!_conApi->PrivateSetScrollingRegion(&srScrollMargins);
         }
     }
     return fSuccess;
@@ -1445,18 +1425,42 @@ bool AdaptDispatch::TabClear(const SHORT sClearType)
 }
 
 //Routine Description:
-// Designate Charset - Sets the active charset to be the one mapped to wch.
+// Designate Charset - Sets the charset in one of G0 - G3 to be the one mapped to wch.
 //     See DispatchTypes::VTCharacterSets for a list of supported charsets.
 //     Also http://invisible-island.net/xterm/ctlseqs/ctlseqs.html#h2-Controls-beginning-with-ESC
 //       For a list of all charsets and their codes.
 //     If the specified charset is unsupported, we do nothing (remain on the current one)
 //Arguments:
+// - gsetNumber - Which of G0 - G3 to designate the charset into.
 // - wchCharset - The character indicating the charset we should switch to.
 // Return value:
 // True if handled successfully. False othewise.
-bool AdaptDispatch::DesignateCharset(const wchar_t wchCharset)
+bool AdaptDispatch::DesignateCharset(const size_t gsetNumber, const wchar_t wchCharset)
+{
+    return _TermOutput.DesignateCharset(gsetNumber, wchCharset);
+}
+
+//Routine Description:
+// Locking Shift - Invokes one of G0 - G3 into GL, so that it's used for all
+//     the text that follows. SI is LS0, SO is LS1.
+//Arguments:
+// - gsetNumber - Which of G0 - G3 to invoke.
+// Return value:
+// True if handled successfully. False othewise.
+bool AdaptDispatch::LockingShift(const size_t gsetNumber)
 {
-    return _TermOutput.DesignateCharset(wchCharset);
+    return _TermOutput.LockingShift(gsetNumber);
+}
+
+//Routine Description:
+// Single Shift - Invokes one of G0 - G3 into GL for the next printed character only.
+//Arguments:
+// - gsetNumber - Which of G0 - G3 to invoke.
+// Return value:
+// True if handled successfully. False othewise.
+bool AdaptDispatch::SingleShift(const size_t gsetNumber)
+{
+    return _TermOutput.SingleShift(gsetNumber);
 }
 
 //Routine Description:
@@ -1506,9 +1510,13 @@ bool AdaptDispatch::SoftReset()
         // Top margin = 1; bottom margin = page length.
         fSuccess = _DoSetTopBottomScrollingMargins(0, 0);
     }
+    for (size_t gsetNumber = 0; fSuccess && gsetNumber < TerminalOutput::s_cCharacterSets; gsetNumber++)
+    {
+        fSuccess = DesignateCharset(gsetNumber, DispatchTypes::VTCharacterSets::USASCII); // Default Charset
+    }
     if (fSuccess)
     {
-        fSuccess = DesignateCharset(DispatchTypes::VTCharacterSets::USASCII); // Default Charset
+        fSuccess = LockingShift(0); // G0 in GL
     }
     if (fSuccess)
     {
@@ -1538,7 +1546,7 @@ bool AdaptDispatch::SoftReset()
 //      * SGR(Off)
 //   - Sets the selective erase attribute write state to "not erasable".
 //   - Sets all character sets to the default.
-//      * G0(USASCII)
+//      * G0 - G3(USASCII), with G0 invoked into GL
 //Arguments:
 // <none>
 // Return value:
@@ -1584,18 +1592,17 @@ bool AdaptDispatch::HardReset()
 // True if handled successfully. False othewise.
 bool AdaptDispatch::_EraseScrollback()
 {
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    ScreenBufferState state = { 0 };
     // Make sure to reset the viewport (with MoveToBottom )to where it was
     //      before the user scrolled the console output
-    bool fSuccess = !!(_conApi->GetConsoleScreenBufferInfoEx(&csbiex) && _conApi->MoveToBottom());
+    bool fSuccess = !!(_conApi->PrivateGetScreenBufferState(&state) && _conApi->MoveToBottom());
     if (fSuccess)
     {
-        const SMALL_RECT Screen = csbiex.srWindow;
+        const SMALL_RECT Screen = state.srWindow;
         const short sWidth = Screen.Right - Screen.Left;
         const short sHeight = Screen.Bottom - Screen.Top;
         FAIL_FAST_IF(!(sWidth > 0 && sHeight > 0));
-        const COORD Cursor = csbiex.dwCursorPosition;
+        const COORD Cursor = state.dwCursorPosition;
 
         // Rectangle to cut out of the existing buffer
         SMALL_RECT srScroll = Screen;
@@ -1606,7 +1613,7 @@ bool AdaptDispatch::_EraseScrollback()
 
         // Fill character for remaining space left behind by "cut" operation (or for fill if we "cut" the entire line)
         CHAR_INFO ciFill;
-        ciFill.Attributes = csbiex.wAttributes;
+        ciFill.Attributes = state.wAttributes;
         ciFill.Char.UnicodeChar = static_cast<WCHAR>(0x20); // space character. use 0x20 instead of literal space because we can't assume the compiler will always turn ' ' into 0x20.
         fSuccess = !!_conApi->ScrollConsoleScreenBufferW(&srScroll, nullptr, coordDestination, &ciFill);
         if (fSuccess)
@@ -1616,21 +1623,22 @@ bool AdaptDispatch::_EraseScrollback()
             // B. to the right of the viewport.
 
             // First clear section A
-            const DWORD dwTotalAreaBelow = csbiex.dwSize.X * (csbiex.dwSize.Y - sHeight);
             const COORD coordBelowStartPosition = {0, sHeight};
-            // We don't use the _EraseAreaHelper here because _EraseSingleLineDistanceHelper does it all in one operation
-            fSuccess = _EraseSingleLineDistanceHelper(coordBelowStartPosition, dwTotalAreaBelow, csbiex.wAttributes);
+            if (state.dwSize.Y > sHeight)
+            {
+                fSuccess = _EraseAreaHelper(coordBelowStartPosition, state.dwSize, state.wAttributes);
+            }
 
             if (fSuccess)
             {
                 // If there is a section B, clear it.
-                const COORD coordBottomRight = {csbiex.dwSize.X, coordBelowStartPosition.Y};
+                const COORD coordBottomRight = {state.dwSize.X, coordBelowStartPosition.Y};
                 const COORD coordRightStartPosition = {sWidth, 0};
                 if (coordBottomRight.X > coordRightStartPosition.X)
                 {
                     // We use the Area helper here because the Line helper would
                     //      erase the parts of the screen we want to keep too
-                    fSuccess = _EraseAreaHelper(coordRightStartPosition, coordBottomRight, csbiex.wAttributes);
+                    fSuccess = _EraseAreaHelper(coordRightStartPosition, coordBottomRight, state.wAttributes);
                 }
 
                 if (fSuccess)
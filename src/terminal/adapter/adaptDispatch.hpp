@@ -84,7 +84,9 @@ namespace Microsoft::Console::VirtualTerminal
         virtual bool ForwardTab(const SHORT sNumTabs); // CHT
         virtual bool BackwardsTab(const SHORT sNumTabs); // CBT
         virtual bool TabClear(const SHORT sClearType); // TBC
-        virtual bool DesignateCharset(const wchar_t wchCharset); // DesignateCharset
+        virtual bool DesignateCharset(const size_t gsetNumber, const wchar_t wchCharset); // DesignateCharset
+        virtual bool LockingShift(const size_t gsetNumber); // SI, SO, LS2, LS3
+        virtual bool SingleShift(const size_t gsetNumber); // SS2, SS3
         virtual bool SoftReset(); // DECSTR
         virtual bool HardReset(); // RIS
         virtual bool EnableVT200MouseMode(const bool fEnabled); // ?1000
@@ -121,7 +123,7 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool _CursorMovement(const CursorDirection dir, _In_ unsigned int const uiDistance) const;
         bool _CursorMovePosition(_In_opt_ const unsigned int* const puiRow, _In_opt_ const unsigned int* const puiCol) const;
-        bool _EraseSingleLineHelper(const CONSOLE_SCREEN_BUFFER_INFOEX* const pcsbiex, const DispatchTypes::EraseType eraseType, const SHORT sLineId, const WORD wFillColor) const;
+        bool _EraseSingleLineHelper(const ScreenBufferState* const pState, const DispatchTypes::EraseType eraseType, const SHORT sLineId, const WORD wFillColor) const;
         void _SetGraphicsOptionHelper(const DispatchTypes::GraphicsOptions opt, _Inout_ WORD* const pAttr);
         bool _EraseAreaHelper(const COORD coordStartPosition, const COORD coordLastPosition, const WORD wFillColor);
         bool _EraseSingleLineDistanceHelper(const COORD coordStartPosition, const DWORD dwLength, const WORD wFillColor) const;
@@ -147,7 +149,6 @@ namespace Microsoft::Console::VirtualTerminal
         TerminalOutput _TermOutput;
 
         COORD _coordSavedCursor;
-        SMALL_RECT _srScrollMargins;
 
         bool _fIsSetColumnsEnabled;
 
@@ -24,11 +24,26 @@ Author(s):
 
 namespace Microsoft::Console::VirtualTerminal
 {
+    // The parts of the screen buffer state that VT sequences consult on every
+    //      call. The fields match their CONSOLE_SCREEN_BUFFER_INFOEX namesakes,
+    //      including srWindow being exclusive.
+    struct ScreenBufferState
+    {
+        COORD dwSize;
+        COORD dwCursorPosition;
+        SMALL_RECT srWindow;
+        WORD wAttributes;
+        // The VT scrolling margins, inclusive and relative to the viewport.
+        //      All zeros when no margins are set.
+        SMALL_RECT srScrollMargins;
+    };
+
     class ConGetSet
     {
     public:
         virtual BOOL GetConsoleCursorInfo(_In_ CONSOLE_CURSOR_INFO* const pConsoleCursorInfo) const = 0;
         virtual BOOL GetConsoleScreenBufferInfoEx(_Out_ CONSOLE_SCREEN_BUFFER_INFOEX* const pConsoleScreenBufferInfoEx) const = 0;
+        virtual BOOL PrivateGetScreenBufferState(_Out_ ScreenBufferState* const pState) const = 0;
         virtual BOOL SetConsoleScreenBufferInfoEx(const CONSOLE_SCREEN_BUFFER_INFOEX* const pConsoleScreenBufferInfoEx) = 0;
         virtual BOOL SetConsoleCursorInfo(const CONSOLE_CURSOR_INFO* const pConsoleCursorInfo) = 0;
         virtual BOOL SetConsoleCursorPosition(const COORD coordCursorPosition) = 0;
@@ -54,8 +69,11 @@ namespace Microsoft::Console::VirtualTerminal
         virtual BOOL SetConsoleRGBTextAttribute(const COLORREF rgbColor, const bool fIsForeground) = 0;
         virtual BOOL PrivateBoldText(const bool bolded) = 0;
 
-        virtual BOOL PrivateWriteConsoleInputW(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& events,
+        virtual BOOL PrivateWriteConsoleInputW(const gsl::span<const INPUT_RECORD> records,
                                                _Out_ size_t& eventsWritten) = 0;
+        virtual BOOL PrivateWriteConsoleInputText(const std::wstring_view text,
+                                                  _Out_ size_t& charsWritten) = 0;
+        virtual BOOL PrivatePostConsoleInput(const gsl::span<const INPUT_RECORD> records) = 0;
         virtual BOOL ScrollConsoleScreenBufferW(const SMALL_RECT* pScrollRectangle,
                                                 _In_opt_ const SMALL_RECT* pClipRectangle,
                                                 _In_ COORD dwDestinationOrigin,
@@ -86,6 +104,7 @@ namespace Microsoft::Console::VirtualTerminal
         virtual BOOL PrivateEnableAnyEventMouseMode(const bool fEnabled) = 0;
         virtual BOOL PrivateEnableAlternateScroll(const bool fEnabled) = 0;
         virtual BOOL PrivateEraseAll() = 0;
+        virtual BOOL PrivateFillRect(const SMALL_RECT* const psrFill, const wchar_t wch, const WORD wAttributes) = 0;
         virtual BOOL SetCursorStyle(const CursorType cursorType) = 0;
         virtual BOOL SetCursorColor(const COLORREF cursorColor) = 0;
         virtual BOOL PrivateGetConsoleScreenBufferAttributes(_Out_ WORD* const pwAttributes) = 0;
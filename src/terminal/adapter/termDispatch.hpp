@@ -79,7 +79,9 @@ public:
     virtual bool DeviceStatusReport(const DispatchTypes::AnsiStatusType /*statusType*/) { return false; } // DSR
     virtual bool DeviceAttributes() { return false; } // DA
 
-    virtual bool DesignateCharset(const wchar_t /*wchCharset*/){ return false; } // DesignateCharset
+    virtual bool DesignateCharset(const size_t /*gsetNumber*/, const wchar_t /*wchCharset*/){ return false; } // DesignateCharset
+    virtual bool LockingShift(const size_t /*gsetNumber*/){ return false; } // SI, SO, LS2, LS3
+    virtual bool SingleShift(const size_t /*gsetNumber*/){ return false; } // SS2, SS3
 
     virtual bool SoftReset(){ return false; } // DECSTR
     virtual bool HardReset(){ return false; } // RIS
@@ -8,7 +8,210 @@
 
 using namespace Microsoft::Console::VirtualTerminal;
 
-TerminalOutput::TerminalOutput()
+namespace
+{
+    using TranslationTable = TerminalOutput::TranslationTable;
+
+    struct Replacement
+    {
+        wchar_t wch;
+        wchar_t wchReplacement;
+    };
+
+    // Builds a table that displays every character as itself, except for the
+    //      given replacements. This is all done at compile time.
+    template<size_t N>
+    constexpr TranslationTable MakeTranslationTable(const Replacement (&rgReplacements)[N]) noexcept
+    {
+        TranslationTable table{};
+        for (size_t i = 0; i < TerminalOutput::s_cDisplayCharacters; i++)
+        {
+            table.translations[i] = static_cast<wchar_t>(L'\x20' + i);
+        }
+
+        table.wchFirstChanged = L'\x7f';
+        table.wchLastChanged = L'\x20';
+        for (const auto& replacement : rgReplacements)
+        {
+            table.translations[replacement.wch - L'\x20'] = replacement.wchReplacement;
+            table.wchFirstChanged = std::min(table.wchFirstChanged, replacement.wch);
+            table.wchLastChanged = std::max(table.wchLastChanged, replacement.wch);
+        }
+        return table;
+    }
+
+    // From http://vt100.net/docs/vt220-rm/table2-4.html
+    constexpr TranslationTable s_DECSpecialGraphicsTranslations = MakeTranslationTable({
+        { L'\x5f', L'\u00A0' }, // Blank
+        { L'\x60', L'\u25C6' }, // Diamond
+        { L'\x61', L'\u2592' }, // Checkerboard
+        { L'\x62', L'\u2409' }, // HT, SYMBOL FOR HORIZONTAL TABULATION
+        { L'\x63', L'\u240C' }, // FF, SYMBOL FOR FORM FEED
+        { L'\x64', L'\u240D' }, // CR, SYMBOL FOR CARRIAGE RETURN
+        { L'\x65', L'\u240A' }, // LF, SYMBOL FOR LINE FEED
+        { L'\x66', L'\u00B0' }, // Degree symbol
+        { L'\x67', L'\u00B1' }, // Plus/minus
+        { L'\x68', L'\u2424' }, // NL, SYMBOL FOR NEWLINE
+        { L'\x69', L'\u240B' }, // VT, SYMBOL FOR VERTICAL TABULATION
+        { L'\x6a', L'\u2518' }, // Lower-right corner
+        { L'\x6b', L'\u2510' }, // Upper-right corner
+        { L'\x6c', L'\u250C' }, // Upper-left corner
+        { L'\x6d', L'\u2514' }, // Lower-left corner
+        { L'\x6e', L'\u253C' }, // crossing lines
+        { L'\x6f', L'\u23BA' }, // HORIZONTAL SCAN LINE-1
+        { L'\x70', L'\u23BB' }, // HORIZONTAL SCAN LINE-3
+        { L'\x71', L'\u2500' }, // HORIZONTAL SCAN LINE-5
+        { L'\x72', L'\u23BC' }, // HORIZONTAL SCAN LINE-7
+        { L'\x73', L'\u23BD' }, // HORIZONTAL SCAN LINE-9
+        { L'\x74', L'\u251C' }, // Left "T"
+        { L'\x75', L'\u2524' }, // Right "T"
+        { L'\x76', L'\u2534' }, // Bottom "T"
+        { L'\x77', L'\u252C' }, // Top "T"
+        { L'\x78', L'\u2502' }, // | Vertical bar
+        { L'\x79', L'\u2264' }, // Less than or equal to
+        { L'\x7a', L'\u2265' }, // Greater than or equal to
+        { L'\x7b', L'\u03C0' }, // Pi
+        { L'\x7c', L'\u2260' }, // Not equal to
+        { L'\x7d', L'\u00A3' }, // UK pound sign
+        { L'\x7e', L'\u00B7' }, // Centered dot
+    });
+
+    // The National Replacement Character Sets.
+    // From http://vt100.net/docs/vt220-rm/table2-5.html
+    constexpr TranslationTable s_BritishTranslations = MakeTranslationTable({
+        { L'#', L'\u00A3' },
+    });
+
+    constexpr TranslationTable s_DutchTranslations = MakeTranslationTable({
+        { L'#', L'\u00A3' },
+        { L'@', L'\u00BE' },
+        { L'[', L'\u0133' },
+        { L'\\', L'\u00BD' },
+        { L']', L'|' },
+        { L'{', L'\u00A8' },
+        { L'|', L'\u0192' },
+        { L'}', L'\u00BC' },
+        { L'~', L'\u00B4' },
+    });
+
+    constexpr TranslationTable s_FinnishTranslations = MakeTranslationTable({
+        { L'[', L'\u00C4' },
+        { L'\\', L'\u00D6' },
+        { L']', L'\u00C5' },
+        { L'^', L'\u00DC' },
+        { L'`', L'\u00E9' },
+        { L'{', L'\u00E4' },
+        { L'|', L'\u00F6' },
+        { L'}', L'\u00E5' },
+        { L'~', L'\u00FC' },
+    });
+
+    constexpr TranslationTable s_FrenchTranslations = MakeTranslationTable({
+        { L'#', L'\u00A3' },
+        { L'@', L'\u00E0' },
+        { L'[', L'\u00B0' },
+        { L'\\', L'\u00E7' },
+        { L']', L'\u00A7' },
+        { L'{', L'\u00E9' },
+        { L'|', L'\u00F9' },
+        { L'}', L'\u00E8' },
+        { L'~', L'\u00A8' },
+    });
+
+    constexpr TranslationTable s_FrenchCanadianTranslations = MakeTranslationTable({
+        { L'@', L'\u00E0' },
+        { L'[', L'\u00E2' },
+        { L'\\', L'\u00E7' },
+        { L']', L'\u00EA' },
+        { L'^', L'\u00EE' },
+        { L'`', L'\u00F4' },
+        { L'{', L'\u00E9' },
+        { L'|', L'\u00F9' },
+        { L'}', L'\u00E8' },
+        { L'~', L'\u00FB' },
+    });
+
+    constexpr TranslationTable s_GermanTranslations = MakeTranslationTable({
+        { L'@', L'\u00A7' },
+        { L'[', L'\u00C4' },
+        { L'\\', L'\u00D6' },
+        { L']', L'\u00DC' },
+        { L'{', L'\u00E4' },
+        { L'|', L'\u00F6' },
+        { L'}', L'\u00FC' },
+        { L'~', L'\u00DF' },
+    });
+
+    constexpr TranslationTable s_ItalianTranslations = MakeTranslationTable({
+        { L'#', L'\u00A3' },
+        { L'@', L'\u00A7' },
+        { L'[', L'\u00B0' },
+        { L'\\', L'\u00E7' },
+        { L']', L'\u00E9' },
+        { L'`', L'\u00F9' },
+        { L'{', L'\u00E0' },
+        { L'|', L'\u00F2' },
+        { L'}', L'\u00E8' },
+        { L'~', L'\u00EC' },
+    });
+
+    constexpr TranslationTable s_NorwegianDanishTranslations = MakeTranslationTable({
+        { L'@', L'\u00C4' },
+        { L'[', L'\u00C6' },
+        { L'\\', L'\u00D8' },
+        { L']', L'\u00C5' },
+        { L'^', L'\u00DC' },
+        { L'`', L'\u00E4' },
+        { L'{', L'\u00E6' },
+        { L'|', L'\u00F8' },
+        { L'}', L'\u00E5' },
+        { L'~', L'\u00FC' },
+    });
+
+    constexpr TranslationTable s_SpanishTranslations = MakeTranslationTable({
+        { L'#', L'\u00A3' },
+        { L'@', L'\u00A7' },
+        { L'[', L'\u00A1' },
+        { L'\\', L'\u00D1' },
+        { L']', L'\u00BF' },
+        { L'{', L'\u00B0' },
+        { L'|', L'\u00F1' },
+        { L'}', L'\u00E7' },
+    });
+
+    constexpr TranslationTable s_SwedishTranslations = MakeTranslationTable({
+        { L'@', L'\u00C9' },
+        { L'[', L'\u00C4' },
+        { L'\\', L'\u00D6' },
+        { L']', L'\u00C5' },
+        { L'^', L'\u00DC' },
+        { L'`', L'\u00E9' },
+        { L'{', L'\u00E4' },
+        { L'|', L'\u00F6' },
+        { L'}', L'\u00E5' },
+        { L'~', L'\u00FC' },
+    });
+
+    constexpr TranslationTable s_SwissTranslations = MakeTranslationTable({
+        { L'#', L'\u00F9' },
+        { L'@', L'\u00E0' },
+        { L'[', L'\u00E9' },
+        { L'\\', L'\u00E7' },
+        { L']', L'\u00EA' },
+        { L'^', L'\u00EE' },
+        { L'_', L'\u00E8' },
+        { L'`', L'\u00F4' },
+        { L'{', L'\u00E4' },
+        { L'|', L'\u00F6' },
+        { L'}', L'\u00FC' },
+        { L'~', L'\u00FB' },
+    });
+}
+
+TerminalOutput::TerminalOutput() noexcept :
+    _gsetTranslationTables{},
+    _glSetNumber{ 0 },
+    _ssSetNumber{}
 {
 
 }
@@ -18,100 +221,247 @@ TerminalOutput::~TerminalOutput()
 
 }
 
-// We include a full table so all we have to do is the lookup.
-// The tables only ever change the values x20 - x7f, hence why the table starts at \x20
-// From http://vt100.net/docs/vt220-rm/table2-4.html
-const wchar_t TerminalOutput::s_rgDECSpecialGraphicsTranslations[s_uiNumDisplayCharacters]
+// Routine Description:
+// - Designates the charset mapped to wchNewCharset into one of G0 - G3.
+//     See DispatchTypes::VTCharacterSets for a list of supported charsets.
+//     If the specified charset is unsupported, we do nothing (the set keeps
+//     its current charset).
+// Arguments:
+// - gsetNumber - Which of G0 - G3 to designate the charset into.
+// - wchNewCharset - The final character of the designation sequence.
+// Return Value:
+// - True if the charset is supported. False otherwise.
+bool TerminalOutput::DesignateCharset(const size_t gsetNumber, const wchar_t wchNewCharset)
 {
-     L'\x20', L'\x21', L'\x22', L'\x23', L'\x24', L'\x25', L'\x26', L'\x27', L'\x28', L'\x29', L'\x2a', L'\x2b', L'\x2c', L'\x2d', L'\x2e', L'\x2f',
-     L'\x30', L'\x31', L'\x32', L'\x33', L'\x34', L'\x35', L'\x36', L'\x37', L'\x38', L'\x39', L'\x3a', L'\x3b', L'\x3c', L'\x3d', L'\x3e', L'\x3f',
-     L'\x40', L'\x41', L'\x42', L'\x43', L'\x44', L'\x45', L'\x46', L'\x47', L'\x48', L'\x49', L'\x4a', L'\x4b', L'\x4c', L'\x4d', L'\x4e', L'\x4f',
-     L'\x50', L'\x51', L'\x52', L'\x53', L'\x54', L'\x55', L'\x56', L'\x57', L'\x58', L'\x59', L'\x5a', L'\x5b', L'\x5c', L'\x5d', L'\x5e', L'\x5f',
-     L'\u25C6', // L'\x60',   -> Diamond
-     L'\u2592', // L'\x61',   -> Checkerboard
-     L'\u2409', // L'\x62',   -> HT, SYMBOL FOR HORIZONTAL TABULATION
-     L'\u240c', // L'\x63',   -> FF, SYMBOL FOR FORM FEED
-     L'\u240d', // L'\x64',   -> CR, SYMBOL FOR CARRIAGE RETURN
-     L'\u240a', // L'\x65',   -> LF, SYMBOL FOR LINE FEED
-     L'\u00B0', // L'\x66',   -> Degree symbol
-     L'\u00B1', // L'\x67',   -> Plus/minus
-     L'\u2424', // L'\x68',   -> NL, SYMBOL FOR NEWLINE
-     L'\u240b', // L'\x69',   -> VT, SYMBOL FOR VERTICAL TABULATION
-     L'\u2518', // L'\x6a',   -> Lower-right corner
-     L'\u2510', // L'\x6b',   -> Upper-right corner
-     L'\u250c', // L'\x6c',   -> Upper-left corner
-     L'\u2514', // L'\x6d',   -> Lower-left corner
-     L'\u253C', // L'\x6e',   -> crossing lines
-     L'\u23ba', // L'\x6f',   -> HORIZONTAL SCAN LINE-3
-     L'\u23bb', // L'\x70',   -> HORIZONTAL SCAN LINE-3
-     L'\u2500', // L'\x71',   -> HORIZONTAL SCAN LINE-5
-     L'\u23bc', // L'\x72',   -> HORIZONTAL SCAN LINE-7
-     L'\u23bd', // L'\x73',   -> HORIZONTAL SCAN LINE-7
-     L'\u251c', // L'\x74',   -> Left "T"
-     L'\u2524', // L'\x75',   -> Right "T"
-     L'\u2534', // L'\x76',   -> Bottom "T"
-     L'\u252c', // L'\x77',   -> Top "T"
-     L'\u2502', // L'\x78',   -> | Vertical bar
-     L'\u2264', // L'\x79',   -> Less than or equal to
-     L'\u2265', // L'\x7a',   -> Greater than or equal to
-     L'\u03C0', // L'\x7b',   -> Pi
-     L'\u2260', // L'\x7c',   -> Not equal to
-     L'\u00A3', // L'\x7d',   -> UK pound sign
-     L'\u00B7', // L'\x7e',   -> Centered dot
-     L'\x7f'    // L'\x7f',   -> DEL
-};
-
-bool TerminalOutput::DesignateCharset(const wchar_t wchNewCharset)
+    const TranslationTable* pTable = nullptr;
+    const bool fSuccess = gsetNumber < s_cCharacterSets && s_GetTranslationTable(wchNewCharset, &pTable);
+    if (fSuccess)
+    {
+        _gsetTranslationTables[gsetNumber] = pTable;
+    }
+    return fSuccess;
+}
+
+// Routine Description:
+// - Invokes one of G0 - G3 into GL, until the next locking shift. (LS0 - LS3)
+// Arguments:
+// - gsetNumber - Which of G0 - G3 to invoke.
+// Return Value:
+// - True if gsetNumber is a valid set. False otherwise.
+bool TerminalOutput::LockingShift(const size_t gsetNumber)
 {
-    bool result = false;
-    if (wchNewCharset == DispatchTypes::VTCharacterSets::DEC_LineDrawing ||
-        wchNewCharset == DispatchTypes::VTCharacterSets::USASCII)
+    const bool fSuccess = gsetNumber < s_cCharacterSets;
+    if (fSuccess)
     {
-        _wchCurrentCharset = wchNewCharset;
-        result = true;
+        _glSetNumber = gsetNumber;
     }
-    return result;
+    return fSuccess;
 }
 
 // Routine Description:
-// - Returns true if the current charset isn't USASCII, indicating that text has to come through here
+// - Invokes one of G0 - G3 into GL for the next printed character only. (SS2, SS3)
+// Arguments:
+// - gsetNumber - Which of G0 - G3 to invoke.
+// Return Value:
+// - True if gsetNumber is a valid set. False otherwise.
+bool TerminalOutput::SingleShift(const size_t gsetNumber)
+{
+    const bool fSuccess = gsetNumber < s_cCharacterSets;
+    if (fSuccess)
+    {
+        _ssSetNumber = gsetNumber;
+    }
+    return fSuccess;
+}
+
+// Routine Description:
+// - Returns true if the charset in GL isn't USASCII, or a single shift is pending,
+//      indicating that text has to come through here
 // Arguments:
 // - <none>
 // Return Value:
-// - True if the current charset is not USASCII
-bool TerminalOutput::NeedToTranslate() const
+// - True if printed text may have to be translated.
+bool TerminalOutput::NeedToTranslate() const noexcept
 {
-    return _wchCurrentCharset != DispatchTypes::VTCharacterSets::USASCII;
+    return _GetGLTranslationTable() != nullptr || _ssSetNumber.has_value();
 }
 
-const wchar_t* TerminalOutput::_GetTranslationTable() const
+// Routine Description:
+// - Translates a single printed character through the current charset. This
+//      consumes any pending single shift.
+// Arguments:
+// - wch - The character to translate.
+// Return Value:
+// - The character to display.
+wchar_t TerminalOutput::TranslateKey(const wchar_t wch)
 {
-    const wchar_t* pwchTranslation = nullptr;
-    switch (_wchCurrentCharset)
+    const bool fSingleShift = _ssSetNumber.has_value();
+    const TranslationTable* const pTable = fSingleShift ? _ConsumeSingleShift() : _GetGLTranslationTable();
+    return pTable != nullptr ? s_Translate(*pTable, wch) : wch;
+}
+
+// Routine Description:
+// - Translates a run of printed characters through the current charset. A
+//      pending single shift applies to the first character only.
+// - If nothing in the run changes, the run itself is returned. Otherwise the
+//      translation is written to a buffer owned by this object, which is only
+//      valid until the next call.
+// Arguments:
+// - str - The characters to translate.
+// Return Value:
+// - The characters to display.
+std::wstring_view TerminalOutput::TranslateString(const std::wstring_view str)
+{
+    if (str.empty())
     {
+        return str;
+    }
+
+    const bool fSingleShift = _ssSetNumber.has_value();
+    const TranslationTable* const pFirstTable = fSingleShift ? _ConsumeSingleShift() : _GetGLTranslationTable();
+    const TranslationTable* const pTable = _GetGLTranslationTable();
+
+    const wchar_t wchFirst = pFirstTable != nullptr ? s_Translate(*pFirstTable, str[0]) : str[0];
+    const std::wstring_view rest = str.substr(1);
+    const size_t firstChanged = pTable != nullptr ? s_FindFirstChanged(*pTable, rest) : rest.size();
+    if (wchFirst == str[0] && firstChanged == rest.size())
+    {
+        return str;
+    }
+
+    _translatedString.assign(str);
+    _translatedString[0] = wchFirst;
+    for (size_t i = firstChanged + 1; i < str.size(); i++)
+    {
+        _translatedString[i] = s_Translate(*pTable, str[i]);
+    }
+    return _translatedString;
+}
+
+const TerminalOutput::TranslationTable* TerminalOutput::_GetGLTranslationTable() const noexcept
+{
+    return _gsetTranslationTables[_glSetNumber];
+}
+
+const TerminalOutput::TranslationTable* TerminalOutput::_ConsumeSingleShift() noexcept
+{
+    const TranslationTable* const pTable = _gsetTranslationTables[_ssSetNumber.value_or(_glSetNumber)];
+    _ssSetNumber.reset();
+    return pTable;
+}
+
+// Routine Description:
+// - Finds the table for the charset mapped to wchCharset.
+// Arguments:
+// - wchCharset - The final character of a designation sequence.
+// - ppTable - Receives the table, or nullptr for US-ASCII.
+// Return Value:
+// - True if the charset is supported. False otherwise.
+_Success_(return)
+bool TerminalOutput::s_GetTranslationTable(const wchar_t wchCharset, _Out_ const TranslationTable** const ppTable) noexcept
+{
+    bool fSuccess = true;
+    *ppTable = nullptr;
+    switch (wchCharset)
+    {
+    case DispatchTypes::VTCharacterSets::USASCII:
+        break;
     case DispatchTypes::VTCharacterSets::DEC_LineDrawing:
-        pwchTranslation = TerminalOutput::s_rgDECSpecialGraphicsTranslations;
+        *ppTable = &s_DECSpecialGraphicsTranslations;
+        break;
+    case DispatchTypes::VTCharacterSets::British:
+        *ppTable = &s_BritishTranslations;
+        break;
+    case DispatchTypes::VTCharacterSets::Dutch:
+        *ppTable = &s_DutchTranslations;
+        break;
+    case DispatchTypes::VTCharacterSets::Finnish:
+    case DispatchTypes::VTCharacterSets::Finnish2:
+        *ppTable = &s_FinnishTranslations;
+        break;
+    case DispatchTypes::VTCharacterSets::French:
+    case DispatchTypes::VTCharacterSets::French2:
+        *ppTable = &s_FrenchTranslations;
+        break;
+    case DispatchTypes::VTCharacterSets::FrenchCanadian:
+    case DispatchTypes::VTCharacterSets::FrenchCanadian2:
+        *ppTable = &s_FrenchCanadianTranslations;
+        break;
+    case DispatchTypes::VTCharacterSets::German:
+        *ppTable = &s_GermanTranslations;
+        break;
+    case DispatchTypes::VTCharacterSets::Italian:
+        *ppTable = &s_ItalianTranslations;
+        break;
+    case DispatchTypes::VTCharacterSets::NorwegianDanish:
+    case DispatchTypes::VTCharacterSets::NorwegianDanish2:
+    case DispatchTypes::VTCharacterSets::NorwegianDanish3:
+        *ppTable = &s_NorwegianDanishTranslations;
+        break;
+    case DispatchTypes::VTCharacterSets::Spanish:
+        *ppTable = &s_SpanishTranslations;
+        break;
+    case DispatchTypes::VTCharacterSets::Swedish:
+    case DispatchTypes::VTCharacterSets::Swedish2:
+        *ppTable = &s_SwedishTranslations;
+        break;
+    case DispatchTypes::VTCharacterSets::Swiss:
+        *ppTable = &s_SwissTranslations;
+        break;
+    default:
+        fSuccess = false;
         break;
     }
-    return pwchTranslation;
+    return fSuccess;
 }
 
-wchar_t TerminalOutput::TranslateKey(const wchar_t wch) const
+// Routine Description:
+// - Finds the first character in the string that falls in the range the table
+//      changes.
+// - Most printed text doesn't touch that range at all (think of the letters and
+//      spaces around a few line drawing characters), so the string is checked a
+//      block at a time with a branchless test per character, which the compiler
+//      vectorizes, before narrowing down to the exact position.
+// Arguments:
+// - table - The table to translate with.
+// - str - The characters to check.
+// Return Value:
+// - The index of the first character that may change, or str.size() if none will.
+size_t TerminalOutput::s_FindFirstChanged(const TranslationTable& table, const std::wstring_view str) noexcept
 {
-    wchar_t wchFound = wch;
-    if (_wchCurrentCharset == DispatchTypes::VTCharacterSets::USASCII ||
-         wch < '\x60' || wch > '\x7f') // filter out the region we know is unchanged
+    static const size_t s_cBlock = 16;
+
+    // Characters below wchFirstChanged wrap around to large unsigned values,
+    //      so a single comparison tests both ends of the range.
+    const unsigned int first = table.wchFirstChanged;
+    const unsigned int span = table.wchLastChanged - first;
+
+    size_t i = 0;
+    for (; i + s_cBlock <= str.size(); i += s_cBlock)
     {
-        ; // do nothing, these are the same as default.
+        bool fAnyChanged = false;
+        for (size_t j = 0; j < s_cBlock; j++)
+        {
+            fAnyChanged |= (str[i + j] - first) <= span;
+        }
+
+        if (fAnyChanged)
+        {
+            break;
+        }
     }
-    else
+
+    for (; i < str.size(); i++)
     {
-        const wchar_t* pwchTranslationTable = _GetTranslationTable();
-        if (pwchTranslationTable != nullptr)
+        if ((str[i] - first) <= span)
         {
-            wchFound = (pwchTranslationTable[wch - '\x20']);
+            break;
         }
     }
-    return wchFound;
+    return i;
+}
 
+wchar_t TerminalOutput::s_Translate(const TranslationTable& table, const wchar_t wch) noexcept
+{
+    return (wch >= L'\x20' && wch <= L'\x7f') ? table.translations[wch - L'\x20'] : wch;
 }
@@ -10,6 +10,8 @@ Abstract:
     characters. There are special VT modes where the display characters (values
     x20 - x7f) should be displayed as other characters. This module provides an
     componentization of that logic.
+- Tracks the charsets designated into G0 - G3, which of them is invoked into GL
+    (by LS0 - LS3), and any pending single shift (SS2/SS3).
 
 Author(s):
 - Mike Griese (migrie) 03-Mar-2016
@@ -18,27 +20,59 @@ Author(s):
 
 #include "termDispatch.hpp"
 
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+
 namespace Microsoft::Console::VirtualTerminal
 {
     class TerminalOutput sealed
     {
     public:
 
-        TerminalOutput();
+        TerminalOutput() noexcept;
         ~TerminalOutput();
 
-        wchar_t TranslateKey(const wchar_t wch) const;
-        bool DesignateCharset(const wchar_t wchNewCharset);
-        bool NeedToTranslate() const;
+        // The tables only ever change the values x20 - x7f (96 display characters)
+        static const size_t s_cDisplayCharacters = 96;
+        static const size_t s_cCharacterSets = 4;
+
+        // A replacement for each of the display characters, along with the
+        //      (inclusive) range of characters the table actually changes, so
+        //      that text outside of that range can skip the lookup entirely.
+        struct TranslationTable
+        {
+            std::array<wchar_t, s_cDisplayCharacters> translations;
+            wchar_t wchFirstChanged;
+            wchar_t wchLastChanged;
+        };
+
+        bool DesignateCharset(const size_t gsetNumber, const wchar_t wchNewCharset);
+        bool LockingShift(const size_t gsetNumber);
+        bool SingleShift(const size_t gsetNumber);
+        bool NeedToTranslate() const noexcept;
+
+        wchar_t TranslateKey(const wchar_t wch);
+        std::wstring_view TranslateString(const std::wstring_view str);
 
     private:
-        wchar_t _wchCurrentCharset = DispatchTypes::VTCharacterSets::USASCII;
+        // The charset designated into each of G0 - G3. nullptr means US-ASCII,
+        //      which never needs to be translated.
+        std::array<const TranslationTable*, s_cCharacterSets> _gsetTranslationTables;
+        size_t _glSetNumber;
+        std::optional<size_t> _ssSetNumber;
 
-        // The tables only ever change the values x20 - x7f (96 display characters)
-        static const unsigned int s_uiNumDisplayCharacters = 96;
-        static const wchar_t s_rgDECSpecialGraphicsTranslations[s_uiNumDisplayCharacters];
+        // Reused for every translated string, so that printing with a
+        //      non-ASCII charset doesn't allocate once the buffer has grown.
+        std::wstring _translatedString;
 
-        const wchar_t* _GetTranslationTable() const;
+        const TranslationTable* _GetGLTranslationTable() const noexcept;
+        const TranslationTable* _ConsumeSingleShift() noexcept;
 
+        _Success_(return)
+        static bool s_GetTranslationTable(const wchar_t wchCharset, _Out_ const TranslationTable** const ppTable) noexcept;
+        static size_t s_FindFirstChanged(const TranslationTable& table, const std::wstring_view str) noexcept;
+        static wchar_t s_Translate(const TranslationTable& table, const wchar_t wch) noexcept;
     };
 }
@@ -79,6 +79,23 @@ public:
 
         return _fGetConsoleScreenBufferInfoExResult;
     }
+    BOOL PrivateGetScreenBufferState(_Out_ ScreenBufferState* const pState) const override
+    {
+        Log::Comment(L"PrivateGetScreenBufferState MOCK returning data...");
+
+        // This is the same information as GetConsoleScreenBufferInfoEx, so it
+        //      fails whenever that would.
+        if (_fGetConsoleScreenBufferInfoExResult)
+        {
+            pState->dwSize = _coordBufferSize;
+            pState->srWindow = _srViewport;
+            pState->dwCursorPosition = _coordCursorPos;
+            pState->wAttributes = _wAttribute;
+            pState->srScrollMargins = { 0 };
+        }
+
+        return _fGetConsoleScreenBufferInfoExResult;
+    }
     BOOL SetConsoleScreenBufferInfoEx(const CONSOLE_SCREEN_BUFFER_INFOEX* const psbiex) override
     {
         Log::Comment(L"SetConsoleScreenBufferInfoEx MOCK returning data...");
@@ -249,6 +266,34 @@ public:
         return _fFillConsoleOutputAttributeResult;
     }
 
+    BOOL PrivateFillRect(const SMALL_RECT* const psrFill, const wchar_t wch, const WORD wAttributes) override
+    {
+        Log::Comment(L"PrivateFillRect MOCK called...");
+
+        // This stands in for a FillConsoleOutputCharacterW and a
+        //      FillConsoleOutputAttribute over the same area, so it fails
+        //      whenever either of those would.
+        const BOOL fResult = _fFillConsoleOutputCharacterWResult && _fFillConsoleOutputAttributeResult;
+
+        if (fResult)
+        {
+            Log::Comment(NoThrowString().Format(L"Filling (L: %d, T: %d, R: %d, B: %d) with '%c' and 0x%x attribute...",
+                                                psrFill->Left, psrFill->Top, psrFill->Right, psrFill->Bottom, wch, wAttributes));
+
+            for (short y = psrFill->Top; y <= psrFill->Bottom; y++)
+            {
+                for (short x = psrFill->Left; x <= psrFill->Right; x++)
+                {
+                    CHAR_INFO* pchar = _GetCharAt(y, x);
+                    pchar->Char.UnicodeChar = wch;
+                    pchar->Attributes = wAttributes;
+                }
+            }
+        }
+
+        return fResult;
+    }
+
     BOOL SetConsoleTextAttribute(const WORD wAttr) override
     {
         Log::Comment(L"SetConsoleTextAttribute MOCK called...");
@@ -347,24 +392,44 @@ public:
         return !!_fPrivateBoldTextResult;
     }
 
-    BOOL PrivateWriteConsoleInputW(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& events,
+    BOOL PrivateWriteConsoleInputW(const gsl::span<const INPUT_RECORD> records,
                                    _Out_ size_t& eventsWritten) override
     {
         Log::Comment(L"PrivateWriteConsoleInputW MOCK called...");
 
         if (_fPrivateWriteConsoleInputWResult)
         {
-            // move all the input events we were given into local storage so we can test against them
-            Log::Comment(NoThrowString().Format(L"Moving %zu input events into local storage...", events.size()));
+            // copy all the input records we were given into local storage so we can test against them
+            Log::Comment(NoThrowString().Format(L"Copying %zu input records into local storage...", records.size()));
 
-            _events.clear();
-            _events.swap(events);
+            _events = IInputEvent::Create(records);
             eventsWritten = _events.size();
         }
 
         return _fPrivateWriteConsoleInputWResult;
     }
 
+    BOOL PrivatePostConsoleInput(const gsl::span<const INPUT_RECORD> records) override
+    {
+        Log::Comment(L"PrivatePostConsoleInput MOCK called...");
+
+        size_t eventsWritten;
+        return PrivateWriteConsoleInputW(records, eventsWritten);
+    }
+
+    BOOL PrivateWriteConsoleInputText(const std::wstring_view text,
+                                      _Out_ size_t& charsWritten) override
+    {
+        Log::Comment(L"PrivateWriteConsoleInputText MOCK called...");
+
+        if (_fPrivateWriteConsoleInputWResult)
+        {
+            charsWritten = text.size();
+        }
+
+        return _fPrivateWriteConsoleInputWResult;
+    }
+
     BOOL PrivatePrependConsoleInput(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& events,
                                     _Out_ size_t& eventsWritten) override
     {
@@ -1384,17 +1449,22 @@ private:
 
 class DummyAdapter : public AdaptDefaults
 {
-    void Print(const wchar_t /*wch*/) override
+public:
+    void Print(const wchar_t wch) override
     {
+        _printed.push_back(wch);
     }
 
-    void PrintString(_In_reads_(_Param_(2)) const wchar_t* const /*rgwch*/, const size_t /*cch*/) override
+    void PrintString(_In_reads_(_Param_(2)) const wchar_t* const rgwch, const size_t cch) override
     {
+        _printed.append(rgwch, cch);
     }
 
     void Execute(const wchar_t /*wch*/) override
     {
     }
+
+    std::wstring _printed;
 };
 
 class AdapterTest
@@ -1411,8 +1481,9 @@ public:
         fSuccess = _testGetSet != nullptr;
         if (fSuccess)
         {
-            // give AdaptDispatch ownership of _testGetSet
-            _pDispatch = new AdaptDispatch(_testGetSet, new DummyAdapter);
+            // give AdaptDispatch ownership of _testGetSet and _testDefaults
+            _testDefaults = new DummyAdapter;
+            _pDispatch = new AdaptDispatch(_testGetSet, _testDefaults);
             fSuccess = _pDispatch != nullptr;
         }
         return fSuccess;
@@ -1422,6 +1493,7 @@ public:
     {
         delete _pDispatch;
         _testGetSet = nullptr;
+        _testDefaults = nullptr;
         return true;
     }
 
@@ -3506,7 +3578,59 @@ public:
 
     }
 
+    TEST_METHOD(CharsetDesignationTests)
+    {
+        Log::Comment(L"Test 1: Text is printed untranslated by default.");
+        _pDispatch->PrintString(L"#lqk`", 5);
+        VERIFY_ARE_EQUAL(std::wstring(L"#lqk`"), _testDefaults->_printed);
+
+        Log::Comment(L"Test 2: Line drawing in G0 translates everything printed.");
+        _testDefaults->_printed.clear();
+        VERIFY_IS_TRUE(_pDispatch->DesignateCharset(0, DispatchTypes::VTCharacterSets::DEC_LineDrawing));
+        _pDispatch->PrintString(L"BOX: lqk", 8);
+        _pDispatch->Print(L'x');
+        VERIFY_ARE_EQUAL(std::wstring(L"BOX: \u250C\u2500\u2510\u2502"), _testDefaults->_printed);
+
+        Log::Comment(L"Test 3: Unsupported charsets are ignored, and leave the designation alone.");
+        _testDefaults->_printed.clear();
+        VERIFY_IS_FALSE(_pDispatch->DesignateCharset(0, L'%'));
+        VERIFY_IS_FALSE(_pDispatch->DesignateCharset(4, DispatchTypes::VTCharacterSets::USASCII));
+        _pDispatch->PrintString(L"q", 1);
+        VERIFY_ARE_EQUAL(std::wstring(L"\u2500"), _testDefaults->_printed);
+
+        Log::Comment(L"Test 4: A locking shift invokes G1 until the next locking shift.");
+        _testDefaults->_printed.clear();
+        VERIFY_IS_TRUE(_pDispatch->DesignateCharset(1, DispatchTypes::VTCharacterSets::German));
+        VERIFY_IS_TRUE(_pDispatch->LockingShift(1));
+        _pDispatch->PrintString(L"[q]", 3);
+        VERIFY_IS_TRUE(_pDispatch->LockingShift(0));
+        _pDispatch->PrintString(L"[q]", 3);
+        VERIFY_ARE_EQUAL(std::wstring(L"\u00C4q\u00DC[\u2500]"), _testDefaults->_printed);
+
+        Log::Comment(L"Test 5: A single shift only applies to the next character.");
+        _testDefaults->_printed.clear();
+        VERIFY_IS_TRUE(_pDispatch->DesignateCharset(0, DispatchTypes::VTCharacterSets::USASCII));
+        VERIFY_IS_TRUE(_pDispatch->DesignateCharset(2, DispatchTypes::VTCharacterSets::British));
+        VERIFY_IS_TRUE(_pDispatch->SingleShift(2));
+        _pDispatch->PrintString(L"##", 2);
+        VERIFY_IS_TRUE(_pDispatch->SingleShift(2));
+        _pDispatch->Print(L'#');
+        _pDispatch->Print(L'#');
+        VERIFY_ARE_EQUAL(std::wstring(L"\u00A3#\u00A3#"), _testDefaults->_printed);
+
+        Log::Comment(L"Test 6: Long runs are only translated where the charset changes them.");
+        _testDefaults->_printed.clear();
+        VERIFY_IS_TRUE(_pDispatch->LockingShift(2));
+        std::wstring expected(100, L'a');
+        std::wstring run(100, L'a');
+        run[70] = L'#';
+        expected[70] = L'\u00A3';
+        _pDispatch->PrintString(run.data(), run.size());
+        VERIFY_ARE_EQUAL(expected, _testDefaults->_printed);
+    }
+
 private:
     TestGetSet* _testGetSet; // non-ownership pointer
+    DummyAdapter* _testDefaults; // non-ownership pointer
     AdaptDispatch* _pDispatch;
 };
@@ -39,13 +39,14 @@ public:
 
     TEST_CLASS(InputTest);
 
-    static void s_TerminalInputTestCallback(_In_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
-    static void s_TerminalInputTestNullCallback(_In_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    static void s_TerminalInputTestCallback(const gsl::span<const INPUT_RECORD> records);
+    static void s_TerminalInputTestNullCallback(const gsl::span<const INPUT_RECORD> records);
 
     TEST_METHOD(TerminalInputTests);
     TEST_METHOD(TerminalInputModifierKeyTests);
     TEST_METHOD(TerminalInputNullKeyTests);
     TEST_METHOD(DifferentModifiersTest);
+    TEST_METHOD(KeySequenceTableTest);
 
     wchar_t GetModifierChar(const bool fShift, const bool fAlt, const bool fCtrl)
     {
@@ -79,14 +80,13 @@ public:
     }
 };
 
-void InputTest::s_TerminalInputTestCallback(_In_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+void InputTest::s_TerminalInputTestCallback(const gsl::span<const INPUT_RECORD> records)
 {
-    auto records = IInputEvent::ToInputRecords(inEvents);
-
     size_t cInputExpected = 0;
     VERIFY_SUCCEEDED(StringCchLengthW(s_pwszInputExpected, STRSAFE_MAX_CCH, &cInputExpected));
 
-    if (VERIFY_ARE_EQUAL(cInputExpected, records.size(), L"Verify expected and actual input array lengths matched."))
+    const size_t cRecords = gsl::narrow<size_t>(records.size());
+    if (VERIFY_ARE_EQUAL(cInputExpected, cRecords, L"Verify expected and actual input array lengths matched."))
     {
         Log::Comment(L"We are expecting always key events and always key down. All other properties should not be written by simulated keys.");
 
@@ -96,7 +96,7 @@ void InputTest::s_TerminalInputTestCallback(_In_ std::deque<std::unique_ptr<IInp
         irExpected.Event.KeyEvent.wRepeatCount = 1;
 
         Log::Comment(L"Verifying individual array members...");
-        for (size_t i = 0; i < records.size(); i++)
+        for (size_t i = 0; i < cRecords; i++)
         {
             irExpected.Event.KeyEvent.uChar.UnicodeChar = s_pwszInputExpected[i];
             VERIFY_ARE_EQUAL(irExpected, records[i], NoThrowString().Format(L"%c, %c", s_pwszInputExpected[i], records[i].Event.KeyEvent.uChar.UnicodeChar));
@@ -104,10 +104,8 @@ void InputTest::s_TerminalInputTestCallback(_In_ std::deque<std::unique_ptr<IInp
     }
 }
 
-void InputTest::s_TerminalInputTestNullCallback(_In_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+void InputTest::s_TerminalInputTestNullCallback(const gsl::span<const INPUT_RECORD> records)
 {
-    auto records = IInputEvent::ToInputRecords(inEvents);
-
     if (records.size() == 1)
     {
         Log::Comment(L"We are expecting a null input event.");
@@ -686,4 +684,39 @@ void InputTest::DifferentModifiersTest()
     TestKey(pInput, uiKeystate, vkey, L'/');
     uiKeystate = RIGHT_ALT_PRESSED;
     TestKey(pInput, uiKeystate, vkey, L'/');
+
+    // Keys in '0'..'Z' with no char, like C-1, are handled but send nothing, not a NUL.
+    uiKeystate = LEFT_CTRL_PRESSED;
+    vkey = '1';
+    s_pwszInputExpected = L"";
+    TestKey(pInput, uiKeystate, vkey);
+    uiKeystate = 0;
+    vkey = 'A';
+    TestKey(pInput, uiKeystate, vkey);
+}
+
+void InputTest::KeySequenceTableTest()
+{
+    Log::Comment(L"Cursor keys depend on the cursor keys mode when unmodified.");
+    VERIFY_ARE_EQUAL(std::wstring_view(L"\x1b[A"), TerminalInput::s_GetKeySequence(VK_UP, false, false, false, false, false));
+    VERIFY_ARE_EQUAL(std::wstring_view(L"\x1bOA"), TerminalInput::s_GetKeySequence(VK_UP, false, false, false, true, false));
+
+    Log::Comment(L"The keypad depends on the keypad mode when unmodified.");
+    VERIFY_ARE_EQUAL(std::wstring_view(L"\x1b[3~"), TerminalInput::s_GetKeySequence(VK_DELETE, false, false, false, false, false));
+    VERIFY_ARE_EQUAL(std::wstring_view(L"\x1bOP"), TerminalInput::s_GetKeySequence(VK_F1, false, false, false, false, true));
+
+    Log::Comment(L"Modified keys encode their modifiers, in every mode.");
+    VERIFY_ARE_EQUAL(std::wstring_view(L"\x1b[1;2A"), TerminalInput::s_GetKeySequence(VK_UP, true, false, false, false, false));
+    VERIFY_ARE_EQUAL(std::wstring_view(L"\x1b[1;8A"), TerminalInput::s_GetKeySequence(VK_UP, true, true, true, true, true));
+    VERIFY_ARE_EQUAL(std::wstring_view(L"\x1b[24;5~"), TerminalInput::s_GetKeySequence(VK_F12, false, false, true, false, true));
+
+    Log::Comment(L"Some keys only have a sequence with exactly these modifiers.");
+    VERIFY_ARE_EQUAL(std::wstring_view(L"\x1b[Z"), TerminalInput::s_GetKeySequence(VK_TAB, true, false, false, false, false));
+    VERIFY_ARE_EQUAL(std::wstring_view(L"\x1b\x8"), TerminalInput::s_GetKeySequence(VK_BACK, false, true, true, false, false));
+    VERIFY_IS_TRUE(TerminalInput::s_GetKeySequence(VK_TAB, true, false, true, false, false).empty());
+
+    Log::Comment(L"Keys that aren't mapped have no sequence.");
+    VERIFY_IS_TRUE(TerminalInput::s_GetKeySequence('A', false, false, false, false, false).empty());
+    VERIFY_IS_TRUE(TerminalInput::s_GetKeySequence('A', false, false, true, false, false).empty());
+    VERIFY_IS_TRUE(TerminalInput::s_GetKeySequence(0x1234, false, false, false, false, false).empty());
 }
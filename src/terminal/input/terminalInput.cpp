@@ -20,7 +20,7 @@ using namespace Microsoft::Console::VirtualTerminal;
 
 DWORD const dwAltGrFlags = LEFT_CTRL_PRESSED | RIGHT_ALT_PRESSED;
 
-TerminalInput::TerminalInput(_In_ std::function<void(std::deque<std::unique_ptr<IInputEvent>>&)> pfn)
+TerminalInput::TerminalInput(_In_ std::function<void(const gsl::span<const INPUT_RECORD>)> pfn)
 {
     _pfnWriteEvents = pfn;
 }
@@ -30,11 +30,47 @@ TerminalInput::~TerminalInput()
 
 }
 
+// The modifier keys, as bits of the index into the table of key sequences.
+//      Adding one to this mask gives the modifier parameter that xterm sends
+//      with a modified key.
+static constexpr size_t s_ShiftBit = 0x1;
+static constexpr size_t s_AltBit = 0x2;
+static constexpr size_t s_CtrlBit = 0x4;
+static constexpr size_t s_cModifierMasks = 8;
+
+// The cursor keys and keypad modes, as bits of the index into the table of
+//      key sequences.
+static constexpr size_t s_CursorApplicationBit = 0x1;
+static constexpr size_t s_KeypadApplicationBit = 0x2;
+static constexpr size_t s_cModes = 4;
+
+// Do NOT include the null terminator in the count.
+static constexpr size_t s_cchMaxSequenceLength = 7;
+
+struct TermKeyMap
+{
+    WORD wVirtualKey;
+    // If this is 0, then the mapping doesn't care what the modifiers are.
+    //      Otherwise, the modifiers pressed have to be exactly these.
+    size_t modifiers;
+    std::wstring_view sequence;
+
+    constexpr TermKeyMap(const WORD wVirtualKey, const std::wstring_view sequence) :
+        wVirtualKey(wVirtualKey),
+        modifiers(0),
+        sequence(sequence) {};
+
+    constexpr TermKeyMap(const WORD wVirtualKey, const size_t modifiers, const std::wstring_view sequence) :
+        wVirtualKey(wVirtualKey),
+        modifiers(modifiers),
+        sequence(sequence) {};
+};
+
 // See http://invisible-island.net/xterm/ctlseqs/ctlseqs.html#h2-PC-Style-Function-Keys
 //    For the source for these tables.
 // Also refer to the values in terminfo for kcub1, kcud1, kcuf1, kcuu1, kend, khome.
 //   the 'xterm' setting lists the application mode versions of these sequences.
-const TerminalInput::_TermKeyMap TerminalInput::s_rgCursorKeysNormalMapping[]
+static constexpr TermKeyMap s_rgCursorKeysNormalMapping[]
 {
     { VK_UP, L"\x1b[A" },
     { VK_DOWN, L"\x1b[B" },
@@ -44,7 +80,7 @@ const TerminalInput::_TermKeyMap TerminalInput::s_rgCursorKeysNormalMapping[]
     { VK_END, L"\x1b[F" },
 };
 
-const TerminalInput::_TermKeyMap TerminalInput::s_rgCursorKeysApplicationMapping[]
+static constexpr TermKeyMap s_rgCursorKeysApplicationMapping[]
 {
     { VK_UP, L"\x1bOA" },
     { VK_DOWN, L"\x1bOB" },
@@ -54,9 +90,8 @@ const TerminalInput::_TermKeyMap TerminalInput::s_rgCursorKeysApplicationMapping
     { VK_END, L"\x1bOF" },
 };
 
-const TerminalInput::_TermKeyMap TerminalInput::s_rgKeypadNumericMapping[]
+static constexpr TermKeyMap s_rgKeypadNumericMapping[]
 {
-    // HEY YOU. UPDATE THE MAX LENGTH DEF WHEN YOU MAKE CHANGES HERE.
     { VK_TAB, L"\x09"},
     { VK_BACK, L"\x7f"},
     { VK_PAUSE, L"\x1a" },
@@ -88,9 +123,8 @@ const TerminalInput::_TermKeyMap TerminalInput::s_rgKeypadNumericMapping[]
 //It seems to me as though this was used for early numpad implementations, where presently numlock would enable
 //  "numeric" mode, outputting the numbers on the keys, while "application" mode does things like pgup/down, arrow keys, etc.
 //These keys aren't translated at all in numeric mode, so I figured I'd leave them out of the numeric table.
-const TerminalInput::_TermKeyMap TerminalInput::s_rgKeypadApplicationMapping[]
+static constexpr TermKeyMap s_rgKeypadApplicationMapping[]
 {
-    // HEY YOU. UPDATE THE MAX LENGTH DEF WHEN YOU MAKE CHANGES HERE.
     { VK_TAB, L"\x09" },
     { VK_BACK, L"\x7f" },
     { VK_PAUSE, L"\x1a" },
@@ -143,9 +177,8 @@ const TerminalInput::_TermKeyMap TerminalInput::s_rgKeypadApplicationMapping[]
 // Sequences to send when a modifier is pressed with any of these keys
 // Basically, the 'm' will be replaced with a character indicating which
 //      modifier keys are pressed.
-const TerminalInput::_TermKeyMap TerminalInput::s_rgModifierKeyMapping[]
+static constexpr TermKeyMap s_rgModifierKeyMapping[]
 {
-    // HEY YOU. UPDATE THE MAX LENGTH DEF WHEN YOU MAKE CHANGES HERE.
     { VK_UP, L"\x1b[1;mA" },
     { VK_DOWN, L"\x1b[1;mB" },
     { VK_RIGHT, L"\x1b[1;mC" },
@@ -177,208 +210,267 @@ const TerminalInput::_TermKeyMap TerminalInput::s_rgModifierKeyMapping[]
 // These sequences are not later updated to encode the modifier state in the
 //      sequence itself, they are just weird exceptional cases to the general
 //      rules above.
-const TerminalInput::_TermKeyMap TerminalInput::s_rgSimpleModifedKeyMapping[]
+static constexpr TermKeyMap s_rgSimpleModifedKeyMapping[]
 {
-    // HEY YOU. UPDATE THE MAX LENGTH DEF WHEN YOU MAKE CHANGES HERE.
-    { VK_BACK, CTRL_PRESSED, L"\x8"},
-    { VK_BACK, ALT_PRESSED, L"\x1b\x7f"},
-    { VK_BACK, CTRL_PRESSED | ALT_PRESSED, L"\x1b\x8"},
-    { VK_TAB, CTRL_PRESSED, L"\t"},
-    { VK_TAB, SHIFT_PRESSED, L"\x1b[Z"},
-    { VK_DIVIDE, CTRL_PRESSED, L"\x1F"},
+    { VK_BACK, s_CtrlBit, L"\x8"},
+    { VK_BACK, s_AltBit, L"\x1b\x7f"},
+    { VK_BACK, s_CtrlBit | s_AltBit, L"\x1b\x8"},
+    { VK_TAB, s_CtrlBit, L"\t"},
+    { VK_TAB, s_ShiftBit, L"\x1b[Z"},
+    { VK_DIVIDE, s_CtrlBit, L"\x1F"},
     // These two are not implemented here, because they are system keys.
     // { VK_TAB, ALT_PRESSED, L""}, This is the Windows system shortcut for switching windows.
     // { VK_ESCAPE, ALT_PRESSED, L""}, This is another Windows system shortcut for switching windows.
 };
 
-const wchar_t* const CTRL_SLASH_SEQUENCE = L"\x1f";
-
-// Do NOT include the null terminator in the count.
-const size_t TerminalInput::_TermKeyMap::s_cchMaxSequenceLength = 7; // UPDATE THIS DEF WHEN THE LONGEST MAPPED STRING CHANGES
-
-const size_t TerminalInput::s_cCursorKeysNormalMapping      = ARRAYSIZE(s_rgCursorKeysNormalMapping);
-const size_t TerminalInput::s_cCursorKeysApplicationMapping = ARRAYSIZE(s_rgCursorKeysApplicationMapping);
-const size_t TerminalInput::s_cKeypadNumericMapping         = ARRAYSIZE(s_rgKeypadNumericMapping);
-const size_t TerminalInput::s_cKeypadApplicationMapping     = ARRAYSIZE(s_rgKeypadApplicationMapping);
-const size_t TerminalInput::s_cModifierKeyMapping           = ARRAYSIZE(s_rgModifierKeyMapping);
-const size_t TerminalInput::s_cSimpleModifedKeyMapping      = ARRAYSIZE(s_rgSimpleModifedKeyMapping);
+// The tables above are only the source for the table below, which is built
+//      at compile time. It holds the sequence to send for every mapped key, in
+//      every combination of modifier keys and modes. Finding a key's sequence
+//      is then just an index, rather than a search through the tables.
+// The unmodified sequences depend on the modes. The modified ones don't, and
+//      are the same in every mode.
+struct KeySequence
+{
+    wchar_t chars[s_cchMaxSequenceLength];
+    BYTE length;
+};
 
-void TerminalInput::ChangeKeypadMode(const bool fApplicationMode)
+template<size_t N>
+static constexpr size_t s_CountNewKeys(const TermKeyMap (&mapping)[N], bool (&seen)[256])
 {
-    _fKeypadApplicationMode = fApplicationMode;
+    size_t count = 0;
+    for (const auto& map : mapping)
+    {
+        if (!seen[map.wVirtualKey])
+        {
+            seen[map.wVirtualKey] = true;
+            ++count;
+        }
+    }
+    return count;
 }
 
-void TerminalInput::ChangeCursorKeysMode(const bool fApplicationMode)
+static constexpr size_t s_CountMappedKeys()
 {
-    _fCursorApplicationMode = fApplicationMode;
+    bool seen[256]{};
+    return s_CountNewKeys(s_rgCursorKeysNormalMapping, seen) +
+           s_CountNewKeys(s_rgCursorKeysApplicationMapping, seen) +
+           s_CountNewKeys(s_rgKeypadNumericMapping, seen) +
+           s_CountNewKeys(s_rgKeypadApplicationMapping, seen) +
+           s_CountNewKeys(s_rgModifierKeyMapping, seen) +
+           s_CountNewKeys(s_rgSimpleModifedKeyMapping, seen);
 }
 
-const size_t TerminalInput::GetKeyMappingLength(const KeyEvent& keyEvent) const
+static constexpr size_t s_cMappedKeys = s_CountMappedKeys();
+static_assert(s_cMappedKeys < 256, "The slots of the key sequence table have to fit in a byte.");
+
+struct KeySequenceTable
 {
-    size_t length = 0;
-    if (keyEvent.IsCursorKey())
-    {
-        length = (_fCursorApplicationMode) ? s_cCursorKeysApplicationMapping : s_cCursorKeysNormalMapping;
-    }
-    else
+    // The index of each virtual key's sequences, plus one. 0 if it isn't mapped.
+    BYTE slots[256];
+    KeySequence sequences[s_cModes][s_cModifierMasks][s_cMappedKeys];
+};
+
+template<size_t N>
+static constexpr void s_AssignSlots(KeySequenceTable& table, size_t& cSlots, const TermKeyMap (&mapping)[N])
+{
+    for (const auto& map : mapping)
     {
-        length = (_fKeypadApplicationMode) ? s_cKeypadApplicationMapping : s_cKeypadNumericMapping;
+        if (table.slots[map.wVirtualKey] == 0)
+        {
+            table.slots[map.wVirtualKey] = static_cast<BYTE>(++cSlots);
+        }
     }
-    return length;
 }
 
-const TerminalInput::_TermKeyMap* TerminalInput::GetKeyMapping(const KeyEvent& keyEvent) const
+// A sequence longer than s_cchMaxSequenceLength writes past the end of its
+//      entry, which fails the build.
+static constexpr void s_SetSequence(KeySequenceTable& table,
+                                    const size_t mode,
+                                    const size_t modifiers,
+                                    const WORD wVirtualKey,
+                                    const std::wstring_view sequence)
 {
-    const TerminalInput::_TermKeyMap* mapping = nullptr;
-
-    if (keyEvent.IsCursorKey())
+    KeySequence& entry = table.sequences[mode][modifiers][table.slots[wVirtualKey] - 1];
+    for (size_t i = 0; i < sequence.size(); ++i)
     {
-        mapping = (_fCursorApplicationMode) ? s_rgCursorKeysApplicationMapping : s_rgCursorKeysNormalMapping;
+        entry.chars[i] = sequence[i];
     }
-    else
+    entry.length = static_cast<BYTE>(sequence.size());
+}
+
+template<size_t N>
+static constexpr void s_SetUnmodifiedSequences(KeySequenceTable& table,
+                                               const size_t mode,
+                                               const bool fCursorKeys,
+                                               const TermKeyMap (&mapping)[N])
+{
+    for (const auto& map : mapping)
     {
-        mapping = (_fKeypadApplicationMode) ? s_rgKeypadApplicationMapping : s_rgKeypadNumericMapping;
+        // The same test as KeyEvent::IsCursorKey.
+        const bool fIsCursorKey = map.wVirtualKey >= VK_END && map.wVirtualKey <= VK_DOWN;
+        if (fIsCursorKey == fCursorKeys)
+        {
+            s_SetSequence(table, mode, 0, map.wVirtualKey, map.sequence);
+        }
     }
-    return mapping;
 }
 
-// Routine Description:
-// - Searches the s_ModifierKeyMapping for a entry corresponding to this key event.
-//      Changes the second to last byte to correspond to the currently pressed modifier keys
-//      before sending to the input.
-// Arguments:
-// - keyEvent - Key event to translate
-// Return Value:
-// - True if there was a match to a key translation, and we successfully modified and sent it to the input
-bool TerminalInput::_SearchWithModifier(const KeyEvent& keyEvent) const
+static constexpr KeySequenceTable s_MakeKeySequenceTable()
 {
+    KeySequenceTable table{};
+
+    size_t cSlots = 0;
+    s_AssignSlots(table, cSlots, s_rgCursorKeysNormalMapping);
+    s_AssignSlots(table, cSlots, s_rgCursorKeysApplicationMapping);
+    s_AssignSlots(table, cSlots, s_rgKeypadNumericMapping);
+    s_AssignSlots(table, cSlots, s_rgKeypadApplicationMapping);
+    s_AssignSlots(table, cSlots, s_rgModifierKeyMapping);
+    s_AssignSlots(table, cSlots, s_rgSimpleModifedKeyMapping);
 
-    const TerminalInput::_TermKeyMap* pMatchingMapping;
-    bool fSuccess = _SearchKeyMapping(keyEvent,
-                                      s_rgModifierKeyMapping,
-                                      s_cModifierKeyMapping,
-                                      &pMatchingMapping);
-    if (fSuccess)
+    for (size_t mode = 0; mode < s_cModes; ++mode)
     {
-        size_t cch = 0;
-        if (SUCCEEDED(StringCchLengthW(pMatchingMapping->pwszSequence, _TermKeyMap::s_cchMaxSequenceLength + 1, &cch)) &&
-            cch > 0)
+        if (mode & s_CursorApplicationBit)
         {
-            wchar_t* rwchModifiedSequence = new(std::nothrow) wchar_t[cch + 1];
-            if (rwchModifiedSequence != nullptr)
-            {
-                memcpy(rwchModifiedSequence, pMatchingMapping->pwszSequence, cch * sizeof(wchar_t));
-                const bool fShift = keyEvent.IsShiftPressed();
-                const bool fAlt = keyEvent.IsAltPressed();
-                const bool fCtrl = keyEvent.IsCtrlPressed();
-                rwchModifiedSequence[cch - 2] = L'1' + (fShift ? 1 : 0) + (fAlt ? 2 : 0) + (fCtrl ? 4 : 0);
-                rwchModifiedSequence[cch] = 0;
-                _SendInputSequence(rwchModifiedSequence);
-                fSuccess = true;
-                delete [] rwchModifiedSequence;
-            }
+            s_SetUnmodifiedSequences(table, mode, true, s_rgCursorKeysApplicationMapping);
         }
-    }
-    else
-    {
-        // We didn't find the key in the map of modified keys that need editing,
-        //      maybe it's in the other map of modified keys with sequences that
-        //      don't need editing before sending.
-        fSuccess = _SearchKeyMapping(keyEvent,
-                                     s_rgSimpleModifedKeyMapping,
-                                     s_cSimpleModifedKeyMapping,
-                                     &pMatchingMapping);
-        if (fSuccess)
+        else
         {
-            // This mapping doesn't need to be changed at all.
-            _SendInputSequence(pMatchingMapping->pwszSequence);
-            fSuccess = true;
+            s_SetUnmodifiedSequences(table, mode, true, s_rgCursorKeysNormalMapping);
+        }
+
+        if (mode & s_KeypadApplicationBit)
+        {
+            s_SetUnmodifiedSequences(table, mode, false, s_rgKeypadApplicationMapping);
         }
         else
         {
-            // One last check: C-/ is supposed to be C-_
-            // But '/' is not the same VKEY on all keyboards. So we have to
-            //      figure out the vkey at runtime.
-            const BYTE slashVkey = LOBYTE(VkKeyScan(L'/'));
-            if (keyEvent.GetVirtualKeyCode() == slashVkey && keyEvent.IsCtrlPressed())
+            s_SetUnmodifiedSequences(table, mode, false, s_rgKeypadNumericMapping);
+        }
+
+        for (size_t modifiers = 1; modifiers < s_cModifierMasks; ++modifiers)
+        {
+            for (const auto& map : s_rgSimpleModifedKeyMapping)
             {
-                // This mapping doesn't need to be changed at all.
-                _SendInputSequence(CTRL_SLASH_SEQUENCE);
-                fSuccess = true;
+                if (map.modifiers == modifiers)
+                {
+                    s_SetSequence(table, mode, modifiers, map.wVirtualKey, map.sequence);
+                }
+            }
 
+            // The modifier mapping is searched before the simple one, so these
+            //      go in last. The 'm' in each is replaced with the modifier parameter.
+            for (const auto& map : s_rgModifierKeyMapping)
+            {
+                s_SetSequence(table, mode, modifiers, map.wVirtualKey, map.sequence);
+                KeySequence& entry = table.sequences[mode][modifiers][table.slots[map.wVirtualKey] - 1];
+                entry.chars[entry.length - 2] = static_cast<wchar_t>(L'1' + modifiers);
             }
         }
     }
+    return table;
+}
 
-    return fSuccess;
+static constexpr KeySequenceTable s_keySequences = s_MakeKeySequenceTable();
+
+const wchar_t* const CTRL_SLASH_SEQUENCE = L"\x1f";
+
+void TerminalInput::ChangeKeypadMode(const bool fApplicationMode)
+{
+    _fKeypadApplicationMode = fApplicationMode;
+}
+
+void TerminalInput::ChangeCursorKeysMode(const bool fApplicationMode)
+{
+    _fCursorApplicationMode = fApplicationMode;
 }
 
 // Routine Description:
-// - Searches the keyMapping for a entry corresponding to this key event, and returns it.
+// - Finds the sequence that a key sends, with the given modifier keys, in the
+//      given modes.
 // Arguments:
-// - keyEvent - Key event to translate
-// - keyMapping - Array of key mappings to search
-// - cKeyMapping - number of entries in keyMapping
-// - pMatchingMapping - Where to put the pointer to the found match
+// - wVirtualKey - the virtual key code of the key
+// - fShift, fAlt, fCtrl - the modifier keys that are pressed
+// - fCursorApplicationMode - true if the cursor keys are in application mode
+// - fKeypadApplicationMode - true if the keypad is in application mode
 // Return Value:
-// - True if there was a match to a key translation
-bool TerminalInput::_SearchKeyMapping(const KeyEvent& keyEvent,
-                                      _In_reads_(cKeyMapping) const TerminalInput::_TermKeyMap* keyMapping,
-                                      const size_t cKeyMapping,
-                                      _Out_ const TerminalInput::_TermKeyMap** pMatchingMapping) const
+// - The sequence, or an empty view if the key isn't mapped with those modifiers.
+std::wstring_view TerminalInput::s_GetKeySequence(const WORD wVirtualKey,
+                                                  const bool fShift,
+                                                  const bool fAlt,
+                                                  const bool fCtrl,
+                                                  const bool fCursorApplicationMode,
+                                                  const bool fKeypadApplicationMode) noexcept
 {
-    bool fKeyTranslated = false;
-    for (size_t i = 0; i < cKeyMapping; i++)
+    if (wVirtualKey >= ARRAYSIZE(s_keySequences.slots) || s_keySequences.slots[wVirtualKey] == 0)
     {
-        const _TermKeyMap* const pMap = &(keyMapping[i]);
+        return {};
+    }
 
-        if (pMap->wVirtualKey == keyEvent.GetVirtualKeyCode())
-        {
-            // If the mapping has no modifiers set, then it doesn't really care
-            //      what the modifiers are on the key. The caller will likely do
-            //      something with them.
-            // However, if there are modifiers set, then we only want to match
-            //      if the key's modifiers are the same as the modifiers in the
-            //      mapping.
-            bool modifiersMatch = WI_AreAllFlagsClear(pMap->dwModifiers, MOD_PRESSED);
-            if (!modifiersMatch)
-            {
-                // The modifier mapping expects certain modifier keys to be
-                //      pressed. Check those as well.
-                modifiersMatch =
-                    (WI_IsFlagSet(pMap->dwModifiers, SHIFT_PRESSED) == keyEvent.IsShiftPressed()) &&
-                    (WI_IsAnyFlagSet(pMap->dwModifiers, ALT_PRESSED) == keyEvent.IsAltPressed()) &&
-                    (WI_IsAnyFlagSet(pMap->dwModifiers, CTRL_PRESSED) == keyEvent.IsCtrlPressed());
-            }
+    const size_t modifiers = (fShift ? s_ShiftBit : 0) | (fAlt ? s_AltBit : 0) | (fCtrl ? s_CtrlBit : 0);
+    const size_t mode = (fCursorApplicationMode ? s_CursorApplicationBit : 0) | (fKeypadApplicationMode ? s_KeypadApplicationBit : 0);
+    const KeySequence& entry = s_keySequences.sequences[mode][modifiers][s_keySequences.slots[wVirtualKey] - 1];
+    return { entry.chars, entry.length };
+}
 
-            if (modifiersMatch)
-            {
-                fKeyTranslated = true;
-                *pMatchingMapping = pMap;
-                break;
-            }
+// Routine Description:
+// - Looks up the sequence for this key event with its modifiers, and sends it
+//      to the input. For the keys that encode their modifiers, the sequence
+//      already has the modifier parameter in it.
+// Arguments:
+// - keyEvent - Key event to translate
+// Return Value:
+// - True if there was a match to a key translation, and we successfully modified and sent it to the input
+bool TerminalInput::_SearchWithModifier(const KeyEvent& keyEvent) const
+{
+    bool fSuccess = false;
+    const std::wstring_view sequence = s_GetKeySequence(keyEvent.GetVirtualKeyCode(),
+                                                        keyEvent.IsShiftPressed(),
+                                                        keyEvent.IsAltPressed(),
+                                                        keyEvent.IsCtrlPressed(),
+                                                        _fCursorApplicationMode,
+                                                        _fKeypadApplicationMode);
+    if (!sequence.empty())
+    {
+        _SendInputSequence(sequence);
+        fSuccess = true;
+    }
+    else
+    {
+        // One last check: C-/ is supposed to be C-_
+        // But '/' is not the same VKEY on all keyboards. So we have to
+        //      figure out the vkey at runtime.
+        const BYTE slashVkey = LOBYTE(VkKeyScan(L'/'));
+        if (keyEvent.GetVirtualKeyCode() == slashVkey && keyEvent.IsCtrlPressed())
+        {
+            // This mapping doesn't need to be changed at all.
+            _SendInputSequence(CTRL_SLASH_SEQUENCE);
+            fSuccess = true;
         }
     }
-    return fKeyTranslated;
+
+    return fSuccess;
 }
 
 // Routine Description:
-// - Searches the input array of mappings, and sends it to the input if a match was found.
+// - Looks up the sequence for this key event in the current modes, ignoring
+//      its modifiers, and sends it to the input if there is one.
 // Arguments:
 // - keyEvent - Key event to translate
-// - keyMapping - Array of key mappings to search
-// - cKeyMapping - number of entries in keyMapping
 // Return Value:
 // - True if there was a match to a key translation, and we successfully sent it to the input
-bool TerminalInput::_TranslateDefaultMapping(const KeyEvent& keyEvent,
-                                             _In_reads_(cKeyMapping) const TerminalInput::_TermKeyMap* keyMapping,
-                                             const size_t cKeyMapping) const
+bool TerminalInput::_TranslateDefaultMapping(const KeyEvent& keyEvent) const
 {
-    const TerminalInput::_TermKeyMap* pMatchingMapping;
-    bool fSuccess = _SearchKeyMapping(keyEvent, keyMapping, cKeyMapping, &pMatchingMapping);
-    if (fSuccess)
+    bool fSuccess = false;
+    const std::wstring_view sequence = s_GetKeySequence(keyEvent.GetVirtualKeyCode(),
+                                                        false,
+                                                        false,
+                                                        false,
+                                                        _fCursorApplicationMode,
+                                                        _fKeypadApplicationMode);
+    if (!sequence.empty())
     {
-        _SendInputSequence(pMatchingMapping->pwszSequence);
+        _SendInputSequence(sequence);
         fSuccess = true;
     }
     return fSuccess;
@@ -466,20 +558,21 @@ bool TerminalInput::HandleKey(const IInputEvent* const pInEvent) const
 
             if (!fKeyHandled)
             {
-                // For perf optimization, filter out any typically printable Virtual Keys (e.g. A-Z)
-                // This is in lieu of an O(1) sparse table or other such less-maintanable methods.
+                // Typically printable Virtual Keys (e.g. A-Z) send their char as is.
                 // VK_CANCEL is an exception and we want to send the associated uChar as is.
                 if ((keyEvent.GetVirtualKeyCode() < '0' || keyEvent.GetVirtualKeyCode() > 'Z') &&
                     keyEvent.GetVirtualKeyCode() != VK_CANCEL)
                 {
-                    fKeyHandled = _TranslateDefaultMapping(keyEvent, GetKeyMapping(keyEvent), GetKeyMappingLength(keyEvent));
+                    fKeyHandled = _TranslateDefaultMapping(keyEvent);
                 }
                 else
                 {
-                    WCHAR rgwchSequence[2];
-                    rgwchSequence[0] = keyEvent.GetCharData();
-                    rgwchSequence[1] = UNICODE_NULL;
-                    _SendInputSequence(rgwchSequence);
+                    // Keys like Ctrl+1 have no char at all. They're still handled, but send nothing.
+                    const wchar_t wch = keyEvent.GetCharData();
+                    if (wch != UNICODE_NULL)
+                    {
+                        _SendInputSequence({ &wch, 1 });
+                    }
                     fKeyHandled = true;
                 }
             }
@@ -489,6 +582,22 @@ bool TerminalInput::HandleKey(const IInputEvent* const pInEvent) const
     return fKeyHandled;
 }
 
+// Routine Description:
+// - Makes the key down record that types a character of a sequence.
+// Arguments:
+// - wch - the character
+// Return Value:
+// - the record
+static constexpr INPUT_RECORD s_MakeSequenceRecord(const wchar_t wch) noexcept
+{
+    INPUT_RECORD record{};
+    record.EventType = KEY_EVENT;
+    record.Event.KeyEvent.bKeyDown = TRUE;
+    record.Event.KeyEvent.wRepeatCount = 1;
+    record.Event.KeyEvent.uChar.UnicodeChar = wch;
+    return record;
+}
+
 // Routine Description:
 // - Sends the given char as a sequence representing Alt+wch, also the same as
 //      Meta+wch.
@@ -500,10 +609,8 @@ void TerminalInput::_SendEscapedInputSequence(const wchar_t wch) const
 {
     try
     {
-        std::deque<std::unique_ptr<IInputEvent>> inputEvents;
-        inputEvents.push_back(std::make_unique<KeyEvent>(true, 1ui16, 0ui16, 0ui16, L'\x1b', 0));
-        inputEvents.push_back(std::make_unique<KeyEvent>(true, 1ui16, 0ui16, 0ui16, wch, 0));
-        _pfnWriteEvents(inputEvents);
+        const INPUT_RECORD records[] = { s_MakeSequenceRecord(L'\x1b'), s_MakeSequenceRecord(wch) };
+        _pfnWriteEvents(gsl::make_span(records));
     }
     catch (...)
     {
@@ -515,14 +622,10 @@ void TerminalInput::_SendNullInputSequence(const DWORD dwControlKeyState) const
 {
     try
     {
-        std::deque<std::unique_ptr<IInputEvent>> inputEvents;
-        inputEvents.push_back(std::make_unique<KeyEvent>(true,
-                                                         1ui16,
-                                                         LOBYTE(VkKeyScanW(0)),
-                                                         0ui16,
-                                                         L'\x0',
-                                                         dwControlKeyState));
-        _pfnWriteEvents(inputEvents);
+        INPUT_RECORD record = s_MakeSequenceRecord(L'\x0');
+        record.Event.KeyEvent.wVirtualKeyCode = LOBYTE(VkKeyScanW(0));
+        record.Event.KeyEvent.dwControlKeyState = dwControlKeyState;
+        _pfnWriteEvents(gsl::make_span(&record, 1));
     }
     catch (...)
     {
@@ -530,20 +633,25 @@ void TerminalInput::_SendNullInputSequence(const DWORD dwControlKeyState) const
     }
 }
 
-void TerminalInput::_SendInputSequence(_In_ PCWSTR const pwszSequence) const
+// Routine Description:
+// - Sends each character of the sequence to the input as a key down.
+//      The records are built on the stack, so nothing is allocated.
+// Arguments:
+// - sequence - the sequence to send
+// Return Value:
+// - None
+void TerminalInput::_SendInputSequence(const std::wstring_view sequence) const
 {
-    size_t cch = 0;
-    // + 1 to max sequence length for null terminator count which is required by StringCchLengthW
-    if (SUCCEEDED(StringCchLengthW(pwszSequence, _TermKeyMap::s_cchMaxSequenceLength + 1, &cch)) && cch > 0)
+    if (!sequence.empty() && sequence.size() <= s_cchMaxSequenceLength)
     {
         try
         {
-            std::deque<std::unique_ptr<IInputEvent>> inputEvents;
-            for (size_t i = 0; i < cch; i++)
+            INPUT_RECORD records[s_cchMaxSequenceLength];
+            for (size_t i = 0; i < sequence.size(); i++)
             {
-                inputEvents.push_back(std::make_unique<KeyEvent>(true, 1ui16, 0ui16, 0ui16, pwszSequence[i], 0));
+                records[i] = s_MakeSequenceRecord(sequence[i]);
             }
-            _pfnWriteEvents(inputEvents);
+            _pfnWriteEvents(gsl::make_span(records, sequence.size()));
         }
         catch (...)
         {
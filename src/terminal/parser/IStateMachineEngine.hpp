@@ -53,6 +53,7 @@ namespace Microsoft::Console::VirtualTerminal
 
         virtual bool FlushAtEndOfString() const = 0;
         virtual bool DispatchControlCharsFromEscape() const = 0;
+        virtual bool ParseSs3Parameters() const = 0;
 
     };
 
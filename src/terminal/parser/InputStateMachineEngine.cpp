@@ -84,7 +84,8 @@ InputStateMachineEngine::InputStateMachineEngine(IInteractDispatch* const pDispa
 
 InputStateMachineEngine::InputStateMachineEngine(IInteractDispatch* const pDispatch, const bool lookingForDSR) :
     _pDispatch(THROW_IF_NULL_ALLOC(pDispatch)),
-    _lookingForDSR(lookingForDSR)
+    _lookingForDSR(lookingForDSR),
+    _inBracketedPaste(false)
 {
 }
 
@@ -227,6 +228,13 @@ bool InputStateMachineEngine::ActionPrintString(const wchar_t* const rgwch,
     {
         return true;
     }
+
+    // Pasted text doesn't need to look typed, so it's written as a run of
+    //      text, instead of as a pair of keystrokes for every character.
+    if (_inBracketedPaste || cch >= s_cchMinimumTextRun)
+    {
+        return _pDispatch->WriteTextRun(rgwch, cch);
+    }
     return _pDispatch->WriteString(rgwch, cch);
 }
 
@@ -310,6 +318,15 @@ bool InputStateMachineEngine::ActionCsiDispatch(const wchar_t wch,
     const unsigned short* const rgusRemainingArgs = (cParams > 1) ? rgusParams + 1 : rgusParams;
     const unsigned short cRemainingArgs = (cParams >= 1) ? cParams - 1 : 0;
 
+    // The bracketed paste markers aren't keys, they just mark the text between them as pasted.
+    if (wch == CsiActionCodes::Generic &&
+        cParams == 1 &&
+        (rgusParams[0] == GenericKeyIdentifiers::PasteStart || rgusParams[0] == GenericKeyIdentifiers::PasteEnd))
+    {
+        _inBracketedPaste = rgusParams[0] == GenericKeyIdentifiers::PasteStart;
+        return true;
+    }
+
     bool fSuccess = false;
     switch(wch)
     {
@@ -662,9 +679,7 @@ bool InputStateMachineEngine::_WriteSingleKey(const wchar_t wch, const short vke
     INPUT_RECORD rgInput[WRAPPED_SEQUENCE_MAX_LENGTH];
     size_t cInput = _GenerateWrappedSequence(wch, vkey, dwModifierState, rgInput, WRAPPED_SEQUENCE_MAX_LENGTH);
 
-    std::deque<std::unique_ptr<IInputEvent>> inputEvents = IInputEvent::Create(gsl::make_span(rgInput, cInput));
-
-    return _pDispatch->WriteInput(inputEvents);
+    return _pDispatch->WriteInput(gsl::make_span(rgInput, cInput));
 }
 
 // Method Description:
@@ -890,6 +905,18 @@ bool InputStateMachineEngine::DispatchControlCharsFromEscape() const
     return true;
 }
 
+// Routine Description:
+// - Returns true if the engine expects parameters after an SS3 (ESC O), the
+//      way the input engine does for modified function keys. If this returns
+//      false, the character following ESC O is dispatched immediately,
+//      whatever it is.
+// Return Value:
+// - True. Some terminals send modified function keys as SS3 with parameters.
+bool InputStateMachineEngine::ParseSs3Parameters() const
+{
+    return true;
+}
+
 // Method Description:
 // - Retrieves the type of window manipulation operation from the parameter pool
 //      stored during Param actions.
@@ -66,11 +66,17 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool FlushAtEndOfString() const override;
         bool DispatchControlCharsFromEscape() const override;
+        bool ParseSs3Parameters() const override;
 
     private:
 
         const std::unique_ptr<IInteractDispatch> _pDispatch;
         bool _lookingForDSR;
+        bool _inBracketedPaste;
+
+        // Printable runs at least this long weren't typed, so they're written as
+        //      text even outside of a bracketed paste.
+        static const size_t s_cchMinimumTextRun = 32;
 
         enum CsiActionCodes : wchar_t
         {
@@ -123,6 +129,8 @@ namespace Microsoft::Console::VirtualTerminal
             F10 = 21,
             F11 = 23,
             F12 = 24,
+            PasteStart = 200,
+            PasteEnd = 201,
         };
 
         struct CSI_TO_VKEY {
@@ -37,13 +37,26 @@ ITermDispatch& OutputStateMachineEngine::Dispatch() noexcept
 // Routine Description:
 // - Triggers the Execute action to indicate that the listener should
 //      immediately respond to a C0 control character.
+//   SO and SI are locking shifts of G1 and G0 into GL, so they're dispatched
+//      as such, rather than executed.
 // Arguments:
 // - wch - Character to dispatch.
 // Return Value:
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionExecute(const wchar_t wch)
 {
-    _dispatch->Execute(wch);
+    switch (wch)
+    {
+    case AsciiChars::SO:
+        _dispatch->LockingShift(1);
+        break;
+    case AsciiChars::SI:
+        _dispatch->LockingShift(0);
+        break;
+    default:
+        _dispatch->Execute(wch);
+        break;
+    }
     _ClearLastChar();
     return true;
 }
@@ -203,6 +216,18 @@ bool OutputStateMachineEngine::ActionEscDispatch(const wchar_t wch,
             fSuccess = _dispatch->HardReset();
             TermTelemetry::Instance().Log(TermTelemetry::Codes::RIS);
             break;
+        case VTActionCodes::SS2_SingleShift:
+            fSuccess = _dispatch->SingleShift(2);
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::SS2);
+            break;
+        case VTActionCodes::LS2_LockingShift:
+            fSuccess = _dispatch->LockingShift(2);
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::LS2);
+            break;
+        case VTActionCodes::LS3_LockingShift:
+            fSuccess = _dispatch->LockingShift(3);
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::LS3);
+            break;
         default:
             // If no functions to call, overall dispatch was a failure.
             fSuccess = false;
@@ -218,19 +243,19 @@ bool OutputStateMachineEngine::ActionEscDispatch(const wchar_t wch,
             switch (designateType)
             {
             case DesignateCharsetTypes::G0:
-                fSuccess = _dispatch->DesignateCharset(wch);
+                fSuccess = _dispatch->DesignateCharset(0, wch);
                 TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG0);
                 break;
             case DesignateCharsetTypes::G1:
-                fSuccess = false;
+                fSuccess = _dispatch->DesignateCharset(1, wch);
                 TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG1);
                 break;
             case DesignateCharsetTypes::G2:
-                fSuccess = false;
+                fSuccess = _dispatch->DesignateCharset(2, wch);
                 TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG2);
                 break;
             case DesignateCharsetTypes::G3:
-                fSuccess = false;
+                fSuccess = _dispatch->DesignateCharset(3, wch);
                 TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG3);
                 break;
             default:
@@ -753,21 +778,32 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
 
 // Routine Description:
 // - Triggers the Ss3Dispatch action to indicate that the listener should handle
-//      a control sequence. These sequences perform various API-type commands
-//      that can include many parameters.
+//      a control sequence.
+//   On output, SS3 is a single shift: the character following it is printed
+//      from the G3 charset. No parameters are ever collected for it, see
+//      ParseSs3Parameters.
 // Arguments:
 // - wch - Character to dispatch.
-// - rgusParams - set of numeric parameters collected while pasring the sequence.
-// - cParams - number of parameters found.
+// - rgusParams - unused.
+// - cParams - unused.
 // Return Value:
 // - true iff we successfully dispatched the sequence.
-bool OutputStateMachineEngine::ActionSs3Dispatch(const wchar_t /*wch*/,
+bool OutputStateMachineEngine::ActionSs3Dispatch(const wchar_t wch,
                                                  _In_reads_(_Param_(3)) const unsigned short* const /*rgusParams*/,
                                                  const unsigned short /*cParams*/)
 {
-    // The output engine doesn't handle any SS3 sequences.
-    _ClearLastChar();
-    return false;
+    bool fSuccess = _dispatch->SingleShift(3);
+    TermTelemetry::Instance().Log(TermTelemetry::Codes::SS3);
+    if (fSuccess)
+    {
+        fSuccess = ActionPrint(wch);
+    }
+
+    if (!fSuccess)
+    {
+        _ClearLastChar();
+    }
+    return fSuccess;
 }
 
 // Routine Description:
@@ -1255,20 +1291,19 @@ bool OutputStateMachineEngine::_GetDesignateType(const wchar_t wchIntermediate,
         fSuccess = true;
         break;
     case ')':
-    case '-':
         *pDesignateType = DesignateCharsetTypes::G1;
         fSuccess = true;
         break;
     case '*':
-    case '.':
         *pDesignateType = DesignateCharsetTypes::G2;
         fSuccess = true;
         break;
     case '+':
-    case '/':
         *pDesignateType = DesignateCharsetTypes::G3;
         fSuccess = true;
         break;
+    // '-', '.' and '/' designate 96-character sets into G1 - G3. Those only
+    //      affect GR, which we never translate, so they aren't supported.
     }
 
     return fSuccess;
@@ -1301,6 +1336,19 @@ bool OutputStateMachineEngine::DispatchControlCharsFromEscape() const
     return false;
 }
 
+// Routine Description:
+// - Returns true if the engine expects parameters after an SS3 (ESC O), the
+//      way the input engine does for modified function keys. If this returns
+//      false, the character following ESC O is dispatched immediately,
+//      whatever it is.
+// Return Value:
+// - False. On output, SS3 single-shifts the next graphic character, and a
+//      digit, ';' or ':' is just the character to print.
+bool OutputStateMachineEngine::ParseSs3Parameters() const
+{
+    return false;
+}
+
 // Routine Description:
 // - Converts a hex character to it's equivalent integer value.
 // Arguments:
@@ -58,6 +58,7 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool FlushAtEndOfString() const override;
         bool DispatchControlCharsFromEscape() const override;
+        bool ParseSs3Parameters() const override;
 
         void SetTerminalConnection(Microsoft::Console::ITerminalOutputConnection* const pTtyConnection,
                                    std::function<bool()> pfnFlushToTerminal);
@@ -120,6 +121,9 @@ namespace Microsoft::Console::VirtualTerminal
             HVP_HorizontalVerticalPosition = L'f',
             DECSTR_SoftReset = L'p',
             RIS_ResetToInitialState = L'c', // DA is prefaced by CSI, RIS by ESC
+            SS2_SingleShift = L'N', // Not a CSI, so doesn't overlap with anything. SS3 is ESC O, see ActionSs3Dispatch
+            LS2_LockingShift = L'n', // DSR is prefaced by CSI, LS2 by ESC
+            LS3_LockingShift = L'o',
             // 'q' is overloaded - no postfix is DECLL, ' ' postfix is DECSCUSR, and '"' is DECSCA
             DECSCUSR_SetCursorStyle = L'q', // I believe we'll only ever implement DECSCUSR
             DTTERM_WindowManipulation = L't',
@@ -6,6 +6,7 @@
 #include "stateMachine.hpp"
 
 #include "ascii.hpp"
+#include "../../types/inc/PerfMetrics.hpp"
 
 using namespace Microsoft::Console::VirtualTerminal;
 
@@ -1161,9 +1162,10 @@ void StateMachine::_EventOscTermination(const wchar_t wch)
 //   Events in this state will:
 //   1. Execute C0 control characters
 //   2. Ignore Delete characters
-//   3. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
-//   4. Store parameter data
-//   5. Dispatch a control sequence with parameters for action
+//   3. Dispatch any other character, if the engine doesn't take SS3 parameters
+//   4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
+//   5. Store parameter data
+//   6. Dispatch a control sequence with parameters for action
 //  SS3 sequences are structurally the same as CSI sequences, just with a
 //      different initiation. It's safe to reuse CSI's functions for
 //      determining if a character is a parameter, delimiter, or invalid.
@@ -1182,6 +1184,12 @@ void StateMachine::_EventSs3Entry(const wchar_t wch)
     {
         _ActionIgnore();
     }
+    else if (!_pEngine->ParseSs3Parameters())
+    {
+        // A single shift: this is the character to shift, even if it looks like a parameter.
+        _ActionSs3Dispatch(wch);
+        _EnterGround();
+    }
     else if (s_IsCsiInvalid(wch))
     {
         // It's safe for us to go into the CSI ignore here, because both SS3 and
@@ -1330,6 +1338,9 @@ bool StateMachine::FlushToTerminal()
 // - <none>
 void StateMachine::ProcessString(const wchar_t* const rgwch, const size_t cch)
 {
+    static auto& s_chunkTime = Metrics::MetricsRegistry::Instance().GetHistogram(Metrics::Names::ParseChunkMicroseconds);
+    Metrics::ScopedLatency measure{ s_chunkTime };
+
     _pwchCurr = rgwch;
     _pwchSequenceStart = rgwch;
     _currRunLength = 0;
@@ -244,6 +244,10 @@ void TermTelemetry::WriteFinalTraceLog() const
                 TraceLoggingUInt32(_uiTimesUsed[OSCSCC], "OscSetCursorColor"),
                 TraceLoggingUInt32(_uiTimesUsed[OSCRCC], "OscResetCursorColor"),
                 TraceLoggingUInt32(_uiTimesUsed[REP], "REP"),
+                TraceLoggingUInt32(_uiTimesUsed[LS2], "LS2"),
+                TraceLoggingUInt32(_uiTimesUsed[LS3], "LS3"),
+                TraceLoggingUInt32(_uiTimesUsed[SS2], "SS2"),
+                TraceLoggingUInt32(_uiTimesUsed[SS3], "SS3"),
                 TraceLoggingUInt32Array(_uiTimesFailed, ARRAYSIZE(_uiTimesFailed), "Failed"),
                 TraceLoggingUInt32(_uiTimesFailedOutsideRange, "FailedOutsideRange"));
         }
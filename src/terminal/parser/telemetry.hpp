@@ -83,6 +83,10 @@ namespace Microsoft::Console::VirtualTerminal
             OSCSCC,
             OSCRCC,
             REP,
+            LS2,
+            LS3,
+            SS2,
+            SS3,
             // Only use this last enum as a count of the number of codes.
             NUMBER_OF_CODES
         };
@@ -72,23 +72,23 @@ public:
         _expectCursorPosition{ false },
         _expectedCursor{ -1, -1 },
         _expectedWindowManipulation{ DispatchTypes::WindowManipulationType::Invalid },
-        _expectedCParams{ 0 }
+        _expectedCParams{ 0 },
+        _textRun{}
     {
         std::fill_n(_expectedParams, ARRAYSIZE(_expectedParams), gsl::narrow<short>(0));
     }
 
-    void RoundtripTerminalInputCallback(_In_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+    void RoundtripTerminalInputCallback(const gsl::span<const INPUT_RECORD> inputRecords)
     {
         // Take all the characters out of the input records here, and put them into
         //  the input state machine.
-        auto inputRecords = IInputEvent::ToInputRecords(inEvents);
         std::wstring vtseq = L"";
         for (auto& inRec : inputRecords)
         {
             VERIFY_ARE_EQUAL(KEY_EVENT, inRec.EventType);
             if (inRec.Event.KeyEvent.bKeyDown)
             {
-                vtseq += &inRec.Event.KeyEvent.uChar.UnicodeChar;
+                vtseq += inRec.Event.KeyEvent.uChar.UnicodeChar;
             }
         }
         Log::Comment(
@@ -204,13 +204,14 @@ public:
     DispatchTypes::WindowManipulationType _expectedWindowManipulation;
     unsigned short _expectedParams[16];
     size_t _expectedCParams;
+    std::wstring _textRun;
 };
 
 class Microsoft::Console::VirtualTerminal::InputEngineTest
 {
     TEST_CLASS(InputEngineTest);
 
-    void RoundtripTerminalInputCallback(std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    void RoundtripTerminalInputCallback(const gsl::span<const INPUT_RECORD> inputRecords);
     void TestInputCallback(std::deque<std::unique_ptr<IInputEvent>>& inEvents);
     void TestInputStringCallback(std::deque<std::unique_ptr<IInputEvent>>& inEvents);
 
@@ -239,6 +240,7 @@ class Microsoft::Console::VirtualTerminal::InputEngineTest
     TEST_METHOD(CSICursorBackTabTest);
     TEST_METHOD(AltBackspaceTest);
     TEST_METHOD(AltCtrlDTest);
+    TEST_METHOD(BracketedPasteTest);
 
     friend class TestInteractDispatch;
 };
@@ -249,13 +251,15 @@ class Microsoft::Console::VirtualTerminal::TestInteractDispatch final : public I
 public:
     TestInteractDispatch(_In_ std::function<void(std::deque<std::unique_ptr<IInputEvent>>&)> pfn,
                          _In_ TestState* testState);
-    virtual bool WriteInput(_In_ std::deque<std::unique_ptr<IInputEvent>>& inputEvents) override;
+    virtual bool WriteInput(const gsl::span<const INPUT_RECORD> inputRecords) override;
     virtual bool WriteCtrlC() override;
     virtual bool WindowManipulation(const DispatchTypes::WindowManipulationType uiFunction,
                                     _In_reads_(cParams) const unsigned short* const rgusParams,
                                     const size_t cParams) override; // DTTERM_WindowManipulation
     virtual bool WriteString(_In_reads_(cch) const wchar_t* const pws,
                              const size_t cch) override;
+    virtual bool WriteTextRun(_In_reads_(cch) const wchar_t* const pws,
+                              const size_t cch) override;
 
     virtual bool MoveCursor(const unsigned int row,
                             const unsigned int col) override;
@@ -273,8 +277,9 @@ TestInteractDispatch::TestInteractDispatch(_In_ std::function<void(std::deque<st
 
 }
 
-bool TestInteractDispatch::WriteInput(_In_ std::deque<std::unique_ptr<IInputEvent>>& inputEvents)
+bool TestInteractDispatch::WriteInput(const gsl::span<const INPUT_RECORD> inputRecords)
 {
+    std::deque<std::unique_ptr<IInputEvent>> inputEvents = IInputEvent::Create(inputRecords);
     _pfnWriteInputCallback(inputEvents);
     return true;
 }
@@ -283,9 +288,8 @@ bool TestInteractDispatch::WriteCtrlC()
 {
     VERIFY_IS_TRUE(_testState->_expectSendCtrlC);
     KeyEvent key = KeyEvent(true, 1, 'C', 0, UNICODE_ETX, LEFT_CTRL_PRESSED);
-    std::deque<std::unique_ptr<IInputEvent>> inputEvents;
-    inputEvents.push_back(std::make_unique<KeyEvent>(key));
-    return WriteInput(inputEvents);
+    const INPUT_RECORD record = key.ToInputRecord();
+    return WriteInput(gsl::make_span(&record, 1));
 }
 
 bool TestInteractDispatch::WindowManipulation(const DispatchTypes::WindowManipulationType uiFunction,
@@ -305,7 +309,7 @@ bool TestInteractDispatch::WindowManipulation(const DispatchTypes::WindowManipul
 bool TestInteractDispatch::WriteString(_In_reads_(cch) const wchar_t* const pws,
                                        const size_t cch)
 {
-    std::deque<std::unique_ptr<IInputEvent>> keyEvents;
+    std::vector<INPUT_RECORD> keyRecords;
 
     for (size_t i = 0; i < cch; ++i)
     {
@@ -313,12 +317,20 @@ bool TestInteractDispatch::WriteString(_In_reads_(cch) const wchar_t* const pws,
         // We're forcing the translation to CP_USA, so that it'll be constant
         //  regardless of the CP the test is running in
         std::deque<std::unique_ptr<KeyEvent>> convertedEvents = CharToKeyEvents(wch, CP_USA);
-        std::move(convertedEvents.begin(),
-                  convertedEvents.end(),
-                  std::back_inserter(keyEvents));
+        for (const auto& keyEvent : convertedEvents)
+        {
+            keyRecords.push_back(keyEvent->ToInputRecord());
+        }
     }
 
-    return WriteInput(keyEvents);
+    return WriteInput(keyRecords);
+}
+
+bool TestInteractDispatch::WriteTextRun(_In_reads_(cch) const wchar_t* const pws,
+                                        const size_t cch)
+{
+    _testState->_textRun.append(pws, cch);
+    return WriteString(pws, cch);
 }
 
 bool TestInteractDispatch::MoveCursor(const unsigned int row,
@@ -788,3 +800,28 @@ void InputEngineTest::AltCtrlDTest()
     Log::Comment(NoThrowString().Format(L"Processing \"\\x1b\\x04\""));
     _stateMachine->ProcessString(seq);
 }
+
+void InputEngineTest::BracketedPasteTest()
+{
+    TestState testState;
+    auto pfn = [](std::deque<std::unique_ptr<IInputEvent>>&) {};
+
+    auto inputEngine = std::make_unique<InputStateMachineEngine>(new TestInteractDispatch(pfn, &testState));
+    auto _stateMachine = std::make_unique<StateMachine>(inputEngine.release());
+    VERIFY_IS_NOT_NULL(_stateMachine);
+    testState._stateMachine = _stateMachine.get();
+
+    Log::Comment(L"Text between the paste markers is written as a text run, without the markers.");
+    _stateMachine->ProcessString(L"\x1b[200~ab\x1b[201~");
+    VERIFY_ARE_EQUAL(std::wstring(L"ab"), testState._textRun);
+
+    Log::Comment(L"Short text outside of a paste is typed.");
+    testState._textRun.clear();
+    _stateMachine->ProcessString(L"cd");
+    VERIFY_ARE_EQUAL(std::wstring(L""), testState._textRun);
+
+    Log::Comment(L"Long text outside of a paste is written as a text run too.");
+    const std::wstring longText(64, L'x');
+    _stateMachine->ProcessString(longText);
+    VERIFY_ARE_EQUAL(longText, testState._textRun);
+}
@@ -520,29 +520,21 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
 
     TEST_METHOD(TestSs3Param)
     {
+        // On output, SS3 is a single shift, so parameter characters are just
+        //      the character being shifted.
         StateMachine mach(new OutputStateMachineEngine(new DummyDispatch));
 
-        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
-        mach.ProcessCharacter(AsciiChars::ESC);
-        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Escape);
-        mach.ProcessCharacter(L'O');
-        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ss3Entry);
-        mach.ProcessCharacter(L';');
-        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ss3Param);
-        mach.ProcessCharacter(L'3');
-        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ss3Param);
-        mach.ProcessCharacter(L'2');
-        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ss3Param);
-        mach.ProcessCharacter(L'4');
-        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ss3Param);
-        mach.ProcessCharacter(L';');
-        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ss3Param);
-        mach.ProcessCharacter(L';');
-        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ss3Param);
-        mach.ProcessCharacter(L'8');
-        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ss3Param);
-        mach.ProcessCharacter(L'J');
-        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+        const wchar_t params[] = { L'0', L'3', L'9', L';', L':' };
+        for (const auto wch : params)
+        {
+            VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+            mach.ProcessCharacter(AsciiChars::ESC);
+            VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Escape);
+            mach.ProcessCharacter(L'O');
+            VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ss3Entry);
+            mach.ProcessCharacter(wch);
+            VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+        }
     }
 };
 
@@ -591,7 +583,11 @@ public:
         _fIsAltBuffer{ false },
         _fCursorKeysMode{ false },
         _fCursorBlinking{ true },
-        _uiWindowWidth{ 80 }
+        _uiWindowWidth{ 80 },
+        _designatedGset{ SIZE_MAX },
+        _wchDesignatedCharset{ L'\0' },
+        _lockingShift{ SIZE_MAX },
+        _singleShift{ SIZE_MAX }
     {
         memset(_rgOptions, s_uiGraphicsCleared, sizeof(_rgOptions));
     }
@@ -819,6 +815,25 @@ public:
         return true;
     }
 
+    bool DesignateCharset(const size_t gsetNumber, const wchar_t wchCharset) override
+    {
+        _designatedGset = gsetNumber;
+        _wchDesignatedCharset = wchCharset;
+        return true;
+    }
+
+    bool LockingShift(const size_t gsetNumber) override
+    {
+        _lockingShift = gsetNumber;
+        return true;
+    }
+
+    bool SingleShift(const size_t gsetNumber) override
+    {
+        _singleShift = gsetNumber;
+        return true;
+    }
+
     unsigned int _uiCursorDistance;
     unsigned int _uiLine;
     unsigned int _uiColumn;
@@ -847,6 +862,10 @@ public:
     bool _fCursorKeysMode;
     bool _fCursorBlinking;
     unsigned int _uiWindowWidth;
+    size_t _designatedGset;
+    wchar_t _wchDesignatedCharset;
+    size_t _lockingShift;
+    size_t _singleShift;
 
     static const size_t s_cMaxOptions = 16;
     static const unsigned int s_uiGraphicsCleared = UINT_MAX;
@@ -1122,6 +1141,59 @@ class StateMachineExternalTest final
         pDispatch->ClearState();
     }
 
+    TEST_METHOD(TestCharsetDesignationAndShifts)
+    {
+        StatefulDispatch* pDispatch = new StatefulDispatch;
+        VERIFY_IS_NOT_NULL(pDispatch);
+        StateMachine mach(new OutputStateMachineEngine(pDispatch));
+
+        Log::Comment(L"Designating 94-character sets into G0 - G3.");
+        const std::wstring_view intermediates = L"()*+";
+        for (size_t gsetNumber = 0; gsetNumber < intermediates.size(); gsetNumber++)
+        {
+            const wchar_t rgwch[] = { L'\x1b', intermediates[gsetNumber], L'K' };
+            mach.ProcessString(rgwch, ARRAYSIZE(rgwch));
+            VERIFY_ARE_EQUAL(gsetNumber, pDispatch->_designatedGset);
+            VERIFY_ARE_EQUAL(L'K', pDispatch->_wchDesignatedCharset);
+
+            pDispatch->ClearState();
+        }
+
+        Log::Comment(L"96-character sets aren't supported.");
+        mach.ProcessString(L"\x1b-A", 3);
+        VERIFY_ARE_EQUAL(SIZE_MAX, pDispatch->_designatedGset);
+
+        pDispatch->ClearState();
+
+        Log::Comment(L"SO and SI are LS1 and LS0.");
+        mach.ProcessString(L"\x0e", 1);
+        VERIFY_ARE_EQUAL(size_t{ 1 }, pDispatch->_lockingShift);
+        mach.ProcessString(L"\x0f", 1);
+        VERIFY_ARE_EQUAL(size_t{ 0 }, pDispatch->_lockingShift);
+
+        Log::Comment(L"LS2 and LS3.");
+        mach.ProcessString(L"\x1bn", 2);
+        VERIFY_ARE_EQUAL(size_t{ 2 }, pDispatch->_lockingShift);
+        mach.ProcessString(L"\x1bo", 2);
+        VERIFY_ARE_EQUAL(size_t{ 3 }, pDispatch->_lockingShift);
+
+        pDispatch->ClearState();
+
+        Log::Comment(L"SS2 and SS3.");
+        mach.ProcessString(L"\x1bN", 2);
+        VERIFY_ARE_EQUAL(size_t{ 2 }, pDispatch->_singleShift);
+        mach.ProcessString(L"\x1bOq", 3);
+        VERIFY_ARE_EQUAL(size_t{ 3 }, pDispatch->_singleShift);
+
+        pDispatch->ClearState();
+
+        Log::Comment(L"SS3 followed by a digit shifts the digit.");
+        mach.ProcessString(L"\x1bO1", 3);
+        VERIFY_ARE_EQUAL(size_t{ 3 }, pDispatch->_singleShift);
+
+        pDispatch->ClearState();
+    }
+
     TEST_METHOD(TestSetNumberOfColumns)
     {
         StatefulDispatch* pDispatch = new StatefulDispatch;
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "inc/FallbackWidthCache.hpp"
+
+static_assert((FallbackWidthCache::s_Capacity & (FallbackWidthCache::s_Capacity - 1)) == 0,
+              "The capacity of the fallback width cache must be a power of two.");
+
+using namespace Microsoft::Console::Metrics;
+
+// NOTE: CAN THROW IF MEMORY ALLOCATION FAILS.
+FallbackWidthCache::FallbackWidthCache() :
+    _entries{},
+    _generation{ 1 },
+    _hits{ MetricsRegistry::Instance().GetCounter(Names::FallbackWidthHits) },
+    _misses{ MetricsRegistry::Instance().GetCounter(Names::FallbackWidthMisses) }
+{
+}
+
+// Routine Description:
+// - Returns the current generation of the cache. Callers should get this before
+//   they ask the font, and store the answer with it, so that an answer that was
+//   worked out for the old font is never kept for the new one.
+uint32_t FallbackWidthCache::Generation() const noexcept
+{
+    return _generation.load(std::memory_order_acquire);
+}
+
+// Routine Description:
+// - Looks up the width stored for a codepoint. Safe to call from any thread.
+// Arguments:
+// - codepoint - the codepoint to look up
+// Return Value:
+// - true if the codepoint is wide, false if it's narrow, or nothing if the
+//   width isn't known for the current font.
+std::optional<bool> FallbackWidthCache::Find(const unsigned int codepoint) const noexcept
+{
+    const uint64_t entry = _entries[s_Slot(codepoint)].load(std::memory_order_relaxed);
+    if ((entry & ~s_WideBit) == (s_MakeEntry(codepoint, false, Generation()) & ~s_WideBit))
+    {
+        _hits.Increment();
+        return WI_IsFlagSet(entry, s_WideBit);
+    }
+
+    _misses.Increment();
+    return std::nullopt;
+}
+
+// Routine Description:
+// - Stores the width of a codepoint. Safe to call from any thread.
+// Arguments:
+// - codepoint - the codepoint to store
+// - isWide - true if the codepoint is wide
+// - generation - the generation of the cache from before the width was worked out
+// Return Value:
+// - <none>
+void FallbackWidthCache::Store(const unsigned int codepoint, const bool isWide, const uint32_t generation) noexcept
+{
+    // If the font changed while the width was being worked out, it's already stale.
+    // It still gets stored, since it's harmless: it won't match the new generation.
+    _entries[s_Slot(codepoint)].store(s_MakeEntry(codepoint, isWide, generation), std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Forgets every width stored so far. Safe to call from any thread.
+void FallbackWidthCache::Invalidate() noexcept
+{
+    _generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+uint64_t FallbackWidthCache::Hits() const noexcept
+{
+    return _hits.Get();
+}
+
+uint64_t FallbackWidthCache::Misses() const noexcept
+{
+    return _misses.Get();
+}
+
+uint64_t FallbackWidthCache::s_MakeEntry(const unsigned int codepoint, const bool isWide, const uint32_t generation) noexcept
+{
+    return (static_cast<uint64_t>(generation) << s_GenerationShift) |
+           (static_cast<uint64_t>(codepoint) << s_CodepointShift) |
+           (isWide ? s_WideBit : 0);
+}
+
+size_t FallbackWidthCache::s_Slot(const unsigned int codepoint) noexcept
+{
+    // Neighboring codepoints go in neighboring slots, so a run of text in one
+    // script doesn't evict itself.
+    return codepoint & (s_Capacity - 1);
+}
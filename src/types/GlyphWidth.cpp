@@ -23,6 +23,22 @@ bool IsGlyphFullWidth(const wchar_t wch)
     return widthDetector.IsWide(wch);
 }
 
+// Function Description:
+// - determines if every char of the run is narrow, checking many at once.
+//      See CodepointWidthDetector::IsAllNarrow
+bool IsGlyphRunNarrow(const std::wstring_view run) noexcept
+{
+    return widthDetector.IsAllNarrow(run);
+}
+
+// Function Description:
+// - measures how many chars at the start of the run are narrow, checking many
+//      at once. See CodepointWidthDetector::GetNarrowRunLength
+size_t GetGlyphNarrowRunLength(const std::wstring_view run) noexcept
+{
+    return widthDetector.GetNarrowRunLength(run);
+}
+
 // Function Description:
 // - Sets a function that should be used by the global CodepointWidthDetector
 //      as the fallback mechanism for determining a particular glyph's width,
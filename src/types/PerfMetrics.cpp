@@ -0,0 +1,351 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "inc/PerfMetrics.hpp"
+
+#include <cmath>
+
+using namespace Microsoft::Console::Metrics;
+
+// Routine Description:
+// - Adds one sample to the histogram.
+// Arguments:
+// - value - The value to record.
+// Return Value:
+// - <none>
+void Histogram::Record(const uint64_t value) noexcept
+{
+    _buckets[s_BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+
+    auto min = _min.load(std::memory_order_relaxed);
+    while (value < min && !_min.compare_exchange_weak(min, value, std::memory_order_relaxed))
+    {
+    }
+
+    auto max = _max.load(std::memory_order_relaxed);
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+// Routine Description:
+// - Discards all the samples recorded so far.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Histogram::Reset() noexcept
+{
+    for (auto& bucket : _buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    _count.store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+    _min.store(UINT64_MAX, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::Count() const noexcept
+{
+    return _count.load(std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Finds the value below which the given percentage of the samples fall.
+// - The result is exact up to the resolution of the bucket it falls into, and
+//      is never more than the largest recorded value.
+// Arguments:
+// - percentile - The percentage of samples, from 0 to 100.
+// Return Value:
+// - The value at that percentile, or 0 if nothing was recorded.
+uint64_t Histogram::ValueAtPercentile(const double percentile) const noexcept
+{
+    const auto count = Count();
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * count)));
+    const auto max = _max.load(std::memory_order_relaxed);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < s_BucketCount; i++)
+    {
+        seen += _buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target)
+        {
+            return std::min(s_BucketHighestValue(i), max);
+        }
+    }
+
+    return max;
+}
+
+// Routine Description:
+// - Summarizes the samples recorded so far.
+// Arguments:
+// - <none>
+// Return Value:
+// - The count, sum, extremes and the common percentiles of the samples.
+HistogramSnapshot Histogram::GetSnapshot() const noexcept
+{
+    HistogramSnapshot snapshot;
+    snapshot.count = Count();
+    snapshot.sum = _sum.load(std::memory_order_relaxed);
+    snapshot.min = snapshot.count > 0 ? _min.load(std::memory_order_relaxed) : 0;
+    snapshot.max = _max.load(std::memory_order_relaxed);
+    snapshot.p50 = ValueAtPercentile(50.0);
+    snapshot.p90 = ValueAtPercentile(90.0);
+    snapshot.p99 = ValueAtPercentile(99.0);
+    snapshot.p999 = ValueAtPercentile(99.9);
+    return snapshot;
+}
+
+// Routine Description:
+// - Finds the bucket a value is counted in. Values below s_SubBucketCount have
+//      a bucket each. Above that, each power of two is split into
+//      s_SubBucketCount equally sized buckets.
+// Arguments:
+// - value - The value to find the bucket for.
+// Return Value:
+// - The index of the bucket.
+size_t Histogram::s_BucketIndex(const uint64_t value) noexcept
+{
+    if (value < s_SubBucketCount)
+    {
+        return static_cast<size_t>(value);
+    }
+
+    // Find the most significant bit.
+    size_t msb = 0;
+    for (size_t step = 32; step > 0; step /= 2)
+    {
+        if (value >> (msb + step))
+        {
+            msb += step;
+        }
+    }
+
+    const size_t shift = msb - s_SubBucketBits;
+    const size_t subBucket = static_cast<size_t>(value >> shift) - s_SubBucketCount;
+    return (shift + 1) * s_SubBucketCount + subBucket;
+}
+
+uint64_t Histogram::s_BucketLowestValue(const size_t index) noexcept
+{
+    if (index < s_SubBucketCount)
+    {
+        return index;
+    }
+
+    const size_t shift = index / s_SubBucketCount - 1;
+    const uint64_t subBucket = index % s_SubBucketCount;
+    return (subBucket + s_SubBucketCount) << shift;
+}
+
+uint64_t Histogram::s_BucketHighestValue(const size_t index) noexcept
+{
+    if (index < s_SubBucketCount)
+    {
+        return index;
+    }
+
+    const size_t shift = index / s_SubBucketCount - 1;
+    return s_BucketLowestValue(index) + ((uint64_t{ 1 } << shift) - 1);
+}
+
+MetricsRegistry& MetricsRegistry::Instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+// Routine Description:
+// - Gets the counter with the given name, creating it if it doesn't exist yet.
+// Arguments:
+// - name - The name of the counter.
+// Return Value:
+// - The counter. It lives as long as the registry.
+// NOTE: CAN THROW IF MEMORY ALLOCATION FAILS.
+Counter& MetricsRegistry::GetCounter(const std::string_view name)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    auto it = _counters.find(name);
+    if (it == _counters.end())
+    {
+        it = _counters.emplace(std::string{ name }, std::make_unique<Counter>()).first;
+    }
+    return *it->second;
+}
+
+// Routine Description:
+// - Gets the histogram with the given name, creating it if it doesn't exist yet.
+// Arguments:
+// - name - The name of the histogram.
+// Return Value:
+// - The histogram. It lives as long as the registry.
+// NOTE: CAN THROW IF MEMORY ALLOCATION FAILS.
+Histogram& MetricsRegistry::GetHistogram(const std::string_view name)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    auto it = _histograms.find(name);
+    if (it == _histograms.end())
+    {
+        it = _histograms.emplace(std::string{ name }, std::make_unique<Histogram>()).first;
+    }
+    return *it->second;
+}
+
+// Routine Description:
+// - Appends the given string to the JSON document as a quoted string.
+// Arguments:
+// - json - The document to append to.
+// - str - The string to quote.
+// Return Value:
+// - <none>
+static void _AppendJsonString(std::string& json, const std::string_view str)
+{
+    static constexpr char hexDigits[] = "0123456789abcdef";
+
+    json.push_back('"');
+    for (const char ch : str)
+    {
+        if (ch == '"' || ch == '\\')
+        {
+            json.push_back('\\');
+            json.push_back(ch);
+        }
+        else if (static_cast<unsigned char>(ch) < 0x20)
+        {
+            json.append("\\u00");
+            json.push_back(hexDigits[(ch >> 4) & 0xf]);
+            json.push_back(hexDigits[ch & 0xf]);
+        }
+        else
+        {
+            json.push_back(ch);
+        }
+    }
+    json.push_back('"');
+}
+
+// Routine Description:
+// - Dumps the current value of every metric as a JSON document, in the form
+//      {"counters":{"name":value,...},
+//       "histograms":{"name":{"count":n,"sum":n,"min":n,"max":n,"p50":n,"p90":n,"p99":n,"p999":n},...}}
+// Arguments:
+// - <none>
+// Return Value:
+// - The JSON document.
+// NOTE: CAN THROW IF MEMORY ALLOCATION FAILS.
+std::string MetricsRegistry::ToJson() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    std::string json = "{\"counters\":{";
+    bool first = true;
+    for (const auto& [name, counter] : _counters)
+    {
+        if (!first)
+        {
+            json.push_back(',');
+        }
+        first = false;
+
+        _AppendJsonString(json, name);
+        json.push_back(':');
+        json.append(std::to_string(counter->Get()));
+    }
+
+    json.append("},\"histograms\":{");
+    first = true;
+    for (const auto& [name, histogram] : _histograms)
+    {
+        if (!first)
+        {
+            json.push_back(',');
+        }
+        first = false;
+
+        const auto snapshot = histogram->GetSnapshot();
+        _AppendJsonString(json, name);
+        json.append(":{\"count\":").append(std::to_string(snapshot.count));
+        json.append(",\"sum\":").append(std::to_string(snapshot.sum));
+        json.append(",\"min\":").append(std::to_string(snapshot.min));
+        json.append(",\"max\":").append(std::to_string(snapshot.max));
+        json.append(",\"p50\":").append(std::to_string(snapshot.p50));
+        json.append(",\"p90\":").append(std::to_string(snapshot.p90));
+        json.append(",\"p99\":").append(std::to_string(snapshot.p99));
+        json.append(",\"p999\":").append(std::to_string(snapshot.p999));
+        json.push_back('}');
+    }
+    json.append("}}");
+
+    return json;
+}
+
+// Routine Description:
+// - Zeroes every metric. The metrics themselves stay registered, so
+//      references held by their users remain valid.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void MetricsRegistry::Reset() noexcept
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    for (auto& [name, counter] : _counters)
+    {
+        counter->Reset();
+    }
+    for (auto& [name, histogram] : _histograms)
+    {
+        histogram->Reset();
+    }
+}
+
+// Routine Description:
+// - Notes that an event happened, if no earlier event is still pending.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void PendingLatency::Begin() noexcept
+{
+    if (_start.load(std::memory_order_relaxed) == 0)
+    {
+        int64_t expected = 0;
+        const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+        _start.compare_exchange_strong(expected, now, std::memory_order_relaxed);
+    }
+}
+
+// Routine Description:
+// - Notes that all pending events have been handled, and records the time since
+//      the earliest of them, in microseconds.
+// Arguments:
+// - histogram - Where to record the latency.
+// Return Value:
+// - <none>
+void PendingLatency::End(Histogram& histogram) noexcept
+{
+    const int64_t start = _start.exchange(0, std::memory_order_relaxed);
+    if (start != 0)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const auto elapsed = now.time_since_epoch() - std::chrono::steady_clock::duration{ start };
+        histogram.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+}
+
+PendingLatency& Microsoft::Console::Metrics::UnpaintedOutput() noexcept
+{
+    static PendingLatency pending;
+    return pending;
+}
@@ -0,0 +1,62 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- FallbackWidthCache.hpp
+
+Abstract:
+- A bounded cache of the widths that the font fallback reported for codepoints.
+- Asking the font is expensive, and the answer only changes when the font does,
+  so the answers are kept until Invalidate is called.
+- Every entry is a single atomic word holding the codepoint, its width, and the
+  generation it was stored in. Readers and writers never lock or wait on each
+  other, and invalidating is a single increment: entries from an older
+  generation just stop matching.
+- The cache is direct mapped, so a codepoint can only be in one slot, and
+  storing a codepoint replaces whatever was in its slot.
+- Hits and misses are counted in the MetricsRegistry, summed over every cache
+  in the process.
+--*/
+
+#pragma once
+
+#include "PerfMetrics.hpp"
+
+#include <optional>
+
+class FallbackWidthCache final
+{
+public:
+    static constexpr size_t s_Capacity = 1024;
+
+    FallbackWidthCache();
+
+    FallbackWidthCache(const FallbackWidthCache&) = delete;
+    FallbackWidthCache& operator=(const FallbackWidthCache&) = delete;
+
+    uint32_t Generation() const noexcept;
+    std::optional<bool> Find(const unsigned int codepoint) const noexcept;
+    void Store(const unsigned int codepoint, const bool isWide, const uint32_t generation) noexcept;
+    void Invalidate() noexcept;
+
+    uint64_t Hits() const noexcept;
+    uint64_t Misses() const noexcept;
+
+private:
+    // The low bit of an entry is the width, the next 21 bits are the codepoint,
+    // and the high 32 bits are the generation. Generations start at 1, so an
+    // entry that was never stored doesn't match anything.
+    static constexpr uint64_t s_WideBit = 0x1;
+    static constexpr unsigned int s_CodepointShift = 1;
+    static constexpr unsigned int s_GenerationShift = 32;
+
+    static uint64_t s_MakeEntry(const unsigned int codepoint, const bool isWide, const uint32_t generation) noexcept;
+    static size_t s_Slot(const unsigned int codepoint) noexcept;
+
+    std::array<std::atomic<uint64_t>, s_Capacity> _entries;
+    std::atomic<uint32_t> _generation;
+
+    Microsoft::Console::Metrics::Counter& _hits;
+    Microsoft::Console::Metrics::Counter& _misses;
+};
@@ -11,5 +11,7 @@ Abstract:
 
 bool IsGlyphFullWidth(const std::wstring_view glyph);
 bool IsGlyphFullWidth(const wchar_t wch);
+bool IsGlyphRunNarrow(const std::wstring_view run) noexcept;
+size_t GetGlyphNarrowRunLength(const std::wstring_view run) noexcept;
 void SetGlyphWidthFallback(std::function<bool(std::wstring_view)> pfnFallback);
 void NotifyGlyphWidthFontChanged();
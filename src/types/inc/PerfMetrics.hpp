@@ -0,0 +1,212 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- PerfMetrics.hpp
+
+Abstract:
+- An in-process registry of performance metrics for the output pipeline.
+- Counters and latency histograms are updated with relaxed atomics only, so they
+  are cheap enough to be left enabled on hot paths. Hot paths should look up
+  their metric once (e.g. into a function-local static) and keep the reference;
+  metrics are never removed from the registry, so the reference stays valid.
+- Unlike ParserTracing and RenderTracing, this doesn't depend on ETW or any
+  other platform facility. Only the standard library is used, so it builds
+  anywhere the rest of the types library does.
+--*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace Microsoft::Console::Metrics
+{
+    // The names of the metrics recorded by the console itself.
+    namespace Names
+    {
+        // Counter: bytes of text written to the console by client applications.
+        constexpr std::string_view OutputBytes = "output.bytes";
+        // Counter: bytes read from the VT input pipe.
+        constexpr std::string_view InputBytes = "input.bytes";
+        // Counter: input records written to the input buffer, including coalesced ones.
+        constexpr std::string_view InputRecords = "input.records";
+        // Histogram: time input records spent posted, before they were moved into the input buffer.
+        constexpr std::string_view InputQueueMicroseconds = "input.queueMicroseconds";
+        // Histogram: time from the oldest unread input being written to it being read.
+        constexpr std::string_view InputWriteToReadMicroseconds = "input.writeToReadMicroseconds";
+        // Histogram: time for the state machine to process one chunk of output.
+        constexpr std::string_view ParseChunkMicroseconds = "parser.chunkMicroseconds";
+        // Histogram: time from the first write after a frame to the start of the next frame.
+        constexpr std::string_view ArrivalToPaintMicroseconds = "render.arrivalToPaintMicroseconds";
+        // Histogram: time for the render thread to paint one frame with every engine.
+        constexpr std::string_view FrameMicroseconds = "render.frameMicroseconds";
+        // Counter: frames painted without waiting out the frame limit, for a small, input-driven change.
+        constexpr std::string_view LowLatencyFrames = "render.lowLatencyFrames";
+        // Counter: frames held back until the frame limit elapsed, while output was bursting.
+        constexpr std::string_view ThrottledFrames = "render.throttledFrames";
+        // Counter: paint notifications folded into a throttled frame.
+        constexpr std::string_view CoalescedPaintNotifications = "render.coalescedNotifications";
+        // Histogram: time for one engine to paint one frame. The engine's index is appended.
+        constexpr std::string_view PaintMicroseconds = "render.paintMicroseconds";
+        // Counter: widths of ambiguous codepoints found in the font fallback cache.
+        constexpr std::string_view FallbackWidthHits = "width.fallbackCache.hits";
+        // Counter: widths of ambiguous codepoints that weren't in the font fallback cache.
+        constexpr std::string_view FallbackWidthMisses = "width.fallbackCache.misses";
+        // Histogram: time spent waiting to acquire the global console lock, when another thread held it.
+        constexpr std::string_view ConsoleLockWaitMicroseconds = "lock.console.waitMicroseconds";
+        // Counter: acquisitions of the global console lock that didn't have to wait.
+        constexpr std::string_view ConsoleLockUncontended = "lock.console.uncontended";
+    }
+
+    class Counter final
+    {
+    public:
+        void Add(const uint64_t value) noexcept
+        {
+            _value.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        void Increment() noexcept
+        {
+            Add(1);
+        }
+
+        uint64_t Get() const noexcept
+        {
+            return _value.load(std::memory_order_relaxed);
+        }
+
+        void Reset() noexcept
+        {
+            _value.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint64_t> _value{ 0 };
+    };
+
+    struct HistogramSnapshot
+    {
+        uint64_t count;
+        uint64_t sum;
+        uint64_t min;
+        uint64_t max;
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        uint64_t p999;
+    };
+
+    // A histogram of non-negative values in the style of HdrHistogram: values
+    //      are bucketed log-linearly, so that every value is recorded with a
+    //      bounded relative error (1 / s_SubBucketCount) over the whole range of
+    //      uint64_t, in a fixed amount of memory.
+    class Histogram final
+    {
+    public:
+        static constexpr size_t s_SubBucketBits = 3;
+        static constexpr size_t s_SubBucketCount = 1 << s_SubBucketBits;
+        static constexpr size_t s_BucketCount = (64 - s_SubBucketBits + 1) * s_SubBucketCount;
+
+        void Record(const uint64_t value) noexcept;
+        void Reset() noexcept;
+
+        uint64_t Count() const noexcept;
+        uint64_t ValueAtPercentile(const double percentile) const noexcept;
+        HistogramSnapshot GetSnapshot() const noexcept;
+
+        static size_t s_BucketIndex(const uint64_t value) noexcept;
+        static uint64_t s_BucketLowestValue(const size_t index) noexcept;
+        static uint64_t s_BucketHighestValue(const size_t index) noexcept;
+
+    private:
+        std::array<std::atomic<uint64_t>, s_BucketCount> _buckets{};
+        std::atomic<uint64_t> _count{ 0 };
+        std::atomic<uint64_t> _sum{ 0 };
+        std::atomic<uint64_t> _min{ UINT64_MAX };
+        std::atomic<uint64_t> _max{ 0 };
+    };
+
+    class MetricsRegistry final
+    {
+    public:
+        static MetricsRegistry& Instance();
+
+        Counter& GetCounter(const std::string_view name);
+        Histogram& GetHistogram(const std::string_view name);
+
+        std::string ToJson() const;
+        void Reset() noexcept;
+
+    private:
+        mutable std::mutex _lock;
+        std::map<std::string, std::unique_ptr<Counter>, std::less<>> _counters;
+        std::map<std::string, std::unique_ptr<Histogram>, std::less<>> _histograms;
+    };
+
+    // Records the time from its construction to its destruction, in
+    //      microseconds, into a histogram.
+    class ScopedLatency final
+    {
+    public:
+        explicit ScopedLatency(Histogram& histogram) noexcept :
+            _histogram{ histogram },
+            _start{ std::chrono::steady_clock::now() }
+        {
+        }
+
+        ~ScopedLatency()
+        {
+            const auto elapsed = std::chrono::steady_clock::now() - _start;
+            _histogram.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+        }
+
+        ScopedLatency(const ScopedLatency&) = delete;
+        ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+    private:
+        Histogram& _histogram;
+        const std::chrono::steady_clock::time_point _start;
+    };
+
+    // Measures the time from the earliest of any number of events to the point
+    //      where they are all handled at once, like writes coalesced into one frame.
+    class PendingLatency final
+    {
+    public:
+        void Begin() noexcept;
+        void End(Histogram& histogram) noexcept;
+
+    private:
+        // steady_clock ticks of the earliest pending event, or 0 if none is pending.
+        std::atomic<int64_t> _start{ 0 };
+    };
+
+    // The pending output that the next frame will present to the user.
+    PendingLatency& UnpaintedOutput() noexcept;
+
+    // Acquires the given lock. If we had to wait for it, records how long we
+    //      waited; otherwise only counts the acquisition, which keeps the
+    //      common uncontended case to a single atomic add.
+    template<typename T>
+    void LockAndMeasureWait(T& lock, Histogram& waits, Counter& uncontended)
+    {
+        if (lock.try_lock())
+        {
+            uncontended.Increment();
+            return;
+        }
+
+        ScopedLatency measure{ waits };
+        lock.lock();
+    }
+}